@@ -0,0 +1,115 @@
+/**
+ * @file main.cpp
+ * @author TheRealKasumi
+ * @brief Example application that prints aggregates over a time window instead of every frame.
+ * @copyright Copyright (c) 2024 TheRealKasumi
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#include <HardwareSerial.h>
+
+#include "bms/SmartBmsAggregator.h"
+#include "bms/SmartBmsData.h"
+#include "bms/SmartBmsError.h"
+#include "bms/SmartBmsReader.h"
+#include "bms/SmartBmsSerializer.h"
+#include "bms/SmartBmsTextWriter.h"
+
+// Serial configuration, adjust as needed
+#define PC_SERIAL_BAUD 115200
+#define BMS_SERIAL_MODE SERIAL_8N1
+#define BMS_SERIAL_PERIPHERAL 1
+#define BMS_SERIAL_BAUD_RATE 9600
+#define BMS_SERIAL_RX_PIN 26
+#define BMS_SERIAL_INVERT false
+
+// Aggregation configuration, length of the window in ms
+#define BMS_AGGREGATION_WINDOW_MS 60000
+
+// Serial connections
+HardwareSerial smartBmsSerial(BMS_SERIAL_PERIPHERAL);
+SmartBmsReader smartBmsReader(&smartBmsSerial);
+
+// Aggregation of the frames
+SmartBmsAggregator smartBmsAggregator;
+
+/**
+ * @brief Print an aggregate to the serial monitor.
+ * @param aggregate aggregate of a closed window
+ * @param context not used
+ */
+void printBmsAggregate(const SmartBmsAggregate *aggregate, void *context)
+{
+	const SmartBmsField fields[] = {SBMS_FIELD_PACK_SOC, SBMS_FIELD_PACK_VOLTAGE, SBMS_FIELD_PACK_CURRENT,
+									SBMS_FIELD_LOWEST_CELL_VOLTAGE, SBMS_FIELD_HIGHEST_CELL_VOLTAGE,
+									SBMS_FIELD_LOWEST_CELL_TEMPERATURE, SBMS_FIELD_HIGHEST_CELL_TEMPERATURE};
+
+	// Write a JSON object with min, mean, max and last value of each field
+	static char buffer[SMART_BMS_SERIALIZER_BUFFER_SIZE];
+	SmartBmsTextWriter writer(buffer, sizeof(buffer));
+	writer.append("{\"windowLength\":");
+	writer.appendUnsigned(aggregate->getWindowLength());
+	writer.append(",\"frames\":");
+	writer.appendUnsigned(aggregate->getSampleCount());
+	for (size_t i = 0; i < sizeof(fields) / sizeof(fields[0]); i++)
+	{
+		writer.append(",\"");
+		writer.append(SmartBmsFields::getDescriptor(fields[i]).name);
+		writer.append("\":[");
+		writer.appendInteger(aggregate->getMin(fields[i]));
+		writer.append(',');
+		writer.appendInteger(aggregate->getMean(fields[i]));
+		writer.append(',');
+		writer.appendInteger(aggregate->getMax(fields[i]));
+		writer.append(',');
+		writer.appendInteger(aggregate->getLast(fields[i]));
+		writer.append(']');
+	}
+	writer.append('}');
+	if (writer.finish() > 0)
+	{
+		Serial.println(buffer);
+	}
+}
+
+/**
+ * @brief Setup.
+ */
+void setup()
+{
+	// Initialize the serial connections
+	Serial.begin(PC_SERIAL_BAUD);
+	smartBmsSerial.begin(BMS_SERIAL_BAUD_RATE, BMS_SERIAL_MODE, BMS_SERIAL_RX_PIN, -1, BMS_SERIAL_INVERT);
+
+	// Aggregate the frames over a fixed window, the first frame starts the window
+	smartBmsAggregator.addWindow(BMS_AGGREGATION_WINDOW_MS);
+	smartBmsAggregator.setAggregateCallback(printBmsAggregate, nullptr);
+}
+
+/**
+ * @brief Endless loop.
+ */
+void loop()
+{
+	// Check if enough data was received
+	if (smartBmsReader.bmsDataReady() == SmartBmsError::SBMS_OK)
+	{
+		SmartBmsData smartBmsData;
+		if (smartBmsReader.decodeBmsData(&smartBmsData) == SmartBmsError::SBMS_OK)
+		{
+			smartBmsAggregator.addSample(smartBmsData, millis());
+		}
+	}
+}
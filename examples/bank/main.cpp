@@ -0,0 +1,112 @@
+/**
+ * @file main.cpp
+ * @author TheRealKasumi
+ * @brief Example application that reads two packs on their own UARTs and prints the combined view of the bank.
+ * @copyright Copyright (c) 2024 TheRealKasumi
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#include <HardwareSerial.h>
+
+#include "bms/SmartBmsBank.h"
+#include "bms/SmartBmsSerializer.h"
+#include "bms/SmartBmsTextWriter.h"
+
+// Serial configuration, adjust as needed
+#define PC_SERIAL_BAUD 115200
+#define BMS_SERIAL_MODE SERIAL_8N1
+#define BMS_SERIAL_BAUD_RATE 9600
+#define BMS_SERIAL_INVERT false
+#define BMS_SERIAL_PERIPHERAL 1
+#define BMS_SERIAL_RX_PIN 26
+#define BMS_SERIAL_2_PERIPHERAL 2
+#define BMS_SERIAL_2_RX_PIN 27
+
+// Bank configuration, a pack without a frame for the maximum age in ms no longer allows charging or discharging
+#define BMS_BANK_MAX_DATA_AGE_MS 5000
+
+// Serial connections, one per pack
+HardwareSerial smartBmsSerial(BMS_SERIAL_PERIPHERAL);
+HardwareSerial smartBmsSerial2(BMS_SERIAL_2_PERIPHERAL);
+
+// Bank of both packs, serviced from the loop
+SmartBmsBank smartBmsBank;
+
+/**
+ * @brief Print the combined view of all packs to the serial monitor.
+ * @param view view of the bank
+ */
+void printBmsBankView(const SmartBmsBankView &view)
+{
+	static char buffer[SMART_BMS_SERIALIZER_BUFFER_SIZE];
+	SmartBmsTextWriter writer(buffer, sizeof(buffer));
+	writer.append("{\"packs\":");
+	writer.appendUnsigned(view.getPackCount());
+	writer.append(",\"stalePacks\":");
+	writer.appendUnsigned(view.getStalePackCount());
+	writer.append(",\"packCurrent\":");
+	writer.appendInteger(view.getPackCurrentMilliamps());
+	writer.append(",\"packRemainingEnergy\":");
+	writer.appendUnsigned(view.getPackRemainingEnergyWattHours());
+	writer.append(",\"lowestCellVoltage\":");
+	writer.appendUnsigned(view.getLowestCellVoltageMillivolts());
+	writer.append(",\"highestCellVoltage\":");
+	writer.appendUnsigned(view.getHighestCellVoltageMillivolts());
+	writer.append(",\"lowestCellTemperature\":");
+	writer.appendInteger(view.getLowestCellTemperatureMillicelsius());
+	writer.append(",\"highestCellTemperature\":");
+	writer.appendInteger(view.getHighestCellTemperatureMillicelsius());
+	writer.append(",\"allowedToCharge\":");
+	writer.append(view.isAllowedToCharge() ? "true" : "false");
+	writer.append(",\"allowedToDischarge\":");
+	writer.append(view.isAllowedToDischarge() ? "true" : "false");
+	writer.append(",\"alarmPacks\":");
+	writer.appendUnsigned(view.getAlarmPackMask());
+	writer.append('}');
+	if (writer.finish() > 0)
+	{
+		Serial.println(buffer);
+	}
+}
+
+/**
+ * @brief Setup.
+ */
+void setup()
+{
+	// Initialize the serial connections, all packs share the same wiring
+	Serial.begin(PC_SERIAL_BAUD);
+	smartBmsSerial.begin(BMS_SERIAL_BAUD_RATE, BMS_SERIAL_MODE, BMS_SERIAL_RX_PIN, -1, BMS_SERIAL_INVERT);
+	smartBmsSerial2.begin(BMS_SERIAL_BAUD_RATE, BMS_SERIAL_MODE, BMS_SERIAL_2_RX_PIN, -1, BMS_SERIAL_INVERT);
+
+	// Read both packs from one loop, each on its own UART
+	smartBmsBank.addPack(&smartBmsSerial);
+	smartBmsBank.addPack(&smartBmsSerial2);
+	smartBmsBank.setMaxDataAge(BMS_BANK_MAX_DATA_AGE_MS * 1000);
+}
+
+/**
+ * @brief Endless loop.
+ */
+void loop()
+{
+	// All packs are serviced in turns and the combined view is printed after every frame
+	if (smartBmsBank.service() > 0)
+	{
+		SmartBmsBankView view;
+		smartBmsBank.getView(&view);
+		printBmsBankView(view);
+	}
+}
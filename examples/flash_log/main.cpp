@@ -0,0 +1,102 @@
+/**
+ * @file main.cpp
+ * @author TheRealKasumi
+ * @brief Example application that keeps a history of the frames in LittleFS.
+ * @copyright Copyright (c) 2024 TheRealKasumi
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#include <HardwareSerial.h>
+#include <LittleFS.h>
+
+#include "bms/SmartBmsData.h"
+#include "bms/SmartBmsError.h"
+#include "bms/SmartBmsLog.h"
+#include "bms/SmartBmsLogStorage.h"
+#include "bms/SmartBmsReader.h"
+
+// Serial configuration, adjust as needed
+#define PC_SERIAL_BAUD 115200
+#define BMS_SERIAL_MODE SERIAL_8N1
+#define BMS_SERIAL_PERIPHERAL 1
+#define BMS_SERIAL_BAUD_RATE 9600
+#define BMS_SERIAL_RX_PIN 26
+#define BMS_SERIAL_INVERT false
+
+// Flash log configuration, the log alternates between two files of at most the maximum size each
+// Partial blocks are written after the flush interval in ms to limit the loss on a power cut
+#define BMS_FLASH_LOG_FIRST_PATH "/littlefs/bms.0.log"
+#define BMS_FLASH_LOG_SECOND_PATH "/littlefs/bms.1.log"
+#define BMS_FLASH_LOG_MAX_SIZE 65536
+#define BMS_FLASH_LOG_FLUSH_INTERVAL_MS 60000
+
+// Serial connections
+HardwareSerial smartBmsSerial(BMS_SERIAL_PERIPHERAL);
+SmartBmsReader smartBmsReader(&smartBmsSerial);
+
+// Log of the frames in the flash
+SmartBmsFileLogStorage smartBmsLogStorage;
+SmartBmsFileLogStorage smartBmsLogStorage2;
+SmartBmsLog smartBmsLog(&smartBmsLogStorage, &smartBmsLogStorage2, BMS_FLASH_LOG_MAX_SIZE);
+uint32_t lastFlashLogFlush = 0;
+
+/**
+ * @brief Setup.
+ */
+void setup()
+{
+	// Initialize the serial connections
+	Serial.begin(PC_SERIAL_BAUD);
+	smartBmsSerial.begin(BMS_SERIAL_BAUD_RATE, BMS_SERIAL_MODE, BMS_SERIAL_RX_PIN, -1, BMS_SERIAL_INVERT);
+
+	// Open the flash log, a block that was cut off by a power loss is removed
+	if (!LittleFS.begin(true) || !smartBmsLogStorage.open(BMS_FLASH_LOG_FIRST_PATH) || !smartBmsLogStorage2.open(BMS_FLASH_LOG_SECOND_PATH) ||
+		smartBmsLog.begin() != SmartBmsError::SBMS_OK)
+	{
+		Serial.println("Error: Failed to open the flash log.");
+		smartBmsLogStorage.close();
+		smartBmsLogStorage2.close();
+	}
+}
+
+/**
+ * @brief Endless loop.
+ */
+void loop()
+{
+	// Check if enough data was received
+	if (smartBmsReader.bmsDataReady() != SmartBmsError::SBMS_OK)
+	{
+		return;
+	}
+
+	SmartBmsData smartBmsData;
+	if (smartBmsReader.decodeBmsData(&smartBmsData) != SmartBmsError::SBMS_OK || !smartBmsLogStorage.isOpen())
+	{
+		return;
+	}
+
+	// Full blocks are written on their own, partial blocks are written from time to time
+	SmartBmsError err = smartBmsLog.append(smartBmsData, millis());
+	if (millis() - lastFlashLogFlush >= BMS_FLASH_LOG_FLUSH_INTERVAL_MS)
+	{
+		err = smartBmsLog.flush();
+		lastFlashLogFlush = millis();
+	}
+	if (err != SmartBmsError::SBMS_OK)
+	{
+		Serial.println("Error: Failed to write the flash log.");
+	}
+}
@@ -0,0 +1,129 @@
+/**
+ * @file main.cpp
+ * @author TheRealKasumi
+ * @brief Example application that assembles the frames in a dedicated task on another core.
+ * @copyright Copyright (c) 2024 TheRealKasumi
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#include <HardwareSerial.h>
+
+#include "bms/SmartBmsData.h"
+#include "bms/SmartBmsFrameView.h"
+#include "bms/SmartBmsIngestTask.h"
+#include "bms/SmartBmsQueue.h"
+#include "bms/SmartBmsSerializer.h"
+
+// Serial configuration, adjust as needed
+#define PC_SERIAL_BAUD 115200
+#define BMS_SERIAL_MODE SERIAL_8N1
+#define BMS_SERIAL_PERIPHERAL 1
+#define BMS_SERIAL_BAUD_RATE 9600
+#define BMS_SERIAL_RX_PIN 26
+#define BMS_SERIAL_INVERT false
+
+// Ingestion configuration, the task runs on the given core
+// A maximum frame age in ms skips frames that waited too long in the queue, 0 keeps all frames
+#define BMS_INGEST_TASK_CORE 0
+#define BMS_MAX_FRAME_AGE_MS 0
+
+// Serial connection, only the ingestion task reads from it
+HardwareSerial smartBmsSerial(BMS_SERIAL_PERIPHERAL);
+
+// Ingestion task and the queue it fills
+SmartBmsFrameQueue smartBmsQueue;
+SmartBmsIngestTask smartBmsIngestTask(&smartBmsSerial, &smartBmsQueue);
+
+/**
+ * @brief Print the BMS data to the serial monitor.
+ * @param smartBmsData data to print
+ */
+void printBmsData(const SmartBmsData &smartBmsData)
+{
+	static char buffer[SMART_BMS_SERIALIZER_BUFFER_SIZE];
+	if (SmartBmsSerializer::serialize(smartBmsData, SmartBmsSerializerFormat::SBMS_FORMAT_JSON, buffer, sizeof(buffer)) > 0)
+	{
+		Serial.println(buffer);
+	}
+}
+
+/**
+ * @brief Print a change of a permission flag. The callback runs in the ingestion task, before the frame is queued.
+ * @param field flag that changed
+ * @param value new value of the flag
+ * @param timestamp time in µs when the first byte of the frame was received
+ * @param context not used
+ */
+void printBmsFlagChange(const SmartBmsField field, const bool value, const uint32_t timestamp, void *context)
+{
+	Serial.print("Event: ");
+	Serial.print(SmartBmsFields::getDescriptor(field).name);
+	Serial.println(value ? " is set" : " is cleared");
+}
+
+/**
+ * @brief Setup.
+ */
+void setup()
+{
+	// Initialize the serial connections
+	Serial.begin(PC_SERIAL_BAUD);
+	smartBmsSerial.begin(BMS_SERIAL_BAUD_RATE, BMS_SERIAL_MODE, BMS_SERIAL_RX_PIN, -1, BMS_SERIAL_INVERT);
+
+	// Watch the permission flags
+	smartBmsIngestTask.subscribe(SBMS_FIELD_ALLOWED_TO_CHARGE, SmartBmsFlagEdge::SBMS_EDGE_BOTH, printBmsFlagChange, nullptr);
+	smartBmsIngestTask.subscribe(SBMS_FIELD_ALLOWED_TO_DISCHARGE, SmartBmsFlagEdge::SBMS_EDGE_BOTH, printBmsFlagChange, nullptr);
+
+	// Count overflows of the receive buffer and start the task
+	smartBmsSerial.onReceiveError([](hardwareSerial_error_t err)
+								  {
+									  if (err == UART_BUFFER_FULL_ERROR || err == UART_FIFO_OVF_ERROR)
+									  {
+										  smartBmsIngestTask.reportRxOverflow();
+									  } });
+	smartBmsIngestTask.begin(BMS_INGEST_TASK_CORE);
+}
+
+/**
+ * @brief Endless loop.
+ */
+void loop()
+{
+	// Drain the frames from the queue at our own pace
+	SmartBmsFrameView frameView;
+	while (smartBmsQueue.pop(&frameView))
+	{
+		SmartBmsData smartBmsData;
+		frameView.decode(&smartBmsData);
+
+		// Frames carry the time of their first byte, so frames that waited too long in the queue can be skipped
+		if (BMS_MAX_FRAME_AGE_MS > 0 && smartBmsData.getAge(micros()) > BMS_MAX_FRAME_AGE_MS * 1000)
+		{
+			continue;
+		}
+		printBmsData(smartBmsData);
+		if (smartBmsQueue.getDroppedCount() > 0 || smartBmsIngestTask.getRxOverflowCount() > 0)
+		{
+			Serial.print("Warning: Dropped frames: ");
+			Serial.print(smartBmsQueue.getDroppedCount());
+			Serial.print(", RX overflows: ");
+			Serial.println(smartBmsIngestTask.getRxOverflowCount());
+		}
+	}
+
+	/*
+	 * Do something else in the meantime, the task keeps reading the UART.
+	 */
+}
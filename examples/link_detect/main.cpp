@@ -0,0 +1,136 @@
+/**
+ * @file main.cpp
+ * @author TheRealKasumi
+ * @brief Example application that detects the polarity of the BMS link at startup.
+ * @copyright Copyright (c) 2024 TheRealKasumi
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#include <HardwareSerial.h>
+
+#include "bms/SmartBmsData.h"
+#include "bms/SmartBmsError.h"
+#include "bms/SmartBmsLinkDetector.h"
+#include "bms/SmartBmsReader.h"
+#include "bms/SmartBmsSerializer.h"
+
+// Serial configuration, adjust as needed, the polarity is only the first guess
+#define PC_SERIAL_BAUD 115200
+#define BMS_SERIAL_MODE SERIAL_8N1
+#define BMS_SERIAL_PERIPHERAL 1
+#define BMS_SERIAL_BAUD_RATE 9600
+#define BMS_SERIAL_RX_PIN 26
+#define BMS_SERIAL_INVERT false
+
+// Link detection, every attempt samples for the given time in ms, the BMS sends a frame about every second
+#define BMS_LINK_DETECT_TIMEOUT_MS 2500
+#define BMS_LINK_DETECT_ATTEMPTS 4
+
+// Serial connections
+HardwareSerial smartBmsSerial(BMS_SERIAL_PERIPHERAL);
+SmartBmsReader smartBmsReader(&smartBmsSerial);
+
+/**
+ * @brief Print the BMS data to the serial monitor.
+ * @param smartBmsData data to print
+ */
+void printBmsData(const SmartBmsData &smartBmsData)
+{
+	static char buffer[SMART_BMS_SERIALIZER_BUFFER_SIZE];
+	if (SmartBmsSerializer::serialize(smartBmsData, SmartBmsSerializerFormat::SBMS_FORMAT_JSON, buffer, sizeof(buffer)) > 0)
+	{
+		Serial.println(buffer);
+	}
+}
+
+/**
+ * @brief Sample the first frames of the BMS UART and flip its polarity until a frame is found.
+ * A UART with the wrong polarity mostly receives framing errors, so every attempt that does not lock flips the polarity.
+ * A link that locks on complemented bytes has the data bits inverted, so the polarity is flipped as well.
+ * @return true when the UART is inverted after the detection
+ */
+bool detectBmsLink()
+{
+	SmartBmsLinkDetector detector;
+	bool invert = BMS_SERIAL_INVERT;
+	for (uint8_t attempt = 0; attempt < BMS_LINK_DETECT_ATTEMPTS; attempt++)
+	{
+		// Sample until two frames at the same alignment were found or the attempt times out
+		uint8_t buffer[SMART_BMS_FRAME_SIZE];
+		const uint32_t start = millis();
+		detector.reset();
+		while (detector.getState() == SmartBmsLinkState::SBMS_LINK_SEARCHING && millis() - start < BMS_LINK_DETECT_TIMEOUT_MS)
+		{
+			const int available = smartBmsSerial.available();
+			if (available <= 0)
+			{
+				delay(5);
+				continue;
+			}
+			const size_t length = available < static_cast<int>(sizeof(buffer)) ? available : sizeof(buffer);
+			detector.feed(buffer, smartBmsSerial.readBytes(buffer, length));
+		}
+
+		if (detector.getState() == SmartBmsLinkState::SBMS_LINK_LOCKED)
+		{
+			if (detector.getPolarity() == SmartBmsLinkPolarity::SBMS_LINK_INVERTED)
+			{
+				invert = !invert;
+				smartBmsSerial.setRxInvert(invert);
+			}
+			Serial.print("Info: BMS link locked after ");
+			Serial.print(detector.getSampledByteCount());
+			Serial.print(" bytes, inverted: ");
+			Serial.println(invert ? "true" : "false");
+			return invert;
+		}
+
+		// Nothing plausible was received, try again with the other polarity
+		invert = !invert;
+		smartBmsSerial.setRxInvert(invert);
+	}
+
+	Serial.println("Error: Failed to detect the BMS link. Check the wiring.");
+	return BMS_SERIAL_INVERT;
+}
+
+/**
+ * @brief Setup.
+ */
+void setup()
+{
+	// Initialize the serial connections
+	Serial.begin(PC_SERIAL_BAUD);
+	smartBmsSerial.begin(BMS_SERIAL_BAUD_RATE, BMS_SERIAL_MODE, BMS_SERIAL_RX_PIN, -1, BMS_SERIAL_INVERT);
+
+	// Find the polarity of the link before anyone reads from the UART
+	detectBmsLink();
+}
+
+/**
+ * @brief Endless loop.
+ */
+void loop()
+{
+	// Check if enough data was received
+	if (smartBmsReader.bmsDataReady() == SmartBmsError::SBMS_OK)
+	{
+		SmartBmsData smartBmsData;
+		if (smartBmsReader.decodeBmsData(&smartBmsData) == SmartBmsError::SBMS_OK)
+		{
+			printBmsData(smartBmsData);
+		}
+	}
+}
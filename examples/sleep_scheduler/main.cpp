@@ -0,0 +1,96 @@
+/**
+ * @file main.cpp
+ * @author TheRealKasumi
+ * @brief Example application that light sleeps between the frames of the BMS.
+ * @copyright Copyright (c) 2024 TheRealKasumi
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#include <HardwareSerial.h>
+#include <esp_sleep.h>
+
+#include "bms/SmartBmsData.h"
+#include "bms/SmartBmsError.h"
+#include "bms/SmartBmsReader.h"
+#include "bms/SmartBmsScheduler.h"
+#include "bms/SmartBmsSerializer.h"
+
+// Serial configuration, adjust as needed
+#define PC_SERIAL_BAUD 115200
+#define BMS_SERIAL_MODE SERIAL_8N1
+#define BMS_SERIAL_PERIPHERAL 1
+#define BMS_SERIAL_BAUD_RATE 9600
+#define BMS_SERIAL_RX_PIN 26
+#define BMS_SERIAL_INVERT false
+
+// Sleep configuration, sleeps shorter than the minimum in ms are not worth waking up for
+#define BMS_SLEEP_MIN_MS 10
+
+// Serial connections
+HardwareSerial smartBmsSerial(BMS_SERIAL_PERIPHERAL);
+SmartBmsReader smartBmsReader(&smartBmsSerial);
+
+// Scheduler that predicts the next frame, so the loop can sleep in between
+SmartBmsScheduler smartBmsScheduler;
+
+/**
+ * @brief Print the BMS data to the serial monitor.
+ * @param smartBmsData data to print
+ */
+void printBmsData(const SmartBmsData &smartBmsData)
+{
+	static char buffer[SMART_BMS_SERIALIZER_BUFFER_SIZE];
+	if (SmartBmsSerializer::serialize(smartBmsData, SmartBmsSerializerFormat::SBMS_FORMAT_JSON, buffer, sizeof(buffer)) > 0)
+	{
+		Serial.println(buffer);
+	}
+}
+
+/**
+ * @brief Setup.
+ */
+void setup()
+{
+	// Initialize the serial connections
+	Serial.begin(PC_SERIAL_BAUD);
+	smartBmsSerial.begin(BMS_SERIAL_BAUD_RATE, BMS_SERIAL_MODE, BMS_SERIAL_RX_PIN, -1, BMS_SERIAL_INVERT);
+}
+
+/**
+ * @brief Endless loop.
+ */
+void loop()
+{
+	// Check if enough data was received
+	if (smartBmsReader.bmsDataReady() == SmartBmsError::SBMS_OK)
+	{
+		SmartBmsData smartBmsData;
+		if (smartBmsReader.decodeBmsData(&smartBmsData) == SmartBmsError::SBMS_OK)
+		{
+			// Every frame teaches the scheduler the cycle of the BMS
+			printBmsData(smartBmsData);
+			smartBmsScheduler.onFrame(smartBmsData.getTimestamp());
+		}
+	}
+
+	// Sleep until shortly before the next frame, the scheduler keeps the loop awake while a frame is due or the cycle is still learned
+	const uint32_t sleepTime = smartBmsScheduler.getSleepTime();
+	if (sleepTime >= BMS_SLEEP_MIN_MS * 1000)
+	{
+		Serial.flush();
+		esp_sleep_enable_timer_wakeup(sleepTime);
+		esp_light_sleep_start();
+	}
+}
@@ -0,0 +1,93 @@
+/**
+ * @file main.cpp
+ * @author TheRealKasumi
+ * @brief Example application that counts the frames and errors of the BMS link and prints them in the Prometheus text format.
+ * @copyright Copyright (c) 2024 TheRealKasumi
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#include <HardwareSerial.h>
+
+#include "bms/SmartBmsData.h"
+#include "bms/SmartBmsError.h"
+#include "bms/SmartBmsReader.h"
+#include "bms/SmartBmsStatistics.h"
+
+// The statistics are only compiled with -D SMART_BMS_STATISTICS in the build flags
+#ifndef SMART_BMS_STATISTICS
+#error "The statistics example requires -D SMART_BMS_STATISTICS"
+#endif
+
+// Serial configuration, adjust as needed
+#define PC_SERIAL_BAUD 115200
+#define BMS_SERIAL_MODE SERIAL_8N1
+#define BMS_SERIAL_PERIPHERAL 1
+#define BMS_SERIAL_BAUD_RATE 9600
+#define BMS_SERIAL_RX_PIN 26
+#define BMS_SERIAL_INVERT false
+
+// Statistics configuration, interval in ms between two prints
+#define BMS_STATISTICS_INTERVAL_MS 60000
+
+// Serial connections
+HardwareSerial smartBmsSerial(BMS_SERIAL_PERIPHERAL);
+SmartBmsReader smartBmsReader(&smartBmsSerial);
+
+// Statistics about the BMS link
+SmartBmsStatistics smartBmsStatistics;
+uint32_t lastStatisticsPrint = 0;
+
+/**
+ * @brief Setup.
+ */
+void setup()
+{
+	// Initialize the serial connections
+	Serial.begin(PC_SERIAL_BAUD);
+	smartBmsSerial.begin(BMS_SERIAL_BAUD_RATE, BMS_SERIAL_MODE, BMS_SERIAL_RX_PIN, -1, BMS_SERIAL_INVERT);
+
+	// Count the frames and errors of the reader and the overflows of the receive buffer
+	smartBmsReader.setStatistics(&smartBmsStatistics);
+	smartBmsSerial.onReceiveError([](hardwareSerial_error_t err)
+								  {
+									  if (err == UART_BUFFER_FULL_ERROR || err == UART_FIFO_OVF_ERROR)
+									  {
+										  smartBmsStatistics.countRxOverflow();
+									  } });
+}
+
+/**
+ * @brief Endless loop.
+ */
+void loop()
+{
+	// The reader counts every frame and error while it decodes
+	if (smartBmsReader.bmsDataReady() == SmartBmsError::SBMS_OK)
+	{
+		SmartBmsData smartBmsData;
+		smartBmsReader.decodeBmsData(&smartBmsData);
+	}
+
+	// Print the statistics from time to time
+	if (millis() - lastStatisticsPrint >= BMS_STATISTICS_INTERVAL_MS)
+	{
+		static char buffer[SMART_BMS_STATISTICS_BUFFER_SIZE];
+		if (smartBmsStatistics.toPrometheus(buffer, sizeof(buffer)) > 0)
+		{
+			Serial.print(buffer);
+		}
+		lastStatisticsPrint = millis();
+	}
+}
@@ -0,0 +1,102 @@
+/**
+ * @file SmartBmsAggregator.h
+ * @author TheRealKasumi
+ * @brief Contains a streaming aggregator that keeps min, max, mean and last values of fields over several time windows.
+ * @copyright Copyright (c) 2024 TheRealKasumi
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#ifndef SMART_BMS_AGGREGATOR_H
+#define SMART_BMS_AGGREGATOR_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "bms/SmartBmsData.h"
+#include "bms/SmartBmsField.h"
+
+// Maximum number of windows that are aggregated at the same time
+#ifndef SMART_BMS_MAX_AGGREGATION_WINDOWS
+#define SMART_BMS_MAX_AGGREGATION_WINDOWS 4
+#endif
+
+class SmartBmsAggregate
+{
+public:
+	SmartBmsAggregate();
+	~SmartBmsAggregate();
+
+	const uint32_t getWindowLength() const;
+	const uint32_t getStartTime() const;
+	const uint32_t getEndTime() const;
+	const uint32_t getSampleCount() const;
+	const uint32_t getFieldMask() const;
+	const bool hasField(const SmartBmsField field) const;
+
+	const uint32_t getCount(const SmartBmsField field) const;
+	const int32_t getMin(const SmartBmsField field) const;
+	const int32_t getMax(const SmartBmsField field) const;
+	const int32_t getMean(const SmartBmsField field) const;
+	const int32_t getLast(const SmartBmsField field) const;
+	const bool wasActive(const SmartBmsField field) const;
+
+private:
+	uint32_t windowLength_;
+	uint32_t startTime_;
+	uint32_t sampleCount_;
+	uint32_t fieldMask_;
+	uint32_t activeMask_;
+	int32_t last_[SBMS_FIELD_COUNT];
+	uint32_t counts_[SBMS_MEASUREMENT_COUNT];
+	int32_t min_[SBMS_MEASUREMENT_COUNT];
+	int32_t max_[SBMS_MEASUREMENT_COUNT];
+	int64_t sum_[SBMS_MEASUREMENT_COUNT];
+
+	void reset_(const uint32_t windowLength, const uint32_t startTime);
+	void add_(const SmartBmsData &smartBmsData, const uint32_t fieldMask);
+	static const size_t getMeasurementIndex_(const SmartBmsField field);
+
+	friend class SmartBmsAggregator;
+};
+
+typedef void (*SmartBmsAggregateCallback)(const SmartBmsAggregate *aggregate, void *context);
+
+class SmartBmsAggregator
+{
+public:
+	SmartBmsAggregator();
+	~SmartBmsAggregator();
+
+	const bool addWindow(const uint32_t windowLength);
+	const size_t getWindowCount() const;
+	const SmartBmsAggregate *getWindow(const size_t index) const;
+	void setFieldMask(const uint32_t fieldMask);
+	void setAggregateCallback(SmartBmsAggregateCallback aggregateCallback, void *context);
+
+	void addSample(const SmartBmsData &smartBmsData, const uint32_t timestamp);
+	void advance(const uint32_t timestamp);
+
+private:
+	SmartBmsAggregate windows_[SMART_BMS_MAX_AGGREGATION_WINDOWS];
+	size_t windowCount_;
+	bool started_;
+	uint32_t startTime_;
+	uint32_t time_;
+	uint32_t fieldMask_;
+	SmartBmsAggregateCallback aggregateCallback_;
+	void *aggregateCallbackContext_;
+};
+
+#endif
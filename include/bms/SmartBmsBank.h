@@ -0,0 +1,160 @@
+/**
+ * @file SmartBmsBank.h
+ * @author TheRealKasumi
+ * @brief Contains a manager for several battery packs that are read from one loop and combined into a bank.
+ * @copyright Copyright (c) 2024 TheRealKasumi
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#ifndef SMART_BMS_BANK_H
+#define SMART_BMS_BANK_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <Stream.h>
+
+#include "bms/SmartBmsClock.h"
+#include "bms/SmartBmsData.h"
+#include "bms/SmartBmsReader.h"
+
+// The ESP32 has three UARTs, so one pack per UART
+#ifndef SMART_BMS_MAX_PACKS
+#define SMART_BMS_MAX_PACKS 3
+#endif
+static_assert(SMART_BMS_MAX_PACKS <= 8, "The alarm pack mask must fit into a single byte");
+
+// Bytes read from a pack per service round, a frame is 58 bytes
+#ifndef SMART_BMS_BANK_BYTE_BUDGET
+#define SMART_BMS_BANK_BYTE_BUDGET 64
+#endif
+
+#define SMART_BMS_BANK_NO_PACK 0xFF
+
+class SmartBmsPack
+{
+public:
+	SmartBmsPack();
+	~SmartBmsPack();
+
+	SmartBmsReader *getReader();
+	const bool hasData() const;
+	const SmartBmsData &getData() const;
+	const uint32_t getFrameCount() const;
+	const uint32_t getReadErrorCount() const;
+	const uint32_t getSkippedByteCount() const;
+	const uint32_t getMissedCycleCount() const;
+
+private:
+	Stream *inputStream_;
+	SmartBmsReader smartBmsReader_;
+	SmartBmsData smartBmsData_;
+	bool hasData_;
+	uint32_t frameCount_;
+	uint32_t readErrorCount_;
+
+	friend class SmartBmsBank;
+};
+
+class SmartBmsBankView
+{
+public:
+	SmartBmsBankView();
+	~SmartBmsBankView();
+
+	const uint8_t getPackCount() const;
+	const uint8_t getStalePackCount() const;
+	const int32_t getPackCurrentMilliamps() const;
+	const uint32_t getPackCapacityWattHours() const;
+	const uint32_t getPackRemainingEnergyWattHours() const;
+
+	const uint32_t getLowestCellVoltageMillivolts() const;
+	const uint8_t getLowestCellVoltagePack() const;
+	const uint8_t getLowestCellVoltageNumber() const;
+	const uint32_t getHighestCellVoltageMillivolts() const;
+	const uint8_t getHighestCellVoltagePack() const;
+	const uint8_t getHighestCellVoltageNumber() const;
+	const int32_t getLowestCellTemperatureMillicelsius() const;
+	const uint8_t getLowestCellTemperaturePack() const;
+	const uint8_t getLowestCellTemperatureNumber() const;
+	const int32_t getHighestCellTemperatureMillicelsius() const;
+	const uint8_t getHighestCellTemperaturePack() const;
+	const uint8_t getHighestCellTemperatureNumber() const;
+
+	const bool hasCommunicationError() const;
+	const bool isAllowedToCharge() const;
+	const bool isAllowedToDischarge() const;
+	const bool isMinVoltageAlarmActive() const;
+	const bool isMaxVoltageAlarmActive() const;
+	const bool isMinTemperatureAlarmActive() const;
+	const bool isMaxTemperatureAlarmActive() const;
+	const uint8_t getAlarmPackMask() const;
+
+private:
+	uint8_t packCount_;
+	uint8_t stalePackCount_;
+	int32_t packCurrent_;
+	uint32_t packCapacity_;
+	uint32_t packRemainingEnergy_;
+	uint32_t lowestCellVoltage_;
+	uint8_t lowestCellVoltagePack_;
+	uint8_t lowestCellVoltageNumber_;
+	uint32_t highestCellVoltage_;
+	uint8_t highestCellVoltagePack_;
+	uint8_t highestCellVoltageNumber_;
+	int32_t lowestCellTemperature_;
+	uint8_t lowestCellTemperaturePack_;
+	uint8_t lowestCellTemperatureNumber_;
+	int32_t highestCellTemperature_;
+	uint8_t highestCellTemperaturePack_;
+	uint8_t highestCellTemperatureNumber_;
+	uint32_t flagMask_;
+	uint8_t alarmPackMask_;
+
+	void add_(const SmartBmsData &smartBmsData, const uint8_t pack);
+
+	friend class SmartBmsBank;
+};
+
+typedef void (*SmartBmsPackCallback)(const uint8_t pack, const SmartBmsData *smartBmsData, void *context);
+
+class SmartBmsBank
+{
+public:
+	SmartBmsBank();
+	~SmartBmsBank();
+
+	const bool addPack(Stream *inputStream);
+	const uint8_t getPackCount() const;
+	SmartBmsPack *getPack(const uint8_t pack);
+	void setClock(SmartBmsClock clock);
+	void setMaxDataAge(const uint32_t maxDataAge);
+	void setPackCallback(SmartBmsPackCallback packCallback, void *context);
+
+	const size_t service();
+	void getView(SmartBmsBankView *view) const;
+
+private:
+	SmartBmsPack packs_[SMART_BMS_MAX_PACKS];
+	uint8_t packCount_;
+	uint8_t nextPack_;
+	SmartBmsClock clock_;
+	uint32_t maxDataAge_;
+	SmartBmsPackCallback packCallback_;
+	void *packCallbackContext_;
+
+	const size_t servicePack_(const uint8_t pack);
+};
+
+#endif
@@ -0,0 +1,40 @@
+/**
+ * @file SmartBmsBatchDecoder.h
+ * @author TheRealKasumi
+ * @brief Contains a class that validates and decodes many aligned frames at once.
+ * @copyright Copyright (c) 2024 TheRealKasumi
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#ifndef SMART_BMS_BATCH_DECODER_H
+#define SMART_BMS_BATCH_DECODER_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "bms/SmartBmsData.h"
+#include "bms/SmartBmsField.h"
+
+class SmartBmsBatchDecoder
+{
+public:
+	static const bool isChecksumValid(const uint8_t frame[SMART_BMS_FRAME_SIZE]);
+	static const bool isFrameValid(const uint8_t frame[SMART_BMS_FRAME_SIZE]);
+	static const size_t validateFrames(const uint8_t *buffer, const size_t frameCount, uint8_t *validBitmap);
+	static const size_t decodeFrames(const uint8_t *buffer, const size_t frameCount, SmartBmsData *smartBmsData, uint8_t *validBitmap, const uint32_t fieldMask = SBMS_FIELD_MASK_ALL);
+	static void markChangedFields(const uint8_t *buffer, const size_t frameCount, SmartBmsData *smartBmsData);
+};
+
+#endif
@@ -0,0 +1,83 @@
+/**
+ * @file SmartBmsCellTable.h
+ * @author TheRealKasumi
+ * @brief Contains a table with the voltage and temperature of every cell, which is filled from the rotating cell data.
+ * @copyright Copyright (c) 2024 TheRealKasumi
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#ifndef SMART_BMS_CELL_TABLE_H
+#define SMART_BMS_CELL_TABLE_H
+
+#ifdef SMART_BMS_CELL_DATA
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "bms/SmartBmsData.h"
+#include "bms/SmartBmsFrameView.h"
+
+// Maximum number of cells the table can hold, cells with a higher number are ignored
+#ifndef SMART_BMS_MAX_CELL_COUNT
+#define SMART_BMS_MAX_CELL_COUNT 32
+#endif
+
+#define SMART_BMS_CELL_AGE_UNKNOWN UINT32_MAX
+
+class SmartBmsCellTable
+{
+public:
+	SmartBmsCellTable();
+	~SmartBmsCellTable();
+
+	const bool update(const SmartBmsFrameView &frameView);
+	const bool update(const SmartBmsData &smartBmsData);
+	void clear();
+
+	const uint8_t getCellCount() const;
+	const bool hasCell(const uint8_t cellNumber) const;
+	const uint32_t getCellVoltageMillivolts(const uint8_t cellNumber) const;
+	const int32_t getCellTemperatureMillicelsius(const uint8_t cellNumber) const;
+#ifndef SMART_BMS_FIXED_POINT
+	const float getCellVoltage(const uint8_t cellNumber) const;
+	const float getCellTemperature(const uint8_t cellNumber) const;
+#endif
+	const uint32_t getCellAge(const uint8_t cellNumber) const;
+
+	const bool isComplete() const;
+	const uint32_t getSweepCount() const;
+	const uint32_t getFrameCount() const;
+
+private:
+	uint8_t cellCount_;
+	uint8_t pendingCellCount_;
+	bool hasPendingCellCount_;
+	uint16_t voltages_[SMART_BMS_MAX_CELL_COUNT];
+	uint16_t temperatures_[SMART_BMS_MAX_CELL_COUNT];
+	uint32_t updateFrames_[SMART_BMS_MAX_CELL_COUNT];
+	uint32_t validMask_[(SMART_BMS_MAX_CELL_COUNT + 31) / 32];
+	uint32_t sweepMask_[(SMART_BMS_MAX_CELL_COUNT + 31) / 32];
+	uint16_t validCount_;
+	uint16_t sweepLength_;
+	uint32_t sweepCount_;
+	uint32_t frameCount_;
+
+	const bool update_(const uint8_t cellCount, const uint8_t cellNumber, const uint16_t voltage, const uint16_t temperature);
+	const uint8_t getTableSize_() const;
+};
+
+#endif
+
+#endif
@@ -0,0 +1,35 @@
+/**
+ * @file SmartBmsClock.h
+ * @author TheRealKasumi
+ * @brief Contains the clock type used to timestamp frames and the default system clock.
+ * @copyright Copyright (c) 2024 TheRealKasumi
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#ifndef SMART_BMS_CLOCK_H
+#define SMART_BMS_CLOCK_H
+
+#include <stdint.h>
+
+// Returns a monotonic time in µs, it may wrap around at 2^32
+typedef const uint32_t (*SmartBmsClock)();
+
+class SmartBmsSystemClock
+{
+public:
+	static const uint32_t getMicros();
+};
+
+#endif
@@ -23,9 +23,10 @@
 
 #include <stdint.h>
 
-#include "bms/SmartBmsReader.h"
+#include "bms/SmartBmsField.h"
+#include "bms/SmartBmsFrameView.h"
 
-class SmartBmsReader;
+class SmartBmsFrameView;
 
 class SmartBmsData
 {
@@ -33,26 +34,38 @@ public:
 	SmartBmsData();
 	~SmartBmsData();
 
+	const uint32_t getFieldMask() const;
+	const bool hasField(const SmartBmsField field) const;
+	const uint32_t getChangedMask() const;
+	const bool hasChanged(const SmartBmsField field) const;
+	const uint32_t getTimestamp() const;
+	const uint32_t getAge(const uint32_t now) const;
+	const int32_t getRawValue(const SmartBmsField field) const;
+	const int32_t getFixedValue(const SmartBmsField field) const;
+#ifndef SMART_BMS_FIXED_POINT
+	const float getValue(const SmartBmsField field) const;
+#endif
+
 	const uint8_t getCellCount() const;
-	const float getCellVoltageMin() const;
-	const float getCellVoltageMax() const;
-	const float getCellVoltageBalance() const;
+	const uint32_t getCellVoltageMinMillivolts() const;
+	const uint32_t getCellVoltageMaxMillivolts() const;
+	const uint32_t getCellVoltageBalanceMillivolts() const;
 
 	const uint8_t getPackSoc() const;
-	const float getPackVoltage() const;
-	const float getPackCurrent() const;
-	const float getPackChargeCurrent() const;
-	const float getPackDischargeCurrent() const;
-	const float getPackCapacity() const;
-	const float getPackRemainingEnergy() const;
+	const uint32_t getPackVoltageMillivolts() const;
+	const int32_t getPackCurrentMilliamps() const;
+	const int32_t getPackChargeCurrentMilliamps() const;
+	const int32_t getPackDischargeCurrentMilliamps() const;
+	const uint32_t getPackCapacityWattHours() const;
+	const uint32_t getPackRemainingEnergyWattHours() const;
 
-	const float getLowestCellVoltage() const;
+	const uint32_t getLowestCellVoltageMillivolts() const;
 	const uint8_t getLowestCellVoltageNumber() const;
-	const float getHighestCellVoltage() const;
+	const uint32_t getHighestCellVoltageMillivolts() const;
 	const uint8_t getHighestCellVoltageNumber() const;
-	const float getLowestCellTemperature() const;
+	const int32_t getLowestCellTemperatureMillicelsius() const;
 	const uint8_t getLowestCellTemperatureNumber() const;
-	const float getHighestCellTemperature() const;
+	const int32_t getHighestCellTemperatureMillicelsius() const;
 	const uint8_t getHighestCellTemperatureNumber() const;
 
 	const bool hasCommunicationError() const;
@@ -63,38 +76,43 @@ public:
 	const bool isMinTemperatureAlarmActive() const;
 	const bool isMaxTemperatureAlarmActive() const;
 
-private:
-	uint8_t cellCount_;
-	float cellVoltageMin_;
-	float cellVoltageMax_;
-	float cellVoltageBalance_;
-
-	uint8_t packSoc_;
-	float packVoltage_;
-	float packCurrent_;
-	float packChargeCurrent_;
-	float packDischargeCurrent_;
-	float packCapacity_;
-	float packRemainingEnergy_;
+#ifdef SMART_BMS_CELL_DATA
+	const uint8_t getCellNumber() const;
+	const uint32_t getCellVoltageMillivolts() const;
+	const int32_t getCellTemperatureMillicelsius() const;
+#endif
 
-	float lowestCellVoltage_;
-	uint8_t lowestCellVoltageNumber_;
-	float highestCellVoltage_;
-	uint8_t highestCellVoltageNumber_;
-	float lowestCellTemperature_;
-	uint8_t lowestCellTemperatureNumber_;
-	float highestCellTemperature_;
-	uint8_t highestCellTemperatureNumber_;
+#ifndef SMART_BMS_FIXED_POINT
+	const float getCellVoltageMin() const;
+	const float getCellVoltageMax() const;
+	const float getCellVoltageBalance() const;
+	const float getPackVoltage() const;
+	const float getPackCurrent() const;
+	const float getPackChargeCurrent() const;
+	const float getPackDischargeCurrent() const;
+	const float getPackCapacity() const;
+	const float getPackRemainingEnergy() const;
+	const float getLowestCellVoltage() const;
+	const float getHighestCellVoltage() const;
+	const float getLowestCellTemperature() const;
+	const float getHighestCellTemperature() const;
+#ifdef SMART_BMS_CELL_DATA
+	const float getCellVoltage() const;
+	const float getCellTemperature() const;
+#endif
+#endif
 
-	bool communicationError_;
-	bool allowedToCharge_;
-	bool allowedToDischarge_;
-	bool minVoltageAlarmActive_;
-	bool maxVoltageAlarmActive_;
-	bool minTemperatureAlarmActive_;
-	bool maxTemperatureAlarmActive_;
+private:
+	uint32_t fieldMask_;
+	uint32_t changedMask_;
+	uint32_t timestamp_;
+	int32_t values_[SBMS_FIELD_COUNT];
 
-	friend class SmartBmsReader;
+	friend class SmartBmsFrameView;
+	friend class SmartBmsBatchDecoder;
+	friend class SmartBmsDeltaCodec;
+	friend class SmartBmsHistoryRecord;
+	friend class SmartBmsLog;
 };
 
 #endif
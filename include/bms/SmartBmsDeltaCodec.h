@@ -0,0 +1,68 @@
+/**
+ * @file SmartBmsDeltaCodec.h
+ * @author TheRealKasumi
+ * @brief Contains an encoder and decoder that serialize only the changed fields of the BMS data.
+ * @copyright Copyright (c) 2024 TheRealKasumi
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#ifndef SMART_BMS_DELTA_CODEC_H
+#define SMART_BMS_DELTA_CODEC_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "bms/SmartBmsData.h"
+#include "bms/SmartBmsError.h"
+#include "bms/SmartBmsField.h"
+
+/**
+ * @brief Calculate the size of all values of a delta record at compile time.
+ * Flags share a single byte, other fields use the width of the field table.
+ * @param index index of the first field
+ * @return size in bytes
+ */
+constexpr size_t smartBmsDeltaValueSize(const size_t index)
+{
+	return index == SBMS_FIELD_COUNT ? 1 : (SMART_BMS_FIELDS[index].encoding == SBMS_ENCODING_FLAG ? 0 : SMART_BMS_FIELDS[index].width) + smartBmsDeltaValueSize(index + 1);
+}
+
+/**
+ * @brief Count the flag fields at compile time.
+ * @param index index of the first field
+ * @return number of flags
+ */
+constexpr size_t smartBmsDeltaFlagCount(const size_t index)
+{
+	return index == SBMS_FIELD_COUNT ? 0 : (SMART_BMS_FIELDS[index].encoding == SBMS_ENCODING_FLAG) + smartBmsDeltaFlagCount(index + 1);
+}
+
+static_assert(smartBmsDeltaFlagCount(0) <= 8, "The flags of a delta record must fit into a single byte");
+
+// Maximum size of a delta record, a 5 byte varint for the mask plus all values
+#define SMART_BMS_DELTA_MAX_SIZE (5 + smartBmsDeltaValueSize(0))
+
+class SmartBmsDeltaCodec
+{
+public:
+	static const size_t encode(const SmartBmsData &smartBmsData, const uint32_t fieldMask, uint8_t *buffer, const size_t size);
+	static const SmartBmsError decode(const uint8_t *buffer, const size_t length, size_t *consumed, SmartBmsData *smartBmsData);
+	static const bool writeVarint(uint8_t *buffer, const size_t size, size_t *position, const uint32_t value);
+	static const SmartBmsError readVarint(const uint8_t *buffer, const size_t length, size_t *position, uint32_t *value);
+	static const uint32_t zigzagEncode(const int32_t value);
+	static const int32_t zigzagDecode(const uint32_t value);
+};
+
+#endif
@@ -26,7 +26,9 @@ enum SmartBmsError
 	SBMS_OK,
 	SBMS_ERR_NOT_ENOUGH_DATA,
 	SBMS_ERR_READ_STREAM,
-	SBMS_ERR_INVALID_CHECKSUM
+	SBMS_ERR_INVALID_CHECKSUM,
+	SBMS_ERR_INVALID_DATA,
+	SBMS_ERR_STORAGE
 };
 
 #endif
@@ -0,0 +1,263 @@
+/**
+ * @file SmartBmsField.h
+ * @author TheRealKasumi
+ * @brief Contains the layout of the fields in a frame of the 123SmartBMS.
+ * @copyright Copyright (c) 2024 TheRealKasumi
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#ifndef SMART_BMS_FIELD_H
+#define SMART_BMS_FIELD_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#define SMART_BMS_FRAME_SIZE 58
+#define SMART_BMS_STATUS_OFFSET 30
+
+// The data of a single cell in bytes 24 to 29 is taken from other open source drivers and not confirmed by the manufacturer
+// Define SMART_BMS_CELL_DATA to decode it, all devices that share logs or captures must use the same setting
+
+#define SBMS_FIELD_MASK(field) (1UL << (field))
+#define SBMS_FIELD_MASK_ALL ((1UL << SBMS_FIELD_COUNT) - 1)
+
+enum SmartBmsField
+{
+	SBMS_FIELD_CELL_COUNT,
+	SBMS_FIELD_CELL_VOLTAGE_MIN,
+	SBMS_FIELD_CELL_VOLTAGE_MAX,
+	SBMS_FIELD_CELL_VOLTAGE_BALANCE,
+	SBMS_FIELD_PACK_SOC,
+	SBMS_FIELD_PACK_VOLTAGE,
+	SBMS_FIELD_PACK_CURRENT,
+	SBMS_FIELD_PACK_CHARGE_CURRENT,
+	SBMS_FIELD_PACK_DISCHARGE_CURRENT,
+	SBMS_FIELD_PACK_CAPACITY,
+	SBMS_FIELD_PACK_REMAINING_ENERGY,
+	SBMS_FIELD_LOWEST_CELL_VOLTAGE,
+	SBMS_FIELD_LOWEST_CELL_VOLTAGE_NUMBER,
+	SBMS_FIELD_HIGHEST_CELL_VOLTAGE,
+	SBMS_FIELD_HIGHEST_CELL_VOLTAGE_NUMBER,
+	SBMS_FIELD_LOWEST_CELL_TEMPERATURE,
+	SBMS_FIELD_LOWEST_CELL_TEMPERATURE_NUMBER,
+	SBMS_FIELD_HIGHEST_CELL_TEMPERATURE,
+	SBMS_FIELD_HIGHEST_CELL_TEMPERATURE_NUMBER,
+	SBMS_FIELD_COMMUNICATION_ERROR,
+	SBMS_FIELD_ALLOWED_TO_CHARGE,
+	SBMS_FIELD_ALLOWED_TO_DISCHARGE,
+	SBMS_FIELD_MIN_VOLTAGE_ALARM,
+	SBMS_FIELD_MAX_VOLTAGE_ALARM,
+	SBMS_FIELD_MIN_TEMPERATURE_ALARM,
+	SBMS_FIELD_MAX_TEMPERATURE_ALARM,
+#ifdef SMART_BMS_CELL_DATA
+	SBMS_FIELD_CELL_NUMBER,
+	SBMS_FIELD_CELL_VOLTAGE,
+	SBMS_FIELD_CELL_TEMPERATURE,
+#endif
+	SBMS_FIELD_COUNT
+};
+
+enum SmartBmsFieldEncoding
+{
+	SBMS_ENCODING_UNSIGNED,
+	SBMS_ENCODING_SIGNED,
+	SBMS_ENCODING_FLAG
+};
+
+/**
+ * @brief Describes where a field is located in the frame and how it is converted.
+ * Unsigned fields are big endian values of 1 to 3 bytes.
+ * Signed fields start with a sign byte, '-' for negative and 'X' for no value, followed by a 2 byte value.
+ * Flag fields are a single bit of a byte.
+ * The fixed point value is raw * fixedScale + fixedOffset, the float value is raw * scale + offsetTerm.
+ * The float conversion only exists when SMART_BMS_FIXED_POINT is not defined.
+ */
+struct SmartBmsFieldDescriptor
+{
+	SmartBmsField field;
+	const char *name;
+	uint8_t offset;
+	uint8_t width;
+	SmartBmsFieldEncoding encoding;
+	uint8_t bitMask;
+	int32_t fixedScale;
+	int32_t fixedOffset;
+	const char *fixedUnit;
+#ifndef SMART_BMS_FIXED_POINT
+	float scale;
+	float offsetTerm;
+	const char *unit;
+#endif
+};
+
+// The float conversion of a field, which is left out of the table in a fixed point build
+#ifndef SMART_BMS_FIXED_POINT
+#define SBMS_FLOAT_CONVERSION(scale, offsetTerm, unit) , scale, offsetTerm, unit
+#else
+#define SBMS_FLOAT_CONVERSION(scale, offsetTerm, unit)
+#endif
+
+constexpr SmartBmsFieldDescriptor SMART_BMS_FIELDS[SBMS_FIELD_COUNT] = {
+	{SBMS_FIELD_CELL_COUNT, "cellCount", 25, 1, SBMS_ENCODING_UNSIGNED, 0, 1, 0, "" SBMS_FLOAT_CONVERSION(1.0f, 0.0f, "")},
+	{SBMS_FIELD_CELL_VOLTAGE_MIN, "cellVoltageMin", 51, 2, SBMS_ENCODING_UNSIGNED, 0, 5, 0, "mV" SBMS_FLOAT_CONVERSION(0.005f, 0.0f, "V")},
+	{SBMS_FIELD_CELL_VOLTAGE_MAX, "cellVoltageMax", 53, 2, SBMS_ENCODING_UNSIGNED, 0, 5, 0, "mV" SBMS_FLOAT_CONVERSION(0.005f, 0.0f, "V")},
+	{SBMS_FIELD_CELL_VOLTAGE_BALANCE, "cellVoltageBalance", 55, 2, SBMS_ENCODING_UNSIGNED, 0, 5, 0, "mV" SBMS_FLOAT_CONVERSION(0.005f, 0.0f, "V")},
+	{SBMS_FIELD_PACK_SOC, "packSoc", 40, 1, SBMS_ENCODING_UNSIGNED, 0, 1, 0, "%" SBMS_FLOAT_CONVERSION(1.0f, 0.0f, "%")},
+	{SBMS_FIELD_PACK_VOLTAGE, "packVoltage", 0, 3, SBMS_ENCODING_UNSIGNED, 0, 5, 0, "mV" SBMS_FLOAT_CONVERSION(0.005f, 0.0f, "V")},
+	{SBMS_FIELD_PACK_CURRENT, "packCurrent", 9, 3, SBMS_ENCODING_SIGNED, 0, 125, 0, "mA" SBMS_FLOAT_CONVERSION(0.125f, 0.0f, "A")},
+	{SBMS_FIELD_PACK_CHARGE_CURRENT, "packChargeCurrent", 3, 3, SBMS_ENCODING_SIGNED, 0, 125, 0, "mA" SBMS_FLOAT_CONVERSION(0.125f, 0.0f, "A")},
+	{SBMS_FIELD_PACK_DISCHARGE_CURRENT, "packDischargeCurrent", 6, 3, SBMS_ENCODING_SIGNED, 0, 125, 0, "mA" SBMS_FLOAT_CONVERSION(0.125f, 0.0f, "A")},
+	{SBMS_FIELD_PACK_CAPACITY, "packCapacity", 49, 2, SBMS_ENCODING_UNSIGNED, 0, 100, 0, "Wh" SBMS_FLOAT_CONVERSION(0.1f, 0.0f, "kWh")},
+	{SBMS_FIELD_PACK_REMAINING_ENERGY, "packRemainingEnergy", 34, 3, SBMS_ENCODING_UNSIGNED, 0, 1, 0, "Wh" SBMS_FLOAT_CONVERSION(0.001f, 0.0f, "kWh")},
+	{SBMS_FIELD_LOWEST_CELL_VOLTAGE, "lowestCellVoltage", 12, 2, SBMS_ENCODING_UNSIGNED, 0, 5, 0, "mV" SBMS_FLOAT_CONVERSION(0.005f, 0.0f, "V")},
+	{SBMS_FIELD_LOWEST_CELL_VOLTAGE_NUMBER, "lowestCellVoltageNumber", 14, 1, SBMS_ENCODING_UNSIGNED, 0, 1, 0, "" SBMS_FLOAT_CONVERSION(1.0f, 0.0f, "")},
+	{SBMS_FIELD_HIGHEST_CELL_VOLTAGE, "highestCellVoltage", 15, 2, SBMS_ENCODING_UNSIGNED, 0, 5, 0, "mV" SBMS_FLOAT_CONVERSION(0.005f, 0.0f, "V")},
+	{SBMS_FIELD_HIGHEST_CELL_VOLTAGE_NUMBER, "highestCellVoltageNumber", 17, 1, SBMS_ENCODING_UNSIGNED, 0, 1, 0, "" SBMS_FLOAT_CONVERSION(1.0f, 0.0f, "")},
+	{SBMS_FIELD_LOWEST_CELL_TEMPERATURE, "lowestCellTemperature", 18, 2, SBMS_ENCODING_UNSIGNED, 0, 857, -232000, "m°C" SBMS_FLOAT_CONVERSION(0.857f, -232.0f, "°C")},
+	{SBMS_FIELD_LOWEST_CELL_TEMPERATURE_NUMBER, "lowestCellTemperatureNumber", 20, 1, SBMS_ENCODING_UNSIGNED, 0, 1, 0, "" SBMS_FLOAT_CONVERSION(1.0f, 0.0f, "")},
+	{SBMS_FIELD_HIGHEST_CELL_TEMPERATURE, "highestCellTemperature", 21, 2, SBMS_ENCODING_UNSIGNED, 0, 857, -232000, "m°C" SBMS_FLOAT_CONVERSION(0.857f, -232.0f, "°C")},
+	{SBMS_FIELD_HIGHEST_CELL_TEMPERATURE_NUMBER, "highestCellTemperatureNumber", 23, 1, SBMS_ENCODING_UNSIGNED, 0, 1, 0, "" SBMS_FLOAT_CONVERSION(1.0f, 0.0f, "")},
+	{SBMS_FIELD_COMMUNICATION_ERROR, "communicationError", 30, 1, SBMS_ENCODING_FLAG, 0b00000100, 1, 0, "" SBMS_FLOAT_CONVERSION(1.0f, 0.0f, "")},
+	{SBMS_FIELD_ALLOWED_TO_CHARGE, "allowedToCharge", 30, 1, SBMS_ENCODING_FLAG, 0b00000001, 1, 0, "" SBMS_FLOAT_CONVERSION(1.0f, 0.0f, "")},
+	{SBMS_FIELD_ALLOWED_TO_DISCHARGE, "allowedToDischarge", 30, 1, SBMS_ENCODING_FLAG, 0b00000010, 1, 0, "" SBMS_FLOAT_CONVERSION(1.0f, 0.0f, "")},
+	{SBMS_FIELD_MIN_VOLTAGE_ALARM, "minVoltageAlarm", 30, 1, SBMS_ENCODING_FLAG, 0b00001000, 1, 0, "" SBMS_FLOAT_CONVERSION(1.0f, 0.0f, "")},
+	{SBMS_FIELD_MAX_VOLTAGE_ALARM, "maxVoltageAlarm", 30, 1, SBMS_ENCODING_FLAG, 0b00010000, 1, 0, "" SBMS_FLOAT_CONVERSION(1.0f, 0.0f, "")},
+	{SBMS_FIELD_MIN_TEMPERATURE_ALARM, "minTemperatureAlarm", 30, 1, SBMS_ENCODING_FLAG, 0b00100000, 1, 0, "" SBMS_FLOAT_CONVERSION(1.0f, 0.0f, "")},
+	{SBMS_FIELD_MAX_TEMPERATURE_ALARM, "maxTemperatureAlarm", 30, 1, SBMS_ENCODING_FLAG, 0b01000000, 1, 0, "" SBMS_FLOAT_CONVERSION(1.0f, 0.0f, "")},
+#ifdef SMART_BMS_CELL_DATA
+	// Data of a single cell, which is added by a different between module in every cycle
+	{SBMS_FIELD_CELL_NUMBER, "cellNumber", 24, 1, SBMS_ENCODING_UNSIGNED, 0, 1, 0, "" SBMS_FLOAT_CONVERSION(1.0f, 0.0f, "")},
+	{SBMS_FIELD_CELL_VOLTAGE, "cellVoltage", 26, 2, SBMS_ENCODING_UNSIGNED, 0, 5, 0, "mV" SBMS_FLOAT_CONVERSION(0.005f, 0.0f, "V")},
+	{SBMS_FIELD_CELL_TEMPERATURE, "cellTemperature", 28, 2, SBMS_ENCODING_UNSIGNED, 0, 857, -232000, "m°C" SBMS_FLOAT_CONVERSION(0.857f, -232.0f, "°C")},
+#endif
+};
+
+/**
+ * @brief Check the field table at compile time.
+ * Every entry must be at the index of its field and must be located in front of the checksum byte.
+ * @param index index of the first entry to check
+ * @return true when the table is valid
+ */
+constexpr bool smartBmsFieldsValid(const size_t index)
+{
+	return index == SBMS_FIELD_COUNT ||
+		   (SMART_BMS_FIELDS[index].field == static_cast<SmartBmsField>(index) &&
+			SMART_BMS_FIELDS[index].width >= 1 && SMART_BMS_FIELDS[index].width <= 3 &&
+			SMART_BMS_FIELDS[index].offset + SMART_BMS_FIELDS[index].width < SMART_BMS_FRAME_SIZE &&
+			(SMART_BMS_FIELDS[index].encoding != SBMS_ENCODING_SIGNED || SMART_BMS_FIELDS[index].width == 3) &&
+			(SMART_BMS_FIELDS[index].encoding != SBMS_ENCODING_FLAG || SMART_BMS_FIELDS[index].bitMask != 0) &&
+			smartBmsFieldsValid(index + 1));
+}
+
+static_assert(smartBmsFieldsValid(0), "The field table of the 123SmartBMS is invalid");
+static_assert(SBMS_FIELD_COUNT <= 32, "The field mask must fit into 32 bits");
+
+/**
+ * @brief Get the mask of the fields that are measurements, these are the fields with a unit.
+ * The cell count, the cell numbers and the flags have no unit, their min, max or mean has no meaning.
+ * @param index index of the first entry to check
+ * @return bit mask with SBMS_FIELD_MASK(field) set for every measurement
+ */
+constexpr uint32_t smartBmsMeasurementMask(const size_t index)
+{
+	return index == SBMS_FIELD_COUNT ? 0 : ((SMART_BMS_FIELDS[index].fixedUnit[0] != '\0' ? SBMS_FIELD_MASK(index) : 0) | smartBmsMeasurementMask(index + 1));
+}
+
+/**
+ * @brief Count the fields that are measurements.
+ * @param index index of the first entry to check
+ * @return number of measurements
+ */
+constexpr size_t smartBmsMeasurementCount(const size_t index)
+{
+	return index == SBMS_FIELD_COUNT ? 0 : (SMART_BMS_FIELDS[index].fixedUnit[0] != '\0' ? 1 : 0) + smartBmsMeasurementCount(index + 1);
+}
+
+#define SBMS_FIELD_MASK_MEASUREMENTS smartBmsMeasurementMask(0)
+#define SBMS_MEASUREMENT_COUNT smartBmsMeasurementCount(0)
+
+/**
+ * @brief Decodes and converts fields based on the field table.
+ * With a constant field, the compiler resolves the table entry at compile time.
+ */
+class SmartBmsFields
+{
+public:
+	static const SmartBmsFieldDescriptor &getDescriptor(const SmartBmsField field)
+	{
+		return SMART_BMS_FIELDS[field];
+	}
+
+	static const int32_t decodeRawValue(const uint8_t frame[SMART_BMS_FRAME_SIZE], const SmartBmsField field)
+	{
+		const SmartBmsFieldDescriptor &descriptor = SMART_BMS_FIELDS[field];
+		const uint8_t *buffer = &frame[descriptor.offset];
+		if (descriptor.encoding == SBMS_ENCODING_FLAG)
+		{
+			return (buffer[0] & descriptor.bitMask) != 0;
+		}
+		else if (descriptor.encoding == SBMS_ENCODING_SIGNED)
+		{
+			if (buffer[0] == 'X')
+			{
+				return 0;
+			}
+			const int32_t rawValue = (static_cast<int32_t>(buffer[1]) << 8) | buffer[2];
+			return buffer[0] == '-' ? -rawValue : rawValue;
+		}
+
+		int32_t rawValue = 0;
+		for (uint8_t i = 0; i < descriptor.width; i++)
+		{
+			rawValue = (rawValue << 8) | buffer[i];
+		}
+		return rawValue;
+	}
+
+	static const uint32_t getChangedMask(const uint8_t frame[SMART_BMS_FRAME_SIZE], const uint8_t previousFrame[SMART_BMS_FRAME_SIZE], const uint32_t fieldMask)
+	{
+		// Most consecutive frames are identical, which is checked first
+		if (memcmp(frame, previousFrame, SMART_BMS_FRAME_SIZE - 1) == 0)
+		{
+			return 0;
+		}
+
+		uint32_t changedMask = 0;
+		for (size_t i = 0; i < SBMS_FIELD_COUNT; i++)
+		{
+			const SmartBmsField field = static_cast<SmartBmsField>(i);
+			if ((fieldMask & SBMS_FIELD_MASK(i)) && decodeRawValue(frame, field) != decodeRawValue(previousFrame, field))
+			{
+				changedMask |= SBMS_FIELD_MASK(i);
+			}
+		}
+		return changedMask;
+	}
+
+	static const int32_t toFixedValue(const SmartBmsField field, const int32_t rawValue)
+	{
+		return rawValue * SMART_BMS_FIELDS[field].fixedScale + SMART_BMS_FIELDS[field].fixedOffset;
+	}
+
+#ifndef SMART_BMS_FIXED_POINT
+	static const float toFloatValue(const SmartBmsField field, const int32_t rawValue)
+	{
+		return rawValue * SMART_BMS_FIELDS[field].scale + SMART_BMS_FIELDS[field].offsetTerm;
+	}
+#endif
+};
+
+#endif
@@ -0,0 +1,126 @@
+/**
+ * @file SmartBmsFrameView.h
+ * @author TheRealKasumi
+ * @brief Contains a class that wraps a raw frame of the 123SmartBMS and decodes fields on access.
+ * @copyright Copyright (c) 2024 TheRealKasumi
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#ifndef SMART_BMS_FRAME_VIEW_H
+#define SMART_BMS_FRAME_VIEW_H
+
+#include <stdint.h>
+
+#include "bms/SmartBmsData.h"
+#include "bms/SmartBmsField.h"
+
+// Plausible ranges of a frame, a window of unknown alignment that only matches the checksum by chance rarely passes all of them
+#ifndef SMART_BMS_PLAUSIBLE_MAX_CELL_COUNT
+#define SMART_BMS_PLAUSIBLE_MAX_CELL_COUNT 128
+#endif
+#ifndef SMART_BMS_PLAUSIBLE_MIN_CELL_VOLTAGE_MV
+#define SMART_BMS_PLAUSIBLE_MIN_CELL_VOLTAGE_MV 1000
+#endif
+#ifndef SMART_BMS_PLAUSIBLE_MAX_CELL_VOLTAGE_MV
+#define SMART_BMS_PLAUSIBLE_MAX_CELL_VOLTAGE_MV 5000
+#endif
+
+class SmartBmsData;
+
+class SmartBmsFrameView
+{
+public:
+	SmartBmsFrameView();
+	SmartBmsFrameView(const uint8_t frame[SMART_BMS_FRAME_SIZE], const uint32_t timestamp = 0);
+	~SmartBmsFrameView();
+
+	const uint8_t *getFrame() const;
+	const uint32_t getTimestamp() const;
+	void decode(SmartBmsData *smartBmsData, const uint32_t fieldMask = SBMS_FIELD_MASK_ALL) const;
+	void decode(SmartBmsData *smartBmsData, const uint32_t fieldMask, const SmartBmsFrameView &previousFrame) const;
+	const uint32_t getChangedMask(const SmartBmsFrameView &previousFrame, const uint32_t fieldMask = SBMS_FIELD_MASK_ALL) const;
+	const bool isWellFormed() const;
+	const bool isPlausible() const;
+
+	static const bool isWellFormed(const uint8_t frame[SMART_BMS_FRAME_SIZE]);
+
+	const int32_t getRawValue(const SmartBmsField field) const;
+	const int32_t getFixedValue(const SmartBmsField field) const;
+#ifndef SMART_BMS_FIXED_POINT
+	const float getValue(const SmartBmsField field) const;
+#endif
+
+	const uint8_t getCellCount() const;
+	const uint32_t getCellVoltageMinMillivolts() const;
+	const uint32_t getCellVoltageMaxMillivolts() const;
+	const uint32_t getCellVoltageBalanceMillivolts() const;
+
+	const uint8_t getPackSoc() const;
+	const uint32_t getPackVoltageMillivolts() const;
+	const int32_t getPackCurrentMilliamps() const;
+	const int32_t getPackChargeCurrentMilliamps() const;
+	const int32_t getPackDischargeCurrentMilliamps() const;
+	const uint32_t getPackCapacityWattHours() const;
+	const uint32_t getPackRemainingEnergyWattHours() const;
+
+	const uint32_t getLowestCellVoltageMillivolts() const;
+	const uint8_t getLowestCellVoltageNumber() const;
+	const uint32_t getHighestCellVoltageMillivolts() const;
+	const uint8_t getHighestCellVoltageNumber() const;
+	const int32_t getLowestCellTemperatureMillicelsius() const;
+	const uint8_t getLowestCellTemperatureNumber() const;
+	const int32_t getHighestCellTemperatureMillicelsius() const;
+	const uint8_t getHighestCellTemperatureNumber() const;
+
+	const bool hasCommunicationError() const;
+	const bool isAllowedToCharge() const;
+	const bool isAllowedToDischarge() const;
+	const bool isMinVoltageAlarmActive() const;
+	const bool isMaxVoltageAlarmActive() const;
+	const bool isMinTemperatureAlarmActive() const;
+	const bool isMaxTemperatureAlarmActive() const;
+
+#ifdef SMART_BMS_CELL_DATA
+	const uint8_t getCellNumber() const;
+	const uint32_t getCellVoltageMillivolts() const;
+	const int32_t getCellTemperatureMillicelsius() const;
+#endif
+
+#ifndef SMART_BMS_FIXED_POINT
+	const float getCellVoltageMin() const;
+	const float getCellVoltageMax() const;
+	const float getCellVoltageBalance() const;
+	const float getPackVoltage() const;
+	const float getPackCurrent() const;
+	const float getPackChargeCurrent() const;
+	const float getPackDischargeCurrent() const;
+	const float getPackCapacity() const;
+	const float getPackRemainingEnergy() const;
+	const float getLowestCellVoltage() const;
+	const float getHighestCellVoltage() const;
+	const float getLowestCellTemperature() const;
+	const float getHighestCellTemperature() const;
+#ifdef SMART_BMS_CELL_DATA
+	const float getCellVoltage() const;
+	const float getCellTemperature() const;
+#endif
+#endif
+
+private:
+	uint8_t frame_[SMART_BMS_FRAME_SIZE];
+	uint32_t timestamp_;
+};
+
+#endif
@@ -0,0 +1,96 @@
+/**
+ * @file SmartBmsHistory.h
+ * @author TheRealKasumi
+ * @brief Contains a compact history record and a ring of records over caller provided memory, like PSRAM.
+ * @copyright Copyright (c) 2024 TheRealKasumi
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#ifndef SMART_BMS_HISTORY_H
+#define SMART_BMS_HISTORY_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "bms/SmartBmsData.h"
+#include "bms/SmartBmsField.h"
+
+class SmartBmsHistoryRecord
+{
+public:
+	SmartBmsHistoryRecord();
+	~SmartBmsHistoryRecord();
+
+	void store(const SmartBmsData &smartBmsData, const uint32_t timestamp);
+	void load(SmartBmsData *smartBmsData) const;
+
+	const uint32_t getTimestamp() const;
+	const uint8_t getStatusFlags() const;
+
+	static const uint32_t getFieldMask();
+
+private:
+	uint32_t timestamp_;
+	uint32_t packVoltageSoc_;
+	uint32_t remainingEnergyStatus_;
+	int16_t packCurrent_;
+	int16_t packChargeCurrent_;
+	int16_t packDischargeCurrent_;
+	uint16_t lowestCellVoltage_;
+	uint16_t highestCellVoltage_;
+	uint16_t lowestCellTemperature_;
+	uint16_t highestCellTemperature_;
+	uint8_t lowestCellVoltageNumber_;
+	uint8_t highestCellVoltageNumber_;
+	uint8_t lowestCellTemperatureNumber_;
+	uint8_t highestCellTemperatureNumber_;
+	uint8_t cellCount_;
+	uint8_t reserved_;
+
+	static const int32_t getValue_(const SmartBmsData &smartBmsData, const SmartBmsField field);
+	static const int16_t saturate_(const int32_t value);
+};
+
+static_assert(sizeof(SmartBmsHistoryRecord) == 32, "A history record must have 32 bytes");
+
+typedef bool (*SmartBmsHistoryCallback)(const SmartBmsHistoryRecord *record, void *context);
+
+class SmartBmsHistory
+{
+public:
+	SmartBmsHistory(SmartBmsHistoryRecord *records, const size_t capacity);
+	~SmartBmsHistory();
+
+	void add(const SmartBmsData &smartBmsData, const uint32_t timestamp);
+	void clear();
+
+	const size_t size() const;
+	const size_t capacity() const;
+	const SmartBmsHistoryRecord *get(const size_t index) const;
+
+	const size_t lowerBound(const uint32_t timestamp) const;
+	const size_t forEach(const uint32_t from, const uint32_t to, const uint32_t interval, SmartBmsHistoryCallback callback, void *context) const;
+
+private:
+	SmartBmsHistoryRecord *records_;
+	size_t capacity_;
+	size_t start_;
+	size_t size_;
+
+	const uint32_t getOffset_(const uint32_t timestamp) const;
+	const size_t lowerBound_(const uint32_t offset, const size_t first) const;
+};
+
+#endif
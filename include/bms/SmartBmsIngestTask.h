@@ -0,0 +1,87 @@
+/**
+ * @file SmartBmsIngestTask.h
+ * @author TheRealKasumi
+ * @brief Contains a class that reads BMS data in a dedicated FreeRTOS task.
+ * @copyright Copyright (c) 2024 TheRealKasumi
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#ifndef SMART_BMS_INGEST_TASK_H
+#define SMART_BMS_INGEST_TASK_H
+
+#if defined(ESP32)
+
+#include <stdint.h>
+#include <atomic>
+#include <Stream.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+#include "bms/SmartBmsData.h"
+#include "bms/SmartBmsFrameView.h"
+#include "bms/SmartBmsPublisher.h"
+#include "bms/SmartBmsQueue.h"
+#include "bms/SmartBmsReader.h"
+#include "bms/SmartBmsStatistics.h"
+
+#ifndef SMART_BMS_QUEUE_CAPACITY
+#define SMART_BMS_QUEUE_CAPACITY 16
+#endif
+
+#ifndef SMART_BMS_INGEST_POLL_INTERVAL_MS
+#define SMART_BMS_INGEST_POLL_INTERVAL_MS 5
+#endif
+
+typedef SmartBmsQueue<SmartBmsFrameView, SMART_BMS_QUEUE_CAPACITY> SmartBmsFrameQueue;
+
+class SmartBmsIngestTask
+{
+public:
+	SmartBmsIngestTask(Stream *inputStream, SmartBmsFrameQueue *queue);
+	~SmartBmsIngestTask();
+
+	const bool begin(const BaseType_t core, const UBaseType_t priority = 5, const uint32_t stackSize = 4096);
+	void end();
+	void setPublisher(SmartBmsPublisher *publisher);
+	const bool subscribe(const SmartBmsField field, const SmartBmsFlagEdge edge, SmartBmsFlagCallback callback, void *context);
+#ifdef SMART_BMS_STATISTICS
+	void setStatistics(SmartBmsStatistics *statistics);
+#endif
+
+	void reportRxOverflow();
+	const uint32_t getRxOverflowCount() const;
+	const uint32_t getSkippedByteCount() const;
+
+private:
+	Stream *inputStream_;
+	SmartBmsFrameQueue *queue_;
+	SmartBmsPublisher *publisher_;
+	SmartBmsReader smartBmsReader_;
+	TaskHandle_t taskHandle_;
+	TaskHandle_t stoppingTask_;
+	std::atomic<bool> stopRequested_;
+#ifdef SMART_BMS_STATISTICS
+	SmartBmsStatistics *statistics_;
+#endif
+	std::atomic<uint32_t> rxOverflowCount_;
+	std::atomic<uint32_t> skippedByteCount_;
+
+	static void run_(void *parameter);
+	static void onFrame_(const SmartBmsFrameView *frameView, void *context);
+};
+
+#endif
+
+#endif
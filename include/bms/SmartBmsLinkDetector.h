@@ -0,0 +1,78 @@
+/**
+ * @file SmartBmsLinkDetector.h
+ * @author TheRealKasumi
+ * @brief Contains a detector that finds the polarity and the frame alignment of the BMS link.
+ * @copyright Copyright (c) 2024 TheRealKasumi
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#ifndef SMART_BMS_LINK_DETECTOR_H
+#define SMART_BMS_LINK_DETECTOR_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "bms/SmartBmsField.h"
+#include "bms/SmartBmsFrameView.h"
+
+// Number of consecutive frames at the same alignment and polarity that lock the link
+#ifndef SMART_BMS_LINK_LOCK_FRAME_COUNT
+#define SMART_BMS_LINK_LOCK_FRAME_COUNT 2
+#endif
+
+enum SmartBmsLinkState
+{
+	SBMS_LINK_SEARCHING,
+	SBMS_LINK_LOCKED
+};
+
+enum SmartBmsLinkPolarity
+{
+	SBMS_LINK_NORMAL,
+	SBMS_LINK_INVERTED,
+	SBMS_LINK_POLARITY_COUNT
+};
+
+class SmartBmsLinkDetector
+{
+public:
+	SmartBmsLinkDetector();
+	~SmartBmsLinkDetector();
+
+	const SmartBmsLinkState feed(const uint8_t *data, const size_t length, size_t *consumed = nullptr);
+	void reset();
+
+	const SmartBmsLinkState getState() const;
+	const SmartBmsLinkPolarity getPolarity() const;
+	const uint8_t getAlignment() const;
+	const uint32_t getSampledByteCount() const;
+	const uint32_t getRejectedFrameCount() const;
+	const SmartBmsFrameView &getFrame() const;
+
+private:
+	SmartBmsLinkState state_;
+	SmartBmsLinkPolarity polarity_;
+	uint8_t alignment_;
+	uint8_t window_[SMART_BMS_FRAME_SIZE];
+	uint8_t windowSum_;
+	uint32_t sampledByteCount_;
+	uint32_t rejectedFrameCount_;
+	uint8_t runLengths_[SBMS_LINK_POLARITY_COUNT][SMART_BMS_FRAME_SIZE];
+	SmartBmsFrameView frameView_;
+
+	const bool checkWindow_(const SmartBmsLinkPolarity polarity, const uint8_t phase);
+};
+
+#endif
@@ -0,0 +1,99 @@
+/**
+ * @file SmartBmsLog.h
+ * @author TheRealKasumi
+ * @brief Contains an append-only log of BMS data with delta compressed and checksummed blocks.
+ * @copyright Copyright (c) 2024 TheRealKasumi
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#ifndef SMART_BMS_LOG_H
+#define SMART_BMS_LOG_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "bms/SmartBmsData.h"
+#include "bms/SmartBmsError.h"
+#include "bms/SmartBmsField.h"
+#include "bms/SmartBmsLogStorage.h"
+
+// Size of a block including header and checksum, every block is written with a single append
+#ifndef SMART_BMS_LOG_BLOCK_SIZE
+#define SMART_BMS_LOG_BLOCK_SIZE 1024
+#endif
+
+// Maximum size of each of the two storages of the log, the log keeps at least this much of the most recent data
+#ifndef SMART_BMS_LOG_MAX_STORAGE_SIZE
+#define SMART_BMS_LOG_MAX_STORAGE_SIZE 65536
+#endif
+
+#define SMART_BMS_LOG_BLOCK_MAGIC 0x4C53
+#define SMART_BMS_LOG_HEADER_SIZE 16
+#define SMART_BMS_LOG_CHECKSUM_SIZE 4
+
+// Largest record, the timestamp and mask as varint and a zigzag varint per field
+#define SMART_BMS_LOG_MAX_RECORD_SIZE (5 + 5 + 5 * SBMS_FIELD_COUNT)
+
+static_assert(SMART_BMS_LOG_BLOCK_SIZE >= SMART_BMS_LOG_HEADER_SIZE + SMART_BMS_LOG_MAX_RECORD_SIZE + SMART_BMS_LOG_CHECKSUM_SIZE, "A log block must hold at least one record");
+static_assert(SMART_BMS_LOG_BLOCK_SIZE <= UINT16_MAX, "The payload length of a log block must fit into 16 bits");
+static_assert(SMART_BMS_LOG_MAX_STORAGE_SIZE >= SMART_BMS_LOG_BLOCK_SIZE, "A log storage must hold at least one block");
+
+typedef bool (*SmartBmsLogCallback)(const SmartBmsData *smartBmsData, const uint32_t timestamp, void *context);
+
+class SmartBmsLog
+{
+public:
+	SmartBmsLog(SmartBmsLogStorage *firstStorage, SmartBmsLogStorage *secondStorage, const size_t maxStorageSize = SMART_BMS_LOG_MAX_STORAGE_SIZE);
+	~SmartBmsLog();
+
+	const SmartBmsError begin();
+	const SmartBmsError append(const SmartBmsData &smartBmsData, const uint32_t timestamp);
+	const SmartBmsError flush();
+	const SmartBmsError forEach(SmartBmsLogCallback callback, void *context);
+	const SmartBmsError forEach(const uint32_t from, SmartBmsLogCallback callback, void *context);
+
+	const uint32_t getBlockCount() const;
+	const uint32_t getRecordCount() const;
+	const size_t getPendingRecordCount() const;
+	const size_t getTruncatedByteCount() const;
+
+	static const uint32_t calculateChecksum(const uint8_t *buffer, const size_t length);
+
+private:
+	SmartBmsLogStorage *storages_[2];
+	size_t maxStorageSize_;
+	size_t activeStorage_;
+	uint16_t generation_;
+	uint8_t block_[SMART_BMS_LOG_BLOCK_SIZE];
+	uint8_t readBuffer_[SMART_BMS_LOG_BLOCK_SIZE];
+	size_t payloadLength_;
+	uint16_t pendingRecordCount_;
+	uint32_t firstTimestamp_;
+	uint32_t lastTimestamp_;
+	SmartBmsData previousData_;
+	uint32_t blockCounts_[2];
+	uint32_t recordCounts_[2];
+	size_t truncatedByteCount_;
+
+	const SmartBmsError check_(const size_t storageIndex, uint16_t *generation);
+	const SmartBmsError rotate_();
+	const SmartBmsError forEach_(const bool filter, const uint32_t from, SmartBmsLogCallback callback, void *context);
+	const SmartBmsError readBlock_(SmartBmsLogStorage *storage, const size_t offset, const size_t size, size_t *payloadLength);
+	const bool decodeBlock_(const uint8_t *block, const bool filter, const uint32_t from, SmartBmsLogCallback callback, void *context);
+	static void writeUint_(uint8_t *buffer, const uint32_t value, const size_t width);
+	static const uint32_t readUint_(const uint8_t *buffer, const size_t width);
+};
+
+#endif
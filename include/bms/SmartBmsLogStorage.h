@@ -0,0 +1,60 @@
+/**
+ * @file SmartBmsLogStorage.h
+ * @author TheRealKasumi
+ * @brief Contains the interface of the storage behind the BMS log and an implementation based on stdio files.
+ * @copyright Copyright (c) 2024 TheRealKasumi
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#ifndef SMART_BMS_LOG_STORAGE_H
+#define SMART_BMS_LOG_STORAGE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+class SmartBmsLogStorage
+{
+public:
+	virtual ~SmartBmsLogStorage() {}
+
+	virtual const size_t getSize() = 0;
+	virtual const bool read(const size_t offset, uint8_t *buffer, const size_t length) = 0;
+	virtual const bool append(const uint8_t *buffer, const size_t length) = 0;
+	virtual const bool truncate(const size_t size) = 0;
+	virtual const bool sync() = 0;
+};
+
+class SmartBmsFileLogStorage : public SmartBmsLogStorage
+{
+public:
+	SmartBmsFileLogStorage();
+	~SmartBmsFileLogStorage();
+
+	const bool open(const char *path);
+	void close();
+	const bool isOpen() const;
+
+	const size_t getSize() override;
+	const bool read(const size_t offset, uint8_t *buffer, const size_t length) override;
+	const bool append(const uint8_t *buffer, const size_t length) override;
+	const bool truncate(const size_t size) override;
+	const bool sync() override;
+
+private:
+	FILE *file_;
+};
+
+#endif
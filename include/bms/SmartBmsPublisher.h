@@ -0,0 +1,51 @@
+/**
+ * @file SmartBmsPublisher.h
+ * @author TheRealKasumi
+ * @brief Contains a class that publishes the latest BMS data to any number of readers without locking.
+ * @copyright Copyright (c) 2024 TheRealKasumi
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#ifndef SMART_BMS_PUBLISHER_H
+#define SMART_BMS_PUBLISHER_H
+
+#include <stdint.h>
+#include <atomic>
+
+#include "bms/SmartBmsData.h"
+
+// Number of attempts to copy the data before a reader gives up, a writer on the same core may need the reader to block first
+#ifndef SMART_BMS_PUBLISHER_MAX_RETRIES
+#define SMART_BMS_PUBLISHER_MAX_RETRIES 64
+#endif
+
+class SmartBmsPublisher
+{
+public:
+	SmartBmsPublisher();
+	~SmartBmsPublisher();
+
+	void publish(const SmartBmsData &smartBmsData);
+	const bool getSnapshot(SmartBmsData *smartBmsData) const;
+	const uint32_t getVersion() const;
+
+private:
+	std::atomic<uint32_t> sequence_;
+	SmartBmsData smartBmsData_;
+
+	static void yield_();
+};
+
+#endif
@@ -0,0 +1,130 @@
+/**
+ * @file SmartBmsQueue.h
+ * @author TheRealKasumi
+ * @brief Contains a lock-free single-producer/single-consumer queue with a fixed capacity.
+ * @copyright Copyright (c) 2024 TheRealKasumi
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#ifndef SMART_BMS_QUEUE_H
+#define SMART_BMS_QUEUE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <atomic>
+
+/**
+ * @brief Lock-free queue for exactly one producer and one consumer, which may run on different cores.
+ * Items are stored in a fixed array, so the queue never allocates memory.
+ * Items are popped in the same order they were pushed. When the queue is full, new items are dropped and counted.
+ * @tparam T type of the items, must be copy assignable
+ * @tparam Capacity number of items, must be a power of two
+ */
+template <typename T, size_t Capacity>
+class SmartBmsQueue
+{
+	static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+public:
+	/**
+	 * @brief Create a new instance of SmartBmsQueue.
+	 */
+	SmartBmsQueue() : head_(0), tail_(0), droppedCount_(0)
+	{
+	}
+
+	/**
+	 * @brief Destroy the SmartBmsQueue instance.
+	 */
+	~SmartBmsQueue()
+	{
+	}
+
+	/**
+	 * @brief Push an item into the queue. Must only be called by the producer.
+	 * @param item item to push
+	 * @return true when the item was pushed
+	 * @return false when the queue is full and the item was dropped
+	 */
+	const bool push(const T &item)
+	{
+		const size_t tail = this->tail_.load(std::memory_order_relaxed);
+		if (tail - this->head_.load(std::memory_order_acquire) == Capacity)
+		{
+			this->droppedCount_.fetch_add(1, std::memory_order_relaxed);
+			return false;
+		}
+
+		// Publish the slot only after the item was written
+		this->items_[tail & (Capacity - 1)] = item;
+		this->tail_.store(tail + 1, std::memory_order_release);
+		return true;
+	}
+
+	/**
+	 * @brief Pop the oldest item from the queue. Must only be called by the consumer.
+	 * @param item reference that will receive the item
+	 * @return true when an item was popped
+	 * @return false when the queue is empty
+	 */
+	const bool pop(T *item)
+	{
+		const size_t head = this->head_.load(std::memory_order_relaxed);
+		if (head == this->tail_.load(std::memory_order_acquire))
+		{
+			return false;
+		}
+
+		// Release the slot only after the item was read
+		*item = this->items_[head & (Capacity - 1)];
+		this->head_.store(head + 1, std::memory_order_release);
+		return true;
+	}
+
+	/**
+	 * @brief Get the number of items in the queue. The value can already be outdated when it is returned.
+	 * @return number of items
+	 */
+	const size_t size() const
+	{
+		return this->tail_.load(std::memory_order_acquire) - this->head_.load(std::memory_order_acquire);
+	}
+
+	/**
+	 * @brief Get the capacity of the queue.
+	 * @return capacity
+	 */
+	const size_t capacity() const
+	{
+		return Capacity;
+	}
+
+	/**
+	 * @brief Get the number of items that were dropped because the queue was full.
+	 * @return number of dropped items
+	 */
+	const uint32_t getDroppedCount() const
+	{
+		return this->droppedCount_.load(std::memory_order_relaxed);
+	}
+
+private:
+	T items_[Capacity];
+	std::atomic<size_t> head_;
+	std::atomic<size_t> tail_;
+	std::atomic<uint32_t> droppedCount_;
+};
+
+#endif
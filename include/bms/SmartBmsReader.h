@@ -24,29 +24,111 @@
 #include <stdint.h>
 #include <Stream.h>
 
+#include "bms/SmartBmsClock.h"
 #include "bms/SmartBmsData.h"
 #include "bms/SmartBmsError.h"
+#include "bms/SmartBmsFrameView.h"
+#include "bms/SmartBmsStatistics.h"
+
+// Time to transfer one byte at 9600 baud with 10 bits per byte, used to date back the bytes of a chunk
+#ifndef SMART_BMS_BYTE_DURATION_US
+#define SMART_BMS_BYTE_DURATION_US 1042
+#endif
+
+// Number of flag subscriptions a reader can hold
+#ifndef SMART_BMS_MAX_SUBSCRIPTIONS
+#define SMART_BMS_MAX_SUBSCRIPTIONS 8
+#endif
 
 class SmartBmsData;
+class SmartBmsFrameView;
+
+enum SmartBmsFlagEdge
+{
+	SBMS_EDGE_RISING = 1,
+	SBMS_EDGE_FALLING = 2,
+	SBMS_EDGE_BOTH = 3
+};
+
+typedef void (*SmartBmsFrameCallback)(const SmartBmsFrameView *frameView, void *context);
+typedef void (*SmartBmsFlagCallback)(const SmartBmsField field, const bool value, const uint32_t timestamp, void *context);
+
+struct SmartBmsFlagSubscription
+{
+	SmartBmsField field;
+	uint8_t bitMask;
+	SmartBmsFlagEdge edge;
+	SmartBmsFlagCallback callback;
+	void *context;
+};
 
 class SmartBmsReader
 {
 public:
-	SmartBmsReader(Stream *inputStream);
+	SmartBmsReader(Stream *inputStream = nullptr);
 	~SmartBmsReader();
 
 	const SmartBmsError bmsDataReady() const;
-	const SmartBmsError decodeBmsData(SmartBmsData *smartBmsData) const;
+	const SmartBmsError decodeBmsData(SmartBmsData *smartBmsData);
+	const SmartBmsError decodeBmsData(SmartBmsFrameView *frameView);
+	const SmartBmsError feed(const uint8_t *data, const size_t length, size_t *consumed, SmartBmsData *smartBmsData);
+	const SmartBmsError feed(const uint8_t *data, const size_t length, size_t *consumed, SmartBmsFrameView *frameView);
+	const size_t feed(const uint8_t *data, const size_t length);
+	void decode(const SmartBmsFrameView &frameView, SmartBmsData *smartBmsData);
+	void setFrameCallback(SmartBmsFrameCallback frameCallback, void *context);
+	const bool subscribe(const SmartBmsField field, const SmartBmsFlagEdge edge, SmartBmsFlagCallback callback, void *context);
+	void unsubscribe(SmartBmsFlagCallback callback, void *context);
+	void setFieldMask(const uint32_t fieldMask);
+	void setClock(SmartBmsClock clock);
+	void setCyclePeriod(const uint32_t cyclePeriod);
+	const uint32_t getSkippedByteCount() const;
+	const uint32_t getCyclePeriod() const;
+	const int32_t getLastJitter() const;
+	const uint32_t getJitter() const;
+	const uint32_t getMissedCycleCount() const;
+#ifdef SMART_BMS_STATISTICS
+	void setStatistics(SmartBmsStatistics *statistics);
+#endif
+
+	static const uint8_t calculateChecksum(const uint8_t *buffer, const size_t length);
 
 private:
 	Stream *inputStream_;
+	SmartBmsFrameCallback frameCallback_;
+	void *frameCallbackContext_;
+	SmartBmsFlagSubscription subscriptions_[SMART_BMS_MAX_SUBSCRIPTIONS];
+	size_t subscriptionCount_;
+	uint8_t previousStatus_;
+	bool hasPreviousStatus_;
+	uint8_t lastStatus_;
+	bool hasLastStatus_;
+	uint32_t fieldMask_;
+	SmartBmsClock clock_;
+	uint8_t window_[SMART_BMS_FRAME_SIZE];
+	uint32_t windowTimestamps_[SMART_BMS_FRAME_SIZE];
+	size_t windowStart_;
+	size_t windowLength_;
+	uint8_t windowSum_;
+	uint32_t skippedByteCount_;
+	bool aligned_;
+	SmartBmsFrameView previousFrame_;
+	bool hasPreviousFrame_;
+	uint32_t lastFrameTimestamp_;
+	bool hasLastFrameTimestamp_;
+	uint32_t cyclePeriod_;
+	int32_t lastJitter_;
+	uint32_t jitter_;
+	uint32_t missedCycleCount_;
+#ifdef SMART_BMS_STATISTICS
+	SmartBmsStatistics *statistics_;
+	bool resynchronizing_;
+#endif
 
-	const float decodePackVoltage_(const uint8_t buffer[3]) const;
-	const float decodePackCurrent_(const uint8_t buffer[3]) const;
-	const float decodeCellVoltage_(const uint8_t buffer[2]) const;
-	const float decodeCellTemperature_(const uint8_t buffer[2]) const;
-	const uint16_t decodeTwoByteValue_(const uint8_t buffer[2]) const;
-	const uint32_t decodeThreeByteValue_(const uint8_t buffer[3]) const;
+	void dispatchFlags_(const uint8_t status, const uint32_t timestamp);
+	void trackCycle_(const uint32_t timestamp);
+	const bool pushByte_(const uint8_t value, const uint32_t timestamp);
+	void copyWindow_(uint8_t buffer[SMART_BMS_FRAME_SIZE]) const;
+	void clearWindow_();
 };
 
 #endif
@@ -0,0 +1,89 @@
+/**
+ * @file SmartBmsScheduler.h
+ * @author TheRealKasumi
+ * @brief Contains a scheduler that predicts when the next frame of the BMS starts.
+ * @copyright Copyright (c) 2024 TheRealKasumi
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#ifndef SMART_BMS_SCHEDULER_H
+#define SMART_BMS_SCHEDULER_H
+
+#include <stdint.h>
+
+#include "bms/SmartBmsClock.h"
+#include "bms/SmartBmsField.h"
+#include "bms/SmartBmsReader.h"
+
+// Range of cycle periods that are accepted while learning
+#ifndef SMART_BMS_SCHEDULER_MIN_PERIOD_US
+#define SMART_BMS_SCHEDULER_MIN_PERIOD_US 100000
+#endif
+#ifndef SMART_BMS_SCHEDULER_MAX_PERIOD_US
+#define SMART_BMS_SCHEDULER_MAX_PERIOD_US 10000000
+#endif
+
+// Time that is kept awake around a predicted frame, the smoothed jitter is added SMART_BMS_SCHEDULER_JITTER_FACTOR times
+#ifndef SMART_BMS_SCHEDULER_MARGIN_US
+#define SMART_BMS_SCHEDULER_MARGIN_US 20000
+#endif
+#ifndef SMART_BMS_SCHEDULER_JITTER_FACTOR
+#define SMART_BMS_SCHEDULER_JITTER_FACTOR 4
+#endif
+
+// A frame is only complete after its last byte, 58 bytes at 9600 baud
+#define SMART_BMS_SCHEDULER_FRAME_DURATION_US (SMART_BMS_FRAME_SIZE * SMART_BMS_BYTE_DURATION_US)
+
+// Regular intervals that are required before sleeping, and missed frames in a row that drop the lock
+#ifndef SMART_BMS_SCHEDULER_LOCK_INTERVAL_COUNT
+#define SMART_BMS_SCHEDULER_LOCK_INTERVAL_COUNT 2
+#endif
+#ifndef SMART_BMS_SCHEDULER_MAX_MISSED_CYCLES
+#define SMART_BMS_SCHEDULER_MAX_MISSED_CYCLES 3
+#endif
+
+class SmartBmsScheduler
+{
+public:
+	SmartBmsScheduler(SmartBmsClock clock = SmartBmsSystemClock::getMicros);
+	~SmartBmsScheduler();
+
+	void setClock(SmartBmsClock clock);
+	void onFrame(const uint32_t timestamp);
+	const uint32_t getSleepTime();
+	void reset();
+
+	const bool isLocked() const;
+	const uint32_t getCyclePeriod() const;
+	const uint32_t getJitter() const;
+	const uint32_t getMargin() const;
+	const uint32_t getNextArrival() const;
+	const uint32_t getMissedCycleCount() const;
+	const uint32_t getRelearnCount() const;
+
+private:
+	SmartBmsClock clock_;
+	bool hasArrival_;
+	uint32_t lastArrival_;
+	uint32_t cyclePeriod_;
+	uint32_t jitter_;
+	uint32_t regularIntervalCount_;
+	uint32_t missedCycleCount_;
+	uint32_t relearnCount_;
+
+	void relearn_();
+};
+
+#endif
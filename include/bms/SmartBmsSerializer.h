@@ -0,0 +1,58 @@
+/**
+ * @file SmartBmsSerializer.h
+ * @author TheRealKasumi
+ * @brief Contains serializers that write the BMS data as JSON, CSV or InfluxDB line protocol into a fixed buffer.
+ * @copyright Copyright (c) 2024 TheRealKasumi
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#ifndef SMART_BMS_SERIALIZER_H
+#define SMART_BMS_SERIALIZER_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "bms/SmartBmsData.h"
+#include "bms/SmartBmsField.h"
+#include "bms/SmartBmsFrameView.h"
+#include "bms/SmartBmsTextWriter.h"
+
+// Buffer size that is large enough for all fields in every format
+#define SMART_BMS_SERIALIZER_BUFFER_SIZE 1024
+
+enum SmartBmsSerializerFormat
+{
+	SBMS_FORMAT_JSON,
+	SBMS_FORMAT_CSV,
+	SBMS_FORMAT_LINE_PROTOCOL
+};
+
+class SmartBmsSerializer
+{
+public:
+	static const size_t toJson(const SmartBmsData &smartBmsData, char *buffer, const size_t size, const uint32_t fieldMask = SBMS_FIELD_MASK_ALL);
+	static const size_t toJson(const SmartBmsFrameView &frameView, char *buffer, const size_t size, const uint32_t fieldMask = SBMS_FIELD_MASK_ALL);
+	static const size_t toCsvHeader(char *buffer, const size_t size, const uint32_t fieldMask = SBMS_FIELD_MASK_ALL);
+	static const size_t toCsv(const SmartBmsData &smartBmsData, char *buffer, const size_t size, const uint32_t fieldMask = SBMS_FIELD_MASK_ALL);
+	static const size_t toCsv(const SmartBmsFrameView &frameView, char *buffer, const size_t size, const uint32_t fieldMask = SBMS_FIELD_MASK_ALL);
+	static const size_t toLineProtocol(const SmartBmsData &smartBmsData, const char *measurement, const uint64_t timestamp, char *buffer, const size_t size, const uint32_t fieldMask = SBMS_FIELD_MASK_ALL);
+	static const size_t toLineProtocol(const SmartBmsFrameView &frameView, const char *measurement, const uint64_t timestamp, char *buffer, const size_t size, const uint32_t fieldMask = SBMS_FIELD_MASK_ALL);
+	static const size_t serialize(const SmartBmsData &smartBmsData, const SmartBmsSerializerFormat format, char *buffer, const size_t size, const uint32_t fieldMask = SBMS_FIELD_MASK_ALL);
+
+private:
+	static void appendValue_(SmartBmsTextWriter &writer, const SmartBmsData &smartBmsData, const SmartBmsField field, const char *trueText, const char *falseText, const char *integerSuffix);
+};
+
+#endif
@@ -0,0 +1,102 @@
+/**
+ * @file SmartBmsStatistics.h
+ * @author TheRealKasumi
+ * @brief Contains optional counters and histograms about the health of the BMS link.
+ * @copyright Copyright (c) 2024 TheRealKasumi
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#ifndef SMART_BMS_STATISTICS_H
+#define SMART_BMS_STATISTICS_H
+
+#ifdef SMART_BMS_STATISTICS
+
+#include <stddef.h>
+#include <stdint.h>
+#include <atomic>
+
+#include "bms/SmartBmsTextWriter.h"
+
+// Number of upper bounds of a histogram, one more bucket counts everything above the last bound
+#define SMART_BMS_HISTOGRAM_BOUND_COUNT 10
+#define SMART_BMS_HISTOGRAM_BUCKET_COUNT (SMART_BMS_HISTOGRAM_BOUND_COUNT + 1)
+
+// Size of a buffer that fits the text export
+#define SMART_BMS_STATISTICS_BUFFER_SIZE 4096
+
+struct SmartBmsHistogram
+{
+	uint32_t bucketCounts[SMART_BMS_HISTOGRAM_BUCKET_COUNT];
+	uint32_t count;
+	uint32_t sum;
+};
+
+struct SmartBmsStatisticsSnapshot
+{
+	uint32_t frameCount;
+	uint32_t checksumErrorCount;
+	uint32_t skippedByteCount;
+	uint32_t missedCycleCount;
+	uint32_t readErrorCount;
+	uint32_t rxOverflowCount;
+	uint32_t droppedFrameCount;
+	SmartBmsHistogram decodeLatency;
+	SmartBmsHistogram frameInterval;
+};
+
+class SmartBmsStatistics
+{
+public:
+	SmartBmsStatistics();
+	~SmartBmsStatistics();
+
+	void countFrame(const uint32_t timestamp);
+	void countChecksumError();
+	void countSkippedBytes(const uint32_t count);
+	void countMissedCycles(const uint32_t count);
+	void countReadError();
+	void countRxOverflow();
+	void countDroppedFrame();
+	void recordDecodeLatency(const uint32_t micros);
+	void reset();
+
+	void getSnapshot(SmartBmsStatisticsSnapshot *snapshot) const;
+	const size_t toPrometheus(char *buffer, const size_t size) const;
+
+	static const uint32_t *getDecodeLatencyBounds();
+	static const uint32_t *getFrameIntervalBounds();
+
+private:
+	std::atomic<uint32_t> frameCount_;
+	std::atomic<uint32_t> checksumErrorCount_;
+	std::atomic<uint32_t> skippedByteCount_;
+	std::atomic<uint32_t> missedCycleCount_;
+	std::atomic<uint32_t> readErrorCount_;
+	std::atomic<uint32_t> rxOverflowCount_;
+	std::atomic<uint32_t> droppedFrameCount_;
+	std::atomic<uint32_t> decodeLatency_[SMART_BMS_HISTOGRAM_BUCKET_COUNT + 2];
+	std::atomic<uint32_t> frameInterval_[SMART_BMS_HISTOGRAM_BUCKET_COUNT + 2];
+	uint32_t lastFrameTime_;
+	bool hasLastFrame_;
+
+	static void record_(std::atomic<uint32_t> *histogram, const uint32_t *bounds, const uint32_t value);
+	static void copy_(const std::atomic<uint32_t> *histogram, SmartBmsHistogram *snapshot);
+	static void writeCounter_(SmartBmsTextWriter &writer, const char *name, const char *help, const uint32_t value);
+	static void writeHistogram_(SmartBmsTextWriter &writer, const char *name, const char *help, const uint32_t *bounds, const SmartBmsHistogram &histogram);
+};
+
+#endif
+
+#endif
@@ -0,0 +1,49 @@
+/**
+ * @file SmartBmsTextWriter.h
+ * @author TheRealKasumi
+ * @brief Contains a writer that formats text and integers into a fixed buffer without using the heap.
+ * @copyright Copyright (c) 2024 TheRealKasumi
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#ifndef SMART_BMS_TEXT_WRITER_H
+#define SMART_BMS_TEXT_WRITER_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+class SmartBmsTextWriter
+{
+public:
+	SmartBmsTextWriter(char *buffer, const size_t size);
+	~SmartBmsTextWriter();
+
+	void append(const char *text);
+	void append(const char character);
+	void appendInteger(const int64_t value);
+	void appendUnsigned(const uint64_t value);
+
+	const size_t getLength() const;
+	const bool hasOverflow() const;
+	const size_t finish();
+
+private:
+	char *buffer_;
+	size_t size_;
+	size_t position_;
+	bool overflow_;
+};
+
+#endif
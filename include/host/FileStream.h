@@ -0,0 +1,55 @@
+/**
+ * @file FileStream.h
+ * @author TheRealKasumi
+ * @brief Contains a Stream that reads from a file descriptor, like a file or a pipe.
+ * @copyright Copyright (c) 2024 TheRealKasumi
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#ifndef FILE_STREAM_H
+#define FILE_STREAM_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <Stream.h>
+
+#define FILE_STREAM_BUFFER_SIZE 4096
+
+class FileStream : public Stream
+{
+public:
+	FileStream(const int fileDescriptor, const bool closeOnDestroy = false);
+	~FileStream();
+
+	int available() override;
+	int read() override;
+	int peek() override;
+	using Stream::readBytes;
+	size_t readBytes(uint8_t *buffer, size_t length) override;
+
+	const bool isEndOfFile() const;
+
+private:
+	int fileDescriptor_;
+	bool closeOnDestroy_;
+	bool endOfFile_;
+	uint8_t buffer_[FILE_STREAM_BUFFER_SIZE];
+	size_t bufferStart_;
+	size_t bufferEnd_;
+
+	const bool fillBuffer_();
+};
+
+#endif
@@ -0,0 +1,50 @@
+/**
+ * @file MemoryStream.h
+ * @author TheRealKasumi
+ * @brief Contains a Stream that reads from a buffer in memory.
+ * @copyright Copyright (c) 2024 TheRealKasumi
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#ifndef MEMORY_STREAM_H
+#define MEMORY_STREAM_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <Stream.h>
+
+class MemoryStream : public Stream
+{
+public:
+	MemoryStream(const uint8_t *data, const size_t length);
+	~MemoryStream();
+
+	int available() override;
+	int read() override;
+	int peek() override;
+	using Stream::readBytes;
+	size_t readBytes(uint8_t *buffer, size_t length) override;
+
+	void setData(const uint8_t *data, const size_t length);
+	void rewind();
+	const size_t getPosition() const;
+
+private:
+	const uint8_t *data_;
+	size_t length_;
+	size_t position_;
+};
+
+#endif
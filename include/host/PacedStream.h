@@ -0,0 +1,63 @@
+/**
+ * @file PacedStream.h
+ * @author TheRealKasumi
+ * @brief Contains a stream that releases the bytes of a buffer at the pace of a UART, based on a clock.
+ * @copyright Copyright (c) 2024 TheRealKasumi
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#ifndef PACED_STREAM_H
+#define PACED_STREAM_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <Stream.h>
+
+#include "bms/SmartBmsClock.h"
+
+/**
+ * @brief Simulates a UART that receives frames from the BMS, so timing dependent code can run on the host.
+ * The bytes of each frame arrive back to back, a new frame starts every frame period.
+ * A simulation can run for about 35 minutes from the start time, after that the time wraps to before the start.
+ */
+class PacedStream : public Stream
+{
+public:
+	PacedStream(const uint8_t *data, const size_t length, SmartBmsClock clock);
+	~PacedStream();
+
+	int available() override;
+	int read() override;
+	int peek() override;
+	using Stream::readBytes;
+	size_t readBytes(uint8_t *buffer, size_t length) override;
+
+	void setTiming(const uint32_t startTime, const uint32_t byteDuration, const uint32_t framePeriod);
+	const size_t getArrivedByteCount();
+	const uint32_t getArrivalTime(const size_t index) const;
+	const size_t getPosition() const;
+	const bool isEndOfData() const;
+
+private:
+	const uint8_t *data_;
+	size_t length_;
+	size_t position_;
+	SmartBmsClock clock_;
+	uint32_t startTime_;
+	uint32_t byteDuration_;
+	uint32_t framePeriod_;
+};
+
+#endif
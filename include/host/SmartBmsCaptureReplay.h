@@ -0,0 +1,77 @@
+/**
+ * @file SmartBmsCaptureReplay.h
+ * @author TheRealKasumi
+ * @brief Contains a replay source for raw UART captures, which maps the capture file into memory.
+ * @copyright Copyright (c) 2024 TheRealKasumi
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#ifndef SMART_BMS_CAPTURE_REPLAY_H
+#define SMART_BMS_CAPTURE_REPLAY_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <chrono>
+
+#include "bms/SmartBmsReader.h"
+
+// Line settings of the BMS port, used for the original pacing, 8N1 has 10 bits per byte
+#define SMART_BMS_REPLAY_BAUD_RATE 9600
+#define SMART_BMS_REPLAY_BITS_PER_BYTE 10
+
+// Number of bytes that are fed at once when replaying as fast as possible
+#define SMART_BMS_REPLAY_CHUNK_SIZE 65536
+
+enum SmartBmsReplayPacing
+{
+	SBMS_REPLAY_AS_FAST_AS_POSSIBLE,
+	SBMS_REPLAY_ORIGINAL_PACING
+};
+
+class SmartBmsCaptureReplay
+{
+public:
+	SmartBmsCaptureReplay();
+	~SmartBmsCaptureReplay();
+
+	const bool open(const char *path);
+	void close();
+	const bool isOpen() const;
+
+	void setPacing(const SmartBmsReplayPacing pacing);
+	const SmartBmsReplayPacing getPacing() const;
+
+	const size_t replay(SmartBmsReader *smartBmsReader, const size_t length = SIZE_MAX);
+	void rewind();
+
+	const uint8_t *getData() const;
+	const size_t getSize() const;
+	const size_t getPosition() const;
+	const bool isEndOfCapture() const;
+
+private:
+	bool open_;
+	uint8_t *data_;
+	size_t size_;
+	size_t position_;
+	SmartBmsReplayPacing pacing_;
+	size_t pacingStartPosition_;
+	std::chrono::steady_clock::time_point pacingStartTime_;
+	bool pacingStarted_;
+
+	void waitForByte_(const size_t position);
+};
+
+#endif
@@ -0,0 +1,61 @@
+/**
+ * @file SmartBmsFrameGenerator.h
+ * @author TheRealKasumi
+ * @brief Contains a class that generates plausible frames of the 123SmartBMS on a host.
+ * @copyright Copyright (c) 2024 TheRealKasumi
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#ifndef SMART_BMS_FRAME_GENERATOR_H
+#define SMART_BMS_FRAME_GENERATOR_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "bms/SmartBmsField.h"
+
+// Bounds of the simulated pack in raw units of the field table, the cell voltage is in 5 mV steps, the current in 125 mA steps
+#define SMART_BMS_GENERATOR_MIN_CELL_VOLTAGE 600
+#define SMART_BMS_GENERATOR_MAX_CELL_VOLTAGE 690
+#define SMART_BMS_GENERATOR_MAX_CURRENT 400
+#define SMART_BMS_GENERATOR_REST_TEMPERATURE 300
+#define SMART_BMS_GENERATOR_CAPACITY_WH 14300
+
+class SmartBmsFrameGenerator
+{
+public:
+	SmartBmsFrameGenerator(const uint32_t seed, const uint8_t cellCount = 16);
+	~SmartBmsFrameGenerator();
+
+	void generate(uint8_t frame[SMART_BMS_FRAME_SIZE]);
+	void generate(uint8_t *buffer, const size_t frameCount);
+	const uint32_t nextRandom();
+
+	static void encodeRawValue(uint8_t frame[SMART_BMS_FRAME_SIZE], const SmartBmsField field, const int32_t rawValue);
+	static void updateChecksum(uint8_t frame[SMART_BMS_FRAME_SIZE]);
+
+private:
+	uint32_t state_;
+	uint8_t cellCount_;
+	uint32_t frameNumber_;
+	int32_t cellVoltage_;
+	int32_t current_;
+	int32_t temperature_;
+	int32_t energy_;
+
+	static const int32_t clamp_(const int32_t value, const int32_t min, const int32_t max);
+};
+
+#endif
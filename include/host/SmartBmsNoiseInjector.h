@@ -0,0 +1,78 @@
+/**
+ * @file SmartBmsNoiseInjector.h
+ * @author TheRealKasumi
+ * @brief Contains a seedable generator that corrupts a byte stream like a noisy BMS link.
+ * @copyright Copyright (c) 2024 TheRealKasumi
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#ifndef SMART_BMS_NOISE_INJECTOR_H
+#define SMART_BMS_NOISE_INJECTOR_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+// Rates of the noise profiles are given per million bytes
+#define SMART_BMS_NOISE_RATE_SCALE 1000000
+
+/**
+ * @brief Describes how often each kind of fault hits a byte.
+ * A bit flip inverts a single bit, a drop removes the byte, a duplicate receives the byte twice
+ * and a burst overwrites the byte and up to maxBurstLength - 1 bytes after it with random values.
+ */
+struct SmartBmsNoiseProfile
+{
+	const char *name;
+	uint32_t bitFlipRate;
+	uint32_t dropRate;
+	uint32_t duplicateRate;
+	uint32_t burstRate;
+	uint8_t maxBurstLength;
+};
+
+/**
+ * @brief Corrupts bytes by a noise profile. The same seed and input always produce the same output, so runs can be compared.
+ * A burst that reaches the end of the input continues in the next call, so a stream can be corrupted frame by frame.
+ */
+class SmartBmsNoiseInjector
+{
+public:
+	SmartBmsNoiseInjector(const uint32_t seed, const SmartBmsNoiseProfile &profile);
+	~SmartBmsNoiseInjector();
+
+	const uint32_t inject(const uint8_t *data, const size_t length, std::vector<uint8_t> *output);
+
+	const SmartBmsNoiseProfile &getProfile() const;
+	const uint32_t getBitFlipCount() const;
+	const uint32_t getDropCount() const;
+	const uint32_t getDuplicateCount() const;
+	const uint32_t getBurstCount() const;
+	const uint32_t getFaultCount() const;
+
+private:
+	uint32_t state_;
+	SmartBmsNoiseProfile profile_;
+	uint32_t burstRemaining_;
+	uint32_t bitFlipCount_;
+	uint32_t dropCount_;
+	uint32_t duplicateCount_;
+	uint32_t burstCount_;
+
+	const uint32_t nextRandom_();
+	const bool chance_(const uint32_t rate);
+};
+
+#endif
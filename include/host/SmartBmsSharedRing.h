@@ -0,0 +1,101 @@
+/**
+ * @file SmartBmsSharedRing.h
+ * @author TheRealKasumi
+ * @brief Contains a shared memory ring that fans out frames from one gateway to several local processes.
+ * @copyright Copyright (c) 2024 TheRealKasumi
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#ifndef SMART_BMS_SHARED_RING_H
+#define SMART_BMS_SHARED_RING_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <atomic>
+
+#include "bms/SmartBmsField.h"
+#include "bms/SmartBmsFrameView.h"
+
+// Identifies a mapping as a frame ring, the version changes with the memory layout
+#define SMART_BMS_SHARED_RING_MAGIC 0x53425252
+#define SMART_BMS_SHARED_RING_VERSION 1
+
+// Default number of slots, with one frame per second this keeps about one hour of frames
+#define SMART_BMS_SHARED_RING_DEFAULT_SLOT_COUNT 4096
+
+// The sequence of a slot is odd while the producer writes it, consumers never wait for it
+struct SmartBmsSharedRingSlot
+{
+	std::atomic<uint32_t> sequence;
+	uint32_t timestamp;
+	uint8_t frame[SMART_BMS_FRAME_SIZE];
+};
+
+struct SmartBmsSharedRingHeader
+{
+	uint32_t magic;
+	uint32_t version;
+	uint32_t slotCount;
+	uint32_t slotSize;
+	std::atomic<uint32_t> writeIndex;
+	uint8_t reserved[64 - 20];
+};
+
+/**
+ * @brief Single producer ring in POSIX shared memory. The gateway creates it and publishes every frame,
+ * any number of processes open it read only and follow it with their own read position.
+ * The producer never waits for consumers, a consumer that falls behind by more than the ring size loses the oldest frames.
+ * Consumers read the frames in place, so a frame is never copied between the processes.
+ */
+class SmartBmsSharedRing
+{
+public:
+	SmartBmsSharedRing();
+	~SmartBmsSharedRing();
+
+	const bool create(const char *name, const uint32_t slotCount = SMART_BMS_SHARED_RING_DEFAULT_SLOT_COUNT);
+	const bool open(const char *name);
+	void close();
+	const bool isOpen() const;
+	const bool isProducer() const;
+	static const bool remove(const char *name);
+
+	void publish(const SmartBmsFrameView &frameView);
+	void publish(const uint8_t frame[SMART_BMS_FRAME_SIZE], const uint32_t timestamp);
+
+	const uint8_t *peek(uint32_t *timestamp = nullptr);
+	const bool advance();
+	const bool read(SmartBmsFrameView *frameView);
+	void skipToLatest();
+
+	const uint32_t getSlotCount() const;
+	const uint32_t getWriteIndex() const;
+	const uint32_t getReadIndex() const;
+	const uint32_t getAvailable() const;
+	const uint32_t getLostFrameCount() const;
+
+private:
+	SmartBmsSharedRingHeader *header_;
+	SmartBmsSharedRingSlot *slots_;
+	size_t mappingSize_;
+	bool producer_;
+	uint32_t readIndex_;
+	uint32_t lostFrameCount_;
+
+	const bool map_(const int fileDescriptor, const size_t size, const int protection);
+	const size_t getMappingSize_(const uint32_t slotCount) const;
+};
+
+#endif
@@ -0,0 +1,81 @@
+/**
+ * @file SmartBmsTtyReader.h
+ * @author TheRealKasumi
+ * @brief Contains a reader that receives the frames of the BMS from a serial port on Linux.
+ * @copyright Copyright (c) 2024 TheRealKasumi
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#ifndef SMART_BMS_TTY_READER_H
+#define SMART_BMS_TTY_READER_H
+
+#if defined(__linux__)
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "bms/SmartBmsReader.h"
+
+// Line settings of the BMS port
+#define SMART_BMS_TTY_BAUD_RATE 9600
+
+// Number of bytes that are read from the port at once
+#define SMART_BMS_TTY_READ_SIZE 256
+
+/**
+ * @brief Reads a serial port with termios and epoll and feeds the bytes into a SmartBmsReader.
+ * The port is configured raw with 8N1. The BMS sends an inverted signal, termios has no way to invert it,
+ * so the inversion has to be done by the adapter, for example by the invert option in the EEPROM of an FTDI chip or by a transistor.
+ * A pseudo terminal can stand in for the BMS, since it accepts the same configuration.
+ */
+class SmartBmsTtyReader
+{
+public:
+	SmartBmsTtyReader();
+	~SmartBmsTtyReader();
+
+	const bool open(const char *path, const uint32_t baudRate = SMART_BMS_TTY_BAUD_RATE);
+	void close();
+	const bool isOpen() const;
+	const int getFileDescriptor() const;
+
+	SmartBmsReader *getReader();
+	void setFrameCallback(SmartBmsFrameCallback frameCallback, void *context);
+
+	const int poll(const int timeout);
+	const bool run();
+	void stop();
+
+	const uint64_t getReceivedByteCount() const;
+	const uint32_t getFrameCount() const;
+
+private:
+	int fileDescriptor_;
+	int epollDescriptor_;
+	int stopDescriptor_;
+	SmartBmsReader smartBmsReader_;
+	SmartBmsFrameCallback frameCallback_;
+	void *frameCallbackContext_;
+	uint64_t receivedByteCount_;
+	uint32_t frameCount_;
+
+	const int drain_();
+	static const bool configure_(const int fileDescriptor, const uint32_t baudRate);
+	static void onFrame_(const SmartBmsFrameView *frameView, void *context);
+};
+
+#endif
+
+#endif
@@ -0,0 +1,51 @@
+/**
+ * @file Stream.h
+ * @author TheRealKasumi
+ * @brief Contains a minimal stand-in for the Arduino Stream class to build the library on a host.
+ * @copyright Copyright (c) 2024 TheRealKasumi
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#ifndef HOST_STREAM_H
+#define HOST_STREAM_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief Subset of the Arduino Stream interface used by the library.
+ * Reading never waits, readBytes() returns early when no more data is available.
+ */
+class Stream
+{
+public:
+	Stream();
+	virtual ~Stream();
+
+	virtual int available() = 0;
+	virtual int read() = 0;
+	virtual int peek() = 0;
+	virtual void flush();
+	virtual size_t write(const uint8_t value);
+
+	virtual size_t readBytes(uint8_t *buffer, size_t length);
+	size_t readBytes(char *buffer, size_t length);
+	void setTimeout(const unsigned long timeout);
+
+protected:
+	unsigned long timeout_;
+};
+
+#endif
@@ -0,0 +1,383 @@
+/**
+ * @file SmartBmsAggregator.cpp
+ * @author TheRealKasumi
+ * @brief Contains a streaming aggregator that keeps min, max, mean and last values of fields over several time windows.
+ * @copyright Copyright (c) 2024 TheRealKasumi
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#include "bms/SmartBmsAggregator.h"
+
+/**
+ * @brief Create a new instance of SmartBmsAggregate.
+ */
+SmartBmsAggregate::SmartBmsAggregate()
+{
+	this->reset_(0, 0);
+}
+
+/**
+ * @brief Destroy the SmartBmsAggregate instance.
+ */
+SmartBmsAggregate::~SmartBmsAggregate()
+{
+}
+
+/**
+ * @brief Get the length of the window.
+ * @return length in ms
+ */
+const uint32_t SmartBmsAggregate::getWindowLength() const
+{
+	return this->windowLength_;
+}
+
+/**
+ * @brief Get the time the window started.
+ * @return timestamp in ms
+ */
+const uint32_t SmartBmsAggregate::getStartTime() const
+{
+	return this->startTime_;
+}
+
+/**
+ * @brief Get the time the window ends. Samples at this time belong to the next window.
+ * @return timestamp in ms
+ */
+const uint32_t SmartBmsAggregate::getEndTime() const
+{
+	return this->startTime_ + this->windowLength_;
+}
+
+/**
+ * @brief Get the number of samples that were added to the window.
+ * @return number of samples
+ */
+const uint32_t SmartBmsAggregate::getSampleCount() const
+{
+	return this->sampleCount_;
+}
+
+/**
+ * @brief Get the mask of fields that have at least one value.
+ * @return bit mask with SBMS_FIELD_MASK(field) set for every aggregated field
+ */
+const uint32_t SmartBmsAggregate::getFieldMask() const
+{
+	return this->fieldMask_;
+}
+
+/**
+ * @brief Check if a field has at least one value.
+ * @param field field to check
+ * @return true when the field has values
+ */
+const bool SmartBmsAggregate::hasField(const SmartBmsField field) const
+{
+	return this->fieldMask_ & SBMS_FIELD_MASK(field);
+}
+
+/**
+ * @brief Get the number of values of a measurement, see SBMS_FIELD_MASK_MEASUREMENTS.
+ * @param field field to get
+ * @return number of values, 0 for fields that are no measurement
+ */
+const uint32_t SmartBmsAggregate::getCount(const SmartBmsField field) const
+{
+	if (!(SBMS_FIELD_MASK_MEASUREMENTS & SBMS_FIELD_MASK(field)))
+	{
+		return 0;
+	}
+	return this->counts_[SmartBmsAggregate::getMeasurementIndex_(field)];
+}
+
+/**
+ * @brief Get the smallest value of a measurement in integer units, see SMART_BMS_FIELDS for the unit.
+ * @param field field to get
+ * @return smallest value, the last value for fields that are no measurement, 0 when the field has no values
+ */
+const int32_t SmartBmsAggregate::getMin(const SmartBmsField field) const
+{
+	if (!(SBMS_FIELD_MASK_MEASUREMENTS & SBMS_FIELD_MASK(field)))
+	{
+		return this->getLast(field);
+	}
+	const size_t index = SmartBmsAggregate::getMeasurementIndex_(field);
+	return this->counts_[index] > 0 ? this->min_[index] : 0;
+}
+
+/**
+ * @brief Get the largest value of a measurement in integer units, see SMART_BMS_FIELDS for the unit.
+ * @param field field to get
+ * @return largest value, the last value for fields that are no measurement, 0 when the field has no values
+ */
+const int32_t SmartBmsAggregate::getMax(const SmartBmsField field) const
+{
+	if (!(SBMS_FIELD_MASK_MEASUREMENTS & SBMS_FIELD_MASK(field)))
+	{
+		return this->getLast(field);
+	}
+	const size_t index = SmartBmsAggregate::getMeasurementIndex_(field);
+	return this->counts_[index] > 0 ? this->max_[index] : 0;
+}
+
+/**
+ * @brief Get the mean value of a measurement in integer units, rounded to the nearest integer.
+ * @param field field to get
+ * @return mean value, the last value for fields that are no measurement, 0 when the field has no values
+ */
+const int32_t SmartBmsAggregate::getMean(const SmartBmsField field) const
+{
+	if (!(SBMS_FIELD_MASK_MEASUREMENTS & SBMS_FIELD_MASK(field)))
+	{
+		return this->getLast(field);
+	}
+	const size_t index = SmartBmsAggregate::getMeasurementIndex_(field);
+	const int64_t count = this->counts_[index];
+	if (count == 0)
+	{
+		return 0;
+	}
+	const int64_t sum = this->sum_[index];
+	return sum >= 0 ? (sum + count / 2) / count : (sum - count / 2) / count;
+}
+
+/**
+ * @brief Get the last value of a field in integer units, see SMART_BMS_FIELDS for the unit.
+ * @param field field to get
+ * @return last value, 0 when the field has no values
+ */
+const int32_t SmartBmsAggregate::getLast(const SmartBmsField field) const
+{
+	return this->hasField(field) ? this->last_[field] : 0;
+}
+
+/**
+ * @brief Check if a flag was set in at least one sample of the window, for example a short alarm.
+ * @param field field to check
+ * @return true when the field had a value other than 0
+ */
+const bool SmartBmsAggregate::wasActive(const SmartBmsField field) const
+{
+	return this->activeMask_ & SBMS_FIELD_MASK(field);
+}
+
+/**
+ * @brief Start a new, empty window.
+ * @param windowLength length of the window in ms
+ * @param startTime start of the window in ms
+ */
+void SmartBmsAggregate::reset_(const uint32_t windowLength, const uint32_t startTime)
+{
+	this->windowLength_ = windowLength;
+	this->startTime_ = startTime;
+	this->sampleCount_ = 0;
+	this->fieldMask_ = 0;
+	this->activeMask_ = 0;
+	for (size_t i = 0; i < SBMS_FIELD_COUNT; i++)
+	{
+		this->last_[i] = 0;
+	}
+	for (size_t i = 0; i < SBMS_MEASUREMENT_COUNT; i++)
+	{
+		this->counts_[i] = 0;
+		this->min_[i] = INT32_MAX;
+		this->max_[i] = INT32_MIN;
+		this->sum_[i] = 0;
+	}
+}
+
+/**
+ * @brief Add the fields of a sample to the window.
+ * Only measurements get statistics, the other fields keep their last value and flags are ORed.
+ * @param smartBmsData sample
+ * @param fieldMask mask of the fields to aggregate
+ */
+void SmartBmsAggregate::add_(const SmartBmsData &smartBmsData, const uint32_t fieldMask)
+{
+	const uint32_t mask = smartBmsData.getFieldMask() & fieldMask;
+	size_t index = 0;
+	for (size_t i = 0; i < SBMS_FIELD_COUNT; i++)
+	{
+		const bool isMeasurement = SBMS_FIELD_MASK_MEASUREMENTS & SBMS_FIELD_MASK(i);
+		if (!(mask & SBMS_FIELD_MASK(i)))
+		{
+			index += isMeasurement ? 1 : 0;
+			continue;
+		}
+
+		const int32_t value = smartBmsData.getFixedValue(static_cast<SmartBmsField>(i));
+		this->last_[i] = value;
+		if (!isMeasurement)
+		{
+			this->activeMask_ |= value != 0 ? SBMS_FIELD_MASK(i) : 0;
+			continue;
+		}
+		this->min_[index] = value < this->min_[index] ? value : this->min_[index];
+		this->max_[index] = value > this->max_[index] ? value : this->max_[index];
+		this->sum_[index] += value;
+		this->counts_[index]++;
+		index++;
+	}
+	this->fieldMask_ |= mask;
+	this->sampleCount_++;
+}
+
+/**
+ * @brief Get the index of a measurement in the statistics, which are only stored for measurements.
+ * @param field measurement
+ * @return index
+ */
+const size_t SmartBmsAggregate::getMeasurementIndex_(const SmartBmsField field)
+{
+	return __builtin_popcount(SBMS_FIELD_MASK_MEASUREMENTS & (SBMS_FIELD_MASK(field) - 1));
+}
+
+/**
+ * @brief Create a new instance of SmartBmsAggregator.
+ */
+SmartBmsAggregator::SmartBmsAggregator()
+{
+	this->windowCount_ = 0;
+	this->started_ = false;
+	this->startTime_ = 0;
+	this->time_ = 0;
+	this->fieldMask_ = SBMS_FIELD_MASK_ALL;
+	this->aggregateCallback_ = nullptr;
+	this->aggregateCallbackContext_ = nullptr;
+}
+
+/**
+ * @brief Destroy the SmartBmsAggregator instance.
+ */
+SmartBmsAggregator::~SmartBmsAggregator()
+{
+}
+
+/**
+ * @brief Add a window that is aggregated in parallel to the others, for example 1 s, 1 min and 1 h.
+ * Windows are back to back and aligned to the timestamp of the first sample.
+ * A window that is added later starts at the latest time passed to the aggregator, aligned to the first sample.
+ * @param windowLength length of the window in ms
+ * @return true when the window was added
+ * @return false when the length is 0 or SMART_BMS_MAX_AGGREGATION_WINDOWS windows were already added
+ */
+const bool SmartBmsAggregator::addWindow(const uint32_t windowLength)
+{
+	if (windowLength == 0 || this->windowCount_ >= SMART_BMS_MAX_AGGREGATION_WINDOWS)
+	{
+		return false;
+	}
+	const uint32_t startTime = this->started_ ? this->time_ - (this->time_ - this->startTime_) % windowLength : 0;
+	this->windows_[this->windowCount_].reset_(windowLength, startTime);
+	this->windowCount_++;
+	return true;
+}
+
+/**
+ * @brief Get the number of windows.
+ * @return number of windows
+ */
+const size_t SmartBmsAggregator::getWindowCount() const
+{
+	return this->windowCount_;
+}
+
+/**
+ * @brief Get the current, not yet closed state of a window.
+ * @param index index of the window in the order it was added
+ * @return window or nullptr when the index is out of range
+ */
+const SmartBmsAggregate *SmartBmsAggregator::getWindow(const size_t index) const
+{
+	return index < this->windowCount_ ? &this->windows_[index] : nullptr;
+}
+
+/**
+ * @brief Set the fields that are aggregated. Fewer fields make adding a sample cheaper.
+ * @param fieldMask mask of the fields, see SBMS_FIELD_MASK
+ */
+void SmartBmsAggregator::setFieldMask(const uint32_t fieldMask)
+{
+	this->fieldMask_ = fieldMask;
+}
+
+/**
+ * @brief Set the callback that is invoked with the aggregate of every window that closes.
+ * @param aggregateCallback callback function or nullptr to remove it
+ * @param context user defined pointer that is passed to the callback
+ */
+void SmartBmsAggregator::setAggregateCallback(SmartBmsAggregateCallback aggregateCallback, void *context)
+{
+	this->aggregateCallback_ = aggregateCallback;
+	this->aggregateCallbackContext_ = context;
+}
+
+/**
+ * @brief Add a sample to all windows. Windows that ended before the sample are closed first.
+ * The cost per sample only depends on the number of windows and fields, not on the window length.
+ * @param smartBmsData sample, only decoded fields are aggregated
+ * @param timestamp time of the sample in ms, may wrap around
+ */
+void SmartBmsAggregator::addSample(const SmartBmsData &smartBmsData, const uint32_t timestamp)
+{
+	// The first sample defines where the windows start
+	if (!this->started_)
+	{
+		for (size_t i = 0; i < this->windowCount_; i++)
+		{
+			this->windows_[i].reset_(this->windows_[i].getWindowLength(), timestamp);
+		}
+		this->started_ = true;
+		this->startTime_ = timestamp;
+	}
+	this->advance(timestamp);
+	for (size_t i = 0; i < this->windowCount_; i++)
+	{
+		this->windows_[i].add_(smartBmsData, this->fieldMask_);
+	}
+}
+
+/**
+ * @brief Close all windows that ended at the given time, even when no new sample arrived.
+ * Windows without samples are skipped and not passed to the callback. Before the first sample, nothing happens.
+ * @param timestamp current time in ms, may wrap around
+ */
+void SmartBmsAggregator::advance(const uint32_t timestamp)
+{
+	if (!this->started_)
+	{
+		return;
+	}
+	this->time_ = timestamp;
+
+	for (size_t i = 0; i < this->windowCount_; i++)
+	{
+		SmartBmsAggregate &window = this->windows_[i];
+		const uint32_t elapsed = timestamp - window.getStartTime();
+		if (elapsed < window.getWindowLength())
+		{
+			continue;
+		}
+
+		// Emit the window and start the one that contains the timestamp
+		if (window.getSampleCount() > 0 && this->aggregateCallback_ != nullptr)
+		{
+			this->aggregateCallback_(&window, this->aggregateCallbackContext_);
+		}
+		window.reset_(window.getWindowLength(), timestamp - elapsed % window.getWindowLength());
+	}
+}
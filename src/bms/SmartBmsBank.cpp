@@ -0,0 +1,589 @@
+/**
+ * @file SmartBmsBank.cpp
+ * @author TheRealKasumi
+ * @brief Implementation of the SmartBmsPack, SmartBmsBankView and SmartBmsBank classes.
+ * @copyright Copyright (c) 2024 TheRealKasumi
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#include "bms/SmartBmsBank.h"
+
+/**
+ * @brief Create a new instance of SmartBmsPack without a stream.
+ */
+SmartBmsPack::SmartBmsPack()
+{
+	this->inputStream_ = nullptr;
+	this->hasData_ = false;
+	this->frameCount_ = 0;
+	this->readErrorCount_ = 0;
+}
+
+/**
+ * @brief Destroy the SmartBmsPack instance.
+ */
+SmartBmsPack::~SmartBmsPack()
+{
+}
+
+/**
+ * @brief Get the reader of the pack, for example to subscribe to its flags.
+ * @return reader that is fed by the bank
+ */
+SmartBmsReader *SmartBmsPack::getReader()
+{
+	return &this->smartBmsReader_;
+}
+
+/**
+ * @brief Check if a frame was received from the pack.
+ * @return true when at least one frame was received
+ */
+const bool SmartBmsPack::hasData() const
+{
+	return this->hasData_;
+}
+
+/**
+ * @brief Get the data of the latest frame of the pack.
+ * @return latest data, empty when no frame was received yet
+ */
+const SmartBmsData &SmartBmsPack::getData() const
+{
+	return this->smartBmsData_;
+}
+
+/**
+ * @brief Get the number of frames received from the pack.
+ * @return number of frames
+ */
+const uint32_t SmartBmsPack::getFrameCount() const
+{
+	return this->frameCount_;
+}
+
+/**
+ * @brief Get the number of failed reads of the stream of the pack.
+ * @return number of failed reads
+ */
+const uint32_t SmartBmsPack::getReadErrorCount() const
+{
+	return this->readErrorCount_;
+}
+
+/**
+ * @brief Get the number of bytes skipped to resynchronize to the frame alignment of the pack.
+ * @return number of skipped bytes
+ */
+const uint32_t SmartBmsPack::getSkippedByteCount() const
+{
+	return this->smartBmsReader_.getSkippedByteCount();
+}
+
+/**
+ * @brief Get the number of cycles of the pack in which no valid frame was received.
+ * @return number of missed cycles
+ */
+const uint32_t SmartBmsPack::getMissedCycleCount() const
+{
+	return this->smartBmsReader_.getMissedCycleCount();
+}
+
+/**
+ * @brief Create a new instance of SmartBmsBankView without packs.
+ */
+SmartBmsBankView::SmartBmsBankView()
+{
+	this->packCount_ = 0;
+	this->stalePackCount_ = 0;
+	this->packCurrent_ = 0;
+	this->packCapacity_ = 0;
+	this->packRemainingEnergy_ = 0;
+	this->lowestCellVoltage_ = UINT32_MAX;
+	this->lowestCellVoltagePack_ = SMART_BMS_BANK_NO_PACK;
+	this->lowestCellVoltageNumber_ = 0;
+	this->highestCellVoltage_ = 0;
+	this->highestCellVoltagePack_ = SMART_BMS_BANK_NO_PACK;
+	this->highestCellVoltageNumber_ = 0;
+	this->lowestCellTemperature_ = INT32_MAX;
+	this->lowestCellTemperaturePack_ = SMART_BMS_BANK_NO_PACK;
+	this->lowestCellTemperatureNumber_ = 0;
+	this->highestCellTemperature_ = INT32_MIN;
+	this->highestCellTemperaturePack_ = SMART_BMS_BANK_NO_PACK;
+	this->highestCellTemperatureNumber_ = 0;
+	this->flagMask_ = 0;
+	this->alarmPackMask_ = 0;
+}
+
+/**
+ * @brief Destroy the SmartBmsBankView instance.
+ */
+SmartBmsBankView::~SmartBmsBankView()
+{
+}
+
+/**
+ * @brief Get the number of packs with current data that are part of the view.
+ * @return number of packs
+ */
+const uint8_t SmartBmsBankView::getPackCount() const
+{
+	return this->packCount_;
+}
+
+/**
+ * @brief Get the number of packs without data or with data that is older than the maximum age.
+ * @return number of packs
+ */
+const uint8_t SmartBmsBankView::getStalePackCount() const
+{
+	return this->stalePackCount_;
+}
+
+/**
+ * @brief Get the current of the whole bank.
+ * @return sum of the currents of the packs in mA, positive while charging
+ */
+const int32_t SmartBmsBankView::getPackCurrentMilliamps() const
+{
+	return this->packCurrent_;
+}
+
+/**
+ * @brief Get the capacity of the whole bank.
+ * @return sum of the capacities of the packs in Wh
+ */
+const uint32_t SmartBmsBankView::getPackCapacityWattHours() const
+{
+	return this->packCapacity_;
+}
+
+/**
+ * @brief Get the remaining energy of the whole bank.
+ * @return sum of the remaining energy of the packs in Wh
+ */
+const uint32_t SmartBmsBankView::getPackRemainingEnergyWattHours() const
+{
+	return this->packRemainingEnergy_;
+}
+
+/**
+ * @brief Get the lowest cell voltage of all packs.
+ * @return voltage in mV, UINT32_MAX without packs
+ */
+const uint32_t SmartBmsBankView::getLowestCellVoltageMillivolts() const
+{
+	return this->lowestCellVoltage_;
+}
+
+/**
+ * @brief Get the pack with the lowest cell voltage.
+ * @return index of the pack or SMART_BMS_BANK_NO_PACK
+ */
+const uint8_t SmartBmsBankView::getLowestCellVoltagePack() const
+{
+	return this->lowestCellVoltagePack_;
+}
+
+/**
+ * @brief Get the number of the cell with the lowest voltage within its pack.
+ * @return number of the cell
+ */
+const uint8_t SmartBmsBankView::getLowestCellVoltageNumber() const
+{
+	return this->lowestCellVoltageNumber_;
+}
+
+/**
+ * @brief Get the highest cell voltage of all packs.
+ * @return voltage in mV, 0 without packs
+ */
+const uint32_t SmartBmsBankView::getHighestCellVoltageMillivolts() const
+{
+	return this->highestCellVoltage_;
+}
+
+/**
+ * @brief Get the pack with the highest cell voltage.
+ * @return index of the pack or SMART_BMS_BANK_NO_PACK
+ */
+const uint8_t SmartBmsBankView::getHighestCellVoltagePack() const
+{
+	return this->highestCellVoltagePack_;
+}
+
+/**
+ * @brief Get the number of the cell with the highest voltage within its pack.
+ * @return number of the cell
+ */
+const uint8_t SmartBmsBankView::getHighestCellVoltageNumber() const
+{
+	return this->highestCellVoltageNumber_;
+}
+
+/**
+ * @brief Get the lowest cell temperature of all packs.
+ * @return temperature in m°C, INT32_MAX without packs
+ */
+const int32_t SmartBmsBankView::getLowestCellTemperatureMillicelsius() const
+{
+	return this->lowestCellTemperature_;
+}
+
+/**
+ * @brief Get the pack with the lowest cell temperature.
+ * @return index of the pack or SMART_BMS_BANK_NO_PACK
+ */
+const uint8_t SmartBmsBankView::getLowestCellTemperaturePack() const
+{
+	return this->lowestCellTemperaturePack_;
+}
+
+/**
+ * @brief Get the number of the cell with the lowest temperature within its pack.
+ * @return number of the cell
+ */
+const uint8_t SmartBmsBankView::getLowestCellTemperatureNumber() const
+{
+	return this->lowestCellTemperatureNumber_;
+}
+
+/**
+ * @brief Get the highest cell temperature of all packs.
+ * @return temperature in m°C, INT32_MIN without packs
+ */
+const int32_t SmartBmsBankView::getHighestCellTemperatureMillicelsius() const
+{
+	return this->highestCellTemperature_;
+}
+
+/**
+ * @brief Get the pack with the highest cell temperature.
+ * @return index of the pack or SMART_BMS_BANK_NO_PACK
+ */
+const uint8_t SmartBmsBankView::getHighestCellTemperaturePack() const
+{
+	return this->highestCellTemperaturePack_;
+}
+
+/**
+ * @brief Get the number of the cell with the highest temperature within its pack.
+ * @return number of the cell
+ */
+const uint8_t SmartBmsBankView::getHighestCellTemperatureNumber() const
+{
+	return this->highestCellTemperatureNumber_;
+}
+
+/**
+ * @brief Check if any pack reports a communication error.
+ * @return true when at least one pack reports an error
+ */
+const bool SmartBmsBankView::hasCommunicationError() const
+{
+	return this->flagMask_ & SBMS_FIELD_MASK(SBMS_FIELD_COMMUNICATION_ERROR);
+}
+
+/**
+ * @brief Check if the bank is allowed to charge. This requires current data of every pack and every pack to allow it.
+ * @return true when charging is allowed
+ */
+const bool SmartBmsBankView::isAllowedToCharge() const
+{
+	return this->packCount_ > 0 && this->stalePackCount_ == 0 && !(this->flagMask_ & SBMS_FIELD_MASK(SBMS_FIELD_ALLOWED_TO_CHARGE));
+}
+
+/**
+ * @brief Check if the bank is allowed to discharge. This requires current data of every pack and every pack to allow it.
+ * @return true when discharging is allowed
+ */
+const bool SmartBmsBankView::isAllowedToDischarge() const
+{
+	return this->packCount_ > 0 && this->stalePackCount_ == 0 && !(this->flagMask_ & SBMS_FIELD_MASK(SBMS_FIELD_ALLOWED_TO_DISCHARGE));
+}
+
+/**
+ * @brief Check if any pack has an active min voltage alarm.
+ * @return true when the alarm is active in at least one pack
+ */
+const bool SmartBmsBankView::isMinVoltageAlarmActive() const
+{
+	return this->flagMask_ & SBMS_FIELD_MASK(SBMS_FIELD_MIN_VOLTAGE_ALARM);
+}
+
+/**
+ * @brief Check if any pack has an active max voltage alarm.
+ * @return true when the alarm is active in at least one pack
+ */
+const bool SmartBmsBankView::isMaxVoltageAlarmActive() const
+{
+	return this->flagMask_ & SBMS_FIELD_MASK(SBMS_FIELD_MAX_VOLTAGE_ALARM);
+}
+
+/**
+ * @brief Check if any pack has an active min temperature alarm.
+ * @return true when the alarm is active in at least one pack
+ */
+const bool SmartBmsBankView::isMinTemperatureAlarmActive() const
+{
+	return this->flagMask_ & SBMS_FIELD_MASK(SBMS_FIELD_MIN_TEMPERATURE_ALARM);
+}
+
+/**
+ * @brief Check if any pack has an active max temperature alarm.
+ * @return true when the alarm is active in at least one pack
+ */
+const bool SmartBmsBankView::isMaxTemperatureAlarmActive() const
+{
+	return this->flagMask_ & SBMS_FIELD_MASK(SBMS_FIELD_MAX_TEMPERATURE_ALARM);
+}
+
+/**
+ * @brief Get the packs that have any alarm active.
+ * @return bit mask with bit n set when pack n has an alarm
+ */
+const uint8_t SmartBmsBankView::getAlarmPackMask() const
+{
+	return this->alarmPackMask_;
+}
+
+/**
+ * @brief Add the data of a pack to the view.
+ * @param smartBmsData current data of the pack
+ * @param pack index of the pack
+ */
+void SmartBmsBankView::add_(const SmartBmsData &smartBmsData, const uint8_t pack)
+{
+	this->packCount_++;
+	this->packCurrent_ += smartBmsData.getPackCurrentMilliamps();
+	this->packCapacity_ += smartBmsData.getPackCapacityWattHours();
+	this->packRemainingEnergy_ += smartBmsData.getPackRemainingEnergyWattHours();
+
+	// Keep the worst cells together with the pack they belong to
+	if (smartBmsData.getLowestCellVoltageMillivolts() < this->lowestCellVoltage_)
+	{
+		this->lowestCellVoltage_ = smartBmsData.getLowestCellVoltageMillivolts();
+		this->lowestCellVoltagePack_ = pack;
+		this->lowestCellVoltageNumber_ = smartBmsData.getLowestCellVoltageNumber();
+	}
+	if (smartBmsData.getHighestCellVoltageMillivolts() > this->highestCellVoltage_ || this->highestCellVoltagePack_ == SMART_BMS_BANK_NO_PACK)
+	{
+		this->highestCellVoltage_ = smartBmsData.getHighestCellVoltageMillivolts();
+		this->highestCellVoltagePack_ = pack;
+		this->highestCellVoltageNumber_ = smartBmsData.getHighestCellVoltageNumber();
+	}
+	if (smartBmsData.getLowestCellTemperatureMillicelsius() < this->lowestCellTemperature_)
+	{
+		this->lowestCellTemperature_ = smartBmsData.getLowestCellTemperatureMillicelsius();
+		this->lowestCellTemperaturePack_ = pack;
+		this->lowestCellTemperatureNumber_ = smartBmsData.getLowestCellTemperatureNumber();
+	}
+	if (smartBmsData.getHighestCellTemperatureMillicelsius() > this->highestCellTemperature_ || this->highestCellTemperaturePack_ == SMART_BMS_BANK_NO_PACK)
+	{
+		this->highestCellTemperature_ = smartBmsData.getHighestCellTemperatureMillicelsius();
+		this->highestCellTemperaturePack_ = pack;
+		this->highestCellTemperatureNumber_ = smartBmsData.getHighestCellTemperatureNumber();
+	}
+
+	// Errors and alarms of any pack count, permissions are kept as a mask of packs that deny them
+	const uint32_t alarmMask = SBMS_FIELD_MASK(SBMS_FIELD_MIN_VOLTAGE_ALARM) | SBMS_FIELD_MASK(SBMS_FIELD_MAX_VOLTAGE_ALARM) |
+							   SBMS_FIELD_MASK(SBMS_FIELD_MIN_TEMPERATURE_ALARM) | SBMS_FIELD_MASK(SBMS_FIELD_MAX_TEMPERATURE_ALARM);
+	uint32_t flagMask = 0;
+	flagMask |= smartBmsData.hasCommunicationError() ? SBMS_FIELD_MASK(SBMS_FIELD_COMMUNICATION_ERROR) : 0;
+	flagMask |= !smartBmsData.isAllowedToCharge() ? SBMS_FIELD_MASK(SBMS_FIELD_ALLOWED_TO_CHARGE) : 0;
+	flagMask |= !smartBmsData.isAllowedToDischarge() ? SBMS_FIELD_MASK(SBMS_FIELD_ALLOWED_TO_DISCHARGE) : 0;
+	flagMask |= smartBmsData.isMinVoltageAlarmActive() ? SBMS_FIELD_MASK(SBMS_FIELD_MIN_VOLTAGE_ALARM) : 0;
+	flagMask |= smartBmsData.isMaxVoltageAlarmActive() ? SBMS_FIELD_MASK(SBMS_FIELD_MAX_VOLTAGE_ALARM) : 0;
+	flagMask |= smartBmsData.isMinTemperatureAlarmActive() ? SBMS_FIELD_MASK(SBMS_FIELD_MIN_TEMPERATURE_ALARM) : 0;
+	flagMask |= smartBmsData.isMaxTemperatureAlarmActive() ? SBMS_FIELD_MASK(SBMS_FIELD_MAX_TEMPERATURE_ALARM) : 0;
+	this->flagMask_ |= flagMask;
+	if (flagMask & alarmMask)
+	{
+		this->alarmPackMask_ |= 1 << pack;
+	}
+}
+
+/**
+ * @brief Create a new instance of SmartBmsBank without packs.
+ */
+SmartBmsBank::SmartBmsBank()
+{
+	this->packCount_ = 0;
+	this->nextPack_ = 0;
+	this->clock_ = SmartBmsSystemClock::getMicros;
+	this->maxDataAge_ = 0;
+	this->packCallback_ = nullptr;
+	this->packCallbackContext_ = nullptr;
+}
+
+/**
+ * @brief Destroy the SmartBmsBank instance.
+ */
+SmartBmsBank::~SmartBmsBank()
+{
+}
+
+/**
+ * @brief Add a pack that is read from its own stream, like one UART per pack.
+ * @param inputStream input stream of the pack, must not be used by anyone else
+ * @return true when the pack was added
+ * @return false when the stream is nullptr or SMART_BMS_MAX_PACKS packs were added already
+ */
+const bool SmartBmsBank::addPack(Stream *inputStream)
+{
+	if (inputStream == nullptr || this->packCount_ == SMART_BMS_MAX_PACKS)
+	{
+		return false;
+	}
+	SmartBmsPack &pack = this->packs_[this->packCount_++];
+	pack.inputStream_ = inputStream;
+	pack.smartBmsReader_.setClock(this->clock_);
+	return true;
+}
+
+/**
+ * @brief Get the number of packs.
+ * @return number of packs
+ */
+const uint8_t SmartBmsBank::getPackCount() const
+{
+	return this->packCount_;
+}
+
+/**
+ * @brief Get a pack with its state and counters.
+ * @param pack index of the pack in the order they were added
+ * @return pointer to the pack or nullptr when the index is invalid
+ */
+SmartBmsPack *SmartBmsBank::getPack(const uint8_t pack)
+{
+	return pack < this->packCount_ ? &this->packs_[pack] : nullptr;
+}
+
+/**
+ * @brief Set the clock that timestamps the frames of all packs and decides if their data is current.
+ * @param clock clock function or nullptr to use SmartBmsSystemClock
+ */
+void SmartBmsBank::setClock(SmartBmsClock clock)
+{
+	this->clock_ = clock != nullptr ? clock : SmartBmsSystemClock::getMicros;
+	for (uint8_t i = 0; i < this->packCount_; i++)
+	{
+		this->packs_[i].smartBmsReader_.setClock(this->clock_);
+	}
+}
+
+/**
+ * @brief Set the age after which the data of a pack is no longer part of the bank view.
+ * @param maxDataAge maximum age in µs or 0 to keep the latest data forever
+ */
+void SmartBmsBank::setMaxDataAge(const uint32_t maxDataAge)
+{
+	this->maxDataAge_ = maxDataAge;
+}
+
+/**
+ * @brief Set the callback that is invoked for every frame of any pack.
+ * @param packCallback callback function or nullptr to remove it
+ * @param context user defined pointer that is passed to the callback
+ */
+void SmartBmsBank::setPackCallback(SmartBmsPackCallback packCallback, void *context)
+{
+	this->packCallback_ = packCallback;
+	this->packCallbackContext_ = context;
+}
+
+/**
+ * @brief Read and decode the available bytes of all packs. Call this often from the loop.
+ * Every pack gets at most SMART_BMS_BANK_BYTE_BUDGET bytes per call and the first pack rotates,
+ * so a pack with a full buffer can not starve the others. At 9600 baud with 8N1 a pack receives about 1 byte per ms, see SMART_BMS_BYTE_DURATION_US,
+ * so the budget of a call covers more than a whole frame and servicing every few ms keeps up with all packs.
+ * @return number of frames decoded in this call
+ */
+const size_t SmartBmsBank::service()
+{
+	size_t frameCount = 0;
+	for (uint8_t i = 0; i < this->packCount_; i++)
+	{
+		frameCount += this->servicePack_((this->nextPack_ + i) % this->packCount_);
+	}
+	this->nextPack_ = this->packCount_ > 0 ? (this->nextPack_ + 1) % this->packCount_ : 0;
+	return frameCount;
+}
+
+/**
+ * @brief Combine the latest data of all packs into a view of the bank.
+ * Packs without data or with data that is too old are counted as stale and left out.
+ * @param view view that receives the combined data
+ */
+void SmartBmsBank::getView(SmartBmsBankView *view) const
+{
+	*view = SmartBmsBankView();
+	const uint32_t now = this->clock_();
+	for (uint8_t i = 0; i < this->packCount_; i++)
+	{
+		const SmartBmsPack &pack = this->packs_[i];
+		if (!pack.hasData_ || (this->maxDataAge_ > 0 && pack.smartBmsData_.getAge(now) > this->maxDataAge_))
+		{
+			view->stalePackCount_++;
+			continue;
+		}
+		view->add_(pack.smartBmsData_, i);
+	}
+}
+
+/**
+ * @brief Read the available bytes of a pack within its budget and decode them.
+ * @param pack index of the pack
+ * @return number of frames decoded
+ */
+const size_t SmartBmsBank::servicePack_(const uint8_t pack)
+{
+	SmartBmsPack &smartBmsPack = this->packs_[pack];
+	const int available = smartBmsPack.inputStream_->available();
+	if (available <= 0)
+	{
+		return 0;
+	}
+
+	uint8_t buffer[SMART_BMS_BANK_BYTE_BUDGET];
+	const size_t length = available < static_cast<int>(sizeof(buffer)) ? available : sizeof(buffer);
+	const size_t readLength = smartBmsPack.inputStream_->readBytes(buffer, length);
+	if (readLength != length)
+	{
+		smartBmsPack.readErrorCount_++;
+	}
+
+	// A budget larger than a frame can complete more than one frame
+	size_t frameCount = 0;
+	size_t offset = 0;
+	while (offset < readLength)
+	{
+		size_t consumed = 0;
+		const SmartBmsError err = smartBmsPack.smartBmsReader_.feed(&buffer[offset], readLength - offset, &consumed, &smartBmsPack.smartBmsData_);
+		offset += consumed;
+		if (err == SmartBmsError::SBMS_OK)
+		{
+			smartBmsPack.hasData_ = true;
+			smartBmsPack.frameCount_++;
+			frameCount++;
+			if (this->packCallback_ != nullptr)
+			{
+				this->packCallback_(pack, &smartBmsPack.smartBmsData_, this->packCallbackContext_);
+			}
+		}
+	}
+	return frameCount;
+}
@@ -0,0 +1,167 @@
+/**
+ * @file SmartBmsBatchDecoder.cpp
+ * @author TheRealKasumi
+ * @brief Implementation of the SmartBmsBatchDecoder class.
+ * @copyright Copyright (c) 2024 TheRealKasumi
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#include "bms/SmartBmsBatchDecoder.h"
+
+#include <string.h>
+
+#include "bms/SmartBmsFrameView.h"
+
+/**
+ * @brief Verify the checksum of an aligned frame.
+ * The first 56 bytes are summed 8 bytes at a time, with every other byte in its own 16 bit lane.
+ * SmartBmsReader::calculateChecksum() is the byte wise reference for this.
+ * @param frame buffer of 58 bytes
+ * @return true when the checksum is valid
+ * @return false when the checksum is invalid
+ */
+const bool SmartBmsBatchDecoder::isChecksumValid(const uint8_t frame[SMART_BMS_FRAME_SIZE])
+{
+	// Each 16 bit lane takes at most 7 * 2 * 255, so no lane can overflow into the next one
+	const uint64_t laneMask = 0x00FF00FF00FF00FFULL;
+	uint64_t lanes = 0;
+	for (size_t i = 0; i < 56; i += 8)
+	{
+		uint64_t word;
+		memcpy(&word, &frame[i], sizeof(word));
+		lanes += (word & laneMask) + ((word >> 8) & laneMask);
+	}
+
+	// Add up the four lanes in the upper lane and add the last data byte
+	const uint32_t sum = static_cast<uint32_t>((lanes * 0x0001000100010001ULL) >> 48) + frame[56];
+	return static_cast<uint8_t>(sum) == frame[SMART_BMS_FRAME_SIZE - 1];
+}
+
+/**
+ * @brief Verify the checksum and the structure of an aligned frame.
+ * These are the checks that SmartBmsReader applies to a frame that directly follows the previous one, so both accept the same frames of an aligned capture.
+ * @param frame buffer of 58 bytes
+ * @return true when the checksum is valid and the frame is well formed, see SmartBmsFrameView::isWellFormed()
+ * @return false when the checksum is invalid or the frame is not well formed
+ */
+const bool SmartBmsBatchDecoder::isFrameValid(const uint8_t frame[SMART_BMS_FRAME_SIZE])
+{
+	return SmartBmsBatchDecoder::isChecksumValid(frame) && SmartBmsFrameView::isWellFormed(frame);
+}
+
+/**
+ * @brief Verify many aligned frames stored back to back, see isFrameValid().
+ * @param buffer buffer of frameCount * 58 bytes
+ * @param frameCount number of frames
+ * @param validBitmap receives one bit per frame, set when the frame is valid, can be nullptr
+ * @return number of valid frames
+ */
+const size_t SmartBmsBatchDecoder::validateFrames(const uint8_t *buffer, const size_t frameCount, uint8_t *validBitmap)
+{
+	if (validBitmap != nullptr)
+	{
+		memset(validBitmap, 0, (frameCount + 7) / 8);
+	}
+
+	size_t validCount = 0;
+	for (size_t i = 0; i < frameCount; i++)
+	{
+		if (SmartBmsBatchDecoder::isFrameValid(&buffer[i * SMART_BMS_FRAME_SIZE]))
+		{
+			validCount++;
+			if (validBitmap != nullptr)
+			{
+				validBitmap[i / 8] |= 1 << (i % 8);
+			}
+		}
+	}
+	return validCount;
+}
+
+/**
+ * @brief Verify and decode many aligned frames stored back to back, see isFrameValid().
+ * Invalid frames leave their record with an empty field mask.
+ * All decoded fields count as changed, markChangedFields() compares the records with each other when that is needed.
+ * @param buffer buffer of frameCount * 58 bytes
+ * @param frameCount number of frames
+ * @param smartBmsData array of frameCount records that receive the data
+ * @param validBitmap receives one bit per frame, set when the frame is valid, can be nullptr
+ * @param fieldMask mask of the fields to decode, see SBMS_FIELD_MASK
+ * @return number of valid frames
+ */
+const size_t SmartBmsBatchDecoder::decodeFrames(const uint8_t *buffer, const size_t frameCount, SmartBmsData *smartBmsData, uint8_t *validBitmap, const uint32_t fieldMask)
+{
+	if (validBitmap != nullptr)
+	{
+		memset(validBitmap, 0, (frameCount + 7) / 8);
+	}
+
+	size_t validCount = 0;
+	for (size_t i = 0; i < frameCount; i++)
+	{
+		// Frames from a buffer have no receive time
+		const uint8_t *frame = &buffer[i * SMART_BMS_FRAME_SIZE];
+		smartBmsData[i].timestamp_ = 0;
+		if (!SmartBmsBatchDecoder::isFrameValid(frame))
+		{
+			smartBmsData[i].fieldMask_ = 0;
+			smartBmsData[i].changedMask_ = 0;
+			continue;
+		}
+
+		// Decode straight from the buffer without copying the frame
+		smartBmsData[i].fieldMask_ = fieldMask & SBMS_FIELD_MASK_ALL;
+		for (size_t j = 0; j < SBMS_FIELD_COUNT; j++)
+		{
+			if (fieldMask & SBMS_FIELD_MASK(j))
+			{
+				smartBmsData[i].values_[j] = SmartBmsFields::decodeRawValue(frame, static_cast<SmartBmsField>(j));
+			}
+		}
+		smartBmsData[i].changedMask_ = smartBmsData[i].fieldMask_;
+
+		validCount++;
+		if (validBitmap != nullptr)
+		{
+			validBitmap[i / 8] |= 1 << (i % 8);
+		}
+	}
+	return validCount;
+}
+
+/**
+ * @brief Mark the fields that changed since the previous valid frame, for records decoded by decodeFrames().
+ * This is a separate pass, so decoding stays as fast as possible when the changes are not needed.
+ * All fields of the first valid record count as changed.
+ * @param buffer buffer of frameCount * 58 bytes that was decoded
+ * @param frameCount number of frames
+ * @param smartBmsData array of frameCount records that were decoded from the buffer
+ */
+void SmartBmsBatchDecoder::markChangedFields(const uint8_t *buffer, const size_t frameCount, SmartBmsData *smartBmsData)
+{
+	const uint8_t *previousFrame = nullptr;
+	for (size_t i = 0; i < frameCount; i++)
+	{
+		// Invalid frames were left with an empty field mask
+		if (smartBmsData[i].fieldMask_ == 0)
+		{
+			continue;
+		}
+
+		const uint8_t *frame = &buffer[i * SMART_BMS_FRAME_SIZE];
+		smartBmsData[i].changedMask_ = previousFrame != nullptr ? SmartBmsFields::getChangedMask(frame, previousFrame, smartBmsData[i].fieldMask_) : smartBmsData[i].fieldMask_;
+		previousFrame = frame;
+	}
+}
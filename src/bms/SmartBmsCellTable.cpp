@@ -0,0 +1,292 @@
+/**
+ * @file SmartBmsCellTable.cpp
+ * @author TheRealKasumi
+ * @brief Contains a table with the voltage and temperature of every cell, which is filled from the rotating cell data.
+ * @copyright Copyright (c) 2024 TheRealKasumi
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#include "bms/SmartBmsCellTable.h"
+
+#ifdef SMART_BMS_CELL_DATA
+
+#include <string.h>
+
+/**
+ * @brief Create a new instance of SmartBmsCellTable.
+ */
+SmartBmsCellTable::SmartBmsCellTable()
+{
+	this->frameCount_ = 0;
+	this->clear();
+}
+
+/**
+ * @brief Destroy the SmartBmsCellTable instance.
+ */
+SmartBmsCellTable::~SmartBmsCellTable()
+{
+}
+
+/**
+ * @brief Update the table with the cell data of a frame. Only the cell fields are decoded.
+ * Every frame carries the data of a single cell, so the table is complete after one sweep over all cells.
+ * When the cell count changes in two frames in a row, the table is cleared. A single frame with a different count is ignored.
+ * @param frameView frame received from the BMS
+ * @return true when a cell was updated
+ * @return false when the frame contains no cell data or the cell number is out of range
+ */
+const bool SmartBmsCellTable::update(const SmartBmsFrameView &frameView)
+{
+	return this->update_(frameView.getRawValue(SBMS_FIELD_CELL_COUNT),
+						 frameView.getRawValue(SBMS_FIELD_CELL_NUMBER),
+						 frameView.getRawValue(SBMS_FIELD_CELL_VOLTAGE),
+						 frameView.getRawValue(SBMS_FIELD_CELL_TEMPERATURE));
+}
+
+/**
+ * @brief Update the table with the cell data of decoded BMS data.
+ * See update(const SmartBmsFrameView &) for details.
+ * @param smartBmsData decoded data, the cell count and all cell fields must be decoded
+ * @return true when a cell was updated
+ * @return false when the data contains no cell data or the cell number is out of range
+ */
+const bool SmartBmsCellTable::update(const SmartBmsData &smartBmsData)
+{
+	const uint32_t requiredMask = SBMS_FIELD_MASK(SBMS_FIELD_CELL_COUNT) | SBMS_FIELD_MASK(SBMS_FIELD_CELL_NUMBER) |
+								  SBMS_FIELD_MASK(SBMS_FIELD_CELL_VOLTAGE) | SBMS_FIELD_MASK(SBMS_FIELD_CELL_TEMPERATURE);
+	if ((smartBmsData.getFieldMask() & requiredMask) != requiredMask)
+	{
+		this->frameCount_++;
+		return false;
+	}
+
+	return this->update_(smartBmsData.getRawValue(SBMS_FIELD_CELL_COUNT),
+						 smartBmsData.getRawValue(SBMS_FIELD_CELL_NUMBER),
+						 smartBmsData.getRawValue(SBMS_FIELD_CELL_VOLTAGE),
+						 smartBmsData.getRawValue(SBMS_FIELD_CELL_TEMPERATURE));
+}
+
+/**
+ * @brief Remove all cells from the table. The frame counter keeps running.
+ */
+void SmartBmsCellTable::clear()
+{
+	this->cellCount_ = 0;
+	this->pendingCellCount_ = 0;
+	this->hasPendingCellCount_ = false;
+	memset(this->voltages_, 0, sizeof(this->voltages_));
+	memset(this->temperatures_, 0, sizeof(this->temperatures_));
+	memset(this->updateFrames_, 0, sizeof(this->updateFrames_));
+	memset(this->validMask_, 0, sizeof(this->validMask_));
+	memset(this->sweepMask_, 0, sizeof(this->sweepMask_));
+	this->validCount_ = 0;
+	this->sweepLength_ = 0;
+	this->sweepCount_ = 0;
+}
+
+/**
+ * @brief Get the number of cells reported by the BMS.
+ * @return number of cells, can be larger than SMART_BMS_MAX_CELL_COUNT
+ */
+const uint8_t SmartBmsCellTable::getCellCount() const
+{
+	return this->cellCount_;
+}
+
+/**
+ * @brief Check if data for a cell was received.
+ * @param cellNumber number of the cell, starting at 1
+ * @return true when the cell was updated at least once
+ */
+const bool SmartBmsCellTable::hasCell(const uint8_t cellNumber) const
+{
+	if (cellNumber == 0 || cellNumber > this->getTableSize_())
+	{
+		return false;
+	}
+	const uint8_t index = cellNumber - 1;
+	return this->validMask_[index / 32] & (1UL << (index % 32));
+}
+
+/**
+ * @brief Get the last voltage of a cell.
+ * @param cellNumber number of the cell, starting at 1
+ * @return voltage in mV, 0 when the cell has no data
+ */
+const uint32_t SmartBmsCellTable::getCellVoltageMillivolts(const uint8_t cellNumber) const
+{
+	if (!this->hasCell(cellNumber))
+	{
+		return 0;
+	}
+	return SmartBmsFields::toFixedValue(SBMS_FIELD_CELL_VOLTAGE, this->voltages_[cellNumber - 1]);
+}
+
+/**
+ * @brief Get the last temperature of a cell.
+ * @param cellNumber number of the cell, starting at 1
+ * @return temperature in m°C, 0 when the cell has no data
+ */
+const int32_t SmartBmsCellTable::getCellTemperatureMillicelsius(const uint8_t cellNumber) const
+{
+	if (!this->hasCell(cellNumber))
+	{
+		return 0;
+	}
+	return SmartBmsFields::toFixedValue(SBMS_FIELD_CELL_TEMPERATURE, this->temperatures_[cellNumber - 1]);
+}
+
+#ifndef SMART_BMS_FIXED_POINT
+/**
+ * @brief Get the last voltage of a cell.
+ * @param cellNumber number of the cell, starting at 1
+ * @return voltage in V, 0 when the cell has no data
+ */
+const float SmartBmsCellTable::getCellVoltage(const uint8_t cellNumber) const
+{
+	if (!this->hasCell(cellNumber))
+	{
+		return 0.0f;
+	}
+	return SmartBmsFields::toFloatValue(SBMS_FIELD_CELL_VOLTAGE, this->voltages_[cellNumber - 1]);
+}
+
+/**
+ * @brief Get the last temperature of a cell.
+ * @param cellNumber number of the cell, starting at 1
+ * @return temperature in °C, 0 when the cell has no data
+ */
+const float SmartBmsCellTable::getCellTemperature(const uint8_t cellNumber) const
+{
+	if (!this->hasCell(cellNumber))
+	{
+		return 0.0f;
+	}
+	return SmartBmsFields::toFloatValue(SBMS_FIELD_CELL_TEMPERATURE, this->temperatures_[cellNumber - 1]);
+}
+#endif
+
+/**
+ * @brief Get the number of frames that were received since a cell was updated.
+ * @param cellNumber number of the cell, starting at 1
+ * @return age in frames, 0 when the last frame updated the cell, SMART_BMS_CELL_AGE_UNKNOWN when the cell has no data
+ */
+const uint32_t SmartBmsCellTable::getCellAge(const uint8_t cellNumber) const
+{
+	if (!this->hasCell(cellNumber))
+	{
+		return SMART_BMS_CELL_AGE_UNKNOWN;
+	}
+	return this->frameCount_ - this->updateFrames_[cellNumber - 1];
+}
+
+/**
+ * @brief Check if data was received for every cell.
+ * @return true when every cell of the table was updated at least once
+ */
+const bool SmartBmsCellTable::isComplete() const
+{
+	return this->getTableSize_() > 0 && this->validCount_ == this->getTableSize_();
+}
+
+/**
+ * @brief Get the number of completed sweeps. A sweep is complete when every cell was updated again.
+ * Compare the value with a previous one to detect a new sweep.
+ * @return number of sweeps since the table was cleared
+ */
+const uint32_t SmartBmsCellTable::getSweepCount() const
+{
+	return this->sweepCount_;
+}
+
+/**
+ * @brief Get the number of frames passed to the table.
+ * @return number of frames
+ */
+const uint32_t SmartBmsCellTable::getFrameCount() const
+{
+	return this->frameCount_;
+}
+
+/**
+ * @brief Store the data of a single cell.
+ * @param cellCount number of cells reported by the frame
+ * @param cellNumber number of the cell, starting at 1, 0 when the frame has no cell data
+ * @param voltage raw voltage
+ * @param temperature raw temperature
+ * @return true when the cell was updated
+ */
+const bool SmartBmsCellTable::update_(const uint8_t cellCount, const uint8_t cellNumber, const uint16_t voltage, const uint16_t temperature)
+{
+	this->frameCount_++;
+	if (cellCount == this->cellCount_)
+	{
+		this->hasPendingCellCount_ = false;
+	}
+	else if (this->cellCount_ != 0 && (!this->hasPendingCellCount_ || this->pendingCellCount_ != cellCount))
+	{
+		// A corrupted frame must not wipe the table, so a new count only counts once the next frame repeats it
+		this->pendingCellCount_ = cellCount;
+		this->hasPendingCellCount_ = true;
+		return false;
+	}
+	else
+	{
+		this->clear();
+		this->cellCount_ = cellCount;
+	}
+	if (cellNumber == 0 || cellNumber > this->getTableSize_())
+	{
+		return false;
+	}
+
+	// Store the cell
+	const uint8_t index = cellNumber - 1;
+	const uint32_t bit = 1UL << (index % 32);
+	this->voltages_[index] = voltage;
+	this->temperatures_[index] = temperature;
+	this->updateFrames_[index] = this->frameCount_;
+	if (!(this->validMask_[index / 32] & bit))
+	{
+		this->validMask_[index / 32] |= bit;
+		this->validCount_++;
+	}
+
+	// Start a new sweep once every cell was seen
+	if (!(this->sweepMask_[index / 32] & bit))
+	{
+		this->sweepMask_[index / 32] |= bit;
+		this->sweepLength_++;
+		if (this->sweepLength_ == this->getTableSize_())
+		{
+			memset(this->sweepMask_, 0, sizeof(this->sweepMask_));
+			this->sweepLength_ = 0;
+			this->sweepCount_++;
+		}
+	}
+	return true;
+}
+
+/**
+ * @brief Get the number of cells that are stored in the table.
+ * @return cell count, limited to SMART_BMS_MAX_CELL_COUNT
+ */
+const uint8_t SmartBmsCellTable::getTableSize_() const
+{
+	return this->cellCount_ < SMART_BMS_MAX_CELL_COUNT ? this->cellCount_ : SMART_BMS_MAX_CELL_COUNT;
+}
+
+#endif
@@ -0,0 +1,40 @@
+/**
+ * @file SmartBmsClock.cpp
+ * @author TheRealKasumi
+ * @brief Implementation of the SmartBmsSystemClock class.
+ * @copyright Copyright (c) 2024 TheRealKasumi
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#include "bms/SmartBmsClock.h"
+
+#if defined(ARDUINO)
+#include <Arduino.h>
+#else
+#include <chrono>
+#endif
+
+/**
+ * @brief Get the time of the system clock, micros() on Arduino and the steady clock on the host.
+ * @return time in µs, wraps around after about 71 minutes
+ */
+const uint32_t SmartBmsSystemClock::getMicros()
+{
+#if defined(ARDUINO)
+	return micros();
+#else
+	return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
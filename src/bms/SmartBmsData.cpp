@@ -25,32 +25,13 @@
  */
 SmartBmsData::SmartBmsData()
 {
-	this->cellCount_ = 0;
-	this->cellVoltageMin_ = 0.0f;
-	this->cellVoltageMax_ = 0.0f;
-	this->cellVoltageBalance_ = 0.0f;
-	this->packSoc_ = 0;
-	this->packVoltage_ = 0.0f;
-	this->packCurrent_ = 0.0f;
-	this->packChargeCurrent_ = 0.0f;
-	this->packDischargeCurrent_ = 0.0f;
-	this->packCapacity_ = 0.0f;
-	this->packRemainingEnergy_ = 0.0f;
-	this->lowestCellVoltage_ = 0.0f;
-	this->lowestCellVoltageNumber_ = 0;
-	this->highestCellVoltage_ = 0.0f;
-	this->highestCellVoltageNumber_ = 0;
-	this->lowestCellTemperature_ = 0.0f;
-	this->lowestCellTemperatureNumber_ = 0;
-	this->highestCellTemperature_ = 0.0f;
-	this->highestCellTemperatureNumber_ = 0;
-	this->communicationError_ = 0;
-	this->allowedToCharge_ = 0;
-	this->allowedToDischarge_ = 0;
-	this->minVoltageAlarmActive_ = 0;
-	this->maxVoltageAlarmActive_ = 0;
-	this->minTemperatureAlarmActive_ = 0;
-	this->maxTemperatureAlarmActive_ = 0;
+	this->fieldMask_ = 0;
+	this->changedMask_ = 0;
+	this->timestamp_ = 0;
+	for (size_t i = 0; i < SBMS_FIELD_COUNT; i++)
+	{
+		this->values_[i] = 0;
+	}
 }
 
 /**
@@ -60,132 +41,320 @@ SmartBmsData::~SmartBmsData()
 {
 }
 
+/**
+ * @brief Get the mask of fields that were decoded.
+ * @return bit mask with SBMS_FIELD_MASK(field) set for every decoded field
+ */
+const uint32_t SmartBmsData::getFieldMask() const
+{
+	return this->fieldMask_;
+}
+
+/**
+ * @brief Check if a field was decoded.
+ * @param field field to check
+ * @return true when the field was decoded
+ * @return false when the field was skipped
+ */
+const bool SmartBmsData::hasField(const SmartBmsField field) const
+{
+	return this->fieldMask_ & SBMS_FIELD_MASK(field);
+}
+
+/**
+ * @brief Get the mask of fields that changed compared to the previous frame.
+ * Without a previous frame, every decoded field counts as changed.
+ * @return bit mask with SBMS_FIELD_MASK(field) set for every changed field
+ */
+const uint32_t SmartBmsData::getChangedMask() const
+{
+	return this->changedMask_;
+}
+
+/**
+ * @brief Check if a field changed compared to the previous frame.
+ * @param field field to check
+ * @return true when the field changed
+ * @return false when the field has the same value or was not decoded
+ */
+const bool SmartBmsData::hasChanged(const SmartBmsField field) const
+{
+	return this->changedMask_ & SBMS_FIELD_MASK(field);
+}
+
+/**
+ * @brief Get the time when the first byte of the frame was received.
+ * @return time in µs of the clock of the reader, see SmartBmsClock
+ */
+const uint32_t SmartBmsData::getTimestamp() const
+{
+	return this->timestamp_;
+}
+
+/**
+ * @brief Get the age of the data, so stale data can be rejected.
+ * @param now current time in µs of the same clock as the timestamp
+ * @return age in µs
+ */
+const uint32_t SmartBmsData::getAge(const uint32_t now) const
+{
+	return now - this->timestamp_;
+}
+
+/**
+ * @brief Get the raw value of a field as it was transmitted.
+ * @param field field to get
+ * @return raw value
+ */
+const int32_t SmartBmsData::getRawValue(const SmartBmsField field) const
+{
+	return this->values_[field];
+}
+
+/**
+ * @brief Get the value of a field in integer units, see SMART_BMS_FIELDS for the unit.
+ * @param field field to get
+ * @return value in integer units
+ */
+const int32_t SmartBmsData::getFixedValue(const SmartBmsField field) const
+{
+	return SmartBmsFields::toFixedValue(field, this->values_[field]);
+}
+
+#ifndef SMART_BMS_FIXED_POINT
+/**
+ * @brief Get the value of a field in physical units, see SMART_BMS_FIELDS for the unit.
+ * @param field field to get
+ * @return value in physical units
+ */
+const float SmartBmsData::getValue(const SmartBmsField field) const
+{
+	return SmartBmsFields::toFloatValue(field, this->values_[field]);
+}
+#endif
+
 const uint8_t SmartBmsData::getCellCount() const
 {
-	return this->cellCount_;
+	return this->values_[SBMS_FIELD_CELL_COUNT];
 }
 
-const float SmartBmsData::getCellVoltageMin() const
+const uint32_t SmartBmsData::getCellVoltageMinMillivolts() const
 {
-	return this->cellVoltageMin_;
+	return this->getFixedValue(SBMS_FIELD_CELL_VOLTAGE_MIN);
 }
 
-const float SmartBmsData::getCellVoltageMax() const
+const uint32_t SmartBmsData::getCellVoltageMaxMillivolts() const
 {
-	return this->cellVoltageMax_;
+	return this->getFixedValue(SBMS_FIELD_CELL_VOLTAGE_MAX);
 }
 
-const float SmartBmsData::getCellVoltageBalance() const
+const uint32_t SmartBmsData::getCellVoltageBalanceMillivolts() const
 {
-	return this->cellVoltageBalance_;
+	return this->getFixedValue(SBMS_FIELD_CELL_VOLTAGE_BALANCE);
 }
 
 const uint8_t SmartBmsData::getPackSoc() const
 {
-	return this->packSoc_;
+	return this->values_[SBMS_FIELD_PACK_SOC];
 }
 
-const float SmartBmsData::getPackVoltage() const
+const uint32_t SmartBmsData::getPackVoltageMillivolts() const
 {
-	return this->packVoltage_;
+	return this->getFixedValue(SBMS_FIELD_PACK_VOLTAGE);
 }
 
-const float SmartBmsData::getPackCurrent() const
+const int32_t SmartBmsData::getPackCurrentMilliamps() const
 {
-	return this->packCurrent_;
+	return this->getFixedValue(SBMS_FIELD_PACK_CURRENT);
 }
 
-const float SmartBmsData::getPackChargeCurrent() const
+const int32_t SmartBmsData::getPackChargeCurrentMilliamps() const
 {
-	return this->packChargeCurrent_;
+	return this->getFixedValue(SBMS_FIELD_PACK_CHARGE_CURRENT);
 }
 
-const float SmartBmsData::getPackDischargeCurrent() const
+const int32_t SmartBmsData::getPackDischargeCurrentMilliamps() const
 {
-	return this->packDischargeCurrent_;
+	return this->getFixedValue(SBMS_FIELD_PACK_DISCHARGE_CURRENT);
 }
 
-const float SmartBmsData::getPackCapacity() const
+const uint32_t SmartBmsData::getPackCapacityWattHours() const
 {
-	return this->packCapacity_;
+	return this->getFixedValue(SBMS_FIELD_PACK_CAPACITY);
 }
 
-const float SmartBmsData::getPackRemainingEnergy() const
+const uint32_t SmartBmsData::getPackRemainingEnergyWattHours() const
 {
-	return this->packRemainingEnergy_;
+	return this->getFixedValue(SBMS_FIELD_PACK_REMAINING_ENERGY);
 }
 
-const float SmartBmsData::getLowestCellVoltage() const
+const uint32_t SmartBmsData::getLowestCellVoltageMillivolts() const
 {
-	return this->lowestCellVoltage_;
+	return this->getFixedValue(SBMS_FIELD_LOWEST_CELL_VOLTAGE);
 }
 
 const uint8_t SmartBmsData::getLowestCellVoltageNumber() const
 {
-	return this->lowestCellVoltageNumber_;
+	return this->values_[SBMS_FIELD_LOWEST_CELL_VOLTAGE_NUMBER];
 }
 
-const float SmartBmsData::getHighestCellVoltage() const
+const uint32_t SmartBmsData::getHighestCellVoltageMillivolts() const
 {
-	return this->highestCellVoltage_;
+	return this->getFixedValue(SBMS_FIELD_HIGHEST_CELL_VOLTAGE);
 }
 
 const uint8_t SmartBmsData::getHighestCellVoltageNumber() const
 {
-	return this->highestCellTemperatureNumber_;
+	return this->values_[SBMS_FIELD_HIGHEST_CELL_VOLTAGE_NUMBER];
 }
 
-const float SmartBmsData::getLowestCellTemperature() const
+const int32_t SmartBmsData::getLowestCellTemperatureMillicelsius() const
 {
-	return this->highestCellTemperature_;
+	return this->getFixedValue(SBMS_FIELD_LOWEST_CELL_TEMPERATURE);
 }
 
 const uint8_t SmartBmsData::getLowestCellTemperatureNumber() const
 {
-	return this->lowestCellTemperatureNumber_;
+	return this->values_[SBMS_FIELD_LOWEST_CELL_TEMPERATURE_NUMBER];
 }
 
-const float SmartBmsData::getHighestCellTemperature() const
+const int32_t SmartBmsData::getHighestCellTemperatureMillicelsius() const
 {
-	return this->highestCellTemperature_;
+	return this->getFixedValue(SBMS_FIELD_HIGHEST_CELL_TEMPERATURE);
 }
 
 const uint8_t SmartBmsData::getHighestCellTemperatureNumber() const
 {
-	return this->highestCellTemperatureNumber_;
+	return this->values_[SBMS_FIELD_HIGHEST_CELL_TEMPERATURE_NUMBER];
 }
 
 const bool SmartBmsData::hasCommunicationError() const
 {
-	return this->communicationError_;
+	return this->values_[SBMS_FIELD_COMMUNICATION_ERROR] != 0;
 }
 
 const bool SmartBmsData::isAllowedToCharge() const
 {
-	return this->allowedToCharge_;
+	return this->values_[SBMS_FIELD_ALLOWED_TO_CHARGE] != 0;
 }
 
 const bool SmartBmsData::isAllowedToDischarge() const
 {
-	return this->allowedToDischarge_;
+	return this->values_[SBMS_FIELD_ALLOWED_TO_DISCHARGE] != 0;
 }
 
 const bool SmartBmsData::isMinVoltageAlarmActive() const
 {
-	return this->minVoltageAlarmActive_;
+	return this->values_[SBMS_FIELD_MIN_VOLTAGE_ALARM] != 0;
 }
 
 const bool SmartBmsData::isMaxVoltageAlarmActive() const
 {
-	return this->maxVoltageAlarmActive_;
+	return this->values_[SBMS_FIELD_MAX_VOLTAGE_ALARM] != 0;
 }
 
 const bool SmartBmsData::isMinTemperatureAlarmActive() const
 {
-	return this->minTemperatureAlarmActive_;
+	return this->values_[SBMS_FIELD_MIN_TEMPERATURE_ALARM] != 0;
 }
 
 const bool SmartBmsData::isMaxTemperatureAlarmActive() const
 {
-	return this->maxTemperatureAlarmActive_;
+	return this->values_[SBMS_FIELD_MAX_TEMPERATURE_ALARM] != 0;
+}
+
+#ifdef SMART_BMS_CELL_DATA
+const uint8_t SmartBmsData::getCellNumber() const
+{
+	return this->values_[SBMS_FIELD_CELL_NUMBER];
+}
+
+const uint32_t SmartBmsData::getCellVoltageMillivolts() const
+{
+	return this->getFixedValue(SBMS_FIELD_CELL_VOLTAGE);
+}
+
+const int32_t SmartBmsData::getCellTemperatureMillicelsius() const
+{
+	return this->getFixedValue(SBMS_FIELD_CELL_TEMPERATURE);
+}
+#endif
+
+#ifndef SMART_BMS_FIXED_POINT
+const float SmartBmsData::getCellVoltageMin() const
+{
+	return this->getValue(SBMS_FIELD_CELL_VOLTAGE_MIN);
+}
+
+const float SmartBmsData::getCellVoltageMax() const
+{
+	return this->getValue(SBMS_FIELD_CELL_VOLTAGE_MAX);
+}
+
+const float SmartBmsData::getCellVoltageBalance() const
+{
+	return this->getValue(SBMS_FIELD_CELL_VOLTAGE_BALANCE);
+}
+
+const float SmartBmsData::getPackVoltage() const
+{
+	return this->getValue(SBMS_FIELD_PACK_VOLTAGE);
+}
+
+const float SmartBmsData::getPackCurrent() const
+{
+	return this->getValue(SBMS_FIELD_PACK_CURRENT);
+}
+
+const float SmartBmsData::getPackChargeCurrent() const
+{
+	return this->getValue(SBMS_FIELD_PACK_CHARGE_CURRENT);
+}
+
+const float SmartBmsData::getPackDischargeCurrent() const
+{
+	return this->getValue(SBMS_FIELD_PACK_DISCHARGE_CURRENT);
+}
+
+const float SmartBmsData::getPackCapacity() const
+{
+	return this->getValue(SBMS_FIELD_PACK_CAPACITY);
+}
+
+const float SmartBmsData::getPackRemainingEnergy() const
+{
+	return this->getValue(SBMS_FIELD_PACK_REMAINING_ENERGY);
+}
+
+const float SmartBmsData::getLowestCellVoltage() const
+{
+	return this->getValue(SBMS_FIELD_LOWEST_CELL_VOLTAGE);
+}
+
+const float SmartBmsData::getHighestCellVoltage() const
+{
+	return this->getValue(SBMS_FIELD_HIGHEST_CELL_VOLTAGE);
+}
+
+const float SmartBmsData::getLowestCellTemperature() const
+{
+	return this->getValue(SBMS_FIELD_LOWEST_CELL_TEMPERATURE);
+}
+
+const float SmartBmsData::getHighestCellTemperature() const
+{
+	return this->getValue(SBMS_FIELD_HIGHEST_CELL_TEMPERATURE);
+}
+
+#ifdef SMART_BMS_CELL_DATA
+const float SmartBmsData::getCellVoltage() const
+{
+	return this->getValue(SBMS_FIELD_CELL_VOLTAGE);
+}
+
+const float SmartBmsData::getCellTemperature() const
+{
+	return this->getValue(SBMS_FIELD_CELL_TEMPERATURE);
 }
+#endif
+#endif
@@ -0,0 +1,239 @@
+/**
+ * @file SmartBmsDeltaCodec.cpp
+ * @author TheRealKasumi
+ * @brief Contains an encoder and decoder that serialize only the changed fields of the BMS data.
+ * @copyright Copyright (c) 2024 TheRealKasumi
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#include "bms/SmartBmsDeltaCodec.h"
+
+/**
+ * @brief Encode the given fields into a delta record.
+ * A record starts with the field mask as varint, followed by one byte with the values of all flags in the mask
+ * and the raw values of all other fields in the mask, in the order of the field table.
+ * Unsigned values use the width of the field table, signed values are zigzag encoded into 3 bytes, all little endian.
+ * Pass getChangedMask() to encode only what changed, or getFieldMask() for a full record to start from.
+ * @param smartBmsData data to encode
+ * @param fieldMask mask of the fields to encode, fields that were not decoded are skipped
+ * @param buffer buffer that receives the record, SMART_BMS_DELTA_MAX_SIZE bytes are always enough
+ * @param size size of the buffer
+ * @return size of the record, 0 when the buffer is too small
+ */
+const size_t SmartBmsDeltaCodec::encode(const SmartBmsData &smartBmsData, const uint32_t fieldMask, uint8_t *buffer, const size_t size)
+{
+	const uint32_t mask = fieldMask & smartBmsData.fieldMask_;
+	size_t position = 0;
+
+	// Write the mask as varint
+	if (!SmartBmsDeltaCodec::writeVarint(buffer, size, &position, mask))
+	{
+		return 0;
+	}
+
+	// Collect the flags into a single byte
+	uint8_t flags = 0;
+	uint8_t flagCount = 0;
+	for (size_t i = 0; i < SBMS_FIELD_COUNT; i++)
+	{
+		if (SMART_BMS_FIELDS[i].encoding == SBMS_ENCODING_FLAG && (mask & SBMS_FIELD_MASK(i)))
+		{
+			flags |= (smartBmsData.values_[i] != 0) << flagCount;
+			flagCount++;
+		}
+	}
+	if (flagCount > 0)
+	{
+		if (position == size)
+		{
+			return 0;
+		}
+		buffer[position++] = flags;
+	}
+
+	// Write the values
+	for (size_t i = 0; i < SBMS_FIELD_COUNT; i++)
+	{
+		const SmartBmsFieldDescriptor &descriptor = SMART_BMS_FIELDS[i];
+		if (!(mask & SBMS_FIELD_MASK(i)) || descriptor.encoding == SBMS_ENCODING_FLAG)
+		{
+			continue;
+		}
+		if (size - position < descriptor.width)
+		{
+			return 0;
+		}
+
+		const int32_t rawValue = smartBmsData.values_[i];
+		const uint32_t value = descriptor.encoding == SBMS_ENCODING_SIGNED ? SmartBmsDeltaCodec::zigzagEncode(rawValue) : rawValue;
+		for (uint8_t j = 0; j < descriptor.width; j++)
+		{
+			buffer[position++] = value >> (8 * j);
+		}
+	}
+	return position;
+}
+
+/**
+ * @brief Apply a delta record to the data. Fields that are not in the record keep their value.
+ * The changed mask of the data is set to the fields of the record.
+ * @param buffer buffer with the record
+ * @param length number of bytes in the buffer
+ * @param consumed receives the size of the record
+ * @param smartBmsData data the record is applied to, must hold the state the record was encoded against
+ * @return SmartBmsError::SBMS_OK when the record was applied
+ * @return SmartBmsError::SBMS_ERR_NOT_ENOUGH_DATA when the buffer ends within the record, the data is unchanged
+ * @return SmartBmsError::SBMS_ERR_INVALID_DATA when the record contains unknown fields, the data is unchanged
+ */
+const SmartBmsError SmartBmsDeltaCodec::decode(const uint8_t *buffer, const size_t length, size_t *consumed, SmartBmsData *smartBmsData)
+{
+	size_t position = 0;
+
+	// Read the mask
+	uint32_t mask = 0;
+	const SmartBmsError err = SmartBmsDeltaCodec::readVarint(buffer, length, &position, &mask);
+	if (err != SmartBmsError::SBMS_OK)
+	{
+		return err;
+	}
+	if (mask & ~SBMS_FIELD_MASK_ALL)
+	{
+		return SmartBmsError::SBMS_ERR_INVALID_DATA;
+	}
+
+	// Check the size first, so the data is not modified by an incomplete record
+	size_t recordSize = position;
+	bool hasFlags = false;
+	for (size_t i = 0; i < SBMS_FIELD_COUNT; i++)
+	{
+		if (mask & SBMS_FIELD_MASK(i))
+		{
+			hasFlags |= SMART_BMS_FIELDS[i].encoding == SBMS_ENCODING_FLAG;
+			recordSize += SMART_BMS_FIELDS[i].encoding == SBMS_ENCODING_FLAG ? 0 : SMART_BMS_FIELDS[i].width;
+		}
+	}
+	recordSize += hasFlags;
+	if (recordSize > length)
+	{
+		return SmartBmsError::SBMS_ERR_NOT_ENOUGH_DATA;
+	}
+
+	// Apply the flags
+	const uint8_t flags = hasFlags ? buffer[position++] : 0;
+	uint8_t flagCount = 0;
+	for (size_t i = 0; i < SBMS_FIELD_COUNT; i++)
+	{
+		if (SMART_BMS_FIELDS[i].encoding == SBMS_ENCODING_FLAG && (mask & SBMS_FIELD_MASK(i)))
+		{
+			smartBmsData->values_[i] = (flags >> flagCount) & 1;
+			flagCount++;
+		}
+	}
+
+	// Apply the values
+	for (size_t i = 0; i < SBMS_FIELD_COUNT; i++)
+	{
+		const SmartBmsFieldDescriptor &descriptor = SMART_BMS_FIELDS[i];
+		if (!(mask & SBMS_FIELD_MASK(i)) || descriptor.encoding == SBMS_ENCODING_FLAG)
+		{
+			continue;
+		}
+
+		uint32_t value = 0;
+		for (uint8_t j = 0; j < descriptor.width; j++)
+		{
+			value |= static_cast<uint32_t>(buffer[position++]) << (8 * j);
+		}
+		smartBmsData->values_[i] = descriptor.encoding == SBMS_ENCODING_SIGNED ? SmartBmsDeltaCodec::zigzagDecode(value) : value;
+	}
+
+	smartBmsData->fieldMask_ |= mask;
+	smartBmsData->changedMask_ = mask;
+	*consumed = position;
+	return SmartBmsError::SBMS_OK;
+}
+
+/**
+ * @brief Write a varint with 7 bits per byte, the lowest bits first.
+ * @param buffer buffer to write to
+ * @param size size of the buffer
+ * @param position position in the buffer, is moved behind the varint
+ * @param value value to write
+ * @return true when the varint was written
+ * @return false when the buffer is too small
+ */
+const bool SmartBmsDeltaCodec::writeVarint(uint8_t *buffer, const size_t size, size_t *position, const uint32_t value)
+{
+	uint32_t remaining = value;
+	do
+	{
+		if (*position >= size)
+		{
+			return false;
+		}
+		buffer[(*position)++] = (remaining & 0x7F) | (remaining > 0x7F ? 0x80 : 0);
+		remaining >>= 7;
+	} while (remaining != 0);
+	return true;
+}
+
+/**
+ * @brief Read a varint with 7 bits per byte, the lowest bits first.
+ * @param buffer buffer to read from
+ * @param length number of bytes in the buffer
+ * @param position position in the buffer, is moved behind the varint
+ * @param value receives the value
+ * @return SmartBmsError::SBMS_OK when a complete varint was read
+ * @return SmartBmsError::SBMS_ERR_NOT_ENOUGH_DATA when the buffer ends within the varint
+ * @return SmartBmsError::SBMS_ERR_INVALID_DATA when the varint is longer than 5 bytes
+ */
+const SmartBmsError SmartBmsDeltaCodec::readVarint(const uint8_t *buffer, const size_t length, size_t *position, uint32_t *value)
+{
+	*value = 0;
+	for (uint8_t shift = 0; shift <= 28; shift += 7)
+	{
+		if (*position >= length)
+		{
+			return SmartBmsError::SBMS_ERR_NOT_ENOUGH_DATA;
+		}
+		const uint8_t byte = buffer[(*position)++];
+		*value |= static_cast<uint32_t>(byte & 0x7F) << shift;
+		if (!(byte & 0x80))
+		{
+			return SmartBmsError::SBMS_OK;
+		}
+	}
+	return SmartBmsError::SBMS_ERR_INVALID_DATA;
+}
+
+/**
+ * @brief Map a signed value to an unsigned one, so that small negative values stay small.
+ * @param value signed value
+ * @return zigzag encoded value
+ */
+const uint32_t SmartBmsDeltaCodec::zigzagEncode(const int32_t value)
+{
+	return (static_cast<uint32_t>(value) << 1) ^ static_cast<uint32_t>(value >> 31);
+}
+
+/**
+ * @brief Reverse zigzagEncode().
+ * @param value zigzag encoded value
+ * @return signed value
+ */
+const int32_t SmartBmsDeltaCodec::zigzagDecode(const uint32_t value)
+{
+	return static_cast<int32_t>((value >> 1) ^ (0 - (value & 1)));
+}
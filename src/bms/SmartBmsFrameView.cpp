@@ -0,0 +1,444 @@
+/**
+ * @file SmartBmsFrameView.cpp
+ * @author TheRealKasumi
+ * @brief Implementation of the SmartBmsFrameView class.
+ * @copyright Copyright (c) 2024 TheRealKasumi
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#include "bms/SmartBmsFrameView.h"
+
+#include <string.h>
+
+/**
+ * @brief Create a new instance of SmartBmsFrameView with an empty frame.
+ */
+SmartBmsFrameView::SmartBmsFrameView()
+{
+	memset(this->frame_, 0, sizeof(this->frame_));
+	this->timestamp_ = 0;
+}
+
+/**
+ * @brief Create a new instance of SmartBmsFrameView from an aligned frame with a valid checksum.
+ * @param frame buffer of 58 bytes, it is copied
+ * @param timestamp time in µs when the first byte of the frame was received, see SmartBmsClock
+ */
+SmartBmsFrameView::SmartBmsFrameView(const uint8_t frame[SMART_BMS_FRAME_SIZE], const uint32_t timestamp)
+{
+	memcpy(this->frame_, frame, sizeof(this->frame_));
+	this->timestamp_ = timestamp;
+}
+
+/**
+ * @brief Destroy the SmartBmsFrameView instance.
+ */
+SmartBmsFrameView::~SmartBmsFrameView()
+{
+}
+
+/**
+ * @brief Get the raw frame.
+ * @return pointer to the 58 bytes of the frame
+ */
+const uint8_t *SmartBmsFrameView::getFrame() const
+{
+	return this->frame_;
+}
+
+/**
+ * @brief Get the time when the first byte of the frame was received.
+ * @return time in µs of the clock of the reader, 0 when the frame was not received by a reader
+ */
+const uint32_t SmartBmsFrameView::getTimestamp() const
+{
+	return this->timestamp_;
+}
+
+/**
+ * @brief Decode the fields of the frame. The decoder is generated from the field table.
+ * All decoded fields are marked as changed.
+ * @param smartBmsData reference to a SmartBmsData object that will receive the data
+ * @param fieldMask mask of the fields to decode, see SBMS_FIELD_MASK
+ */
+void SmartBmsFrameView::decode(SmartBmsData *smartBmsData, const uint32_t fieldMask) const
+{
+	smartBmsData->fieldMask_ = fieldMask & SBMS_FIELD_MASK_ALL;
+	smartBmsData->changedMask_ = smartBmsData->fieldMask_;
+	smartBmsData->timestamp_ = this->timestamp_;
+	for (size_t i = 0; i < SBMS_FIELD_COUNT; i++)
+	{
+		if (fieldMask & SBMS_FIELD_MASK(i))
+		{
+			smartBmsData->values_[i] = SmartBmsFields::decodeRawValue(this->frame_, static_cast<SmartBmsField>(i));
+		}
+	}
+}
+
+/**
+ * @brief Decode the fields of the frame and mark the fields that changed compared to the previous frame.
+ * @param smartBmsData reference to a SmartBmsData object that will receive the data
+ * @param fieldMask mask of the fields to decode, see SBMS_FIELD_MASK
+ * @param previousFrame frame that was received before this one
+ */
+void SmartBmsFrameView::decode(SmartBmsData *smartBmsData, const uint32_t fieldMask, const SmartBmsFrameView &previousFrame) const
+{
+	this->decode(smartBmsData, fieldMask);
+	smartBmsData->changedMask_ = this->getChangedMask(previousFrame, smartBmsData->fieldMask_);
+}
+
+/**
+ * @brief Get the fields whose value differs from the previous frame.
+ * @param previousFrame frame that was received before this one
+ * @param fieldMask mask of the fields to compare, see SBMS_FIELD_MASK
+ * @return bit mask with SBMS_FIELD_MASK(field) set for every changed field
+ */
+const uint32_t SmartBmsFrameView::getChangedMask(const SmartBmsFrameView &previousFrame, const uint32_t fieldMask) const
+{
+	return SmartBmsFields::getChangedMask(this->frame_, previousFrame.frame_, fieldMask);
+}
+
+/**
+ * @brief Check if the structure of a frame is consistent, independent of the state of the pack.
+ * These checks hold for every real frame, even one of a deeply discharged or failed cell.
+ * The configured cell voltage limits are settings of the BMS and not measurements, so they are checked as well.
+ * @param frame buffer of 58 bytes
+ * @return true when the cell count, the order of the cell voltages, the configured limits, the cell numbers and the state of charge are valid
+ */
+const bool SmartBmsFrameView::isWellFormed(const uint8_t frame[SMART_BMS_FRAME_SIZE])
+{
+	const uint32_t cellCount = SmartBmsFields::decodeRawValue(frame, SBMS_FIELD_CELL_COUNT);
+	if (cellCount == 0 || cellCount > SMART_BMS_PLAUSIBLE_MAX_CELL_COUNT)
+	{
+		return false;
+	}
+
+	// The lowest cell can not be above the highest cell
+	if (SmartBmsFields::decodeRawValue(frame, SBMS_FIELD_LOWEST_CELL_VOLTAGE) > SmartBmsFields::decodeRawValue(frame, SBMS_FIELD_HIGHEST_CELL_VOLTAGE))
+	{
+		return false;
+	}
+
+	// The configured cell voltage limits are in the range of a cell and ordered, they are at the end of the frame where a shift shows first
+	const uint32_t cellVoltageMin = SmartBmsFields::toFixedValue(SBMS_FIELD_CELL_VOLTAGE_MIN, SmartBmsFields::decodeRawValue(frame, SBMS_FIELD_CELL_VOLTAGE_MIN));
+	const uint32_t cellVoltageMax = SmartBmsFields::toFixedValue(SBMS_FIELD_CELL_VOLTAGE_MAX, SmartBmsFields::decodeRawValue(frame, SBMS_FIELD_CELL_VOLTAGE_MAX));
+	const uint32_t cellVoltageBalance = SmartBmsFields::toFixedValue(SBMS_FIELD_CELL_VOLTAGE_BALANCE, SmartBmsFields::decodeRawValue(frame, SBMS_FIELD_CELL_VOLTAGE_BALANCE));
+	if (cellVoltageMin < SMART_BMS_PLAUSIBLE_MIN_CELL_VOLTAGE_MV || cellVoltageMax > SMART_BMS_PLAUSIBLE_MAX_CELL_VOLTAGE_MV || cellVoltageMin > cellVoltageMax ||
+		cellVoltageBalance < SMART_BMS_PLAUSIBLE_MIN_CELL_VOLTAGE_MV || cellVoltageBalance > SMART_BMS_PLAUSIBLE_MAX_CELL_VOLTAGE_MV)
+	{
+		return false;
+	}
+
+	// The cells with the extreme values must be real cells of the pack
+	return static_cast<uint32_t>(SmartBmsFields::decodeRawValue(frame, SBMS_FIELD_LOWEST_CELL_VOLTAGE_NUMBER)) <= cellCount &&
+		   static_cast<uint32_t>(SmartBmsFields::decodeRawValue(frame, SBMS_FIELD_HIGHEST_CELL_VOLTAGE_NUMBER)) <= cellCount &&
+		   static_cast<uint32_t>(SmartBmsFields::decodeRawValue(frame, SBMS_FIELD_LOWEST_CELL_TEMPERATURE_NUMBER)) <= cellCount &&
+		   static_cast<uint32_t>(SmartBmsFields::decodeRawValue(frame, SBMS_FIELD_HIGHEST_CELL_TEMPERATURE_NUMBER)) <= cellCount &&
+		   SmartBmsFields::decodeRawValue(frame, SBMS_FIELD_PACK_SOC) <= 100;
+}
+
+/**
+ * @brief Check if the structure of the frame is consistent, see isWellFormed(const uint8_t *).
+ * @return true when the cell count, the order of the cell voltages, the configured limits, the cell numbers and the state of charge are valid
+ */
+const bool SmartBmsFrameView::isWellFormed() const
+{
+	return SmartBmsFrameView::isWellFormed(this->frame_);
+}
+
+/**
+ * @brief Check if the frame is well formed and its values are in the range of a healthy pack.
+ * This tells a window that matched the checksum by chance from a real frame, but it also rejects real frames of a deeply discharged or failed cell.
+ * So it is only meant for windows whose alignment is unknown, like after a resynchronization or during the link detection.
+ * @return true when the frame is well formed and the cell voltages and the pack voltage are plausible
+ */
+const bool SmartBmsFrameView::isPlausible() const
+{
+	if (!this->isWellFormed())
+	{
+		return false;
+	}
+
+	// The lowest and the highest cell voltage are in the range of a healthy cell
+	const uint32_t cellCount = this->getCellCount();
+	const uint32_t lowestCellVoltage = this->getLowestCellVoltageMillivolts();
+	const uint32_t highestCellVoltage = this->getHighestCellVoltageMillivolts();
+	if (lowestCellVoltage < SMART_BMS_PLAUSIBLE_MIN_CELL_VOLTAGE_MV || highestCellVoltage > SMART_BMS_PLAUSIBLE_MAX_CELL_VOLTAGE_MV)
+	{
+		return false;
+	}
+
+	// The pack voltage is the sum of the cells
+	const uint32_t packVoltage = this->getPackVoltageMillivolts();
+	return packVoltage >= cellCount * SMART_BMS_PLAUSIBLE_MIN_CELL_VOLTAGE_MV && packVoltage <= cellCount * SMART_BMS_PLAUSIBLE_MAX_CELL_VOLTAGE_MV;
+}
+
+/**
+ * @brief Get the raw value of a field as it was transmitted.
+ * @param field field to get
+ * @return raw value
+ */
+const int32_t SmartBmsFrameView::getRawValue(const SmartBmsField field) const
+{
+	return SmartBmsFields::decodeRawValue(this->frame_, field);
+}
+
+/**
+ * @brief Get the value of a field in integer units, see SMART_BMS_FIELDS for the unit.
+ * @param field field to get
+ * @return value in integer units
+ */
+const int32_t SmartBmsFrameView::getFixedValue(const SmartBmsField field) const
+{
+	return SmartBmsFields::toFixedValue(field, this->getRawValue(field));
+}
+
+#ifndef SMART_BMS_FIXED_POINT
+/**
+ * @brief Get the value of a field in physical units, see SMART_BMS_FIELDS for the unit.
+ * @param field field to get
+ * @return value in physical units
+ */
+const float SmartBmsFrameView::getValue(const SmartBmsField field) const
+{
+	return SmartBmsFields::toFloatValue(field, this->getRawValue(field));
+}
+#endif
+
+const uint8_t SmartBmsFrameView::getCellCount() const
+{
+	return this->getRawValue(SBMS_FIELD_CELL_COUNT);
+}
+
+const uint32_t SmartBmsFrameView::getCellVoltageMinMillivolts() const
+{
+	return this->getFixedValue(SBMS_FIELD_CELL_VOLTAGE_MIN);
+}
+
+const uint32_t SmartBmsFrameView::getCellVoltageMaxMillivolts() const
+{
+	return this->getFixedValue(SBMS_FIELD_CELL_VOLTAGE_MAX);
+}
+
+const uint32_t SmartBmsFrameView::getCellVoltageBalanceMillivolts() const
+{
+	return this->getFixedValue(SBMS_FIELD_CELL_VOLTAGE_BALANCE);
+}
+
+const uint8_t SmartBmsFrameView::getPackSoc() const
+{
+	return this->getRawValue(SBMS_FIELD_PACK_SOC);
+}
+
+const uint32_t SmartBmsFrameView::getPackVoltageMillivolts() const
+{
+	return this->getFixedValue(SBMS_FIELD_PACK_VOLTAGE);
+}
+
+const int32_t SmartBmsFrameView::getPackCurrentMilliamps() const
+{
+	return this->getFixedValue(SBMS_FIELD_PACK_CURRENT);
+}
+
+const int32_t SmartBmsFrameView::getPackChargeCurrentMilliamps() const
+{
+	return this->getFixedValue(SBMS_FIELD_PACK_CHARGE_CURRENT);
+}
+
+const int32_t SmartBmsFrameView::getPackDischargeCurrentMilliamps() const
+{
+	return this->getFixedValue(SBMS_FIELD_PACK_DISCHARGE_CURRENT);
+}
+
+const uint32_t SmartBmsFrameView::getPackCapacityWattHours() const
+{
+	return this->getFixedValue(SBMS_FIELD_PACK_CAPACITY);
+}
+
+const uint32_t SmartBmsFrameView::getPackRemainingEnergyWattHours() const
+{
+	return this->getFixedValue(SBMS_FIELD_PACK_REMAINING_ENERGY);
+}
+
+const uint32_t SmartBmsFrameView::getLowestCellVoltageMillivolts() const
+{
+	return this->getFixedValue(SBMS_FIELD_LOWEST_CELL_VOLTAGE);
+}
+
+const uint8_t SmartBmsFrameView::getLowestCellVoltageNumber() const
+{
+	return this->getRawValue(SBMS_FIELD_LOWEST_CELL_VOLTAGE_NUMBER);
+}
+
+const uint32_t SmartBmsFrameView::getHighestCellVoltageMillivolts() const
+{
+	return this->getFixedValue(SBMS_FIELD_HIGHEST_CELL_VOLTAGE);
+}
+
+const uint8_t SmartBmsFrameView::getHighestCellVoltageNumber() const
+{
+	return this->getRawValue(SBMS_FIELD_HIGHEST_CELL_VOLTAGE_NUMBER);
+}
+
+const int32_t SmartBmsFrameView::getLowestCellTemperatureMillicelsius() const
+{
+	return this->getFixedValue(SBMS_FIELD_LOWEST_CELL_TEMPERATURE);
+}
+
+const uint8_t SmartBmsFrameView::getLowestCellTemperatureNumber() const
+{
+	return this->getRawValue(SBMS_FIELD_LOWEST_CELL_TEMPERATURE_NUMBER);
+}
+
+const int32_t SmartBmsFrameView::getHighestCellTemperatureMillicelsius() const
+{
+	return this->getFixedValue(SBMS_FIELD_HIGHEST_CELL_TEMPERATURE);
+}
+
+const uint8_t SmartBmsFrameView::getHighestCellTemperatureNumber() const
+{
+	return this->getRawValue(SBMS_FIELD_HIGHEST_CELL_TEMPERATURE_NUMBER);
+}
+
+const bool SmartBmsFrameView::hasCommunicationError() const
+{
+	return this->getRawValue(SBMS_FIELD_COMMUNICATION_ERROR) != 0;
+}
+
+const bool SmartBmsFrameView::isAllowedToCharge() const
+{
+	return this->getRawValue(SBMS_FIELD_ALLOWED_TO_CHARGE) != 0;
+}
+
+const bool SmartBmsFrameView::isAllowedToDischarge() const
+{
+	return this->getRawValue(SBMS_FIELD_ALLOWED_TO_DISCHARGE) != 0;
+}
+
+const bool SmartBmsFrameView::isMinVoltageAlarmActive() const
+{
+	return this->getRawValue(SBMS_FIELD_MIN_VOLTAGE_ALARM) != 0;
+}
+
+const bool SmartBmsFrameView::isMaxVoltageAlarmActive() const
+{
+	return this->getRawValue(SBMS_FIELD_MAX_VOLTAGE_ALARM) != 0;
+}
+
+const bool SmartBmsFrameView::isMinTemperatureAlarmActive() const
+{
+	return this->getRawValue(SBMS_FIELD_MIN_TEMPERATURE_ALARM) != 0;
+}
+
+const bool SmartBmsFrameView::isMaxTemperatureAlarmActive() const
+{
+	return this->getRawValue(SBMS_FIELD_MAX_TEMPERATURE_ALARM) != 0;
+}
+
+#ifdef SMART_BMS_CELL_DATA
+const uint8_t SmartBmsFrameView::getCellNumber() const
+{
+	return this->getRawValue(SBMS_FIELD_CELL_NUMBER);
+}
+
+const uint32_t SmartBmsFrameView::getCellVoltageMillivolts() const
+{
+	return this->getFixedValue(SBMS_FIELD_CELL_VOLTAGE);
+}
+
+const int32_t SmartBmsFrameView::getCellTemperatureMillicelsius() const
+{
+	return this->getFixedValue(SBMS_FIELD_CELL_TEMPERATURE);
+}
+#endif
+
+#ifndef SMART_BMS_FIXED_POINT
+const float SmartBmsFrameView::getCellVoltageMin() const
+{
+	return this->getValue(SBMS_FIELD_CELL_VOLTAGE_MIN);
+}
+
+const float SmartBmsFrameView::getCellVoltageMax() const
+{
+	return this->getValue(SBMS_FIELD_CELL_VOLTAGE_MAX);
+}
+
+const float SmartBmsFrameView::getCellVoltageBalance() const
+{
+	return this->getValue(SBMS_FIELD_CELL_VOLTAGE_BALANCE);
+}
+
+const float SmartBmsFrameView::getPackVoltage() const
+{
+	return this->getValue(SBMS_FIELD_PACK_VOLTAGE);
+}
+
+const float SmartBmsFrameView::getPackCurrent() const
+{
+	return this->getValue(SBMS_FIELD_PACK_CURRENT);
+}
+
+const float SmartBmsFrameView::getPackChargeCurrent() const
+{
+	return this->getValue(SBMS_FIELD_PACK_CHARGE_CURRENT);
+}
+
+const float SmartBmsFrameView::getPackDischargeCurrent() const
+{
+	return this->getValue(SBMS_FIELD_PACK_DISCHARGE_CURRENT);
+}
+
+const float SmartBmsFrameView::getPackCapacity() const
+{
+	return this->getValue(SBMS_FIELD_PACK_CAPACITY);
+}
+
+const float SmartBmsFrameView::getPackRemainingEnergy() const
+{
+	return this->getValue(SBMS_FIELD_PACK_REMAINING_ENERGY);
+}
+
+const float SmartBmsFrameView::getLowestCellVoltage() const
+{
+	return this->getValue(SBMS_FIELD_LOWEST_CELL_VOLTAGE);
+}
+
+const float SmartBmsFrameView::getHighestCellVoltage() const
+{
+	return this->getValue(SBMS_FIELD_HIGHEST_CELL_VOLTAGE);
+}
+
+const float SmartBmsFrameView::getLowestCellTemperature() const
+{
+	return this->getValue(SBMS_FIELD_LOWEST_CELL_TEMPERATURE);
+}
+
+const float SmartBmsFrameView::getHighestCellTemperature() const
+{
+	return this->getValue(SBMS_FIELD_HIGHEST_CELL_TEMPERATURE);
+}
+
+#ifdef SMART_BMS_CELL_DATA
+const float SmartBmsFrameView::getCellVoltage() const
+{
+	return this->getValue(SBMS_FIELD_CELL_VOLTAGE);
+}
+
+const float SmartBmsFrameView::getCellTemperature() const
+{
+	return this->getValue(SBMS_FIELD_CELL_TEMPERATURE);
+}
+#endif
+#endif
@@ -0,0 +1,362 @@
+/**
+ * @file SmartBmsHistory.cpp
+ * @author TheRealKasumi
+ * @brief Contains a compact history record and a ring of records over caller provided memory, like PSRAM.
+ * @copyright Copyright (c) 2024 TheRealKasumi
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#include "bms/SmartBmsHistory.h"
+
+/**
+ * @brief Create a new, empty instance of SmartBmsHistoryRecord.
+ */
+SmartBmsHistoryRecord::SmartBmsHistoryRecord()
+{
+	this->timestamp_ = 0;
+	this->packVoltageSoc_ = 0;
+	this->remainingEnergyStatus_ = 0;
+	this->packCurrent_ = 0;
+	this->packChargeCurrent_ = 0;
+	this->packDischargeCurrent_ = 0;
+	this->lowestCellVoltage_ = 0;
+	this->highestCellVoltage_ = 0;
+	this->lowestCellTemperature_ = 0;
+	this->highestCellTemperature_ = 0;
+	this->lowestCellVoltageNumber_ = 0;
+	this->highestCellVoltageNumber_ = 0;
+	this->lowestCellTemperatureNumber_ = 0;
+	this->highestCellTemperatureNumber_ = 0;
+	this->cellCount_ = 0;
+	this->reserved_ = 0;
+}
+
+/**
+ * @brief Destroy the SmartBmsHistoryRecord instance.
+ */
+SmartBmsHistoryRecord::~SmartBmsHistoryRecord()
+{
+}
+
+/**
+ * @brief Store the pack state in the record. Values are kept in raw units.
+ * The pack voltage and remaining energy share a word with the SOC and the status flags.
+ * Currents are limited to 16 bits, which covers about +-4000A.
+ * @param smartBmsData data to store, fields that were not decoded are stored as 0
+ * @param timestamp time of the data in ms
+ */
+void SmartBmsHistoryRecord::store(const SmartBmsData &smartBmsData, const uint32_t timestamp)
+{
+	// Rebuild the status byte of the frame from the flags
+	uint8_t statusFlags = 0;
+	for (size_t i = 0; i < SBMS_FIELD_COUNT; i++)
+	{
+		if (SMART_BMS_FIELDS[i].encoding == SBMS_ENCODING_FLAG && SmartBmsHistoryRecord::getValue_(smartBmsData, static_cast<SmartBmsField>(i)) != 0)
+		{
+			statusFlags |= SMART_BMS_FIELDS[i].bitMask;
+		}
+	}
+
+	this->timestamp_ = timestamp;
+	this->packVoltageSoc_ = (static_cast<uint32_t>(SmartBmsHistoryRecord::getValue_(smartBmsData, SBMS_FIELD_PACK_VOLTAGE)) & 0xFFFFFF) | (static_cast<uint32_t>(SmartBmsHistoryRecord::getValue_(smartBmsData, SBMS_FIELD_PACK_SOC)) << 24);
+	this->remainingEnergyStatus_ = (static_cast<uint32_t>(SmartBmsHistoryRecord::getValue_(smartBmsData, SBMS_FIELD_PACK_REMAINING_ENERGY)) & 0xFFFFFF) | (static_cast<uint32_t>(statusFlags) << 24);
+	this->packCurrent_ = SmartBmsHistoryRecord::saturate_(SmartBmsHistoryRecord::getValue_(smartBmsData, SBMS_FIELD_PACK_CURRENT));
+	this->packChargeCurrent_ = SmartBmsHistoryRecord::saturate_(SmartBmsHistoryRecord::getValue_(smartBmsData, SBMS_FIELD_PACK_CHARGE_CURRENT));
+	this->packDischargeCurrent_ = SmartBmsHistoryRecord::saturate_(SmartBmsHistoryRecord::getValue_(smartBmsData, SBMS_FIELD_PACK_DISCHARGE_CURRENT));
+	this->lowestCellVoltage_ = SmartBmsHistoryRecord::getValue_(smartBmsData, SBMS_FIELD_LOWEST_CELL_VOLTAGE);
+	this->highestCellVoltage_ = SmartBmsHistoryRecord::getValue_(smartBmsData, SBMS_FIELD_HIGHEST_CELL_VOLTAGE);
+	this->lowestCellTemperature_ = SmartBmsHistoryRecord::getValue_(smartBmsData, SBMS_FIELD_LOWEST_CELL_TEMPERATURE);
+	this->highestCellTemperature_ = SmartBmsHistoryRecord::getValue_(smartBmsData, SBMS_FIELD_HIGHEST_CELL_TEMPERATURE);
+	this->lowestCellVoltageNumber_ = SmartBmsHistoryRecord::getValue_(smartBmsData, SBMS_FIELD_LOWEST_CELL_VOLTAGE_NUMBER);
+	this->highestCellVoltageNumber_ = SmartBmsHistoryRecord::getValue_(smartBmsData, SBMS_FIELD_HIGHEST_CELL_VOLTAGE_NUMBER);
+	this->lowestCellTemperatureNumber_ = SmartBmsHistoryRecord::getValue_(smartBmsData, SBMS_FIELD_LOWEST_CELL_TEMPERATURE_NUMBER);
+	this->highestCellTemperatureNumber_ = SmartBmsHistoryRecord::getValue_(smartBmsData, SBMS_FIELD_HIGHEST_CELL_TEMPERATURE_NUMBER);
+	this->cellCount_ = SmartBmsHistoryRecord::getValue_(smartBmsData, SBMS_FIELD_CELL_COUNT);
+}
+
+/**
+ * @brief Restore the stored fields into BMS data. Only the fields of getFieldMask() are set.
+ * @param smartBmsData reference to a SmartBmsData object that will receive the data
+ */
+void SmartBmsHistoryRecord::load(SmartBmsData *smartBmsData) const
+{
+	int32_t *values = smartBmsData->values_;
+	values[SBMS_FIELD_CELL_COUNT] = this->cellCount_;
+	values[SBMS_FIELD_PACK_SOC] = this->packVoltageSoc_ >> 24;
+	values[SBMS_FIELD_PACK_VOLTAGE] = this->packVoltageSoc_ & 0xFFFFFF;
+	values[SBMS_FIELD_PACK_CURRENT] = this->packCurrent_;
+	values[SBMS_FIELD_PACK_CHARGE_CURRENT] = this->packChargeCurrent_;
+	values[SBMS_FIELD_PACK_DISCHARGE_CURRENT] = this->packDischargeCurrent_;
+	values[SBMS_FIELD_PACK_REMAINING_ENERGY] = this->remainingEnergyStatus_ & 0xFFFFFF;
+	values[SBMS_FIELD_LOWEST_CELL_VOLTAGE] = this->lowestCellVoltage_;
+	values[SBMS_FIELD_LOWEST_CELL_VOLTAGE_NUMBER] = this->lowestCellVoltageNumber_;
+	values[SBMS_FIELD_HIGHEST_CELL_VOLTAGE] = this->highestCellVoltage_;
+	values[SBMS_FIELD_HIGHEST_CELL_VOLTAGE_NUMBER] = this->highestCellVoltageNumber_;
+	values[SBMS_FIELD_LOWEST_CELL_TEMPERATURE] = this->lowestCellTemperature_;
+	values[SBMS_FIELD_LOWEST_CELL_TEMPERATURE_NUMBER] = this->lowestCellTemperatureNumber_;
+	values[SBMS_FIELD_HIGHEST_CELL_TEMPERATURE] = this->highestCellTemperature_;
+	values[SBMS_FIELD_HIGHEST_CELL_TEMPERATURE_NUMBER] = this->highestCellTemperatureNumber_;
+	for (size_t i = 0; i < SBMS_FIELD_COUNT; i++)
+	{
+		if (SMART_BMS_FIELDS[i].encoding == SBMS_ENCODING_FLAG)
+		{
+			values[i] = (this->getStatusFlags() & SMART_BMS_FIELDS[i].bitMask) != 0;
+		}
+	}
+	smartBmsData->fieldMask_ = SmartBmsHistoryRecord::getFieldMask();
+	smartBmsData->changedMask_ = smartBmsData->fieldMask_;
+}
+
+/**
+ * @brief Get the time of the record.
+ * @return timestamp in ms
+ */
+const uint32_t SmartBmsHistoryRecord::getTimestamp() const
+{
+	return this->timestamp_;
+}
+
+/**
+ * @brief Get the status flags in the layout of byte 30 of the frame.
+ * @return status flags, see the bit masks of the flag fields in SMART_BMS_FIELDS
+ */
+const uint8_t SmartBmsHistoryRecord::getStatusFlags() const
+{
+	return this->remainingEnergyStatus_ >> 24;
+}
+
+/**
+ * @brief Get the fields that are kept in a record.
+ * The settings of the pack like the cell voltage limits and the capacity are not kept, neither is the data of single cells.
+ * @return bit mask with SBMS_FIELD_MASK(field) set for every stored field
+ */
+const uint32_t SmartBmsHistoryRecord::getFieldMask()
+{
+	uint32_t fieldMask = SBMS_FIELD_MASK(SBMS_FIELD_CELL_COUNT) | SBMS_FIELD_MASK(SBMS_FIELD_PACK_SOC) | SBMS_FIELD_MASK(SBMS_FIELD_PACK_VOLTAGE) |
+						 SBMS_FIELD_MASK(SBMS_FIELD_PACK_CURRENT) | SBMS_FIELD_MASK(SBMS_FIELD_PACK_CHARGE_CURRENT) |
+						 SBMS_FIELD_MASK(SBMS_FIELD_PACK_DISCHARGE_CURRENT) | SBMS_FIELD_MASK(SBMS_FIELD_PACK_REMAINING_ENERGY) |
+						 SBMS_FIELD_MASK(SBMS_FIELD_LOWEST_CELL_VOLTAGE) | SBMS_FIELD_MASK(SBMS_FIELD_LOWEST_CELL_VOLTAGE_NUMBER) |
+						 SBMS_FIELD_MASK(SBMS_FIELD_HIGHEST_CELL_VOLTAGE) | SBMS_FIELD_MASK(SBMS_FIELD_HIGHEST_CELL_VOLTAGE_NUMBER) |
+						 SBMS_FIELD_MASK(SBMS_FIELD_LOWEST_CELL_TEMPERATURE) | SBMS_FIELD_MASK(SBMS_FIELD_LOWEST_CELL_TEMPERATURE_NUMBER) |
+						 SBMS_FIELD_MASK(SBMS_FIELD_HIGHEST_CELL_TEMPERATURE) | SBMS_FIELD_MASK(SBMS_FIELD_HIGHEST_CELL_TEMPERATURE_NUMBER);
+	for (size_t i = 0; i < SBMS_FIELD_COUNT; i++)
+	{
+		if (SMART_BMS_FIELDS[i].encoding == SBMS_ENCODING_FLAG)
+		{
+			fieldMask |= SBMS_FIELD_MASK(i);
+		}
+	}
+	return fieldMask;
+}
+
+/**
+ * @brief Get the raw value of a field.
+ * @param smartBmsData data that holds the value
+ * @param field field to get
+ * @return raw value, 0 when the field was not decoded
+ */
+const int32_t SmartBmsHistoryRecord::getValue_(const SmartBmsData &smartBmsData, const SmartBmsField field)
+{
+	return smartBmsData.hasField(field) ? smartBmsData.getRawValue(field) : 0;
+}
+
+/**
+ * @brief Limit a value to the range of 16 bits.
+ * @param value value to limit
+ * @return limited value
+ */
+const int16_t SmartBmsHistoryRecord::saturate_(const int32_t value)
+{
+	return value > INT16_MAX ? INT16_MAX : (value < INT16_MIN ? INT16_MIN : value);
+}
+
+/**
+ * @brief Create a new instance of SmartBmsHistory.
+ * The records are not allocated by the history, so they can be placed in PSRAM, like with ps_malloc().
+ * @param records memory for the records, must stay valid while the history is used
+ * @param capacity number of records, one hour at one frame per second needs 3600 records or 115kB
+ */
+SmartBmsHistory::SmartBmsHistory(SmartBmsHistoryRecord *records, const size_t capacity)
+{
+	this->records_ = records;
+	this->capacity_ = records != nullptr ? capacity : 0;
+	this->clear();
+}
+
+/**
+ * @brief Destroy the SmartBmsHistory instance.
+ */
+SmartBmsHistory::~SmartBmsHistory()
+{
+}
+
+/**
+ * @brief Add a record. When the history is full, the oldest record is overwritten.
+ * @param smartBmsData data to add
+ * @param timestamp time of the data in ms, must not be older than the last record and may wrap around
+ */
+void SmartBmsHistory::add(const SmartBmsData &smartBmsData, const uint32_t timestamp)
+{
+	if (this->capacity_ == 0)
+	{
+		return;
+	}
+
+	size_t index = this->start_ + this->size_;
+	if (this->size_ == this->capacity_)
+	{
+		this->start_ = this->start_ + 1 == this->capacity_ ? 0 : this->start_ + 1;
+	}
+	else
+	{
+		this->size_++;
+	}
+	index = index >= this->capacity_ ? index - this->capacity_ : index;
+	this->records_[index].store(smartBmsData, timestamp);
+}
+
+/**
+ * @brief Remove all records.
+ */
+void SmartBmsHistory::clear()
+{
+	this->start_ = 0;
+	this->size_ = 0;
+}
+
+/**
+ * @brief Get the number of records.
+ * @return number of records
+ */
+const size_t SmartBmsHistory::size() const
+{
+	return this->size_;
+}
+
+/**
+ * @brief Get the maximum number of records.
+ * @return capacity
+ */
+const size_t SmartBmsHistory::capacity() const
+{
+	return this->capacity_;
+}
+
+/**
+ * @brief Get a record by its age.
+ * @param index index of the record, 0 is the oldest
+ * @return record or nullptr when the index is out of range
+ */
+const SmartBmsHistoryRecord *SmartBmsHistory::get(const size_t index) const
+{
+	if (index >= this->size_)
+	{
+		return nullptr;
+	}
+	const size_t position = this->start_ + index;
+	return &this->records_[position >= this->capacity_ ? position - this->capacity_ : position];
+}
+
+/**
+ * @brief Find the first record at or after a point in time with a binary search.
+ * @param timestamp time in ms
+ * @return index of the record, size() when all records are older
+ */
+const size_t SmartBmsHistory::lowerBound(const uint32_t timestamp) const
+{
+	return this->lowerBound_(this->getOffset_(timestamp), 0);
+}
+
+/**
+ * @brief Visit the records of a time range in place, optionally downsampled.
+ * The range is located with a binary search, so the cost depends on the number of visited records and not on the size of the history.
+ * @param from start of the range in ms
+ * @param to end of the range in ms, inclusive
+ * @param interval minimum time between two visited records in ms, 0 to visit every record
+ * @param callback function that is called for every visited record, returns false to stop
+ * @param context user defined pointer that is passed to the callback
+ * @return number of visited records
+ */
+const size_t SmartBmsHistory::forEach(const uint32_t from, const uint32_t to, const uint32_t interval, SmartBmsHistoryCallback callback, void *context) const
+{
+	// A range that ends before the oldest record is empty, the offset of its end would be mapped to the oldest record
+	if (this->size_ == 0 || static_cast<int32_t>(to - this->get(0)->getTimestamp()) < 0)
+	{
+		return 0;
+	}
+
+	const uint32_t endOffset = this->getOffset_(to);
+	size_t visitedCount = 0;
+	size_t index = this->lowerBound(from);
+	while (index < this->size_)
+	{
+		const SmartBmsHistoryRecord *record = this->get(index);
+		const uint32_t offset = this->getOffset_(record->getTimestamp());
+		if (offset > endOffset)
+		{
+			break;
+		}
+
+		visitedCount++;
+		if (!callback(record, context))
+		{
+			break;
+		}
+
+		// Skip ahead to the first record of the next interval
+		index = interval == 0 || offset > UINT32_MAX - interval ? index + 1 : this->lowerBound_(offset + interval, index + 1);
+	}
+	return visitedCount;
+}
+
+/**
+ * @brief Get the time since the oldest record. Timestamps before the oldest record are mapped to 0.
+ * @param timestamp time in ms
+ * @return offset in ms
+ */
+const uint32_t SmartBmsHistory::getOffset_(const uint32_t timestamp) const
+{
+	if (this->size_ == 0)
+	{
+		return 0;
+	}
+	const int32_t offset = static_cast<int32_t>(timestamp - this->get(0)->getTimestamp());
+	return offset < 0 ? 0 : offset;
+}
+
+/**
+ * @brief Binary search for the first record with at least the given offset.
+ * @param offset offset from the oldest record in ms
+ * @param first index to start the search at
+ * @return index of the record, size() when there is none
+ */
+const size_t SmartBmsHistory::lowerBound_(const uint32_t offset, const size_t first) const
+{
+	size_t low = first;
+	size_t high = this->size_;
+	while (low < high)
+	{
+		const size_t middle = low + (high - low) / 2;
+		if (this->getOffset_(this->get(middle)->getTimestamp()) < offset)
+		{
+			low = middle + 1;
+		}
+		else
+		{
+			high = middle;
+		}
+	}
+	return low;
+}
@@ -0,0 +1,225 @@
+/**
+ * @file SmartBmsIngestTask.cpp
+ * @author TheRealKasumi
+ * @brief Implementation of the SmartBmsIngestTask class.
+ * @copyright Copyright (c) 2024 TheRealKasumi
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#include "bms/SmartBmsIngestTask.h"
+
+#if defined(ESP32)
+
+/**
+ * @brief Create a new instance of SmartBmsIngestTask.
+ * @param inputStream input stream from which the BMS data is read, must not be used by anyone else once started
+ * @param queue queue that receives the frames, the application is the only consumer
+ */
+SmartBmsIngestTask::SmartBmsIngestTask(Stream *inputStream, SmartBmsFrameQueue *queue)
+{
+	this->inputStream_ = inputStream;
+	this->queue_ = queue;
+	this->publisher_ = nullptr;
+	this->taskHandle_ = nullptr;
+	this->stoppingTask_ = nullptr;
+	this->stopRequested_ = false;
+#ifdef SMART_BMS_STATISTICS
+	this->statistics_ = nullptr;
+#endif
+	this->rxOverflowCount_ = 0;
+	this->skippedByteCount_ = 0;
+	this->smartBmsReader_.setFrameCallback(SmartBmsIngestTask::onFrame_, this);
+}
+
+/**
+ * @brief Destroy the SmartBmsIngestTask instance.
+ */
+SmartBmsIngestTask::~SmartBmsIngestTask()
+{
+	this->end();
+}
+
+/**
+ * @brief Start the task that assembles the frames.
+ * @param core core the task is pinned to
+ * @param priority priority of the task
+ * @param stackSize stack size of the task in bytes
+ * @return true when the task was started
+ * @return false when the task is already running or could not be created
+ */
+const bool SmartBmsIngestTask::begin(const BaseType_t core, const UBaseType_t priority, const uint32_t stackSize)
+{
+	if (this->taskHandle_ != nullptr)
+	{
+		return false;
+	}
+	this->stopRequested_.store(false);
+	return xTaskCreatePinnedToCore(SmartBmsIngestTask::run_, "SmartBmsIngest", stackSize, this, priority, &this->taskHandle_, core) == pdPASS;
+}
+
+/**
+ * @brief Stop the task and wait until it has ended.
+ * The task is not deleted from outside, since it could be inside the stream or hold the UART lock.
+ * Instead it finishes its current loop, notifies the caller and deletes itself.
+ * The task notification of the calling task is used to wait.
+ */
+void SmartBmsIngestTask::end()
+{
+	if (this->taskHandle_ == nullptr)
+	{
+		return;
+	}
+
+	// When the task stops itself, for example from a flag callback, it can not wait for itself
+	const TaskHandle_t currentTask = xTaskGetCurrentTaskHandle();
+	this->stoppingTask_ = currentTask != this->taskHandle_ ? currentTask : nullptr;
+	this->stopRequested_.store(true);
+	if (this->stoppingTask_ != nullptr)
+	{
+		ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+	}
+	this->taskHandle_ = nullptr;
+}
+
+/**
+ * @brief Set a publisher that additionally receives the latest decoded frame. Must be set before the task is started.
+ * @param publisher publisher or nullptr to disable it
+ */
+void SmartBmsIngestTask::setPublisher(SmartBmsPublisher *publisher)
+{
+	this->publisher_ = publisher;
+}
+
+/**
+ * @brief Subscribe to transitions of a permission or alarm flag. Must be called before the task is started.
+ * The callback runs in the task as soon as a frame is complete, without waiting for the application to drain the queue.
+ * See SmartBmsReader::subscribe() for details.
+ * @param field flag to watch, like SBMS_FIELD_ALLOWED_TO_CHARGE
+ * @param edge transitions that invoke the callback
+ * @param callback function that is called with the new value of the flag and the timestamp of the frame
+ * @param context user defined pointer that is passed to the callback
+ * @return true when the subscription was added
+ * @return false when the field is not a flag or no subscription is left
+ */
+const bool SmartBmsIngestTask::subscribe(const SmartBmsField field, const SmartBmsFlagEdge edge, SmartBmsFlagCallback callback, void *context)
+{
+	return this->smartBmsReader_.subscribe(field, edge, callback, context);
+}
+
+#ifdef SMART_BMS_STATISTICS
+/**
+ * @brief Set the statistics that count the frames and errors of the task. Must be set before the task is started.
+ * @param statistics statistics or nullptr to disable them
+ */
+void SmartBmsIngestTask::setStatistics(SmartBmsStatistics *statistics)
+{
+	this->statistics_ = statistics;
+	this->smartBmsReader_.setStatistics(statistics);
+}
+#endif
+
+/**
+ * @brief Report that the UART receive buffer overflowed. Can be called from the UART error callback.
+ */
+void SmartBmsIngestTask::reportRxOverflow()
+{
+	this->rxOverflowCount_.fetch_add(1, std::memory_order_relaxed);
+#ifdef SMART_BMS_STATISTICS
+	if (this->statistics_ != nullptr)
+	{
+		this->statistics_->countRxOverflow();
+	}
+#endif
+}
+
+/**
+ * @brief Get the number of reported UART receive buffer overflows.
+ * @return number of overflows
+ */
+const uint32_t SmartBmsIngestTask::getRxOverflowCount() const
+{
+	return this->rxOverflowCount_.load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief Get the number of bytes the reader skipped to resynchronize to the frame alignment.
+ * @return number of skipped bytes
+ */
+const uint32_t SmartBmsIngestTask::getSkippedByteCount() const
+{
+	return this->skippedByteCount_.load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief Task function that drains the input stream and feeds the reader until a stop is requested.
+ * @param parameter pointer to the SmartBmsIngestTask instance
+ */
+void SmartBmsIngestTask::run_(void *parameter)
+{
+	SmartBmsIngestTask *ingestTask = static_cast<SmartBmsIngestTask *>(parameter);
+	uint8_t buffer[SMART_BMS_FRAME_SIZE];
+	while (!ingestTask->stopRequested_.load())
+	{
+		// Drain everything that is available, the reader keeps partial frames
+		int available = ingestTask->inputStream_->available();
+		while (available > 0)
+		{
+			const size_t length = available < static_cast<int>(sizeof(buffer)) ? available : sizeof(buffer);
+			const size_t readLength = ingestTask->inputStream_->readBytes(buffer, length);
+			ingestTask->smartBmsReader_.feed(buffer, readLength);
+			available = ingestTask->inputStream_->available();
+		}
+		ingestTask->skippedByteCount_.store(ingestTask->smartBmsReader_.getSkippedByteCount(), std::memory_order_relaxed);
+
+		// A frame takes about 60ms at 9600 baud, so polling every few milliseconds keeps the hardware buffer small
+		vTaskDelay(pdMS_TO_TICKS(SMART_BMS_INGEST_POLL_INTERVAL_MS));
+	}
+
+	// The instance may be gone as soon as the waiting task is notified, so it is not touched afterwards
+	const TaskHandle_t stoppingTask = ingestTask->stoppingTask_;
+	if (stoppingTask != nullptr)
+	{
+		xTaskNotifyGive(stoppingTask);
+	}
+	vTaskDelete(nullptr);
+}
+
+/**
+ * @brief Frame callback of the reader that pushes the frame into the queue and publishes it.
+ * @param frameView completed frame
+ * @param context pointer to the SmartBmsIngestTask instance
+ */
+void SmartBmsIngestTask::onFrame_(const SmartBmsFrameView *frameView, void *context)
+{
+	// A full queue counts the frame as dropped, the application reads the counter from the queue
+	SmartBmsIngestTask *ingestTask = static_cast<SmartBmsIngestTask *>(context);
+#ifdef SMART_BMS_STATISTICS
+	if (!ingestTask->queue_->push(*frameView) && ingestTask->statistics_ != nullptr)
+	{
+		ingestTask->statistics_->countDroppedFrame();
+	}
+#else
+	ingestTask->queue_->push(*frameView);
+#endif
+	if (ingestTask->publisher_ != nullptr)
+	{
+		// Decode through the reader, so the decode latency is recorded like for any other frame
+		SmartBmsData smartBmsData;
+		ingestTask->smartBmsReader_.decode(*frameView, &smartBmsData);
+		ingestTask->publisher_->publish(smartBmsData);
+	}
+}
+
+#endif
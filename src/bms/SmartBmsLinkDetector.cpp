@@ -0,0 +1,195 @@
+/**
+ * @file SmartBmsLinkDetector.cpp
+ * @author TheRealKasumi
+ * @brief Implementation of the SmartBmsLinkDetector class.
+ * @copyright Copyright (c) 2024 TheRealKasumi
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#include "bms/SmartBmsLinkDetector.h"
+
+#include <string.h>
+
+/**
+ * @brief Create a new instance of SmartBmsLinkDetector.
+ */
+SmartBmsLinkDetector::SmartBmsLinkDetector()
+{
+	this->reset();
+}
+
+/**
+ * @brief Destroy the SmartBmsLinkDetector instance.
+ */
+SmartBmsLinkDetector::~SmartBmsLinkDetector()
+{
+}
+
+/**
+ * @brief Feed the first bytes of a link into the detector until it locks.
+ * Every byte completes a window of one frame, so all alignments are checked as the window slides, each for both polarities.
+ * The inverted polarity checks the complement of every byte, both checksums are derived from the same rolling sum.
+ * A window that matches a checksum and passes SmartBmsFrameView::isPlausible() extends the run of its alignment, any other window ends it.
+ * The link locks as soon as one run reaches SMART_BMS_LINK_LOCK_FRAME_COUNT frames, which takes two frames when the sample starts anywhere in a frame.
+ * @param data bytes received from the BMS
+ * @param length number of bytes
+ * @param consumed optional pointer that receives the number of bytes used, the bytes after the locking frame are not used
+ * @return SBMS_LINK_LOCKED when the link is locked
+ * @return SBMS_LINK_SEARCHING when all bytes were used without locking
+ */
+const SmartBmsLinkState SmartBmsLinkDetector::feed(const uint8_t *data, const size_t length, size_t *consumed)
+{
+	size_t i = 0;
+	for (; i < length && this->state_ == SmartBmsLinkState::SBMS_LINK_SEARCHING; i++)
+	{
+		// The byte replaces the byte one frame before it, so slot and alignment are both the position modulo the frame size
+		const uint8_t value = data[i];
+		const uint8_t slot = this->sampledByteCount_ % SMART_BMS_FRAME_SIZE;
+		this->windowSum_ += value - this->window_[slot];
+		this->window_[slot] = value;
+		this->sampledByteCount_++;
+		if (this->sampledByteCount_ < SMART_BMS_FRAME_SIZE)
+		{
+			continue;
+		}
+
+		// The last byte is the checksum of the first 57 bytes, the complement of a sum of 57 bytes is 57 * 255 minus the sum
+		const uint8_t phase = this->sampledByteCount_ % SMART_BMS_FRAME_SIZE;
+		const uint8_t sum = this->windowSum_ - value;
+		const bool matches[SBMS_LINK_POLARITY_COUNT] = {
+			sum == value,
+			static_cast<uint8_t>((SMART_BMS_FRAME_SIZE - 1) * 0xFF - sum) == static_cast<uint8_t>(~value)};
+		for (uint8_t polarity = 0; polarity < SBMS_LINK_POLARITY_COUNT; polarity++)
+		{
+			uint8_t &runLength = this->runLengths_[polarity][phase];
+			if (!matches[polarity] || !this->checkWindow_(static_cast<SmartBmsLinkPolarity>(polarity), phase))
+			{
+				runLength = 0;
+				continue;
+			}
+
+			runLength++;
+			if (runLength >= SMART_BMS_LINK_LOCK_FRAME_COUNT)
+			{
+				this->state_ = SmartBmsLinkState::SBMS_LINK_LOCKED;
+				this->polarity_ = static_cast<SmartBmsLinkPolarity>(polarity);
+				this->alignment_ = phase;
+				break;
+			}
+		}
+	}
+
+	if (consumed != nullptr)
+	{
+		*consumed = i;
+	}
+	return this->state_;
+}
+
+/**
+ * @brief Forget all sampled bytes and search again, like after the polarity of the UART was changed.
+ */
+void SmartBmsLinkDetector::reset()
+{
+	this->state_ = SmartBmsLinkState::SBMS_LINK_SEARCHING;
+	this->polarity_ = SmartBmsLinkPolarity::SBMS_LINK_NORMAL;
+	this->alignment_ = 0;
+	memset(this->window_, 0, sizeof(this->window_));
+	this->windowSum_ = 0;
+	this->sampledByteCount_ = 0;
+	this->rejectedFrameCount_ = 0;
+	memset(this->runLengths_, 0, sizeof(this->runLengths_));
+	this->frameView_ = SmartBmsFrameView();
+}
+
+/**
+ * @brief Get the state of the detector.
+ * @return SBMS_LINK_LOCKED when the link is locked
+ */
+const SmartBmsLinkState SmartBmsLinkDetector::getState() const
+{
+	return this->state_;
+}
+
+/**
+ * @brief Get the polarity of the locked link. Inverted means that every byte arrived complemented.
+ * @return polarity, SBMS_LINK_NORMAL while searching
+ */
+const SmartBmsLinkPolarity SmartBmsLinkDetector::getPolarity() const
+{
+	return this->polarity_;
+}
+
+/**
+ * @brief Get the alignment of the locked link.
+ * @return number of bytes in front of the first complete frame of the sample, modulo the frame size
+ */
+const uint8_t SmartBmsLinkDetector::getAlignment() const
+{
+	return this->alignment_;
+}
+
+/**
+ * @brief Get the number of bytes that were sampled.
+ * @return number of bytes
+ */
+const uint32_t SmartBmsLinkDetector::getSampledByteCount() const
+{
+	return this->sampledByteCount_;
+}
+
+/**
+ * @brief Get the number of windows that matched a checksum, but were not plausible.
+ * @return number of rejected windows
+ */
+const uint32_t SmartBmsLinkDetector::getRejectedFrameCount() const
+{
+	return this->rejectedFrameCount_;
+}
+
+/**
+ * @brief Get the frame that locked the link, so it does not have to be received again.
+ * The frame is already complemented when the link is inverted. The frame has no timestamp.
+ * @return locking frame, an empty frame while searching
+ */
+const SmartBmsFrameView &SmartBmsLinkDetector::getFrame() const
+{
+	return this->frameView_;
+}
+
+/**
+ * @brief Copy the window in the given polarity and check if it is a plausible frame.
+ * @param polarity polarity of the window
+ * @param phase slot of the first byte of the window
+ * @return true when the window is plausible, it is kept as the latest frame
+ */
+const bool SmartBmsLinkDetector::checkWindow_(const SmartBmsLinkPolarity polarity, const uint8_t phase)
+{
+	uint8_t frame[SMART_BMS_FRAME_SIZE];
+	const uint8_t mask = polarity == SmartBmsLinkPolarity::SBMS_LINK_INVERTED ? 0xFF : 0x00;
+	for (uint8_t i = 0; i < SMART_BMS_FRAME_SIZE; i++)
+	{
+		frame[i] = this->window_[(phase + i) % SMART_BMS_FRAME_SIZE] ^ mask;
+	}
+
+	const SmartBmsFrameView frameView(frame);
+	if (!frameView.isPlausible())
+	{
+		this->rejectedFrameCount_++;
+		return false;
+	}
+	this->frameView_ = frameView;
+	return true;
+}
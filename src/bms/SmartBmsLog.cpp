@@ -0,0 +1,528 @@
+/**
+ * @file SmartBmsLog.cpp
+ * @author TheRealKasumi
+ * @brief Contains an append-only log of BMS data with delta compressed and checksummed blocks.
+ * @copyright Copyright (c) 2024 TheRealKasumi
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#include "bms/SmartBmsLog.h"
+
+#include "bms/SmartBmsDeltaCodec.h"
+
+/*
+ * Layout of a block, all values are little endian:
+ *   uint16 magic, uint16 payload length, uint16 record count, uint16 generation of the storage,
+ *   uint32 timestamp of the first record, uint32 timestamp of the last record,
+ *   payload, uint32 CRC-32 of header and payload
+ * Every record of the payload is stored against the previous record of the same block, the first one against empty data:
+ *   varint timestamp delta, varint mask of the changed fields, zigzag varint value delta per changed field
+ * Blocks do not depend on each other, so a damaged block at the end can be dropped without losing older data.
+ * The log alternates between two storages. When the active one is full, the other one is cleared and becomes the active one.
+ * Every rotation increments the generation, so the newer storage can be found after a restart, even though the timestamps restart with the device.
+ */
+
+/**
+ * @brief Create a new instance of SmartBmsLog.
+ * The log uses at most twice the maximum storage size and keeps at least the maximum storage size of the most recent data.
+ * @param firstStorage first storage of the log, must stay valid while the log is used
+ * @param secondStorage second storage of the log, must stay valid while the log is used
+ * @param maxStorageSize maximum size of each storage in bytes, at least SMART_BMS_LOG_BLOCK_SIZE
+ */
+SmartBmsLog::SmartBmsLog(SmartBmsLogStorage *firstStorage, SmartBmsLogStorage *secondStorage, const size_t maxStorageSize)
+{
+	this->storages_[0] = firstStorage;
+	this->storages_[1] = secondStorage;
+	this->maxStorageSize_ = maxStorageSize < SMART_BMS_LOG_BLOCK_SIZE ? SMART_BMS_LOG_BLOCK_SIZE : maxStorageSize;
+	this->activeStorage_ = 0;
+	this->generation_ = 0;
+	this->payloadLength_ = 0;
+	this->pendingRecordCount_ = 0;
+	this->firstTimestamp_ = 0;
+	this->lastTimestamp_ = 0;
+	this->blockCounts_[0] = 0;
+	this->blockCounts_[1] = 0;
+	this->recordCounts_[0] = 0;
+	this->recordCounts_[1] = 0;
+	this->truncatedByteCount_ = 0;
+}
+
+/**
+ * @brief Destroy the SmartBmsLog instance. Pending records are not written, call flush() before.
+ */
+SmartBmsLog::~SmartBmsLog()
+{
+}
+
+/**
+ * @brief Check the blocks in both storages, recover from an interrupted write and continue with the storage that has the newer data.
+ * Each storage is truncated in front of its first damaged block, which is usually a block that was written during a power loss.
+ * @return SmartBmsError::SBMS_OK when the log is ready
+ * @return SmartBmsError::SBMS_ERR_STORAGE when a storage could not be read or truncated
+ */
+const SmartBmsError SmartBmsLog::begin()
+{
+	this->truncatedByteCount_ = 0;
+	uint16_t generations[2] = {0, 0};
+	for (size_t i = 0; i < 2; i++)
+	{
+		const SmartBmsError err = this->check_(i, &generations[i]);
+		if (err != SmartBmsError::SBMS_OK)
+		{
+			return err;
+		}
+	}
+
+	// An empty storage was cleared by the last rotation or never used, otherwise the storage with the later generation is newer
+	if (this->blockCounts_[0] == 0 || this->blockCounts_[1] == 0)
+	{
+		this->activeStorage_ = this->blockCounts_[1] > 0 ? 1 : 0;
+	}
+	else
+	{
+		this->activeStorage_ = static_cast<int16_t>(generations[1] - generations[0]) > 0 ? 1 : 0;
+	}
+	this->generation_ = generations[this->activeStorage_];
+	return SmartBmsError::SBMS_OK;
+}
+
+/**
+ * @brief Add a record to the current block. The block is written when it is full.
+ * Only changed fields are stored, so a record of a frame without changes needs only a few bytes.
+ * @param smartBmsData data to add
+ * @param timestamp time of the data in ms
+ * @return SmartBmsError::SBMS_OK when the record was added
+ * @return SmartBmsError::SBMS_ERR_STORAGE when a full block could not be written, the record is still added to the next block
+ */
+const SmartBmsError SmartBmsLog::append(const SmartBmsData &smartBmsData, const uint32_t timestamp)
+{
+	SmartBmsError err = SmartBmsError::SBMS_OK;
+	if (SMART_BMS_LOG_HEADER_SIZE + this->payloadLength_ + SMART_BMS_LOG_MAX_RECORD_SIZE + SMART_BMS_LOG_CHECKSUM_SIZE > SMART_BMS_LOG_BLOCK_SIZE)
+	{
+		err = this->flush();
+		if (err != SmartBmsError::SBMS_OK)
+		{
+			// Start over, so the log keeps the most recent data
+			this->payloadLength_ = 0;
+			this->pendingRecordCount_ = 0;
+		}
+	}
+
+	// The first record of a block is stored against empty data
+	if (this->pendingRecordCount_ == 0)
+	{
+		this->previousData_ = SmartBmsData();
+		this->firstTimestamp_ = timestamp;
+		this->lastTimestamp_ = timestamp;
+	}
+
+	uint32_t changedMask = 0;
+	for (size_t i = 0; i < SBMS_FIELD_COUNT; i++)
+	{
+		const SmartBmsField field = static_cast<SmartBmsField>(i);
+		if (smartBmsData.hasField(field) && (!this->previousData_.hasField(field) || smartBmsData.getRawValue(field) != this->previousData_.getRawValue(field)))
+		{
+			changedMask |= SBMS_FIELD_MASK(i);
+		}
+	}
+
+	// Write the record behind the header space of the block
+	uint8_t *payload = &this->block_[SMART_BMS_LOG_HEADER_SIZE];
+	const size_t payloadSize = SMART_BMS_LOG_BLOCK_SIZE - SMART_BMS_LOG_HEADER_SIZE - SMART_BMS_LOG_CHECKSUM_SIZE;
+	SmartBmsDeltaCodec::writeVarint(payload, payloadSize, &this->payloadLength_, timestamp - this->lastTimestamp_);
+	SmartBmsDeltaCodec::writeVarint(payload, payloadSize, &this->payloadLength_, changedMask);
+	for (size_t i = 0; i < SBMS_FIELD_COUNT; i++)
+	{
+		if (changedMask & SBMS_FIELD_MASK(i))
+		{
+			const int32_t delta = smartBmsData.values_[i] - this->previousData_.values_[i];
+			SmartBmsDeltaCodec::writeVarint(payload, payloadSize, &this->payloadLength_, SmartBmsDeltaCodec::zigzagEncode(delta));
+			this->previousData_.values_[i] = smartBmsData.values_[i];
+		}
+	}
+	this->previousData_.fieldMask_ |= changedMask;
+	this->lastTimestamp_ = timestamp;
+	this->pendingRecordCount_++;
+	return err;
+}
+
+/**
+ * @brief Write the current block to the storage, even when it is not full.
+ * Flushing often protects more data against a power loss, but creates smaller blocks and more writes.
+ * @return SmartBmsError::SBMS_OK when the block was written or there was nothing to write
+ * @return SmartBmsError::SBMS_ERR_STORAGE when the block could not be written, it is kept for the next attempt
+ */
+const SmartBmsError SmartBmsLog::flush()
+{
+	if (this->pendingRecordCount_ == 0)
+	{
+		return SmartBmsError::SBMS_OK;
+	}
+
+	// Continue in the other storage when the block does not fit, the block carries the generation of the storage it is written to
+	const size_t checksumOffset = SMART_BMS_LOG_HEADER_SIZE + this->payloadLength_;
+	const size_t blockSize = checksumOffset + SMART_BMS_LOG_CHECKSUM_SIZE;
+	if (this->storages_[this->activeStorage_]->getSize() + blockSize > this->maxStorageSize_)
+	{
+		const SmartBmsError err = this->rotate_();
+		if (err != SmartBmsError::SBMS_OK)
+		{
+			return err;
+		}
+	}
+
+	// Complete the block with header and checksum
+	SmartBmsLog::writeUint_(&this->block_[0], SMART_BMS_LOG_BLOCK_MAGIC, 2);
+	SmartBmsLog::writeUint_(&this->block_[2], this->payloadLength_, 2);
+	SmartBmsLog::writeUint_(&this->block_[4], this->pendingRecordCount_, 2);
+	SmartBmsLog::writeUint_(&this->block_[6], this->generation_, 2);
+	SmartBmsLog::writeUint_(&this->block_[8], this->firstTimestamp_, 4);
+	SmartBmsLog::writeUint_(&this->block_[12], this->lastTimestamp_, 4);
+	SmartBmsLog::writeUint_(&this->block_[checksumOffset], SmartBmsLog::calculateChecksum(this->block_, checksumOffset), 4);
+
+	// Write the block at once, a partial write is removed again so the next block starts at a valid position
+	SmartBmsLogStorage *storage = this->storages_[this->activeStorage_];
+	const size_t size = storage->getSize();
+	if (!storage->append(this->block_, blockSize) || !storage->sync())
+	{
+		storage->truncate(size);
+		return SmartBmsError::SBMS_ERR_STORAGE;
+	}
+
+	this->blockCounts_[this->activeStorage_]++;
+	this->recordCounts_[this->activeStorage_] += this->pendingRecordCount_;
+	this->payloadLength_ = 0;
+	this->pendingRecordCount_ = 0;
+	return SmartBmsError::SBMS_OK;
+}
+
+/**
+ * @brief Read all records, including the records that are not written yet.
+ * @param callback function that is called for every record, returns false to stop
+ * @param context user defined pointer that is passed to the callback
+ * @return SmartBmsError::SBMS_OK when all records were read or the callback stopped
+ * @return SmartBmsError::SBMS_ERR_STORAGE when the storage could not be read
+ * @return SmartBmsError::SBMS_ERR_INVALID_DATA when a block is damaged
+ */
+const SmartBmsError SmartBmsLog::forEach(SmartBmsLogCallback callback, void *context)
+{
+	return this->forEach_(false, 0, callback, context);
+}
+
+/**
+ * @brief Read all records starting at a point in time, including the records that are not written yet.
+ * Blocks that end before the start time are skipped based on their header.
+ * Timestamps are compared with wrap around, so the start time must be less than 2^31 ms in the past of the records.
+ * @param from time in ms of the first record to read
+ * @param callback function that is called for every record, returns false to stop
+ * @param context user defined pointer that is passed to the callback
+ * @return SmartBmsError::SBMS_OK when all records were read or the callback stopped
+ * @return SmartBmsError::SBMS_ERR_STORAGE when the storage could not be read
+ * @return SmartBmsError::SBMS_ERR_INVALID_DATA when a block is damaged
+ */
+const SmartBmsError SmartBmsLog::forEach(const uint32_t from, SmartBmsLogCallback callback, void *context)
+{
+	return this->forEach_(true, from, callback, context);
+}
+
+/**
+ * @brief Get the number of blocks in both storages.
+ * @return number of blocks
+ */
+const uint32_t SmartBmsLog::getBlockCount() const
+{
+	return this->blockCounts_[0] + this->blockCounts_[1];
+}
+
+/**
+ * @brief Get the number of records in both storages.
+ * @return number of records
+ */
+const uint32_t SmartBmsLog::getRecordCount() const
+{
+	return this->recordCounts_[0] + this->recordCounts_[1];
+}
+
+/**
+ * @brief Get the number of records that are not written yet.
+ * @return number of records
+ */
+const size_t SmartBmsLog::getPendingRecordCount() const
+{
+	return this->pendingRecordCount_;
+}
+
+/**
+ * @brief Get the number of bytes that were dropped by begin() because they did not form a valid block, summed over both storages.
+ * @return number of bytes
+ */
+const size_t SmartBmsLog::getTruncatedByteCount() const
+{
+	return this->truncatedByteCount_;
+}
+
+/**
+ * @brief Calculate the CRC-32 of a buffer, as used by zlib.
+ * @param buffer data
+ * @param length number of bytes
+ * @return checksum
+ */
+const uint32_t SmartBmsLog::calculateChecksum(const uint8_t *buffer, const size_t length)
+{
+	uint32_t checksum = 0xFFFFFFFF;
+	for (size_t i = 0; i < length; i++)
+	{
+		checksum ^= buffer[i];
+		for (uint8_t j = 0; j < 8; j++)
+		{
+			checksum = (checksum >> 1) ^ (0xEDB88320 & (0 - (checksum & 1)));
+		}
+	}
+	return ~checksum;
+}
+
+/**
+ * @brief Check the blocks of a storage and drop everything behind the last valid block.
+ * @param storageIndex index of the storage
+ * @param generation receives the generation of the first block, 0 when the storage is empty
+ * @return SmartBmsError::SBMS_OK when the storage was checked
+ * @return SmartBmsError::SBMS_ERR_STORAGE when the storage could not be read or truncated
+ */
+const SmartBmsError SmartBmsLog::check_(const size_t storageIndex, uint16_t *generation)
+{
+	SmartBmsLogStorage *storage = this->storages_[storageIndex];
+	this->blockCounts_[storageIndex] = 0;
+	this->recordCounts_[storageIndex] = 0;
+	*generation = 0;
+
+	const size_t size = storage->getSize();
+	size_t offset = 0;
+	size_t payloadLength = 0;
+	SmartBmsError err = SmartBmsError::SBMS_OK;
+	while ((err = this->readBlock_(storage, offset, size, &payloadLength)) == SmartBmsError::SBMS_OK)
+	{
+		if (this->blockCounts_[storageIndex] == 0)
+		{
+			*generation = SmartBmsLog::readUint_(&this->readBuffer_[6], 2);
+		}
+		this->blockCounts_[storageIndex]++;
+		this->recordCounts_[storageIndex] += SmartBmsLog::readUint_(&this->readBuffer_[4], 2);
+		offset += SMART_BMS_LOG_HEADER_SIZE + payloadLength + SMART_BMS_LOG_CHECKSUM_SIZE;
+	}
+
+	// A read error says nothing about the data, so nothing is dropped
+	if (err == SmartBmsError::SBMS_ERR_STORAGE)
+	{
+		return err;
+	}
+	if (offset < size)
+	{
+		this->truncatedByteCount_ += size - offset;
+		if (!storage->truncate(offset) || !storage->sync())
+		{
+			return SmartBmsError::SBMS_ERR_STORAGE;
+		}
+	}
+	return SmartBmsError::SBMS_OK;
+}
+
+/**
+ * @brief Clear the other storage, which holds the oldest data, and make it the active one with the next generation.
+ * A power loss in between leaves an empty storage, which begin() does not pick as active one.
+ * @return SmartBmsError::SBMS_OK when the storages were switched
+ * @return SmartBmsError::SBMS_ERR_STORAGE when the other storage could not be cleared
+ */
+const SmartBmsError SmartBmsLog::rotate_()
+{
+	const size_t otherStorage = 1 - this->activeStorage_;
+	if (!this->storages_[otherStorage]->truncate(0) || !this->storages_[otherStorage]->sync())
+	{
+		return SmartBmsError::SBMS_ERR_STORAGE;
+	}
+	this->blockCounts_[otherStorage] = 0;
+	this->recordCounts_[otherStorage] = 0;
+	this->activeStorage_ = otherStorage;
+	this->generation_++;
+	return SmartBmsError::SBMS_OK;
+}
+
+/**
+ * @brief Read the records of all blocks and the pending records.
+ * @param filter true to skip the records before the start time
+ * @param from time in ms of the first record to read
+ * @param callback function that is called for every record, returns false to stop
+ * @param context user defined pointer that is passed to the callback
+ * @return SmartBmsError::SBMS_OK when all records were read or the callback stopped
+ * @return SmartBmsError::SBMS_ERR_STORAGE when the storage could not be read
+ * @return SmartBmsError::SBMS_ERR_INVALID_DATA when a block is damaged
+ */
+const SmartBmsError SmartBmsLog::forEach_(const bool filter, const uint32_t from, SmartBmsLogCallback callback, void *context)
+{
+	// The other storage holds the older data
+	for (size_t i = 1; i <= 2; i++)
+	{
+		SmartBmsLogStorage *storage = this->storages_[(this->activeStorage_ + i) % 2];
+		const size_t size = storage->getSize();
+		size_t offset = 0;
+		size_t payloadLength = 0;
+		while (offset < size)
+		{
+			const SmartBmsError err = this->readBlock_(storage, offset, size, &payloadLength);
+			if (err != SmartBmsError::SBMS_OK)
+			{
+				return err;
+			}
+			offset += SMART_BMS_LOG_HEADER_SIZE + payloadLength + SMART_BMS_LOG_CHECKSUM_SIZE;
+
+			const uint32_t lastTimestamp = SmartBmsLog::readUint_(&this->readBuffer_[12], 4);
+			if ((!filter || static_cast<int32_t>(lastTimestamp - from) >= 0) && !this->decodeBlock_(this->readBuffer_, filter, from, callback, context))
+			{
+				return SmartBmsError::SBMS_OK;
+			}
+		}
+	}
+
+	// Records that are not written yet
+	if (this->pendingRecordCount_ > 0)
+	{
+		SmartBmsLog::writeUint_(&this->block_[2], this->payloadLength_, 2);
+		SmartBmsLog::writeUint_(&this->block_[4], this->pendingRecordCount_, 2);
+		SmartBmsLog::writeUint_(&this->block_[8], this->firstTimestamp_, 4);
+		this->decodeBlock_(this->block_, filter, from, callback, context);
+	}
+	return SmartBmsError::SBMS_OK;
+}
+
+/**
+ * @brief Read a block into the read buffer and verify it.
+ * @param storage storage to read from
+ * @param offset position of the block
+ * @param size size of the storage
+ * @param payloadLength receives the length of the payload
+ * @return SmartBmsError::SBMS_OK when the block is complete and the checksum matches
+ * @return SmartBmsError::SBMS_ERR_STORAGE when the storage could not be read
+ * @return SmartBmsError::SBMS_ERR_INVALID_DATA when the block is incomplete or damaged
+ */
+const SmartBmsError SmartBmsLog::readBlock_(SmartBmsLogStorage *storage, const size_t offset, const size_t size, size_t *payloadLength)
+{
+	if (offset > size || size - offset < SMART_BMS_LOG_HEADER_SIZE + SMART_BMS_LOG_CHECKSUM_SIZE)
+	{
+		return SmartBmsError::SBMS_ERR_INVALID_DATA;
+	}
+	if (!storage->read(offset, this->readBuffer_, SMART_BMS_LOG_HEADER_SIZE))
+	{
+		return SmartBmsError::SBMS_ERR_STORAGE;
+	}
+
+	// Check the header before trusting the length
+	*payloadLength = SmartBmsLog::readUint_(&this->readBuffer_[2], 2);
+	const size_t blockSize = SMART_BMS_LOG_HEADER_SIZE + *payloadLength + SMART_BMS_LOG_CHECKSUM_SIZE;
+	if (SmartBmsLog::readUint_(&this->readBuffer_[0], 2) != SMART_BMS_LOG_BLOCK_MAGIC || blockSize > SMART_BMS_LOG_BLOCK_SIZE || blockSize > size - offset)
+	{
+		return SmartBmsError::SBMS_ERR_INVALID_DATA;
+	}
+
+	if (!storage->read(offset + SMART_BMS_LOG_HEADER_SIZE, &this->readBuffer_[SMART_BMS_LOG_HEADER_SIZE], *payloadLength + SMART_BMS_LOG_CHECKSUM_SIZE))
+	{
+		return SmartBmsError::SBMS_ERR_STORAGE;
+	}
+	const size_t checksumOffset = SMART_BMS_LOG_HEADER_SIZE + *payloadLength;
+	if (SmartBmsLog::readUint_(&this->readBuffer_[checksumOffset], 4) != SmartBmsLog::calculateChecksum(this->readBuffer_, checksumOffset))
+	{
+		return SmartBmsError::SBMS_ERR_INVALID_DATA;
+	}
+	return SmartBmsError::SBMS_OK;
+}
+
+/**
+ * @brief Decode the records of a block and pass the ones at or after the start time to the callback.
+ * @param block block with header and payload
+ * @param filter true to skip the records before the start time
+ * @param from time in ms of the first record to pass
+ * @param callback function that is called for every record
+ * @param context user defined pointer that is passed to the callback
+ * @return true when the block was decoded completely
+ * @return false when the callback stopped or the payload is malformed
+ */
+const bool SmartBmsLog::decodeBlock_(const uint8_t *block, const bool filter, const uint32_t from, SmartBmsLogCallback callback, void *context)
+{
+	const size_t payloadLength = SmartBmsLog::readUint_(&block[2], 2);
+	const uint16_t recordCount = SmartBmsLog::readUint_(&block[4], 2);
+	const uint8_t *payload = &block[SMART_BMS_LOG_HEADER_SIZE];
+	uint32_t timestamp = SmartBmsLog::readUint_(&block[8], 4);
+	SmartBmsData smartBmsData;
+	size_t position = 0;
+	for (uint16_t i = 0; i < recordCount; i++)
+	{
+		uint32_t timestampDelta = 0;
+		uint32_t changedMask = 0;
+		if (SmartBmsDeltaCodec::readVarint(payload, payloadLength, &position, &timestampDelta) != SmartBmsError::SBMS_OK ||
+			SmartBmsDeltaCodec::readVarint(payload, payloadLength, &position, &changedMask) != SmartBmsError::SBMS_OK ||
+			(changedMask & ~SBMS_FIELD_MASK_ALL) != 0)
+		{
+			return false;
+		}
+
+		// Apply the deltas to the previous record
+		for (size_t j = 0; j < SBMS_FIELD_COUNT; j++)
+		{
+			uint32_t value = 0;
+			if ((changedMask & SBMS_FIELD_MASK(j)) && SmartBmsDeltaCodec::readVarint(payload, payloadLength, &position, &value) != SmartBmsError::SBMS_OK)
+			{
+				return false;
+			}
+			smartBmsData.values_[j] += SmartBmsDeltaCodec::zigzagDecode(value);
+		}
+		smartBmsData.fieldMask_ |= changedMask;
+		smartBmsData.changedMask_ = changedMask;
+		timestamp += timestampDelta;
+
+		if ((!filter || static_cast<int32_t>(timestamp - from) >= 0) && !callback(&smartBmsData, timestamp, context))
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+/**
+ * @brief Write an unsigned integer in little endian order.
+ * @param buffer buffer to write to
+ * @param value value to write
+ * @param width number of bytes
+ */
+void SmartBmsLog::writeUint_(uint8_t *buffer, const uint32_t value, const size_t width)
+{
+	for (size_t i = 0; i < width; i++)
+	{
+		buffer[i] = value >> (8 * i);
+	}
+}
+
+/**
+ * @brief Read an unsigned integer in little endian order.
+ * @param buffer buffer to read from
+ * @param width number of bytes
+ * @return value
+ */
+const uint32_t SmartBmsLog::readUint_(const uint8_t *buffer, const size_t width)
+{
+	uint32_t value = 0;
+	for (size_t i = 0; i < width; i++)
+	{
+		value |= static_cast<uint32_t>(buffer[i]) << (8 * i);
+	}
+	return value;
+}
@@ -0,0 +1,149 @@
+/**
+ * @file SmartBmsLogStorage.cpp
+ * @author TheRealKasumi
+ * @brief Contains the interface of the storage behind the BMS log and an implementation based on stdio files.
+ * @copyright Copyright (c) 2024 TheRealKasumi
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#include "bms/SmartBmsLogStorage.h"
+
+#include <unistd.h>
+
+/**
+ * @brief Create a new instance of SmartBmsFileLogStorage without an open file.
+ */
+SmartBmsFileLogStorage::SmartBmsFileLogStorage()
+{
+	this->file_ = nullptr;
+}
+
+/**
+ * @brief Destroy the SmartBmsFileLogStorage instance and close the file.
+ */
+SmartBmsFileLogStorage::~SmartBmsFileLogStorage()
+{
+	this->close();
+}
+
+/**
+ * @brief Open the log file, it is created when it does not exist.
+ * On the ESP32 the path includes the mount point of the filesystem, like /littlefs/bms.log.
+ * @param path path of the file
+ * @return true when the file was opened
+ */
+const bool SmartBmsFileLogStorage::open(const char *path)
+{
+	this->close();
+	this->file_ = fopen(path, "r+b");
+	if (this->file_ == nullptr)
+	{
+		this->file_ = fopen(path, "w+b");
+	}
+	return this->file_ != nullptr;
+}
+
+/**
+ * @brief Close the file.
+ */
+void SmartBmsFileLogStorage::close()
+{
+	if (this->file_ != nullptr)
+	{
+		fclose(this->file_);
+		this->file_ = nullptr;
+	}
+}
+
+/**
+ * @brief Check if a file is open.
+ * @return true when a file is open
+ */
+const bool SmartBmsFileLogStorage::isOpen() const
+{
+	return this->file_ != nullptr;
+}
+
+/**
+ * @brief Get the size of the file.
+ * @return size in bytes, 0 when no file is open
+ */
+const size_t SmartBmsFileLogStorage::getSize()
+{
+	if (this->file_ == nullptr || fseek(this->file_, 0, SEEK_END) != 0)
+	{
+		return 0;
+	}
+	const long size = ftell(this->file_);
+	return size > 0 ? size : 0;
+}
+
+/**
+ * @brief Read from the file.
+ * @param offset position to read from
+ * @param buffer buffer that receives the data
+ * @param length number of bytes to read
+ * @return true when all bytes were read
+ */
+const bool SmartBmsFileLogStorage::read(const size_t offset, uint8_t *buffer, const size_t length)
+{
+	if (this->file_ == nullptr || fseek(this->file_, offset, SEEK_SET) != 0)
+	{
+		return false;
+	}
+	return fread(buffer, 1, length, this->file_) == length;
+}
+
+/**
+ * @brief Append to the end of the file.
+ * @param buffer data to append
+ * @param length number of bytes
+ * @return true when all bytes were written
+ */
+const bool SmartBmsFileLogStorage::append(const uint8_t *buffer, const size_t length)
+{
+	if (this->file_ == nullptr || fseek(this->file_, 0, SEEK_END) != 0)
+	{
+		return false;
+	}
+	return fwrite(buffer, 1, length, this->file_) == length;
+}
+
+/**
+ * @brief Cut the file to the given size.
+ * @param size new size in bytes
+ * @return true when the file was truncated
+ */
+const bool SmartBmsFileLogStorage::truncate(const size_t size)
+{
+	if (this->file_ == nullptr || fflush(this->file_) != 0)
+	{
+		return false;
+	}
+	return ftruncate(fileno(this->file_), size) == 0;
+}
+
+/**
+ * @brief Write buffered data to the filesystem.
+ * @return true when the data was written
+ */
+const bool SmartBmsFileLogStorage::sync()
+{
+	if (this->file_ == nullptr || fflush(this->file_) != 0)
+	{
+		return false;
+	}
+	return fsync(fileno(this->file_)) == 0;
+}
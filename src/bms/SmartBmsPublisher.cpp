@@ -0,0 +1,121 @@
+/**
+ * @file SmartBmsPublisher.cpp
+ * @author TheRealKasumi
+ * @brief Implementation of the SmartBmsPublisher class.
+ * @copyright Copyright (c) 2024 TheRealKasumi
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#include "bms/SmartBmsPublisher.h"
+
+#if defined(ESP32)
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#else
+#include <thread>
+#endif
+
+/**
+ * @brief Create a new instance of SmartBmsPublisher.
+ */
+SmartBmsPublisher::SmartBmsPublisher()
+{
+	this->sequence_ = 0;
+}
+
+/**
+ * @brief Destroy the SmartBmsPublisher instance.
+ */
+SmartBmsPublisher::~SmartBmsPublisher()
+{
+}
+
+/**
+ * @brief Publish new BMS data. This is a sequence lock, so there must only be a single publisher.
+ * The publisher never waits for readers.
+ * @param smartBmsData data to publish
+ */
+void SmartBmsPublisher::publish(const SmartBmsData &smartBmsData)
+{
+	// An odd sequence marks the data as being written
+	const uint32_t sequence = this->sequence_.load(std::memory_order_relaxed);
+	this->sequence_.store(sequence + 1, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+
+	this->smartBmsData_ = smartBmsData;
+
+	// An even sequence marks the data as consistent again
+	this->sequence_.store(sequence + 2, std::memory_order_release);
+}
+
+/**
+ * @brief Get a consistent copy of the latest published data. Can be called by any number of readers.
+ * When the data is updated while copying, the reader yields and copies again, at most SMART_BMS_PUBLISHER_MAX_RETRIES times.
+ * Yielding lets a writer of the same priority on the same core finish, a writer of lower priority only finishes
+ * once the reader blocks. So a reader that gets false must not retry in a busy loop, but wait for its next cycle.
+ * @param smartBmsData reference to a SmartBmsData object that will receive the data
+ * @return true when a consistent copy was made
+ * @return false when no data was published yet or the data was updated during every attempt
+ */
+const bool SmartBmsPublisher::getSnapshot(SmartBmsData *smartBmsData) const
+{
+	for (uint32_t attempt = 0; attempt < SMART_BMS_PUBLISHER_MAX_RETRIES; attempt++)
+	{
+		// An odd sequence means the data is being written right now
+		const uint32_t sequenceBefore = this->sequence_.load(std::memory_order_acquire);
+		if (sequenceBefore & 1)
+		{
+			SmartBmsPublisher::yield_();
+			continue;
+		}
+		if (sequenceBefore == 0)
+		{
+			return false;
+		}
+
+		*smartBmsData = this->smartBmsData_;
+
+		// The copy is only consistent when no publication started in the meantime
+		std::atomic_thread_fence(std::memory_order_acquire);
+		if (this->sequence_.load(std::memory_order_relaxed) == sequenceBefore)
+		{
+			return true;
+		}
+		SmartBmsPublisher::yield_();
+	}
+	return false;
+}
+
+/**
+ * @brief Get the version of the published data. It changes with every publication.
+ * Readers can compare it to find out if new data is available without copying it.
+ * @return version of the data
+ */
+const uint32_t SmartBmsPublisher::getVersion() const
+{
+	return this->sequence_.load(std::memory_order_acquire) >> 1;
+}
+
+/**
+ * @brief Give other tasks or threads the chance to run, so a writer that was interrupted can finish.
+ */
+void SmartBmsPublisher::yield_()
+{
+#if defined(ESP32)
+	taskYIELD();
+#else
+	std::this_thread::yield();
+#endif
+}
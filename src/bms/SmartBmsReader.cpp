@@ -25,13 +25,33 @@
 
 /**
  * @brief Create a new instance of SmartBmsReader.
- * @param inputStream input stream from which the BMS data is read
+ * @param inputStream input stream from which the BMS data is read, can be nullptr when only feed() is used
  */
 SmartBmsReader::SmartBmsReader(Stream *inputStream)
 {
-	// Set the stream and clear it
 	this->inputStream_ = inputStream;
-	this->inputStream_->flush();
+	this->frameCallback_ = nullptr;
+	this->frameCallbackContext_ = nullptr;
+	this->subscriptionCount_ = 0;
+	this->previousStatus_ = 0;
+	this->hasPreviousStatus_ = false;
+	this->lastStatus_ = 0;
+	this->hasLastStatus_ = false;
+	this->fieldMask_ = SBMS_FIELD_MASK_ALL;
+	this->clock_ = SmartBmsSystemClock::getMicros;
+	this->skippedByteCount_ = 0;
+	this->aligned_ = false;
+	this->hasPreviousFrame_ = false;
+	this->lastFrameTimestamp_ = 0;
+	this->hasLastFrameTimestamp_ = false;
+	this->cyclePeriod_ = 0;
+	this->lastJitter_ = 0;
+	this->jitter_ = 0;
+	this->missedCycleCount_ = 0;
+#ifdef SMART_BMS_STATISTICS
+	this->statistics_ = nullptr;
+#endif
+	this->clearWindow_();
 }
 
 /**
@@ -42,155 +62,572 @@ SmartBmsReader::~SmartBmsReader()
 }
 
 /**
- * @brief Check if the input stream is ready to be read. Once it contains at least 58 bytes, it is considdered ready.
+ * @brief Check if the input stream is ready to be read. Once the buffered and the available bytes can complete
+ * the 58 byte window, it is considdered ready.
  * @return SmartBmsError::SBMS_OK when the input stream is ready to be read
  * @return SmartBmsError::SBMS_ERR_NOT_ENOUGH_DATA when not enough data is available yet
  */
 const SmartBmsError SmartBmsReader::bmsDataReady() const
 {
-	return this->inputStream_->available() >= 58 ? SmartBmsError::SBMS_OK : SmartBmsError::SBMS_ERR_NOT_ENOUGH_DATA;
+	if (this->inputStream_ == nullptr)
+	{
+		return SmartBmsError::SBMS_ERR_NOT_ENOUGH_DATA;
+	}
+
+	const int available = this->inputStream_->available();
+	if (available <= 0)
+	{
+		return SmartBmsError::SBMS_ERR_NOT_ENOUGH_DATA;
+	}
+	return this->windowLength_ + available >= SMART_BMS_FRAME_SIZE ? SmartBmsError::SBMS_OK : SmartBmsError::SBMS_ERR_NOT_ENOUGH_DATA;
 }
 
 /**
  * @brief Decode a single frame of BMS data from the input stream.
+ * The reader keeps a rolling window of the last 58 bytes together with a running checksum.
+ * When the checksum does not match or the window is not a valid frame, the window slides by one byte until it is aligned to a frame again.
+ * A window that directly follows the previous frame only needs a consistent structure, a window found by sliding must also have plausible values, see SmartBmsFrameView::isPlausible().
+ * Bytes that are not yet part of a complete frame stay buffered for the next call.
+ * Only bytes that are already available are read, so this call never waits for the stream timeout.
+ * The changed mask of the data is relative to the previous frame decoded into SmartBmsData by this reader.
  * @param smartBmsData reference to a SmartBmsData object that will receive the data
- * @return SmartBmsError with error information
+ * @return SmartBmsError::SBMS_OK when a frame was decoded
+ * @return SmartBmsError::SBMS_ERR_NOT_ENOUGH_DATA when the available data did not complete a frame
+ * @return SmartBmsError::SBMS_ERR_READ_STREAM when the input stream could not be read
+ * @return SmartBmsError::SBMS_ERR_INVALID_CHECKSUM when bytes were skipped without finding a valid frame yet
  */
-const SmartBmsError SmartBmsReader::decodeBmsData(SmartBmsData *smartBmsData) const
+const SmartBmsError SmartBmsReader::decodeBmsData(SmartBmsData *smartBmsData)
 {
-	// Ensure enough data is available in the input stream
-	if (this->bmsDataReady() != SmartBmsError::SBMS_OK)
+	SmartBmsFrameView frameView;
+	const SmartBmsError err = this->decodeBmsData(&frameView);
+	if (err == SmartBmsError::SBMS_OK)
 	{
-		return SmartBmsError::SBMS_ERR_NOT_ENOUGH_DATA;
+		this->decode(frameView, smartBmsData);
 	}
+	return err;
+}
 
-	// Create a buffer for the 58 bytes and read it from the input stream
-	uint8_t buffer[58];
-	if (this->inputStream_->readBytes(buffer, sizeof(buffer)) != 58)
+/**
+ * @brief Read a single frame of BMS data from the input stream without decoding it.
+ * See decodeBmsData(SmartBmsData *) for details.
+ * @param frameView reference to a SmartBmsFrameView object that will receive the frame
+ * @return SmartBmsError::SBMS_OK when a frame was read
+ * @return SmartBmsError::SBMS_ERR_NOT_ENOUGH_DATA when the available data did not complete a frame
+ * @return SmartBmsError::SBMS_ERR_READ_STREAM when the input stream could not be read
+ * @return SmartBmsError::SBMS_ERR_INVALID_CHECKSUM when bytes were skipped without finding a valid frame yet
+ */
+const SmartBmsError SmartBmsReader::decodeBmsData(SmartBmsFrameView *frameView)
+{
+	if (this->inputStream_ == nullptr)
 	{
 		return SmartBmsError::SBMS_ERR_READ_STREAM;
 	}
 
-	// Calculate the checksum
-	uint8_t checkSum = 0;
-	for (size_t i = 0; i < sizeof(buffer) - 1; i++)
+	const uint32_t skippedByteCount = this->skippedByteCount_;
+	uint8_t buffer[SMART_BMS_FRAME_SIZE];
+	while (true)
 	{
-		checkSum += buffer[i];
+		// Read only what is required to complete the window, so no bytes of the next frame are consumed
+		const int available = this->inputStream_->available();
+		if (available <= 0)
+		{
+			break;
+		}
+		size_t length = this->windowLength_ < SMART_BMS_FRAME_SIZE ? SMART_BMS_FRAME_SIZE - this->windowLength_ : 1;
+		if (length > static_cast<size_t>(available))
+		{
+			length = available;
+		}
+		if (this->inputStream_->readBytes(buffer, length) != length)
+		{
+#ifdef SMART_BMS_STATISTICS
+			if (this->statistics_ != nullptr)
+			{
+				this->statistics_->countReadError();
+			}
+#endif
+			return SmartBmsError::SBMS_ERR_READ_STREAM;
+		}
+
+		// The checksum can only match on the last byte of the chunk, so the whole chunk is consumed
+		size_t consumed = 0;
+		if (this->feed(buffer, length, &consumed, frameView) == SmartBmsError::SBMS_OK)
+		{
+			return SmartBmsError::SBMS_OK;
+		}
 	}
 
-	// Verify the checksum
-	if (checkSum != buffer[sizeof(buffer) - 1])
+	// Report a checksum error when bytes had to be skipped and no frame could be found yet
+	return this->skippedByteCount_ != skippedByteCount ? SmartBmsError::SBMS_ERR_INVALID_CHECKSUM : SmartBmsError::SBMS_ERR_NOT_ENOUGH_DATA;
+}
+
+/**
+ * @brief Feed raw bytes into the decoder until the next frame is complete.
+ * This does not block and can be called with bytes from any source, like a UART event, a DMA buffer or a file.
+ * When a frame is complete, the remaining bytes are not consumed and can be passed in the next call.
+ * @param data bytes received from the BMS
+ * @param length number of bytes
+ * @param consumed receives the number of bytes that were consumed
+ * @param smartBmsData reference to a SmartBmsData object that will receive the data
+ * @return SmartBmsError::SBMS_OK when a frame was decoded
+ * @return SmartBmsError::SBMS_ERR_NOT_ENOUGH_DATA when all bytes were consumed without completing a frame
+ */
+const SmartBmsError SmartBmsReader::feed(const uint8_t *data, const size_t length, size_t *consumed, SmartBmsData *smartBmsData)
+{
+	SmartBmsFrameView frameView;
+	const SmartBmsError err = this->feed(data, length, consumed, &frameView);
+	if (err == SmartBmsError::SBMS_OK)
+	{
+		this->decode(frameView, smartBmsData);
+	}
+	return err;
+}
+
+/**
+ * @brief Feed raw bytes into the decoder until the next frame is complete, without decoding it.
+ * See feed(const uint8_t *, const size_t, size_t *, SmartBmsData *) for details.
+ * The last byte is assumed to be received just now, the bytes before it are dated back by SMART_BMS_BYTE_DURATION_US each.
+ * The frame is stamped with the time of its first byte, so feeding small chunks soon after they arrived gives the best timestamps.
+ * @param data bytes received from the BMS
+ * @param length number of bytes
+ * @param consumed receives the number of bytes that were consumed
+ * @param frameView reference to a SmartBmsFrameView object that will receive the frame
+ * @return SmartBmsError::SBMS_OK when a frame was completed
+ * @return SmartBmsError::SBMS_ERR_NOT_ENOUGH_DATA when all bytes were consumed without completing a frame
+ */
+const SmartBmsError SmartBmsReader::feed(const uint8_t *data, const size_t length, size_t *consumed, SmartBmsFrameView *frameView)
+{
+#ifdef SMART_BMS_STATISTICS
+	const uint32_t skippedByteCount = this->skippedByteCount_;
+	const uint32_t missedCycleCount = this->missedCycleCount_;
+#endif
+	uint32_t byteTimestamp = this->clock_() - (length - 1) * SMART_BMS_BYTE_DURATION_US;
+	for (size_t i = 0; i < length; i++, byteTimestamp += SMART_BMS_BYTE_DURATION_US)
 	{
-		// Flush the stream
-		this->inputStream_->flush();
-		return SmartBmsError::SBMS_ERR_INVALID_CHECKSUM;
+		if (this->pushByte_(data[i], byteTimestamp))
+		{
+			// Take the aligned frame out of the window, together with the time of its first byte
+			const uint32_t timestamp = this->windowTimestamps_[this->windowStart_];
+			uint8_t buffer[SMART_BMS_FRAME_SIZE];
+			this->copyWindow_(buffer);
+			const SmartBmsFrameView candidate(buffer, timestamp);
+
+			// One in 256 windows of a shifted or corrupted stream matches the 8 bit checksum by chance, its values give it away
+			// A window that directly follows the previous frame is aligned, its values may be out of range when a cell failed, so only its structure is checked
+			if (this->aligned_ ? candidate.isWellFormed() : candidate.isPlausible())
+			{
+				if (this->subscriptionCount_ > 0)
+				{
+					this->dispatchFlags_(buffer[SMART_BMS_STATUS_OFFSET], timestamp);
+				}
+				this->clearWindow_();
+				this->aligned_ = true;
+				*frameView = candidate;
+				*consumed = i + 1;
+				this->trackCycle_(timestamp);
+#ifdef SMART_BMS_STATISTICS
+				if (this->statistics_ != nullptr)
+				{
+					this->statistics_->countSkippedBytes(this->skippedByteCount_ - skippedByteCount);
+					this->statistics_->countMissedCycles(this->missedCycleCount_ - missedCycleCount);
+					this->statistics_->countFrame(timestamp);
+				}
+#endif
+				return SmartBmsError::SBMS_OK;
+			}
+		}
+#ifdef SMART_BMS_STATISTICS
+		// The first full window that is not accepted starts a resynchronization, sliding on from there is not counted again
+		if (this->windowLength_ == SMART_BMS_FRAME_SIZE && !this->resynchronizing_)
+		{
+			this->resynchronizing_ = true;
+			if (this->statistics_ != nullptr)
+			{
+				this->statistics_->countChecksumError();
+			}
+		}
+#endif
 	}
 
-	// Decode the BMS data from the buffer
-	smartBmsData->cellCount_ = buffer[25];
-	smartBmsData->cellVoltageMin_ = this->decodeCellVoltage_(&buffer[51]);
-	smartBmsData->cellVoltageMax_ = this->decodeCellVoltage_(&buffer[53]);
-	smartBmsData->cellVoltageBalance_ = this->decodeCellVoltage_(&buffer[55]);
-	smartBmsData->packSoc_ = buffer[40];
-	smartBmsData->packVoltage_ = this->decodePackVoltage_(&buffer[0]);
-	smartBmsData->packCurrent_ = this->decodePackCurrent_(&buffer[9]);
-	smartBmsData->packChargeCurrent_ = this->decodePackCurrent_(&buffer[3]);
-	smartBmsData->packDischargeCurrent_ = this->decodePackCurrent_(&buffer[6]);
-	smartBmsData->packCapacity_ = this->decodeTwoByteValue_(&buffer[49]) * 0.1f;
-	smartBmsData->packRemainingEnergy_ = this->decodeThreeByteValue_(&buffer[34]) * 0.001f;
-	smartBmsData->lowestCellVoltage_ = this->decodeCellVoltage_(&buffer[12]);
-	smartBmsData->lowestCellVoltageNumber_ = buffer[14];
-	smartBmsData->highestCellVoltage_ = this->decodeCellVoltage_(&buffer[15]);
-	smartBmsData->highestCellVoltageNumber_ = buffer[17];
-	smartBmsData->lowestCellTemperature_ = this->decodeCellTemperature_(&buffer[18]);
-	smartBmsData->lowestCellTemperatureNumber_ = buffer[20];
-	smartBmsData->highestCellTemperature_ = this->decodeCellTemperature_(&buffer[21]);
-	smartBmsData->highestCellTemperatureNumber_ = buffer[23];
-	smartBmsData->communicationError_ = buffer[30] & 0b00000100;
-	smartBmsData->allowedToCharge_ = buffer[30] & 0b00000001;
-	smartBmsData->allowedToDischarge_ = buffer[30] & 0b00000010;
-	smartBmsData->minVoltageAlarmActive_ = buffer[30] & 0b00001000;
-	smartBmsData->maxVoltageAlarmActive_ = buffer[30] & 0b00010000;
-	smartBmsData->minTemperatureAlarmActive_ = buffer[30] & 0b00100000;
-	smartBmsData->maxTemperatureAlarmActive_ = buffer[30] & 0b01000000;
-	return SmartBmsError::SBMS_OK;
+	*consumed = length;
+#ifdef SMART_BMS_STATISTICS
+	if (this->statistics_ != nullptr)
+	{
+		this->statistics_->countSkippedBytes(this->skippedByteCount_ - skippedByteCount);
+	}
+#endif
+	return SmartBmsError::SBMS_ERR_NOT_ENOUGH_DATA;
+}
+
+/**
+ * @brief Feed raw bytes into the decoder and pass every completed frame to the frame callback.
+ * The frame is passed undecoded, so the callback only pays for the fields it reads.
+ * This does not block and can be called with bytes from any source, like a UART event, a DMA buffer or a file.
+ * @param data bytes received from the BMS
+ * @param length number of bytes
+ * @return number of frames that were decoded
+ */
+const size_t SmartBmsReader::feed(const uint8_t *data, const size_t length)
+{
+	size_t frameCount = 0;
+	size_t offset = 0;
+	while (offset < length)
+	{
+		SmartBmsFrameView frameView;
+		size_t consumed = 0;
+		const SmartBmsError err = this->feed(&data[offset], length - offset, &consumed, &frameView);
+		offset += consumed;
+		if (err == SmartBmsError::SBMS_OK)
+		{
+			frameCount++;
+			if (this->frameCallback_ != nullptr)
+			{
+				this->frameCallback_(&frameView, this->frameCallbackContext_);
+			}
+		}
+	}
+	return frameCount;
+}
+
+/**
+ * @brief Set the callback that is invoked for every frame decoded by feed(const uint8_t *, const size_t).
+ * @param frameCallback callback function or nullptr to remove it
+ * @param context user defined pointer that is passed to the callback
+ */
+void SmartBmsReader::setFrameCallback(SmartBmsFrameCallback frameCallback, void *context)
+{
+	this->frameCallback_ = frameCallback;
+	this->frameCallbackContext_ = context;
+}
+
+/**
+ * @brief Subscribe to transitions of a permission or alarm flag.
+ * The status byte is checked as soon as a frame is accepted, before it is decoded or passed on.
+ * A new value must be reported by two frames in a row, so a corrupted frame that matched the checksum by chance does not cause a transition.
+ * The callback is invoked with the second of these frames, one cycle of the BMS after the first one.
+ * The first two frames with the same status byte report the flags that are set as rising and the flags that are clear as falling, since their previous state is unknown.
+ * The callback runs in the context that feeds the reader and should return quickly.
+ * @param field flag to watch, like SBMS_FIELD_ALLOWED_TO_CHARGE
+ * @param edge transitions that invoke the callback
+ * @param callback function that is called with the new value of the flag and the timestamp of the frame
+ * @param context user defined pointer that is passed to the callback
+ * @return true when the subscription was added
+ * @return false when the field is not a flag, the callback is nullptr or all SMART_BMS_MAX_SUBSCRIPTIONS are used
+ */
+const bool SmartBmsReader::subscribe(const SmartBmsField field, const SmartBmsFlagEdge edge, SmartBmsFlagCallback callback, void *context)
+{
+	if (field >= SBMS_FIELD_COUNT || callback == nullptr || this->subscriptionCount_ == SMART_BMS_MAX_SUBSCRIPTIONS)
+	{
+		return false;
+	}
+	const SmartBmsFieldDescriptor &descriptor = SmartBmsFields::getDescriptor(field);
+	if (descriptor.encoding != SBMS_ENCODING_FLAG || descriptor.offset != SMART_BMS_STATUS_OFFSET)
+	{
+		return false;
+	}
+
+	SmartBmsFlagSubscription &subscription = this->subscriptions_[this->subscriptionCount_++];
+	subscription.field = field;
+	subscription.bitMask = descriptor.bitMask;
+	subscription.edge = edge;
+	subscription.callback = callback;
+	subscription.context = context;
+	return true;
+}
+
+/**
+ * @brief Remove all subscriptions with the given callback and context.
+ * @param callback callback function of the subscriptions
+ * @param context user defined pointer of the subscriptions
+ */
+void SmartBmsReader::unsubscribe(SmartBmsFlagCallback callback, void *context)
+{
+	size_t count = 0;
+	for (size_t i = 0; i < this->subscriptionCount_; i++)
+	{
+		if (this->subscriptions_[i].callback != callback || this->subscriptions_[i].context != context)
+		{
+			this->subscriptions_[count++] = this->subscriptions_[i];
+		}
+	}
+	this->subscriptionCount_ = count;
+}
+
+/**
+ * @brief Set the fields that are decoded into SmartBmsData, all other fields are skipped.
+ * Frames passed as SmartBmsFrameView are not affected.
+ * @param fieldMask mask of the fields to decode, see SBMS_FIELD_MASK
+ */
+void SmartBmsReader::setFieldMask(const uint32_t fieldMask)
+{
+	this->fieldMask_ = fieldMask;
+}
+
+/**
+ * @brief Set the clock that is used to timestamp the frames.
+ * @param clock clock function or nullptr to use SmartBmsSystemClock
+ */
+void SmartBmsReader::setClock(SmartBmsClock clock)
+{
+	this->clock_ = clock != nullptr ? clock : SmartBmsSystemClock::getMicros;
+}
+
+/**
+ * @brief Set the expected time between two frames, instead of learning it from the first frames.
+ * The period is still adjusted to the measured intervals afterwards and learned again when a frame is more than an eighth of a period off.
+ * @param cyclePeriod period in µs or 0 to learn it
+ */
+void SmartBmsReader::setCyclePeriod(const uint32_t cyclePeriod)
+{
+	this->cyclePeriod_ = cyclePeriod;
+}
+
+/**
+ * @brief Get the total number of bytes that were skipped to resynchronize to the frame alignment.
+ * @return number of skipped bytes
+ */
+const uint32_t SmartBmsReader::getSkippedByteCount() const
+{
+	return this->skippedByteCount_;
 }
 
 /**
- * @brief Decode the pack voltage value from 3 bytes.
- * @param buffer buffer of 3 bytes
- * @return voltage value in V
+ * @brief Get the expected time between two frames.
+ * @return period in µs or 0 when it is not known yet
  */
-const float SmartBmsReader::decodePackVoltage_(const uint8_t buffer[3]) const
+const uint32_t SmartBmsReader::getCyclePeriod() const
 {
-	// Detmerine the raw value and multiply it with the factor
-	const uint32_t rawValue = this->decodeThreeByteValue_(buffer);
-	return rawValue * 0.005f;
+	return this->cyclePeriod_;
 }
 
 /**
- * @brief Decode a current value from 3 bytes.
- * @param buffer buffer of 3 bytes
- * @return current value in A
+ * @brief Get how far the last frame arrived from the expected time.
+ * @return deviation in µs, negative when the frame was early
+ */
+const int32_t SmartBmsReader::getLastJitter() const
+{
+	return this->lastJitter_;
+}
+
+/**
+ * @brief Get the smoothed jitter of the frames, calculated like the interarrival jitter of RFC 3550.
+ * @return mean deviation in µs
+ */
+const uint32_t SmartBmsReader::getJitter() const
+{
+	return this->jitter_;
+}
+
+/**
+ * @brief Get the total number of cycles of the BMS in which no valid frame was received.
+ * @return number of missed cycles
+ */
+const uint32_t SmartBmsReader::getMissedCycleCount() const
+{
+	return this->missedCycleCount_;
+}
+
+#ifdef SMART_BMS_STATISTICS
+/**
+ * @brief Set the statistics that count the frames and errors of this reader.
+ * @param statistics statistics or nullptr to disable them
+ */
+void SmartBmsReader::setStatistics(SmartBmsStatistics *statistics)
+{
+	this->statistics_ = statistics;
+}
+#endif
+
+/**
+ * @brief Calculate the checksum of a buffer byte by byte.
+ * This is the reference for the rolling checksum and for SmartBmsBatchDecoder.
+ * @param buffer buffer to sum up, usually the first 57 bytes of a frame
+ * @param length number of bytes
+ * @return checksum of the buffer
+ */
+const uint8_t SmartBmsReader::calculateChecksum(const uint8_t *buffer, const size_t length)
+{
+	uint8_t checkSum = 0;
+	for (size_t i = 0; i < length; i++)
+	{
+		checkSum += buffer[i];
+	}
+	return checkSum;
+}
+
+/**
+ * @brief Decode a frame and mark the fields that changed since the previous frame decoded by this reader.
+ * Frames that were passed on undecoded, like to the frame callback, can be decoded here later,
+ * so the field mask, the changed mask and the decode latency are the same as for decodeBmsData(SmartBmsData *).
+ * @param frameView frame to decode
+ * @param smartBmsData reference to a SmartBmsData object that will receive the data
  */
-const float SmartBmsReader::decodePackCurrent_(const uint8_t buffer[3]) const
+void SmartBmsReader::decode(const SmartBmsFrameView &frameView, SmartBmsData *smartBmsData)
 {
-	// Determine the factor based on the first byte
-	float factor = 1.0f;
-	if (buffer[0] == 'X')
+#ifdef SMART_BMS_STATISTICS
+	const uint32_t start = this->statistics_ != nullptr ? this->clock_() : 0;
+#endif
+	if (this->hasPreviousFrame_)
 	{
-		factor = 0.0f;
+		frameView.decode(smartBmsData, this->fieldMask_, this->previousFrame_);
 	}
-	else if (buffer[0] == '-')
+	else
 	{
-		factor = -1.0f;
+		frameView.decode(smartBmsData, this->fieldMask_);
+	}
+	this->previousFrame_ = frameView;
+	this->hasPreviousFrame_ = true;
+#ifdef SMART_BMS_STATISTICS
+	if (this->statistics_ != nullptr)
+	{
+		this->statistics_->recordDecodeLatency(this->clock_() - start);
+	}
+#endif
+}
+
+/**
+ * @brief Invoke the subscriptions whose flag changed in the direction they are waiting for.
+ * @param status status byte of a frame with a valid checksum
+ * @param timestamp time in µs when the first byte of the frame was received
+ */
+void SmartBmsReader::dispatchFlags_(const uint8_t status, const uint32_t timestamp)
+{
+	// Only flags that have the same value as in the last frame are confirmed
+	const uint8_t confirmed = this->hasLastStatus_ ? ~(status ^ this->lastStatus_) : 0;
+	this->lastStatus_ = status;
+	this->hasLastStatus_ = true;
+
+	// Without a previous state every flag counts as changed once the whole status byte is confirmed
+	uint8_t changed = 0;
+	if (this->hasPreviousStatus_)
+	{
+		changed = (status ^ this->previousStatus_) & confirmed;
+	}
+	else if (confirmed == 0xFF)
+	{
+		changed = 0xFF;
+		this->hasPreviousStatus_ = true;
+	}
+	this->previousStatus_ = (this->previousStatus_ & ~changed) | (status & changed);
+	if (changed == 0)
+	{
+		return;
 	}
 
-	// Detmerine the raw value and multiply it with the factor
-	const uint16_t rawValue = this->decodeTwoByteValue_(&buffer[1]);
-	return factor * rawValue * 0.125f;
+	const uint8_t rising = changed & status;
+	const uint8_t falling = changed & ~status;
+	for (size_t i = 0; i < this->subscriptionCount_; i++)
+	{
+		const SmartBmsFlagSubscription &subscription = this->subscriptions_[i];
+		if (((subscription.edge & SBMS_EDGE_RISING) && (rising & subscription.bitMask)) ||
+			((subscription.edge & SBMS_EDGE_FALLING) && (falling & subscription.bitMask)))
+		{
+			subscription.callback(subscription.field, status & subscription.bitMask, timestamp, subscription.context);
+		}
+	}
 }
 
 /**
- * @brief Decode a cell voltage value from 2 bytes.
- * @param buffer buffer of 2 bytes
- * @return voltage value in V
+ * @brief Update the cycle period, the jitter and the missed cycles with the timestamp of a new frame.
+ * @param timestamp time in µs when the first byte of the frame was received
  */
-const float SmartBmsReader::decodeCellVoltage_(const uint8_t buffer[2]) const
+void SmartBmsReader::trackCycle_(const uint32_t timestamp)
 {
-	// Detmerine the raw value and multiply it with the factor
-	const uint16_t rawValue = this->decodeTwoByteValue_(buffer);
-	return rawValue * 0.005f;
+	const uint32_t interval = timestamp - this->lastFrameTimestamp_;
+	const bool hasInterval = this->hasLastFrameTimestamp_;
+	this->lastFrameTimestamp_ = timestamp;
+	this->hasLastFrameTimestamp_ = true;
+	if (!hasInterval)
+	{
+		return;
+	}
+
+	// A frame that starts within the duration of the previous frame was sent back to back with it, like frames that were buffered
+	if (interval <= SMART_BMS_FRAME_SIZE * SMART_BMS_BYTE_DURATION_US)
+	{
+		return;
+	}
+
+	// The first interval is the first guess
+	if (this->cyclePeriod_ == 0)
+	{
+		this->cyclePeriod_ = interval;
+		return;
+	}
+
+	// Round to the nearest number of cycles, everything beyond one cycle was missed
+	// A frame more than an eighth of a period off means the guess was wrong, for example because it contained missed cycles, so the next interval is the new guess
+	const uint32_t cycles = (interval + this->cyclePeriod_ / 2) / this->cyclePeriod_;
+	const int32_t jitter = static_cast<int32_t>(interval - cycles * this->cyclePeriod_);
+	const int32_t absoluteJitter = jitter < 0 ? -jitter : jitter;
+	if (cycles == 0 || static_cast<uint32_t>(absoluteJitter) > this->cyclePeriod_ / 8)
+	{
+		this->cyclePeriod_ = 0;
+		return;
+	}
+	this->missedCycleCount_ += cycles - 1;
+	this->lastJitter_ = jitter;
+	this->jitter_ += (absoluteJitter - static_cast<int32_t>(this->jitter_)) / 16;
+
+	// Follow slow drifts of the BMS clock with regular intervals only
+	if (cycles == 1)
+	{
+		this->cyclePeriod_ += jitter / 16;
+	}
 }
 
 /**
- * @brief Decode a cell temperature value from 2 bytes.
- * @param buffer buffer of 2 bytes
- * @return temperature value in °C
+ * @brief Push a single byte into the rolling window.
+ * When the window is already full, the oldest byte is dropped and counted as skipped and the alignment is lost.
+ * @param value byte to push
+ * @param timestamp time in µs when the byte was received
+ * @return true when the window contains a complete frame with a valid checksum
+ * @return false when the window does not contain a valid frame
  */
-const float SmartBmsReader::decodeCellTemperature_(const uint8_t buffer[2]) const
+const bool SmartBmsReader::pushByte_(const uint8_t value, const uint32_t timestamp)
 {
-	// Detmerine the raw value and multiply it with the factor
-	const uint16_t rawValue = this->decodeTwoByteValue_(buffer);
-	return rawValue * 0.857f - 232.0f;
+	// Slide the window by one byte when it is full
+	if (this->windowLength_ == SMART_BMS_FRAME_SIZE)
+	{
+		this->windowSum_ -= this->window_[this->windowStart_];
+		this->windowStart_ = (this->windowStart_ + 1) % SMART_BMS_FRAME_SIZE;
+		this->windowLength_--;
+		this->skippedByteCount_++;
+		this->aligned_ = false;
+	}
+
+	// Append the new byte and update the running sum over the whole window
+	const size_t slot = (this->windowStart_ + this->windowLength_) % SMART_BMS_FRAME_SIZE;
+	this->window_[slot] = value;
+	this->windowTimestamps_[slot] = timestamp;
+	this->windowSum_ += value;
+	this->windowLength_++;
+
+	// The last byte is the checksum of the first 57 bytes
+	return this->windowLength_ == SMART_BMS_FRAME_SIZE && static_cast<uint8_t>(this->windowSum_ - value) == value;
 }
 
 /**
- * @brief Decode a 2 byte value.
- * @param buffer buffer of 2 bytes
- * @return decoded 2 byte value
+ * @brief Copy the content of the rolling window into a linear buffer.
+ * @param buffer buffer of 58 bytes
  */
-const uint16_t SmartBmsReader::decodeTwoByteValue_(const uint8_t buffer[2]) const
+void SmartBmsReader::copyWindow_(uint8_t buffer[SMART_BMS_FRAME_SIZE]) const
 {
-	return (static_cast<uint16_t>(buffer[0]) << 8) | buffer[1];
+	for (size_t i = 0; i < this->windowLength_; i++)
+	{
+		buffer[i] = this->window_[(this->windowStart_ + i) % SMART_BMS_FRAME_SIZE];
+	}
 }
 
 /**
- * @brief Decode a 3 byte value.
- * @param buffer buffer of 3 bytes
- * @return decoded 3 byte value
+ * @brief Clear the rolling window.
  */
-const uint32_t SmartBmsReader::decodeThreeByteValue_(const uint8_t buffer[3]) const
+void SmartBmsReader::clearWindow_()
 {
-	return (static_cast<uint32_t>(buffer[0]) << 16) | (static_cast<uint16_t>(buffer[1]) << 8) | buffer[2];
+	this->windowStart_ = 0;
+	this->windowLength_ = 0;
+	this->windowSum_ = 0;
+#ifdef SMART_BMS_STATISTICS
+	this->resynchronizing_ = false;
+#endif
 }
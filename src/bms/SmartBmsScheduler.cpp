@@ -0,0 +1,232 @@
+/**
+ * @file SmartBmsScheduler.cpp
+ * @author TheRealKasumi
+ * @brief Implementation of the SmartBmsScheduler class.
+ * @copyright Copyright (c) 2024 TheRealKasumi
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#include "bms/SmartBmsScheduler.h"
+
+/**
+ * @brief Create a new instance of SmartBmsScheduler.
+ * @param clock clock in µs, must be the same clock that stamps the frames
+ */
+SmartBmsScheduler::SmartBmsScheduler(SmartBmsClock clock)
+{
+	this->clock_ = clock;
+	this->reset();
+}
+
+/**
+ * @brief Destroy the SmartBmsScheduler instance.
+ */
+SmartBmsScheduler::~SmartBmsScheduler()
+{
+}
+
+/**
+ * @brief Set the clock, like a simulated clock to replay recorded arrivals.
+ * @param clock clock in µs, must be the same clock that stamps the frames
+ */
+void SmartBmsScheduler::setClock(SmartBmsClock clock)
+{
+	this->clock_ = clock;
+}
+
+/**
+ * @brief Learn from the arrival of a frame. Must be called for every frame, in the order they arrived.
+ * The first interval is the first guess of the period. Regular intervals let the period follow the drift of the BMS clock,
+ * intervals of several cycles count the missed frames. A frame far from every predicted arrival means that the BMS restarted
+ * or that the guess was wrong, so the period is learned again from this frame on. Frames back to back are no interval, like in SmartBmsReader.
+ * @param timestamp time in µs when the first byte of the frame was received, see SmartBmsFrameView::getTimestamp()
+ */
+void SmartBmsScheduler::onFrame(const uint32_t timestamp)
+{
+	const uint32_t interval = timestamp - this->lastArrival_;
+	const bool hasInterval = this->hasArrival_;
+	this->lastArrival_ = timestamp;
+	this->hasArrival_ = true;
+	if (!hasInterval)
+	{
+		return;
+	}
+
+	// A frame that starts within the duration of the previous frame was sent back to back with it, like frames that were buffered while the loop stalled
+	if (interval <= SMART_BMS_SCHEDULER_FRAME_DURATION_US)
+	{
+		return;
+	}
+
+	if (this->cyclePeriod_ == 0)
+	{
+		if (interval >= SMART_BMS_SCHEDULER_MIN_PERIOD_US && interval <= SMART_BMS_SCHEDULER_MAX_PERIOD_US)
+		{
+			this->cyclePeriod_ = interval;
+		}
+		return;
+	}
+
+	// A frame must arrive within an eighth of a period of a predicted arrival
+	const uint32_t cycles = (interval + this->cyclePeriod_ / 2) / this->cyclePeriod_;
+	const int32_t error = static_cast<int32_t>(interval - cycles * this->cyclePeriod_);
+	const int32_t absoluteError = error < 0 ? -error : error;
+	if (cycles == 0 || static_cast<uint32_t>(absoluteError) > this->cyclePeriod_ / 8)
+	{
+		this->relearn_();
+		return;
+	}
+
+	this->missedCycleCount_ += cycles - 1;
+	this->jitter_ += (absoluteError - static_cast<int32_t>(this->jitter_)) / 16;
+	if (cycles == 1)
+	{
+		this->cyclePeriod_ += error / 16;
+		this->regularIntervalCount_++;
+	}
+}
+
+/**
+ * @brief Get the time the application can sleep or do other work before the next frame starts.
+ * The application stays awake from the margin before a predicted arrival until the frame is complete, plus the margin for a late frame.
+ * When more than SMART_BMS_SCHEDULER_MAX_MISSED_CYCLES predicted frames in a row did not arrive, the lock is dropped and the period is learned again.
+ * @return time in µs, 0 when a frame is due or the scheduler is not locked, in that case the application should keep polling
+ */
+const uint32_t SmartBmsScheduler::getSleepTime()
+{
+	if (!this->isLocked())
+	{
+		return 0;
+	}
+
+	const uint32_t elapsed = this->clock_() - this->lastArrival_;
+	const uint32_t margin = this->getMargin();
+	if (margin * 2 + SMART_BMS_SCHEDULER_FRAME_DURATION_US >= this->cyclePeriod_)
+	{
+		return 0;
+	}
+	if (elapsed > margin && (elapsed - margin) / this->cyclePeriod_ > SMART_BMS_SCHEDULER_MAX_MISSED_CYCLES)
+	{
+		this->relearn_();
+		this->hasArrival_ = false;
+		return 0;
+	}
+
+	// The window right after the last arrival is the frame that was just received
+	const uint32_t phase = elapsed % this->cyclePeriod_;
+	if ((elapsed >= this->cyclePeriod_ && phase <= margin + SMART_BMS_SCHEDULER_FRAME_DURATION_US) || phase >= this->cyclePeriod_ - margin)
+	{
+		return 0;
+	}
+	return this->cyclePeriod_ - margin - phase;
+}
+
+/**
+ * @brief Forget everything that was learned.
+ */
+void SmartBmsScheduler::reset()
+{
+	this->hasArrival_ = false;
+	this->lastArrival_ = 0;
+	this->cyclePeriod_ = 0;
+	this->jitter_ = 0;
+	this->regularIntervalCount_ = 0;
+	this->missedCycleCount_ = 0;
+	this->relearnCount_ = 0;
+}
+
+/**
+ * @brief Check if the period is known well enough to sleep.
+ * @return true after SMART_BMS_SCHEDULER_LOCK_INTERVAL_COUNT regular intervals
+ */
+const bool SmartBmsScheduler::isLocked() const
+{
+	return this->cyclePeriod_ != 0 && this->regularIntervalCount_ >= SMART_BMS_SCHEDULER_LOCK_INTERVAL_COUNT;
+}
+
+/**
+ * @brief Get the learned period of the BMS cycle.
+ * @return period in µs, 0 while learning
+ */
+const uint32_t SmartBmsScheduler::getCyclePeriod() const
+{
+	return this->cyclePeriod_;
+}
+
+/**
+ * @brief Get the smoothed deviation of the arrivals from the predicted arrivals.
+ * @return jitter in µs
+ */
+const uint32_t SmartBmsScheduler::getJitter() const
+{
+	return this->jitter_;
+}
+
+/**
+ * @brief Get the time that is kept awake before and after a predicted arrival.
+ * @return margin in µs
+ */
+const uint32_t SmartBmsScheduler::getMargin() const
+{
+	return SMART_BMS_SCHEDULER_MARGIN_US + SMART_BMS_SCHEDULER_JITTER_FACTOR * this->jitter_;
+}
+
+/**
+ * @brief Get the predicted start of the next frame, which is the current one while a frame is due. Only valid when locked.
+ * @return time in µs
+ */
+const uint32_t SmartBmsScheduler::getNextArrival() const
+{
+	if (this->cyclePeriod_ == 0)
+	{
+		return this->clock_();
+	}
+	const uint32_t elapsed = this->clock_() - this->lastArrival_;
+	uint32_t cycles = elapsed / this->cyclePeriod_ + 1;
+	if (cycles > 1 && elapsed % this->cyclePeriod_ <= this->getMargin() + SMART_BMS_SCHEDULER_FRAME_DURATION_US)
+	{
+		cycles--;
+	}
+	return this->lastArrival_ + cycles * this->cyclePeriod_;
+}
+
+/**
+ * @brief Get the number of predicted frames that did not arrive.
+ * @return number of missed cycles
+ */
+const uint32_t SmartBmsScheduler::getMissedCycleCount() const
+{
+	return this->missedCycleCount_;
+}
+
+/**
+ * @brief Get the number of times the lock was dropped and the period was learned again.
+ * @return number of relearns
+ */
+const uint32_t SmartBmsScheduler::getRelearnCount() const
+{
+	return this->relearnCount_;
+}
+
+/**
+ * @brief Drop the lock and learn the period again from the last arrival on.
+ */
+void SmartBmsScheduler::relearn_()
+{
+	this->cyclePeriod_ = 0;
+	this->jitter_ = 0;
+	this->regularIntervalCount_ = 0;
+	this->relearnCount_++;
+}
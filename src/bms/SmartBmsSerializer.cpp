@@ -0,0 +1,240 @@
+/**
+ * @file SmartBmsSerializer.cpp
+ * @author TheRealKasumi
+ * @brief Contains serializers that write the BMS data as JSON, CSV or InfluxDB line protocol into a fixed buffer.
+ * @copyright Copyright (c) 2024 TheRealKasumi
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#include "bms/SmartBmsSerializer.h"
+
+/**
+ * @brief Write the decoded fields as a single line JSON object, like {"cellCount":16,"packVoltage":52800,...}.
+ * Values are in the integer units of the field table, flags are true or false.
+ * @param smartBmsData data to write
+ * @param buffer buffer that receives the null terminated text
+ * @param size size of the buffer, SMART_BMS_SERIALIZER_BUFFER_SIZE is always enough
+ * @param fieldMask mask of the fields to write, fields that were not decoded are skipped
+ * @return length of the text, 0 when the buffer is too small
+ */
+const size_t SmartBmsSerializer::toJson(const SmartBmsData &smartBmsData, char *buffer, const size_t size, const uint32_t fieldMask)
+{
+	SmartBmsTextWriter writer(buffer, size);
+	const uint32_t mask = fieldMask & smartBmsData.getFieldMask();
+	bool first = true;
+	writer.append('{');
+	for (size_t i = 0; i < SBMS_FIELD_COUNT; i++)
+	{
+		if (mask & SBMS_FIELD_MASK(i))
+		{
+			writer.append(first ? "\"" : ",\"");
+			writer.append(SMART_BMS_FIELDS[i].name);
+			writer.append("\":");
+			SmartBmsSerializer::appendValue_(writer, smartBmsData, static_cast<SmartBmsField>(i), "true", "false", "");
+			first = false;
+		}
+	}
+	writer.append('}');
+	return writer.finish();
+}
+
+/**
+ * @brief Decode a frame and write it as JSON. See toJson(const SmartBmsData &, char *, const size_t, const uint32_t) for details.
+ * @param frameView frame to write
+ * @param buffer buffer that receives the null terminated text
+ * @param size size of the buffer
+ * @param fieldMask mask of the fields to write
+ * @return length of the text, 0 when the buffer is too small
+ */
+const size_t SmartBmsSerializer::toJson(const SmartBmsFrameView &frameView, char *buffer, const size_t size, const uint32_t fieldMask)
+{
+	SmartBmsData smartBmsData;
+	frameView.decode(&smartBmsData, fieldMask);
+	return SmartBmsSerializer::toJson(smartBmsData, buffer, size, fieldMask);
+}
+
+/**
+ * @brief Write the CSV header that matches toCsv(), like cellCount,packVoltage[mV],...
+ * @param buffer buffer that receives the null terminated text
+ * @param size size of the buffer
+ * @param fieldMask mask of the fields to write
+ * @return length of the text, 0 when the buffer is too small
+ */
+const size_t SmartBmsSerializer::toCsvHeader(char *buffer, const size_t size, const uint32_t fieldMask)
+{
+	SmartBmsTextWriter writer(buffer, size);
+	bool first = true;
+	for (size_t i = 0; i < SBMS_FIELD_COUNT; i++)
+	{
+		if (fieldMask & SBMS_FIELD_MASK(i))
+		{
+			writer.append(first ? "" : ",");
+			writer.append(SMART_BMS_FIELDS[i].name);
+			if (SMART_BMS_FIELDS[i].fixedUnit[0] != '\0')
+			{
+				writer.append('[');
+				writer.append(SMART_BMS_FIELDS[i].fixedUnit);
+				writer.append(']');
+			}
+			first = false;
+		}
+	}
+	return writer.finish();
+}
+
+/**
+ * @brief Write the fields as a CSV line without line break.
+ * Every field of the mask gets a column, fields that were not decoded are left empty, flags are 0 or 1.
+ * @param smartBmsData data to write
+ * @param buffer buffer that receives the null terminated text
+ * @param size size of the buffer
+ * @param fieldMask mask of the fields to write
+ * @return length of the text, 0 when the buffer is too small
+ */
+const size_t SmartBmsSerializer::toCsv(const SmartBmsData &smartBmsData, char *buffer, const size_t size, const uint32_t fieldMask)
+{
+	SmartBmsTextWriter writer(buffer, size);
+	bool first = true;
+	for (size_t i = 0; i < SBMS_FIELD_COUNT; i++)
+	{
+		if (fieldMask & SBMS_FIELD_MASK(i))
+		{
+			writer.append(first ? "" : ",");
+			if (smartBmsData.hasField(static_cast<SmartBmsField>(i)))
+			{
+				SmartBmsSerializer::appendValue_(writer, smartBmsData, static_cast<SmartBmsField>(i), "1", "0", "");
+			}
+			first = false;
+		}
+	}
+	return writer.finish();
+}
+
+/**
+ * @brief Decode a frame and write it as CSV line. See toCsv(const SmartBmsData &, char *, const size_t, const uint32_t) for details.
+ * @param frameView frame to write
+ * @param buffer buffer that receives the null terminated text
+ * @param size size of the buffer
+ * @param fieldMask mask of the fields to write
+ * @return length of the text, 0 when the buffer is too small
+ */
+const size_t SmartBmsSerializer::toCsv(const SmartBmsFrameView &frameView, char *buffer, const size_t size, const uint32_t fieldMask)
+{
+	SmartBmsData smartBmsData;
+	frameView.decode(&smartBmsData, fieldMask);
+	return SmartBmsSerializer::toCsv(smartBmsData, buffer, size, fieldMask);
+}
+
+/**
+ * @brief Write the fields as a single InfluxDB line protocol point without line break,
+ * like smartbms cellCount=16i,packVoltage=52800i,allowedToCharge=true 1700000000000000000.
+ * @param smartBmsData data to write
+ * @param measurement name of the measurement, must not contain spaces or commas
+ * @param timestamp timestamp of the point, 0 to let the server assign it
+ * @param buffer buffer that receives the null terminated text
+ * @param size size of the buffer
+ * @param fieldMask mask of the fields to write, fields that were not decoded are skipped
+ * @return length of the text, 0 when the buffer is too small or no field was written
+ */
+const size_t SmartBmsSerializer::toLineProtocol(const SmartBmsData &smartBmsData, const char *measurement, const uint64_t timestamp, char *buffer, const size_t size, const uint32_t fieldMask)
+{
+	SmartBmsTextWriter writer(buffer, size);
+	const uint32_t mask = fieldMask & smartBmsData.getFieldMask();
+	if (mask == 0)
+	{
+		// A point without fields is invalid
+		return writer.finish();
+	}
+
+	bool first = true;
+	writer.append(measurement);
+	for (size_t i = 0; i < SBMS_FIELD_COUNT; i++)
+	{
+		if (mask & SBMS_FIELD_MASK(i))
+		{
+			writer.append(first ? ' ' : ',');
+			writer.append(SMART_BMS_FIELDS[i].name);
+			writer.append('=');
+			SmartBmsSerializer::appendValue_(writer, smartBmsData, static_cast<SmartBmsField>(i), "true", "false", "i");
+			first = false;
+		}
+	}
+	if (timestamp != 0)
+	{
+		writer.append(' ');
+		writer.appendUnsigned(timestamp);
+	}
+	return writer.finish();
+}
+
+/**
+ * @brief Decode a frame and write it as line protocol.
+ * See toLineProtocol(const SmartBmsData &, const char *, const uint64_t, char *, const size_t, const uint32_t) for details.
+ * @param frameView frame to write
+ * @param measurement name of the measurement
+ * @param timestamp timestamp of the point, 0 to let the server assign it
+ * @param buffer buffer that receives the null terminated text
+ * @param size size of the buffer
+ * @param fieldMask mask of the fields to write
+ * @return length of the text, 0 when the buffer is too small
+ */
+const size_t SmartBmsSerializer::toLineProtocol(const SmartBmsFrameView &frameView, const char *measurement, const uint64_t timestamp, char *buffer, const size_t size, const uint32_t fieldMask)
+{
+	SmartBmsData smartBmsData;
+	frameView.decode(&smartBmsData, fieldMask);
+	return SmartBmsSerializer::toLineProtocol(smartBmsData, measurement, timestamp, buffer, size, fieldMask);
+}
+
+/**
+ * @brief Write the fields in the given format. Line protocol uses the measurement smartbms without timestamp.
+ * @param smartBmsData data to write
+ * @param format output format
+ * @param buffer buffer that receives the null terminated text
+ * @param size size of the buffer
+ * @param fieldMask mask of the fields to write
+ * @return length of the text, 0 when the buffer is too small
+ */
+const size_t SmartBmsSerializer::serialize(const SmartBmsData &smartBmsData, const SmartBmsSerializerFormat format, char *buffer, const size_t size, const uint32_t fieldMask)
+{
+	if (format == SmartBmsSerializerFormat::SBMS_FORMAT_CSV)
+	{
+		return SmartBmsSerializer::toCsv(smartBmsData, buffer, size, fieldMask);
+	}
+	else if (format == SmartBmsSerializerFormat::SBMS_FORMAT_LINE_PROTOCOL)
+	{
+		return SmartBmsSerializer::toLineProtocol(smartBmsData, "smartbms", 0, buffer, size, fieldMask);
+	}
+	return SmartBmsSerializer::toJson(smartBmsData, buffer, size, fieldMask);
+}
+
+/**
+ * @brief Append the value of a field in integer units.
+ * @param writer writer to append to
+ * @param smartBmsData data that holds the value
+ * @param field field to append
+ * @param trueText text of a set flag
+ * @param falseText text of a cleared flag
+ * @param integerSuffix text behind an integer
+ */
+void SmartBmsSerializer::appendValue_(SmartBmsTextWriter &writer, const SmartBmsData &smartBmsData, const SmartBmsField field, const char *trueText, const char *falseText, const char *integerSuffix)
+{
+	if (SMART_BMS_FIELDS[field].encoding == SBMS_ENCODING_FLAG)
+	{
+		writer.append(smartBmsData.getRawValue(field) != 0 ? trueText : falseText);
+		return;
+	}
+	writer.appendInteger(smartBmsData.getFixedValue(field));
+	writer.append(integerSuffix);
+}
@@ -0,0 +1,304 @@
+/**
+ * @file SmartBmsStatistics.cpp
+ * @author TheRealKasumi
+ * @brief Implementation of the SmartBmsStatistics class.
+ * @copyright Copyright (c) 2024 TheRealKasumi
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#include "bms/SmartBmsStatistics.h"
+
+#ifdef SMART_BMS_STATISTICS
+
+// A histogram is stored as its buckets followed by the number and the sum of all values
+#define SMART_BMS_HISTOGRAM_COUNT_INDEX SMART_BMS_HISTOGRAM_BUCKET_COUNT
+#define SMART_BMS_HISTOGRAM_SUM_INDEX (SMART_BMS_HISTOGRAM_BUCKET_COUNT + 1)
+
+// Decoding takes a few µs, a frame arrives about once per second
+static const uint32_t decodeLatencyBounds[SMART_BMS_HISTOGRAM_BOUND_COUNT] = {1, 2, 5, 10, 20, 50, 100, 200, 500, 1000};
+static const uint32_t frameIntervalBounds[SMART_BMS_HISTOGRAM_BOUND_COUNT] = {100, 250, 500, 750, 900, 1100, 1250, 1500, 2000, 5000};
+
+/**
+ * @brief Create a new instance of SmartBmsStatistics with all counters at 0.
+ */
+SmartBmsStatistics::SmartBmsStatistics()
+{
+	this->reset();
+}
+
+/**
+ * @brief Destroy the SmartBmsStatistics instance.
+ */
+SmartBmsStatistics::~SmartBmsStatistics()
+{
+}
+
+/**
+ * @brief Count a frame with a valid checksum and record the time since the previous one.
+ * Must only be called by the task that reads the frames.
+ * @param timestamp time in µs when the first byte of the frame was received
+ */
+void SmartBmsStatistics::countFrame(const uint32_t timestamp)
+{
+	if (this->hasLastFrame_)
+	{
+		SmartBmsStatistics::record_(this->frameInterval_, frameIntervalBounds, (timestamp - this->lastFrameTime_) / 1000);
+	}
+	this->lastFrameTime_ = timestamp;
+	this->hasLastFrame_ = true;
+	this->frameCount_.fetch_add(1, std::memory_order_relaxed);
+}
+
+/**
+ * @brief Count a complete window that did not match its checksum, which starts a resynchronization.
+ */
+void SmartBmsStatistics::countChecksumError()
+{
+	this->checksumErrorCount_.fetch_add(1, std::memory_order_relaxed);
+}
+
+/**
+ * @brief Count bytes that were skipped to resynchronize to the frame alignment.
+ * @param count number of skipped bytes
+ */
+void SmartBmsStatistics::countSkippedBytes(const uint32_t count)
+{
+	this->skippedByteCount_.fetch_add(count, std::memory_order_relaxed);
+}
+
+/**
+ * @brief Count cycles of the BMS in which no frame was received.
+ * @param count number of missed cycles
+ */
+void SmartBmsStatistics::countMissedCycles(const uint32_t count)
+{
+	this->missedCycleCount_.fetch_add(count, std::memory_order_relaxed);
+}
+
+/**
+ * @brief Count a failed read of the input stream.
+ */
+void SmartBmsStatistics::countReadError()
+{
+	this->readErrorCount_.fetch_add(1, std::memory_order_relaxed);
+}
+
+/**
+ * @brief Count an overflow of the UART receive buffer. Can be called from the UART error callback.
+ */
+void SmartBmsStatistics::countRxOverflow()
+{
+	this->rxOverflowCount_.fetch_add(1, std::memory_order_relaxed);
+}
+
+/**
+ * @brief Count a frame that was dropped because the queue was full.
+ */
+void SmartBmsStatistics::countDroppedFrame()
+{
+	this->droppedFrameCount_.fetch_add(1, std::memory_order_relaxed);
+}
+
+/**
+ * @brief Record the time it took to decode a frame.
+ * @param micros duration in µs
+ */
+void SmartBmsStatistics::recordDecodeLatency(const uint32_t micros)
+{
+	SmartBmsStatistics::record_(this->decodeLatency_, decodeLatencyBounds, micros);
+}
+
+/**
+ * @brief Set all counters and histograms back to 0.
+ */
+void SmartBmsStatistics::reset()
+{
+	this->frameCount_ = 0;
+	this->checksumErrorCount_ = 0;
+	this->skippedByteCount_ = 0;
+	this->missedCycleCount_ = 0;
+	this->readErrorCount_ = 0;
+	this->rxOverflowCount_ = 0;
+	this->droppedFrameCount_ = 0;
+	for (size_t i = 0; i < SMART_BMS_HISTOGRAM_BUCKET_COUNT + 2; i++)
+	{
+		this->decodeLatency_[i] = 0;
+		this->frameInterval_[i] = 0;
+	}
+	this->lastFrameTime_ = 0;
+	this->hasLastFrame_ = false;
+}
+
+/**
+ * @brief Copy the current values. Each value is read on its own, so the values of a snapshot can be a few updates apart.
+ * @param snapshot snapshot that receives the values
+ */
+void SmartBmsStatistics::getSnapshot(SmartBmsStatisticsSnapshot *snapshot) const
+{
+	snapshot->frameCount = this->frameCount_.load(std::memory_order_relaxed);
+	snapshot->checksumErrorCount = this->checksumErrorCount_.load(std::memory_order_relaxed);
+	snapshot->skippedByteCount = this->skippedByteCount_.load(std::memory_order_relaxed);
+	snapshot->missedCycleCount = this->missedCycleCount_.load(std::memory_order_relaxed);
+	snapshot->readErrorCount = this->readErrorCount_.load(std::memory_order_relaxed);
+	snapshot->rxOverflowCount = this->rxOverflowCount_.load(std::memory_order_relaxed);
+	snapshot->droppedFrameCount = this->droppedFrameCount_.load(std::memory_order_relaxed);
+	SmartBmsStatistics::copy_(this->decodeLatency_, &snapshot->decodeLatency);
+	SmartBmsStatistics::copy_(this->frameInterval_, &snapshot->frameInterval);
+}
+
+/**
+ * @brief Write all values in the Prometheus text format.
+ * Counters wrap around at 2^32, which Prometheus treats like a restart.
+ * @param buffer buffer that receives the text, SMART_BMS_STATISTICS_BUFFER_SIZE bytes are enough
+ * @param size size of the buffer
+ * @return length of the text without the terminating 0 or 0 when the buffer is too small
+ */
+const size_t SmartBmsStatistics::toPrometheus(char *buffer, const size_t size) const
+{
+	SmartBmsStatisticsSnapshot snapshot;
+	this->getSnapshot(&snapshot);
+
+	SmartBmsTextWriter writer(buffer, size);
+	SmartBmsStatistics::writeCounter_(writer, "smartbms_frames_total", "Frames with a valid checksum.", snapshot.frameCount);
+	SmartBmsStatistics::writeCounter_(writer, "smartbms_checksum_errors_total", "Complete windows that did not match their checksum.", snapshot.checksumErrorCount);
+	SmartBmsStatistics::writeCounter_(writer, "smartbms_skipped_bytes_total", "Bytes skipped to resynchronize to the frame alignment.", snapshot.skippedByteCount);
+	SmartBmsStatistics::writeCounter_(writer, "smartbms_missed_cycles_total", "Cycles of the BMS without a valid frame.", snapshot.missedCycleCount);
+	SmartBmsStatistics::writeCounter_(writer, "smartbms_read_errors_total", "Failed reads of the input stream.", snapshot.readErrorCount);
+	SmartBmsStatistics::writeCounter_(writer, "smartbms_rx_overflows_total", "Overflows of the UART receive buffer.", snapshot.rxOverflowCount);
+	SmartBmsStatistics::writeCounter_(writer, "smartbms_dropped_frames_total", "Frames dropped because the queue was full.", snapshot.droppedFrameCount);
+	SmartBmsStatistics::writeHistogram_(writer, "smartbms_decode_latency_microseconds", "Time to decode a frame.", decodeLatencyBounds, snapshot.decodeLatency);
+	SmartBmsStatistics::writeHistogram_(writer, "smartbms_frame_interval_milliseconds", "Time between two valid frames.", frameIntervalBounds, snapshot.frameInterval);
+	return writer.finish();
+}
+
+/**
+ * @brief Get the upper bounds of the decode latency buckets in µs.
+ * @return array of SMART_BMS_HISTOGRAM_BOUND_COUNT bounds
+ */
+const uint32_t *SmartBmsStatistics::getDecodeLatencyBounds()
+{
+	return decodeLatencyBounds;
+}
+
+/**
+ * @brief Get the upper bounds of the frame interval buckets in ms.
+ * @return array of SMART_BMS_HISTOGRAM_BOUND_COUNT bounds
+ */
+const uint32_t *SmartBmsStatistics::getFrameIntervalBounds()
+{
+	return frameIntervalBounds;
+}
+
+/**
+ * @brief Add a value to a histogram.
+ * @param histogram buckets, count and sum of the histogram
+ * @param bounds upper bounds of the buckets
+ * @param value value to add
+ */
+void SmartBmsStatistics::record_(std::atomic<uint32_t> *histogram, const uint32_t *bounds, const uint32_t value)
+{
+	size_t bucket = 0;
+	while (bucket < SMART_BMS_HISTOGRAM_BOUND_COUNT && value > bounds[bucket])
+	{
+		bucket++;
+	}
+	histogram[bucket].fetch_add(1, std::memory_order_relaxed);
+	histogram[SMART_BMS_HISTOGRAM_COUNT_INDEX].fetch_add(1, std::memory_order_relaxed);
+	histogram[SMART_BMS_HISTOGRAM_SUM_INDEX].fetch_add(value, std::memory_order_relaxed);
+}
+
+/**
+ * @brief Copy a histogram into a snapshot.
+ * @param histogram buckets, count and sum of the histogram
+ * @param snapshot histogram that receives the values
+ */
+void SmartBmsStatistics::copy_(const std::atomic<uint32_t> *histogram, SmartBmsHistogram *snapshot)
+{
+	for (size_t i = 0; i < SMART_BMS_HISTOGRAM_BUCKET_COUNT; i++)
+	{
+		snapshot->bucketCounts[i] = histogram[i].load(std::memory_order_relaxed);
+	}
+	snapshot->count = histogram[SMART_BMS_HISTOGRAM_COUNT_INDEX].load(std::memory_order_relaxed);
+	snapshot->sum = histogram[SMART_BMS_HISTOGRAM_SUM_INDEX].load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief Write a counter in the Prometheus text format.
+ * @param writer writer that receives the text
+ * @param name name of the metric
+ * @param help description of the metric
+ * @param value value of the counter
+ */
+void SmartBmsStatistics::writeCounter_(SmartBmsTextWriter &writer, const char *name, const char *help, const uint32_t value)
+{
+	writer.append("# HELP ");
+	writer.append(name);
+	writer.append(' ');
+	writer.append(help);
+	writer.append("\n# TYPE ");
+	writer.append(name);
+	writer.append(" counter\n");
+	writer.append(name);
+	writer.append(' ');
+	writer.appendUnsigned(value);
+	writer.append('\n');
+}
+
+/**
+ * @brief Write a histogram in the Prometheus text format. The buckets are cumulative in this format.
+ * @param writer writer that receives the text
+ * @param name name of the metric
+ * @param help description of the metric
+ * @param bounds upper bounds of the buckets
+ * @param histogram histogram to write
+ */
+void SmartBmsStatistics::writeHistogram_(SmartBmsTextWriter &writer, const char *name, const char *help, const uint32_t *bounds, const SmartBmsHistogram &histogram)
+{
+	writer.append("# HELP ");
+	writer.append(name);
+	writer.append(' ');
+	writer.append(help);
+	writer.append("\n# TYPE ");
+	writer.append(name);
+	writer.append(" histogram\n");
+	uint32_t count = 0;
+	for (size_t i = 0; i < SMART_BMS_HISTOGRAM_BUCKET_COUNT; i++)
+	{
+		count += histogram.bucketCounts[i];
+		writer.append(name);
+		writer.append("_bucket{le=\"");
+		if (i < SMART_BMS_HISTOGRAM_BOUND_COUNT)
+		{
+			writer.appendUnsigned(bounds[i]);
+		}
+		else
+		{
+			writer.append("+Inf");
+		}
+		writer.append("\"} ");
+		writer.appendUnsigned(count);
+		writer.append('\n');
+	}
+	writer.append(name);
+	writer.append("_sum ");
+	writer.appendUnsigned(histogram.sum);
+	writer.append('\n');
+	writer.append(name);
+	writer.append("_count ");
+	writer.appendUnsigned(histogram.count);
+	writer.append('\n');
+}
+
+#endif
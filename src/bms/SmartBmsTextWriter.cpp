@@ -0,0 +1,161 @@
+/**
+ * @file SmartBmsTextWriter.cpp
+ * @author TheRealKasumi
+ * @brief Contains a writer that formats text and integers into a fixed buffer without using the heap.
+ * @copyright Copyright (c) 2024 TheRealKasumi
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#include "bms/SmartBmsTextWriter.h"
+
+#include <string.h>
+
+/**
+ * @brief Create a new instance of SmartBmsTextWriter.
+ * @param buffer buffer that receives the text
+ * @param size size of the buffer including the terminating null character
+ */
+SmartBmsTextWriter::SmartBmsTextWriter(char *buffer, const size_t size)
+{
+	this->buffer_ = buffer;
+	this->size_ = size;
+	this->position_ = 0;
+	this->overflow_ = size == 0;
+}
+
+/**
+ * @brief Destroy the SmartBmsTextWriter instance.
+ */
+SmartBmsTextWriter::~SmartBmsTextWriter()
+{
+}
+
+/**
+ * @brief Append a null terminated text.
+ * @param text text to append
+ */
+void SmartBmsTextWriter::append(const char *text)
+{
+	const size_t length = strlen(text);
+	if (this->overflow_ || this->position_ + length >= this->size_)
+	{
+		this->overflow_ = true;
+		return;
+	}
+	memcpy(&this->buffer_[this->position_], text, length);
+	this->position_ += length;
+}
+
+/**
+ * @brief Append a single character. One byte of the buffer is always kept free for the null character.
+ * @param character character to append
+ */
+void SmartBmsTextWriter::append(const char character)
+{
+	if (this->overflow_ || this->position_ + 1 >= this->size_)
+	{
+		this->overflow_ = true;
+		return;
+	}
+	this->buffer_[this->position_++] = character;
+}
+
+/**
+ * @brief Append a signed integer in decimal.
+ * @param value value to append
+ */
+void SmartBmsTextWriter::appendInteger(const int64_t value)
+{
+	if (value < 0)
+	{
+		this->append('-');
+		this->appendUnsigned(0 - static_cast<uint64_t>(value));
+		return;
+	}
+	this->appendUnsigned(value);
+}
+
+/**
+ * @brief Append an unsigned integer in decimal. The digits are formatted with integer math only.
+ * @param value value to append
+ */
+void SmartBmsTextWriter::appendUnsigned(const uint64_t value)
+{
+	// Collect the digits from the back, 20 are enough for 64 bits
+	char digits[20];
+	size_t digitCount = 0;
+	uint64_t remaining = value;
+	while (remaining > UINT32_MAX)
+	{
+		digits[digitCount++] = '0' + remaining % 10;
+		remaining /= 10;
+	}
+
+	// The field values fit into 32 bits, where the division is much cheaper than the 64 bit library call
+	uint32_t remaining32 = remaining;
+	do
+	{
+		digits[digitCount++] = '0' + remaining32 % 10;
+		remaining32 /= 10;
+	} while (remaining32 != 0);
+
+	if (this->overflow_ || this->position_ + digitCount >= this->size_)
+	{
+		this->overflow_ = true;
+		return;
+	}
+	while (digitCount > 0)
+	{
+		this->buffer_[this->position_++] = digits[--digitCount];
+	}
+}
+
+/**
+ * @brief Get the length of the text written so far.
+ * @return length without the null character
+ */
+const size_t SmartBmsTextWriter::getLength() const
+{
+	return this->position_;
+}
+
+/**
+ * @brief Check if the text did not fit into the buffer.
+ * @return true when characters were dropped
+ */
+const bool SmartBmsTextWriter::hasOverflow() const
+{
+	return this->overflow_;
+}
+
+/**
+ * @brief Terminate the text with a null character.
+ * When the text did not fit, the buffer is left with an empty text, so incomplete records are never used by accident.
+ * @return length of the text, 0 when it did not fit
+ */
+const size_t SmartBmsTextWriter::finish()
+{
+	if (this->size_ == 0)
+	{
+		return 0;
+	}
+	if (this->overflow_)
+	{
+		this->buffer_[0] = '\0';
+		return 0;
+	}
+	this->buffer_[this->position_] = '\0';
+	return this->position_;
+}
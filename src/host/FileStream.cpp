@@ -0,0 +1,144 @@
+/**
+ * @file FileStream.cpp
+ * @author TheRealKasumi
+ * @brief Implementation of the FileStream class.
+ * @copyright Copyright (c) 2024 TheRealKasumi
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#include "host/FileStream.h"
+
+#include <string.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+
+/**
+ * @brief Create a new instance of FileStream.
+ * @param fileDescriptor open file descriptor to read from, pipes and terminals should be non-blocking
+ * @param closeOnDestroy true to close the file descriptor when the stream is destroyed
+ */
+FileStream::FileStream(const int fileDescriptor, const bool closeOnDestroy)
+{
+	this->fileDescriptor_ = fileDescriptor;
+	this->closeOnDestroy_ = closeOnDestroy;
+	this->endOfFile_ = false;
+	this->bufferStart_ = 0;
+	this->bufferEnd_ = 0;
+}
+
+/**
+ * @brief Destroy the FileStream instance.
+ */
+FileStream::~FileStream()
+{
+	if (this->closeOnDestroy_)
+	{
+		close(this->fileDescriptor_);
+	}
+}
+
+/**
+ * @brief Get the number of bytes that can be read without waiting.
+ * @return number of buffered bytes plus the bytes pending in the file descriptor
+ */
+int FileStream::available()
+{
+	int pending = 0;
+	if (ioctl(this->fileDescriptor_, FIONREAD, &pending) != 0 || pending < 0)
+	{
+		pending = 0;
+	}
+	return static_cast<int>(this->bufferEnd_ - this->bufferStart_) + pending;
+}
+
+/**
+ * @brief Read a single byte.
+ * @return byte value or -1 when no data is available
+ */
+int FileStream::read()
+{
+	if (this->bufferStart_ == this->bufferEnd_ && !this->fillBuffer_())
+	{
+		return -1;
+	}
+	return this->buffer_[this->bufferStart_++];
+}
+
+/**
+ * @brief Get the next byte without consuming it.
+ * @return byte value or -1 when no data is available
+ */
+int FileStream::peek()
+{
+	if (this->bufferStart_ == this->bufferEnd_ && !this->fillBuffer_())
+	{
+		return -1;
+	}
+	return this->buffer_[this->bufferStart_];
+}
+
+/**
+ * @brief Read bytes into a buffer until the buffer is full or no more data is available.
+ * @param buffer buffer that receives the data
+ * @param length size of the buffer
+ * @return number of bytes read
+ */
+size_t FileStream::readBytes(uint8_t *buffer, size_t length)
+{
+	size_t count = 0;
+	while (count < length)
+	{
+		if (this->bufferStart_ == this->bufferEnd_ && !this->fillBuffer_())
+		{
+			break;
+		}
+		size_t chunk = this->bufferEnd_ - this->bufferStart_;
+		if (chunk > length - count)
+		{
+			chunk = length - count;
+		}
+		memcpy(&buffer[count], &this->buffer_[this->bufferStart_], chunk);
+		this->bufferStart_ += chunk;
+		count += chunk;
+	}
+	return count;
+}
+
+/**
+ * @brief Check if the end of the file was reached, or the write end of a pipe was closed.
+ * @return true when the end of the file was reached
+ */
+const bool FileStream::isEndOfFile() const
+{
+	return this->endOfFile_ && this->bufferStart_ == this->bufferEnd_;
+}
+
+/**
+ * @brief Refill the internal buffer with a single read call.
+ * @return true when new data was read
+ * @return false when no data was available
+ */
+const bool FileStream::fillBuffer_()
+{
+	const ssize_t length = ::read(this->fileDescriptor_, this->buffer_, sizeof(this->buffer_));
+	if (length <= 0)
+	{
+		this->endOfFile_ = length == 0;
+		return false;
+	}
+	this->bufferStart_ = 0;
+	this->bufferEnd_ = length;
+	return true;
+}
@@ -0,0 +1,115 @@
+/**
+ * @file MemoryStream.cpp
+ * @author TheRealKasumi
+ * @brief Implementation of the MemoryStream class.
+ * @copyright Copyright (c) 2024 TheRealKasumi
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#include "host/MemoryStream.h"
+
+#include <string.h>
+
+/**
+ * @brief Create a new instance of MemoryStream.
+ * @param data data to read, it is not copied and must stay valid
+ * @param length number of bytes
+ */
+MemoryStream::MemoryStream(const uint8_t *data, const size_t length)
+{
+	this->setData(data, length);
+}
+
+/**
+ * @brief Destroy the MemoryStream instance.
+ */
+MemoryStream::~MemoryStream()
+{
+}
+
+/**
+ * @brief Get the number of bytes that are left to read.
+ * @return number of bytes, limited to the range of int
+ */
+int MemoryStream::available()
+{
+	const size_t remaining = this->length_ - this->position_;
+	return remaining > 0x7FFFFFFF ? 0x7FFFFFFF : static_cast<int>(remaining);
+}
+
+/**
+ * @brief Read a single byte.
+ * @return byte value or -1 at the end of the data
+ */
+int MemoryStream::read()
+{
+	return this->position_ < this->length_ ? this->data_[this->position_++] : -1;
+}
+
+/**
+ * @brief Get the next byte without consuming it.
+ * @return byte value or -1 at the end of the data
+ */
+int MemoryStream::peek()
+{
+	return this->position_ < this->length_ ? this->data_[this->position_] : -1;
+}
+
+/**
+ * @brief Read bytes into a buffer until the buffer is full or the end of the data is reached.
+ * @param buffer buffer that receives the data
+ * @param length size of the buffer
+ * @return number of bytes read
+ */
+size_t MemoryStream::readBytes(uint8_t *buffer, size_t length)
+{
+	const size_t remaining = this->length_ - this->position_;
+	if (length > remaining)
+	{
+		length = remaining;
+	}
+	memcpy(buffer, &this->data_[this->position_], length);
+	this->position_ += length;
+	return length;
+}
+
+/**
+ * @brief Replace the data and start reading from the beginning.
+ * @param data data to read, it is not copied and must stay valid
+ * @param length number of bytes
+ */
+void MemoryStream::setData(const uint8_t *data, const size_t length)
+{
+	this->data_ = data;
+	this->length_ = length;
+	this->position_ = 0;
+}
+
+/**
+ * @brief Start reading from the beginning again.
+ */
+void MemoryStream::rewind()
+{
+	this->position_ = 0;
+}
+
+/**
+ * @brief Get the number of bytes that were read so far.
+ * @return read position
+ */
+const size_t MemoryStream::getPosition() const
+{
+	return this->position_;
+}
@@ -0,0 +1,152 @@
+/**
+ * @file PacedStream.cpp
+ * @author TheRealKasumi
+ * @brief Implementation of the PacedStream class.
+ * @copyright Copyright (c) 2024 TheRealKasumi
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#include "host/PacedStream.h"
+
+#include <string.h>
+
+#include "bms/SmartBmsField.h"
+
+/**
+ * @brief Create a new instance of PacedStream. By default the frames arrive back to back at 9600 baud from time 0.
+ * @param data data to read, it is not copied and must stay valid
+ * @param length number of bytes
+ * @param clock clock that decides which bytes have arrived
+ */
+PacedStream::PacedStream(const uint8_t *data, const size_t length, SmartBmsClock clock)
+{
+	this->data_ = data;
+	this->length_ = length;
+	this->position_ = 0;
+	this->clock_ = clock;
+	this->setTiming(0, 1042, SMART_BMS_FRAME_SIZE * 1042);
+}
+
+/**
+ * @brief Destroy the PacedStream instance.
+ */
+PacedStream::~PacedStream()
+{
+}
+
+/**
+ * @brief Get the number of bytes that have arrived and were not read yet.
+ * @return number of bytes
+ */
+int PacedStream::available()
+{
+	return this->getArrivedByteCount() - this->position_;
+}
+
+/**
+ * @brief Read a single byte.
+ * @return byte value or -1 when no byte is available
+ */
+int PacedStream::read()
+{
+	return this->available() > 0 ? this->data_[this->position_++] : -1;
+}
+
+/**
+ * @brief Get the next byte without consuming it.
+ * @return byte value or -1 when no byte is available
+ */
+int PacedStream::peek()
+{
+	return this->available() > 0 ? this->data_[this->position_] : -1;
+}
+
+/**
+ * @brief Read the bytes that have arrived into a buffer, without waiting for more.
+ * @param buffer buffer that receives the data
+ * @param length size of the buffer
+ * @return number of bytes read
+ */
+size_t PacedStream::readBytes(uint8_t *buffer, size_t length)
+{
+	const size_t available = this->available();
+	if (length > available)
+	{
+		length = available;
+	}
+	memcpy(buffer, &this->data_[this->position_], length);
+	this->position_ += length;
+	return length;
+}
+
+/**
+ * @brief Set when the bytes arrive.
+ * @param startTime time in µs when the first byte arrives
+ * @param byteDuration time in µs to transfer one byte, 1042 at 9600 baud
+ * @param framePeriod time in µs from the start of one frame to the start of the next one, at least 58 byte durations
+ */
+void PacedStream::setTiming(const uint32_t startTime, const uint32_t byteDuration, const uint32_t framePeriod)
+{
+	this->startTime_ = startTime;
+	this->byteDuration_ = byteDuration > 0 ? byteDuration : 1;
+	this->framePeriod_ = framePeriod > SMART_BMS_FRAME_SIZE * this->byteDuration_ ? framePeriod : SMART_BMS_FRAME_SIZE * this->byteDuration_;
+}
+
+/**
+ * @brief Get the number of bytes that have arrived until now, including the ones that were read.
+ * @return number of bytes
+ */
+const size_t PacedStream::getArrivedByteCount()
+{
+	// A byte has arrived once its last bit was transferred, the time before the start wraps to a negative value
+	const uint32_t elapsed = this->clock_() - this->startTime_;
+	if (static_cast<int32_t>(elapsed) < static_cast<int32_t>(this->byteDuration_))
+	{
+		return 0;
+	}
+	const size_t frameCount = elapsed / this->framePeriod_;
+	size_t byteCount = (elapsed - frameCount * this->framePeriod_) / this->byteDuration_;
+	byteCount = byteCount < SMART_BMS_FRAME_SIZE ? byteCount : SMART_BMS_FRAME_SIZE;
+	const size_t arrived = frameCount * SMART_BMS_FRAME_SIZE + byteCount;
+	return arrived < this->length_ ? arrived : this->length_;
+}
+
+/**
+ * @brief Get the time when the first bit of a byte arrives.
+ * @param index index of the byte
+ * @return time in µs
+ */
+const uint32_t PacedStream::getArrivalTime(const size_t index) const
+{
+	return this->startTime_ + (index / SMART_BMS_FRAME_SIZE) * this->framePeriod_ + (index % SMART_BMS_FRAME_SIZE) * this->byteDuration_;
+}
+
+/**
+ * @brief Get the number of bytes that were read so far.
+ * @return read position
+ */
+const size_t PacedStream::getPosition() const
+{
+	return this->position_;
+}
+
+/**
+ * @brief Check if all bytes were read.
+ * @return true when all bytes were read
+ */
+const bool PacedStream::isEndOfData() const
+{
+	return this->position_ == this->length_;
+}
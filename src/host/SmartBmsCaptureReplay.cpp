@@ -0,0 +1,238 @@
+/**
+ * @file SmartBmsCaptureReplay.cpp
+ * @author TheRealKasumi
+ * @brief Contains a replay source for raw UART captures, which maps the capture file into memory.
+ * @copyright Copyright (c) 2024 TheRealKasumi
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#include "host/SmartBmsCaptureReplay.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <thread>
+
+/**
+ * @brief Create a new instance of SmartBmsCaptureReplay.
+ */
+SmartBmsCaptureReplay::SmartBmsCaptureReplay()
+{
+	this->open_ = false;
+	this->data_ = nullptr;
+	this->size_ = 0;
+	this->position_ = 0;
+	this->pacing_ = SmartBmsReplayPacing::SBMS_REPLAY_AS_FAST_AS_POSSIBLE;
+	this->pacingStartPosition_ = 0;
+	this->pacingStarted_ = false;
+}
+
+/**
+ * @brief Destroy the SmartBmsCaptureReplay instance.
+ */
+SmartBmsCaptureReplay::~SmartBmsCaptureReplay()
+{
+	this->close();
+}
+
+/**
+ * @brief Map a capture file into memory. A capture that is already open is closed first.
+ * The file is mapped read only, so it is never copied into a buffer.
+ * @param path path of the capture file
+ * @return true when the capture was opened
+ * @return false when the file can not be opened or mapped
+ */
+const bool SmartBmsCaptureReplay::open(const char *path)
+{
+	this->close();
+
+	const int fileDescriptor = ::open(path, O_RDONLY);
+	if (fileDescriptor < 0)
+	{
+		return false;
+	}
+
+	struct stat fileStatus;
+	if (fstat(fileDescriptor, &fileStatus) != 0)
+	{
+		::close(fileDescriptor);
+		return false;
+	}
+
+	// An empty file can not be mapped, but is still a valid capture
+	if (fileStatus.st_size > 0)
+	{
+		void *data = mmap(nullptr, fileStatus.st_size, PROT_READ, MAP_PRIVATE, fileDescriptor, 0);
+		if (data == MAP_FAILED)
+		{
+			::close(fileDescriptor);
+			return false;
+		}
+
+		// The capture is read front to back, so let the kernel read ahead aggressively
+		madvise(data, fileStatus.st_size, MADV_SEQUENTIAL);
+		this->data_ = static_cast<uint8_t *>(data);
+	}
+
+	// The mapping stays valid after the file descriptor was closed
+	::close(fileDescriptor);
+	this->open_ = true;
+	this->size_ = fileStatus.st_size;
+	this->rewind();
+	return true;
+}
+
+/**
+ * @brief Unmap the capture file.
+ */
+void SmartBmsCaptureReplay::close()
+{
+	if (this->data_ != nullptr)
+	{
+		munmap(this->data_, this->size_);
+	}
+	this->open_ = false;
+	this->data_ = nullptr;
+	this->size_ = 0;
+	this->rewind();
+}
+
+/**
+ * @brief Check if a capture is open.
+ * @return true when a capture is open
+ */
+const bool SmartBmsCaptureReplay::isOpen() const
+{
+	return this->open_;
+}
+
+/**
+ * @brief Set how fast the capture is replayed.
+ * @param pacing as fast as possible or with the timing of the original 9600 baud line
+ */
+void SmartBmsCaptureReplay::setPacing(const SmartBmsReplayPacing pacing)
+{
+	this->pacing_ = pacing;
+	this->pacingStarted_ = false;
+}
+
+/**
+ * @brief Get how fast the capture is replayed.
+ * @return pacing mode
+ */
+const SmartBmsReplayPacing SmartBmsCaptureReplay::getPacing() const
+{
+	return this->pacing_;
+}
+
+/**
+ * @brief Feed the next bytes of the capture into a reader. Decoded frames are passed to the frame callback of the reader.
+ * With the original pacing, the call blocks so that the bytes are fed at the rate of the original line.
+ * A 58 byte frame then takes about 60 ms.
+ * @param smartBmsReader reader that receives the bytes
+ * @param length maximum number of bytes to replay
+ * @return number of decoded frames
+ */
+const size_t SmartBmsCaptureReplay::replay(SmartBmsReader *smartBmsReader, const size_t length)
+{
+	const size_t end = this->size_ - this->position_ < length ? this->size_ : this->position_ + length;
+	size_t frameCount = 0;
+
+	// Without pacing, hand out large chunks straight from the mapping
+	if (this->pacing_ == SmartBmsReplayPacing::SBMS_REPLAY_AS_FAST_AS_POSSIBLE)
+	{
+		while (this->position_ < end)
+		{
+			const size_t chunkSize = end - this->position_ < SMART_BMS_REPLAY_CHUNK_SIZE ? end - this->position_ : SMART_BMS_REPLAY_CHUNK_SIZE;
+			frameCount += smartBmsReader->feed(&this->data_[this->position_], chunkSize);
+			this->position_ += chunkSize;
+		}
+		return frameCount;
+	}
+
+	// With pacing, every byte is fed when it would have arrived on the line
+	while (this->position_ < end)
+	{
+		this->waitForByte_(this->position_);
+		frameCount += smartBmsReader->feed(&this->data_[this->position_], 1);
+		this->position_++;
+	}
+	return frameCount;
+}
+
+/**
+ * @brief Restart the replay at the beginning of the capture.
+ */
+void SmartBmsCaptureReplay::rewind()
+{
+	this->position_ = 0;
+	this->pacingStarted_ = false;
+}
+
+/**
+ * @brief Get the mapped capture.
+ * @return pointer to the first byte, nullptr when no or an empty capture is open
+ */
+const uint8_t *SmartBmsCaptureReplay::getData() const
+{
+	return this->data_;
+}
+
+/**
+ * @brief Get the size of the capture.
+ * @return size in bytes
+ */
+const size_t SmartBmsCaptureReplay::getSize() const
+{
+	return this->size_;
+}
+
+/**
+ * @brief Get the position of the next byte that will be replayed.
+ * @return position in bytes
+ */
+const size_t SmartBmsCaptureReplay::getPosition() const
+{
+	return this->position_;
+}
+
+/**
+ * @brief Check if the whole capture was replayed.
+ * @return true when all bytes were replayed
+ */
+const bool SmartBmsCaptureReplay::isEndOfCapture() const
+{
+	return this->position_ >= this->size_;
+}
+
+/**
+ * @brief Wait until a byte would have been received on the original line.
+ * The arrival time is calculated from the start of the replay, so delays of single calls do not add up.
+ * @param position position of the byte
+ */
+void SmartBmsCaptureReplay::waitForByte_(const size_t position)
+{
+	if (!this->pacingStarted_)
+	{
+		this->pacingStartPosition_ = position;
+		this->pacingStartTime_ = std::chrono::steady_clock::now();
+		this->pacingStarted_ = true;
+	}
+
+	const uint64_t bitCount = static_cast<uint64_t>(position - this->pacingStartPosition_ + 1) * SMART_BMS_REPLAY_BITS_PER_BYTE;
+	const std::chrono::microseconds arrival(bitCount * 1000000 / SMART_BMS_REPLAY_BAUD_RATE);
+	std::this_thread::sleep_until(this->pacingStartTime_ + arrival);
+}
@@ -0,0 +1,181 @@
+/**
+ * @file SmartBmsFrameGenerator.cpp
+ * @author TheRealKasumi
+ * @brief Implementation of the SmartBmsFrameGenerator class.
+ * @copyright Copyright (c) 2024 TheRealKasumi
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#include "host/SmartBmsFrameGenerator.h"
+
+#include <string.h>
+
+#include "bms/SmartBmsReader.h"
+
+/**
+ * @brief Create a new instance of SmartBmsFrameGenerator.
+ * The same seed always produces the same sequence of frames.
+ * @param seed seed of the random number generator, must not be 0
+ * @param cellCount number of cells of the simulated pack
+ */
+SmartBmsFrameGenerator::SmartBmsFrameGenerator(const uint32_t seed, const uint8_t cellCount)
+{
+	this->state_ = seed != 0 ? seed : 1;
+	this->cellCount_ = cellCount;
+	this->frameNumber_ = 0;
+	this->cellVoltage_ = 660;
+	this->current_ = 0;
+	this->temperature_ = SMART_BMS_GENERATOR_REST_TEMPERATURE;
+	this->energy_ = SMART_BMS_GENERATOR_CAPACITY_WH / 2;
+}
+
+/**
+ * @brief Destroy the SmartBmsFrameGenerator instance.
+ */
+SmartBmsFrameGenerator::~SmartBmsFrameGenerator()
+{
+}
+
+/**
+ * @brief Generate the next frame. Values follow a slow random walk around a LiFePo4 pack at rest.
+ * Every value is pulled back to its rest value and kept within realistic bounds, so long runs stay plausible.
+ * The state of charge follows the remaining energy and the cell voltage follows the state of charge.
+ * @param frame buffer of 58 bytes that receives the frame
+ */
+void SmartBmsFrameGenerator::generate(uint8_t frame[SMART_BMS_FRAME_SIZE])
+{
+	// Let the pack state drift a little per frame, the current is pulled back to rest
+	this->current_ += static_cast<int32_t>(this->nextRandom() % 9) - 4 - this->current_ / 64;
+	this->current_ = SmartBmsFrameGenerator::clamp_(this->current_, -SMART_BMS_GENERATOR_MAX_CURRENT, SMART_BMS_GENERATOR_MAX_CURRENT);
+	this->energy_ = SmartBmsFrameGenerator::clamp_(this->energy_ + this->current_ / 64, 0, SMART_BMS_GENERATOR_CAPACITY_WH);
+	const int32_t soc = this->energy_ * 100 / SMART_BMS_GENERATOR_CAPACITY_WH;
+
+	// The cell voltage wanders around the open circuit voltage of the state of charge
+	const int32_t restVoltage = SMART_BMS_GENERATOR_MIN_CELL_VOLTAGE + (SMART_BMS_GENERATOR_MAX_CELL_VOLTAGE - SMART_BMS_GENERATOR_MIN_CELL_VOLTAGE) * soc / 100;
+	this->cellVoltage_ += static_cast<int32_t>(this->nextRandom() % 3) - 1 + (restVoltage - this->cellVoltage_) / 8;
+	this->cellVoltage_ = SmartBmsFrameGenerator::clamp_(this->cellVoltage_, SMART_BMS_GENERATOR_MIN_CELL_VOLTAGE + 8, SMART_BMS_GENERATOR_MAX_CELL_VOLTAGE - 8);
+	this->temperature_ += static_cast<int32_t>(this->nextRandom() % 3) - 1 + (SMART_BMS_GENERATOR_REST_TEMPERATURE - this->temperature_) / 16;
+
+	memset(frame, 0, SMART_BMS_FRAME_SIZE);
+	const uint8_t cellCount = this->cellCount_ > 0 ? this->cellCount_ : 1;
+	const int32_t spread = this->nextRandom() % 8;
+	SmartBmsFrameGenerator::encodeRawValue(frame, SBMS_FIELD_CELL_COUNT, cellCount);
+	SmartBmsFrameGenerator::encodeRawValue(frame, SBMS_FIELD_CELL_VOLTAGE_MIN, 560);
+	SmartBmsFrameGenerator::encodeRawValue(frame, SBMS_FIELD_CELL_VOLTAGE_MAX, 730);
+	SmartBmsFrameGenerator::encodeRawValue(frame, SBMS_FIELD_CELL_VOLTAGE_BALANCE, 690);
+	SmartBmsFrameGenerator::encodeRawValue(frame, SBMS_FIELD_PACK_SOC, soc);
+	SmartBmsFrameGenerator::encodeRawValue(frame, SBMS_FIELD_PACK_VOLTAGE, this->cellVoltage_ * cellCount);
+	SmartBmsFrameGenerator::encodeRawValue(frame, SBMS_FIELD_PACK_CURRENT, this->current_);
+	SmartBmsFrameGenerator::encodeRawValue(frame, SBMS_FIELD_PACK_CHARGE_CURRENT, this->current_ > 0 ? this->current_ : 0);
+	SmartBmsFrameGenerator::encodeRawValue(frame, SBMS_FIELD_PACK_DISCHARGE_CURRENT, this->current_ < 0 ? -this->current_ : 0);
+	SmartBmsFrameGenerator::encodeRawValue(frame, SBMS_FIELD_PACK_CAPACITY, SMART_BMS_GENERATOR_CAPACITY_WH / 100);
+	SmartBmsFrameGenerator::encodeRawValue(frame, SBMS_FIELD_PACK_REMAINING_ENERGY, this->energy_);
+	SmartBmsFrameGenerator::encodeRawValue(frame, SBMS_FIELD_LOWEST_CELL_VOLTAGE, this->cellVoltage_ - spread);
+	SmartBmsFrameGenerator::encodeRawValue(frame, SBMS_FIELD_LOWEST_CELL_VOLTAGE_NUMBER, 1 + this->nextRandom() % cellCount);
+	SmartBmsFrameGenerator::encodeRawValue(frame, SBMS_FIELD_HIGHEST_CELL_VOLTAGE, this->cellVoltage_ + spread);
+	SmartBmsFrameGenerator::encodeRawValue(frame, SBMS_FIELD_HIGHEST_CELL_VOLTAGE_NUMBER, 1 + this->nextRandom() % cellCount);
+	SmartBmsFrameGenerator::encodeRawValue(frame, SBMS_FIELD_LOWEST_CELL_TEMPERATURE, this->temperature_ - 2);
+	SmartBmsFrameGenerator::encodeRawValue(frame, SBMS_FIELD_LOWEST_CELL_TEMPERATURE_NUMBER, 1 + this->nextRandom() % cellCount);
+	SmartBmsFrameGenerator::encodeRawValue(frame, SBMS_FIELD_HIGHEST_CELL_TEMPERATURE, this->temperature_ + 2);
+	SmartBmsFrameGenerator::encodeRawValue(frame, SBMS_FIELD_HIGHEST_CELL_TEMPERATURE_NUMBER, 1 + this->nextRandom() % cellCount);
+	SmartBmsFrameGenerator::encodeRawValue(frame, SBMS_FIELD_ALLOWED_TO_CHARGE, 1);
+	SmartBmsFrameGenerator::encodeRawValue(frame, SBMS_FIELD_ALLOWED_TO_DISCHARGE, 1);
+
+#ifdef SMART_BMS_CELL_DATA
+	// One between module adds the data of its cell per cycle, the modules take turns
+	const uint8_t cellNumber = 1 + this->frameNumber_ % cellCount;
+	SmartBmsFrameGenerator::encodeRawValue(frame, SBMS_FIELD_CELL_NUMBER, cellNumber);
+	SmartBmsFrameGenerator::encodeRawValue(frame, SBMS_FIELD_CELL_VOLTAGE, this->cellVoltage_ + cellNumber % 5 - 2);
+	SmartBmsFrameGenerator::encodeRawValue(frame, SBMS_FIELD_CELL_TEMPERATURE, this->temperature_ + cellNumber % 3 - 1);
+#endif
+	SmartBmsFrameGenerator::updateChecksum(frame);
+	this->frameNumber_++;
+}
+
+/**
+ * @brief Generate many frames back to back.
+ * @param buffer buffer of frameCount * 58 bytes
+ * @param frameCount number of frames
+ */
+void SmartBmsFrameGenerator::generate(uint8_t *buffer, const size_t frameCount)
+{
+	for (size_t i = 0; i < frameCount; i++)
+	{
+		this->generate(&buffer[i * SMART_BMS_FRAME_SIZE]);
+	}
+}
+
+/**
+ * @brief Get the next number of the xorshift random number generator.
+ * @return random number
+ */
+const uint32_t SmartBmsFrameGenerator::nextRandom()
+{
+	this->state_ ^= this->state_ << 13;
+	this->state_ ^= this->state_ >> 17;
+	this->state_ ^= this->state_ << 5;
+	return this->state_;
+}
+
+/**
+ * @brief Limit a value to a range.
+ * @param value value to limit
+ * @param min lower bound
+ * @param max upper bound
+ * @return value within the range
+ */
+const int32_t SmartBmsFrameGenerator::clamp_(const int32_t value, const int32_t min, const int32_t max)
+{
+	return value < min ? min : (value > max ? max : value);
+}
+
+/**
+ * @brief Encode a raw value into a frame, based on the field table.
+ * @param frame buffer of 58 bytes
+ * @param field field to encode
+ * @param rawValue raw value, flags are set for any value other than 0
+ */
+void SmartBmsFrameGenerator::encodeRawValue(uint8_t frame[SMART_BMS_FRAME_SIZE], const SmartBmsField field, const int32_t rawValue)
+{
+	const SmartBmsFieldDescriptor &descriptor = SmartBmsFields::getDescriptor(field);
+	uint8_t *buffer = &frame[descriptor.offset];
+	if (descriptor.encoding == SBMS_ENCODING_FLAG)
+	{
+		buffer[0] = rawValue != 0 ? buffer[0] | descriptor.bitMask : buffer[0] & ~descriptor.bitMask;
+		return;
+	}
+	else if (descriptor.encoding == SBMS_ENCODING_SIGNED)
+	{
+		const int32_t absoluteValue = rawValue < 0 ? -rawValue : rawValue;
+		buffer[0] = rawValue < 0 ? '-' : '+';
+		buffer[1] = absoluteValue >> 8;
+		buffer[2] = absoluteValue;
+		return;
+	}
+
+	for (uint8_t i = 0; i < descriptor.width; i++)
+	{
+		buffer[i] = rawValue >> (8 * (descriptor.width - 1 - i));
+	}
+}
+
+/**
+ * @brief Calculate the checksum of a frame and store it in the last byte.
+ * @param frame buffer of 58 bytes
+ */
+void SmartBmsFrameGenerator::updateChecksum(uint8_t frame[SMART_BMS_FRAME_SIZE])
+{
+	frame[SMART_BMS_FRAME_SIZE - 1] = SmartBmsReader::calculateChecksum(frame, SMART_BMS_FRAME_SIZE - 1);
+}
@@ -0,0 +1,171 @@
+/**
+ * @file SmartBmsNoiseInjector.cpp
+ * @author TheRealKasumi
+ * @brief Implementation of the SmartBmsNoiseInjector class.
+ * @copyright Copyright (c) 2024 TheRealKasumi
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#include "host/SmartBmsNoiseInjector.h"
+
+/**
+ * @brief Create a new instance of SmartBmsNoiseInjector.
+ * @param seed seed of the random numbers, 0 is replaced by 1
+ * @param profile rates of the faults
+ */
+SmartBmsNoiseInjector::SmartBmsNoiseInjector(const uint32_t seed, const SmartBmsNoiseProfile &profile)
+{
+	this->state_ = seed != 0 ? seed : 1;
+	this->profile_ = profile;
+	this->burstRemaining_ = 0;
+	this->bitFlipCount_ = 0;
+	this->dropCount_ = 0;
+	this->duplicateCount_ = 0;
+	this->burstCount_ = 0;
+}
+
+/**
+ * @brief Destroy the SmartBmsNoiseInjector instance.
+ */
+SmartBmsNoiseInjector::~SmartBmsNoiseInjector()
+{
+}
+
+/**
+ * @brief Corrupt bytes and append them to the output.
+ * @param data bytes to corrupt
+ * @param length number of bytes
+ * @param output vector that receives the corrupted bytes
+ * @return number of bytes that were hit by a fault, including the bytes of a burst that continued from the previous call
+ */
+const uint32_t SmartBmsNoiseInjector::inject(const uint8_t *data, const size_t length, std::vector<uint8_t> *output)
+{
+	uint32_t faultCount = 0;
+	for (size_t i = 0; i < length; i++)
+	{
+		// A burst hides every other fault of the bytes it overwrites
+		if (this->burstRemaining_ == 0 && this->profile_.maxBurstLength > 0 && this->chance_(this->profile_.burstRate))
+		{
+			this->burstRemaining_ = 1 + this->nextRandom_() % this->profile_.maxBurstLength;
+			this->burstCount_++;
+		}
+		if (this->burstRemaining_ > 0)
+		{
+			this->burstRemaining_--;
+			output->push_back(this->nextRandom_() >> 24);
+			faultCount++;
+			continue;
+		}
+
+		if (this->chance_(this->profile_.dropRate))
+		{
+			this->dropCount_++;
+			faultCount++;
+			continue;
+		}
+
+		uint8_t value = data[i];
+		if (this->chance_(this->profile_.bitFlipRate))
+		{
+			value ^= 1 << (this->nextRandom_() % 8);
+			this->bitFlipCount_++;
+			faultCount++;
+		}
+		output->push_back(value);
+		if (this->chance_(this->profile_.duplicateRate))
+		{
+			output->push_back(value);
+			this->duplicateCount_++;
+			faultCount++;
+		}
+	}
+	return faultCount;
+}
+
+/**
+ * @brief Get the noise profile.
+ * @return reference to the profile
+ */
+const SmartBmsNoiseProfile &SmartBmsNoiseInjector::getProfile() const
+{
+	return this->profile_;
+}
+
+/**
+ * @brief Get the number of flipped bits.
+ * @return number of bit flips
+ */
+const uint32_t SmartBmsNoiseInjector::getBitFlipCount() const
+{
+	return this->bitFlipCount_;
+}
+
+/**
+ * @brief Get the number of dropped bytes.
+ * @return number of drops
+ */
+const uint32_t SmartBmsNoiseInjector::getDropCount() const
+{
+	return this->dropCount_;
+}
+
+/**
+ * @brief Get the number of duplicated bytes.
+ * @return number of duplicates
+ */
+const uint32_t SmartBmsNoiseInjector::getDuplicateCount() const
+{
+	return this->duplicateCount_;
+}
+
+/**
+ * @brief Get the number of bursts.
+ * @return number of bursts
+ */
+const uint32_t SmartBmsNoiseInjector::getBurstCount() const
+{
+	return this->burstCount_;
+}
+
+/**
+ * @brief Get the number of faults of all kinds, a burst counts as one fault.
+ * @return number of faults
+ */
+const uint32_t SmartBmsNoiseInjector::getFaultCount() const
+{
+	return this->bitFlipCount_ + this->dropCount_ + this->duplicateCount_ + this->burstCount_;
+}
+
+/**
+ * @brief Get the next random number, the generator is the same xorshift as the one of SmartBmsFrameGenerator.
+ * @return random number
+ */
+const uint32_t SmartBmsNoiseInjector::nextRandom_()
+{
+	this->state_ ^= this->state_ << 13;
+	this->state_ ^= this->state_ >> 17;
+	this->state_ ^= this->state_ << 5;
+	return this->state_;
+}
+
+/**
+ * @brief Roll a fault.
+ * @param rate probability of the fault per million bytes
+ * @return true when the fault happens
+ */
+const bool SmartBmsNoiseInjector::chance_(const uint32_t rate)
+{
+	return rate > 0 && this->nextRandom_() % SMART_BMS_NOISE_RATE_SCALE < rate;
+}
@@ -0,0 +1,387 @@
+/**
+ * @file SmartBmsSharedRing.cpp
+ * @author TheRealKasumi
+ * @brief Implementation of the SmartBmsSharedRing class.
+ * @copyright Copyright (c) 2024 TheRealKasumi
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#include "host/SmartBmsSharedRing.h"
+
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+static_assert(sizeof(SmartBmsSharedRingHeader) == 64, "The header must fill exactly one cache line, so the slots never share it with the write index");
+
+/**
+ * @brief Create a new instance of SmartBmsSharedRing.
+ */
+SmartBmsSharedRing::SmartBmsSharedRing()
+{
+	this->header_ = nullptr;
+	this->slots_ = nullptr;
+	this->mappingSize_ = 0;
+	this->producer_ = false;
+	this->readIndex_ = 0;
+	this->lostFrameCount_ = 0;
+}
+
+/**
+ * @brief Destroy the SmartBmsSharedRing instance.
+ * The shared memory object stays until it is removed, so consumers survive a restart of the producer.
+ */
+SmartBmsSharedRing::~SmartBmsSharedRing()
+{
+	this->close();
+}
+
+/**
+ * @brief Create the ring as producer. An existing ring with the same name is removed first.
+ * Consumers that still map the removed ring keep their mapping but never see a new frame, so they have to open the ring again.
+ * @param name name of the shared memory object, like "/smartbms"
+ * @param slotCount number of frames the ring holds
+ * @return true when the ring was created
+ * @return false when the slot count is zero or the shared memory can not be created
+ */
+const bool SmartBmsSharedRing::create(const char *name, const uint32_t slotCount)
+{
+	this->close();
+	if (slotCount == 0)
+	{
+		return false;
+	}
+
+	shm_unlink(name);
+	const int fileDescriptor = shm_open(name, O_CREAT | O_EXCL | O_RDWR, 0644);
+	if (fileDescriptor < 0)
+	{
+		return false;
+	}
+
+	const size_t size = this->getMappingSize_(slotCount);
+	if (ftruncate(fileDescriptor, size) != 0 || !this->map_(fileDescriptor, size, PROT_READ | PROT_WRITE))
+	{
+		::close(fileDescriptor);
+		shm_unlink(name);
+		return false;
+	}
+	::close(fileDescriptor);
+
+	// A new object is zero filled, the magic is written last so a consumer never accepts a half initialized header
+	this->header_->version = SMART_BMS_SHARED_RING_VERSION;
+	this->header_->slotCount = slotCount;
+	this->header_->slotSize = sizeof(SmartBmsSharedRingSlot);
+	this->header_->writeIndex.store(0, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+	this->header_->magic = SMART_BMS_SHARED_RING_MAGIC;
+	this->producer_ = true;
+	return true;
+}
+
+/**
+ * @brief Open an existing ring as consumer. The memory is mapped read only, so a consumer can never corrupt the ring.
+ * The consumer starts at the latest frame and only sees frames that are published after it was opened.
+ * @param name name of the shared memory object, like "/smartbms"
+ * @return true when the ring was opened
+ * @return false when the ring does not exist or has an unknown layout
+ */
+const bool SmartBmsSharedRing::open(const char *name)
+{
+	this->close();
+
+	const int fileDescriptor = shm_open(name, O_RDONLY, 0);
+	if (fileDescriptor < 0)
+	{
+		return false;
+	}
+
+	struct stat fileStatus;
+	if (fstat(fileDescriptor, &fileStatus) != 0 || static_cast<size_t>(fileStatus.st_size) < sizeof(SmartBmsSharedRingHeader) ||
+		!this->map_(fileDescriptor, fileStatus.st_size, PROT_READ))
+	{
+		::close(fileDescriptor);
+		return false;
+	}
+	::close(fileDescriptor);
+
+	// The producer might still be initializing the header, in that case the magic is not yet set
+	const bool valid = this->header_->magic == SMART_BMS_SHARED_RING_MAGIC;
+	std::atomic_thread_fence(std::memory_order_acquire);
+	if (!valid || this->header_->version != SMART_BMS_SHARED_RING_VERSION || this->header_->slotSize != sizeof(SmartBmsSharedRingSlot) ||
+		this->header_->slotCount == 0 || this->mappingSize_ < this->getMappingSize_(this->header_->slotCount))
+	{
+		this->close();
+		return false;
+	}
+	this->skipToLatest();
+	return true;
+}
+
+/**
+ * @brief Unmap the ring. The shared memory object itself is not removed.
+ */
+void SmartBmsSharedRing::close()
+{
+	if (this->header_ != nullptr)
+	{
+		munmap(this->header_, this->mappingSize_);
+	}
+	this->header_ = nullptr;
+	this->slots_ = nullptr;
+	this->mappingSize_ = 0;
+	this->producer_ = false;
+	this->readIndex_ = 0;
+	this->lostFrameCount_ = 0;
+}
+
+/**
+ * @brief Check if a ring is open.
+ * @return true when the ring is open as producer or consumer
+ */
+const bool SmartBmsSharedRing::isOpen() const
+{
+	return this->header_ != nullptr;
+}
+
+/**
+ * @brief Check if the ring was created by this instance.
+ * @return true when this instance is the producer
+ */
+const bool SmartBmsSharedRing::isProducer() const
+{
+	return this->producer_;
+}
+
+/**
+ * @brief Remove a shared memory object. Processes that still map it keep their mapping.
+ * @param name name of the shared memory object
+ * @return true when the object was removed
+ */
+const bool SmartBmsSharedRing::remove(const char *name)
+{
+	return shm_unlink(name) == 0;
+}
+
+/**
+ * @brief Publish a frame. Must only be called by the producer.
+ * @param frameView frame to publish, the timestamp of the view is published with it
+ */
+void SmartBmsSharedRing::publish(const SmartBmsFrameView &frameView)
+{
+	this->publish(frameView.getFrame(), frameView.getTimestamp());
+}
+
+/**
+ * @brief Publish a frame. Must only be called by the producer.
+ * The slot is marked as being written while it is filled, the write index only moves once the slot is complete.
+ * @param frame raw frame to publish
+ * @param timestamp arrival time of the frame in µs
+ */
+void SmartBmsSharedRing::publish(const uint8_t frame[SMART_BMS_FRAME_SIZE], const uint32_t timestamp)
+{
+	if (!this->producer_)
+	{
+		return;
+	}
+
+	const uint32_t index = this->header_->writeIndex.load(std::memory_order_relaxed);
+	SmartBmsSharedRingSlot &slot = this->slots_[index % this->header_->slotCount];
+	slot.sequence.store(index * 2 + 1, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+	slot.timestamp = timestamp;
+	memcpy(slot.frame, frame, SMART_BMS_FRAME_SIZE);
+	slot.sequence.store(index * 2 + 2, std::memory_order_release);
+	this->header_->writeIndex.store(index + 1, std::memory_order_release);
+}
+
+/**
+ * @brief Get the next frame in place, without copying it out of the shared memory.
+ * The frame must be released with advance(), which tells if the producer overwrote it in the meantime.
+ * @param timestamp optional pointer that receives the arrival time of the frame in µs
+ * @return pointer to the frame in the shared memory or nullptr when there is no new frame
+ */
+const uint8_t *SmartBmsSharedRing::peek(uint32_t *timestamp)
+{
+	if (this->header_ == nullptr)
+	{
+		return nullptr;
+	}
+
+	const uint32_t slotCount = this->header_->slotCount;
+	while (true)
+	{
+		// Frames that were overwritten before the consumer got to them are lost
+		const uint32_t writeIndex = this->header_->writeIndex.load(std::memory_order_acquire);
+		const uint32_t available = writeIndex - this->readIndex_;
+		if (available == 0)
+		{
+			return nullptr;
+		}
+		else if (available > slotCount)
+		{
+			this->lostFrameCount_ += available - slotCount;
+			this->readIndex_ = writeIndex - slotCount;
+		}
+
+		// The producer might already reuse the oldest slot, without having moved the write index yet
+		const SmartBmsSharedRingSlot &slot = this->slots_[this->readIndex_ % slotCount];
+		if (slot.sequence.load(std::memory_order_acquire) == this->readIndex_ * 2 + 2)
+		{
+			if (timestamp != nullptr)
+			{
+				*timestamp = slot.timestamp;
+			}
+			return slot.frame;
+		}
+		this->lostFrameCount_++;
+		this->readIndex_++;
+	}
+}
+
+/**
+ * @brief Release the frame that was returned by peek() and move to the next one.
+ * @return true when the frame was still intact after it was read
+ * @return false when the producer overwrote the frame while it was read, everything read from it must be discarded
+ */
+const bool SmartBmsSharedRing::advance()
+{
+	if (this->header_ == nullptr)
+	{
+		return false;
+	}
+
+	// The reads of the frame must complete before the sequence is checked again
+	std::atomic_thread_fence(std::memory_order_acquire);
+	const SmartBmsSharedRingSlot &slot = this->slots_[this->readIndex_ % this->header_->slotCount];
+	const bool intact = slot.sequence.load(std::memory_order_relaxed) == this->readIndex_ * 2 + 2;
+	if (!intact)
+	{
+		this->lostFrameCount_++;
+	}
+	this->readIndex_++;
+	return intact;
+}
+
+/**
+ * @brief Copy the next frame out of the ring.
+ * @param frameView view that receives the frame and its timestamp
+ * @return true when a frame was read
+ * @return false when there is no new frame
+ */
+const bool SmartBmsSharedRing::read(SmartBmsFrameView *frameView)
+{
+	uint32_t timestamp = 0;
+	const uint8_t *frame = this->peek(&timestamp);
+	while (frame != nullptr)
+	{
+		*frameView = SmartBmsFrameView(frame, timestamp);
+		if (this->advance())
+		{
+			return true;
+		}
+		frame = this->peek(&timestamp);
+	}
+	return false;
+}
+
+/**
+ * @brief Skip all unread frames, the next frame is the next one that is published.
+ */
+void SmartBmsSharedRing::skipToLatest()
+{
+	if (this->header_ != nullptr)
+	{
+		this->readIndex_ = this->header_->writeIndex.load(std::memory_order_acquire);
+	}
+}
+
+/**
+ * @brief Get the number of frames the ring holds.
+ * @return number of slots or 0 when the ring is not open
+ */
+const uint32_t SmartBmsSharedRing::getSlotCount() const
+{
+	return this->header_ != nullptr ? this->header_->slotCount : 0;
+}
+
+/**
+ * @brief Get the number of frames that were published since the ring was created.
+ * @return write index, wraps after 2^32 frames
+ */
+const uint32_t SmartBmsSharedRing::getWriteIndex() const
+{
+	return this->header_ != nullptr ? this->header_->writeIndex.load(std::memory_order_acquire) : 0;
+}
+
+/**
+ * @brief Get the index of the next frame this consumer reads.
+ * @return read index
+ */
+const uint32_t SmartBmsSharedRing::getReadIndex() const
+{
+	return this->readIndex_;
+}
+
+/**
+ * @brief Get the number of frames that were published, but not yet read by this consumer.
+ * @return number of frames, at most the number of slots
+ */
+const uint32_t SmartBmsSharedRing::getAvailable() const
+{
+	const uint32_t available = this->getWriteIndex() - this->readIndex_;
+	return available < this->getSlotCount() ? available : this->getSlotCount();
+}
+
+/**
+ * @brief Get the number of frames this consumer lost, because the producer overwrote them before they were read.
+ * @return number of lost frames
+ */
+const uint32_t SmartBmsSharedRing::getLostFrameCount() const
+{
+	return this->lostFrameCount_;
+}
+
+/**
+ * @brief Map the shared memory object and locate the header and the slots.
+ * @param fileDescriptor descriptor of the shared memory object
+ * @param size size of the mapping in bytes
+ * @param protection protection of the mapping
+ * @return true when the object was mapped
+ */
+const bool SmartBmsSharedRing::map_(const int fileDescriptor, const size_t size, const int protection)
+{
+	void *data = mmap(nullptr, size, protection, MAP_SHARED, fileDescriptor, 0);
+	if (data == MAP_FAILED)
+	{
+		return false;
+	}
+	this->header_ = static_cast<SmartBmsSharedRingHeader *>(data);
+	this->slots_ = reinterpret_cast<SmartBmsSharedRingSlot *>(this->header_ + 1);
+	this->mappingSize_ = size;
+	return true;
+}
+
+/**
+ * @brief Calculate the size of the shared memory object.
+ * @param slotCount number of slots
+ * @return size in bytes
+ */
+const size_t SmartBmsSharedRing::getMappingSize_(const uint32_t slotCount) const
+{
+	return sizeof(SmartBmsSharedRingHeader) + static_cast<size_t>(slotCount) * sizeof(SmartBmsSharedRingSlot);
+}
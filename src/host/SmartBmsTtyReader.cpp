@@ -0,0 +1,355 @@
+/**
+ * @file SmartBmsTtyReader.cpp
+ * @author TheRealKasumi
+ * @brief Implementation of the SmartBmsTtyReader class.
+ * @copyright Copyright (c) 2024 TheRealKasumi
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#include "host/SmartBmsTtyReader.h"
+
+#if defined(__linux__)
+
+#include <errno.h>
+#include <fcntl.h>
+#include <termios.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+
+/**
+ * @brief Create a new instance of SmartBmsTtyReader.
+ */
+SmartBmsTtyReader::SmartBmsTtyReader()
+{
+	this->fileDescriptor_ = -1;
+	this->epollDescriptor_ = -1;
+	this->stopDescriptor_ = -1;
+	this->frameCallback_ = nullptr;
+	this->frameCallbackContext_ = nullptr;
+	this->receivedByteCount_ = 0;
+	this->frameCount_ = 0;
+	this->smartBmsReader_.setFrameCallback(SmartBmsTtyReader::onFrame_, this);
+}
+
+/**
+ * @brief Destroy the SmartBmsTtyReader instance.
+ */
+SmartBmsTtyReader::~SmartBmsTtyReader()
+{
+	this->close();
+}
+
+/**
+ * @brief Open and configure a serial port. A port that is already open is closed first.
+ * @param path path of the port, like "/dev/ttyUSB0" or the slave of a pseudo terminal
+ * @param baudRate baud rate of the port
+ * @return true when the port was opened
+ * @return false when the port can not be opened, configured or watched
+ */
+const bool SmartBmsTtyReader::open(const char *path, const uint32_t baudRate)
+{
+	this->close();
+
+	this->fileDescriptor_ = ::open(path, O_RDONLY | O_NOCTTY | O_NONBLOCK | O_CLOEXEC);
+	if (this->fileDescriptor_ < 0 || !SmartBmsTtyReader::configure_(this->fileDescriptor_, baudRate))
+	{
+		this->close();
+		return false;
+	}
+
+	// The port and the stop event are watched together, so stop() can interrupt a wait at any time
+	this->epollDescriptor_ = epoll_create1(EPOLL_CLOEXEC);
+	this->stopDescriptor_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+	if (this->epollDescriptor_ < 0 || this->stopDescriptor_ < 0)
+	{
+		this->close();
+		return false;
+	}
+
+	struct epoll_event event = {};
+	event.events = EPOLLIN;
+	event.data.fd = this->fileDescriptor_;
+	if (epoll_ctl(this->epollDescriptor_, EPOLL_CTL_ADD, this->fileDescriptor_, &event) != 0)
+	{
+		this->close();
+		return false;
+	}
+	event.data.fd = this->stopDescriptor_;
+	if (epoll_ctl(this->epollDescriptor_, EPOLL_CTL_ADD, this->stopDescriptor_, &event) != 0)
+	{
+		this->close();
+		return false;
+	}
+	return true;
+}
+
+/**
+ * @brief Close the port.
+ */
+void SmartBmsTtyReader::close()
+{
+	if (this->epollDescriptor_ >= 0)
+	{
+		::close(this->epollDescriptor_);
+	}
+	if (this->stopDescriptor_ >= 0)
+	{
+		::close(this->stopDescriptor_);
+	}
+	if (this->fileDescriptor_ >= 0)
+	{
+		::close(this->fileDescriptor_);
+	}
+	this->fileDescriptor_ = -1;
+	this->epollDescriptor_ = -1;
+	this->stopDescriptor_ = -1;
+}
+
+/**
+ * @brief Check if a port is open.
+ * @return true when the port is open
+ */
+const bool SmartBmsTtyReader::isOpen() const
+{
+	return this->fileDescriptor_ >= 0;
+}
+
+/**
+ * @brief Get the file descriptor of the port, so it can be watched by another event loop. The descriptor is non blocking.
+ * @return file descriptor or -1 when the port is not open
+ */
+const int SmartBmsTtyReader::getFileDescriptor() const
+{
+	return this->fileDescriptor_;
+}
+
+/**
+ * @brief Get the reader that assembles the frames, to subscribe to flags or to read the cycle tracking.
+ * The frame callback of the reader must not be replaced, use setFrameCallback() instead.
+ * @return pointer to the reader
+ */
+SmartBmsReader *SmartBmsTtyReader::getReader()
+{
+	return &this->smartBmsReader_;
+}
+
+/**
+ * @brief Set a callback that is called for every complete frame.
+ * @param frameCallback function that is called with the frame, the view is only valid during the call
+ * @param context user defined pointer that is passed to the callback
+ */
+void SmartBmsTtyReader::setFrameCallback(SmartBmsFrameCallback frameCallback, void *context)
+{
+	this->frameCallback_ = frameCallback;
+	this->frameCallbackContext_ = context;
+}
+
+/**
+ * @brief Wait for data and feed everything that arrived into the reader.
+ * @param timeout maximum time to wait in ms, -1 waits until data arrives or stop() is called
+ * @return number of completed frames, 0 on a timeout or a stop request
+ * @return -1 when the port failed or was hung up, like an unplugged adapter or a closed pseudo terminal
+ */
+const int SmartBmsTtyReader::poll(const int timeout)
+{
+	if (this->epollDescriptor_ < 0)
+	{
+		return -1;
+	}
+
+	struct epoll_event events[2];
+	const int eventCount = epoll_wait(this->epollDescriptor_, events, 2, timeout);
+	if (eventCount < 0)
+	{
+		return errno == EINTR ? 0 : -1;
+	}
+
+	int frameCount = 0;
+	for (int i = 0; i < eventCount; i++)
+	{
+		if (events[i].data.fd == this->stopDescriptor_)
+		{
+			continue;
+		}
+
+		// Data that arrived before a hang up is still decoded
+		const int drained = this->drain_();
+		if (drained < 0)
+		{
+			return -1;
+		}
+		frameCount += drained;
+		if ((events[i].events & (EPOLLHUP | EPOLLERR)) != 0)
+		{
+			return -1;
+		}
+	}
+	return frameCount;
+}
+
+/**
+ * @brief Read the port until stop() is called or the port fails.
+ * @return true when the loop was stopped by stop()
+ * @return false when the port failed
+ */
+const bool SmartBmsTtyReader::run()
+{
+	uint64_t stopCount = 0;
+	while (this->poll(-1) >= 0)
+	{
+		if (read(this->stopDescriptor_, &stopCount, sizeof(stopCount)) == sizeof(stopCount))
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+/**
+ * @brief Make run() return and wake up a waiting poll(). Can be called from another thread or a signal handler.
+ */
+void SmartBmsTtyReader::stop()
+{
+	if (this->stopDescriptor_ >= 0)
+	{
+		const uint64_t increment = 1;
+		const ssize_t written = write(this->stopDescriptor_, &increment, sizeof(increment));
+		(void)written;
+	}
+}
+
+/**
+ * @brief Get the number of bytes that were received from the port.
+ * @return number of bytes
+ */
+const uint64_t SmartBmsTtyReader::getReceivedByteCount() const
+{
+	return this->receivedByteCount_;
+}
+
+/**
+ * @brief Get the number of frames that were completed.
+ * @return number of frames
+ */
+const uint32_t SmartBmsTtyReader::getFrameCount() const
+{
+	return this->frameCount_;
+}
+
+/**
+ * @brief Read everything the port has buffered and feed it into the reader.
+ * @return number of completed frames or -1 when the port failed
+ */
+const int SmartBmsTtyReader::drain_()
+{
+	const uint32_t frameCount = this->frameCount_;
+	uint8_t buffer[SMART_BMS_TTY_READ_SIZE];
+	while (true)
+	{
+		const ssize_t length = read(this->fileDescriptor_, buffer, sizeof(buffer));
+		if (length > 0)
+		{
+			this->receivedByteCount_ += length;
+			this->smartBmsReader_.feed(buffer, length);
+		}
+		else if (length < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+		{
+			return this->frameCount_ - frameCount;
+		}
+		else if (length < 0 && errno == EINTR)
+		{
+			continue;
+		}
+		else
+		{
+			// A tty reports a hang up with an end of file or with EIO
+			return -1;
+		}
+	}
+}
+
+/**
+ * @brief Put the port into raw mode with 8 data bits, no parity and one stop bit.
+ * @param fileDescriptor descriptor of the port
+ * @param baudRate baud rate of the port
+ * @return true when the port was configured
+ * @return false when the baud rate is not supported or the port is not a tty
+ */
+const bool SmartBmsTtyReader::configure_(const int fileDescriptor, const uint32_t baudRate)
+{
+	speed_t speed;
+	switch (baudRate)
+	{
+	case 4800:
+		speed = B4800;
+		break;
+	case 9600:
+		speed = B9600;
+		break;
+	case 19200:
+		speed = B19200;
+		break;
+	case 38400:
+		speed = B38400;
+		break;
+	case 57600:
+		speed = B57600;
+		break;
+	case 115200:
+		speed = B115200;
+		break;
+	default:
+		return false;
+	}
+
+	struct termios options;
+	if (tcgetattr(fileDescriptor, &options) != 0)
+	{
+		return false;
+	}
+
+	// Raw mode disables echo, line editing and every translation of the received bytes
+	cfmakeraw(&options);
+	options.c_cflag &= ~(CSIZE | PARENB | CSTOPB | CRTSCTS);
+	options.c_cflag |= CS8 | CLOCAL | CREAD;
+	options.c_cc[VMIN] = 1;
+	options.c_cc[VTIME] = 0;
+	if (cfsetispeed(&options, speed) != 0 || cfsetospeed(&options, speed) != 0 || tcsetattr(fileDescriptor, TCSANOW, &options) != 0)
+	{
+		return false;
+	}
+
+	// Bytes that were buffered before the port was opened are too old to be timestamped
+	tcflush(fileDescriptor, TCIFLUSH);
+	return true;
+}
+
+/**
+ * @brief Frame callback of the reader that counts the frame and forwards it.
+ * @param frameView completed frame
+ * @param context pointer to the SmartBmsTtyReader instance
+ */
+void SmartBmsTtyReader::onFrame_(const SmartBmsFrameView *frameView, void *context)
+{
+	SmartBmsTtyReader *ttyReader = static_cast<SmartBmsTtyReader *>(context);
+	ttyReader->frameCount_++;
+	if (ttyReader->frameCallback_ != nullptr)
+	{
+		ttyReader->frameCallback_(frameView, ttyReader->frameCallbackContext_);
+	}
+}
+
+#endif
@@ -0,0 +1,95 @@
+/**
+ * @file Stream.cpp
+ * @author TheRealKasumi
+ * @brief Implementation of the host stand-in for the Arduino Stream class.
+ * @copyright Copyright (c) 2024 TheRealKasumi
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#include "host/Stream.h"
+
+/**
+ * @brief Create a new instance of Stream.
+ */
+Stream::Stream()
+{
+	this->timeout_ = 1000;
+}
+
+/**
+ * @brief Destroy the Stream instance.
+ */
+Stream::~Stream()
+{
+}
+
+/**
+ * @brief Flush the output, there is nothing to do by default.
+ */
+void Stream::flush()
+{
+}
+
+/**
+ * @brief Write a single byte, writing is not supported by default.
+ * @param value byte to write
+ * @return number of bytes written
+ */
+size_t Stream::write(const uint8_t value)
+{
+	(void)value;
+	return 0;
+}
+
+/**
+ * @brief Read bytes into a buffer until the buffer is full or no more data is available.
+ * @param buffer buffer that receives the data
+ * @param length size of the buffer
+ * @return number of bytes read
+ */
+size_t Stream::readBytes(uint8_t *buffer, size_t length)
+{
+	size_t count = 0;
+	while (count < length)
+	{
+		const int value = this->read();
+		if (value < 0)
+		{
+			break;
+		}
+		buffer[count++] = static_cast<uint8_t>(value);
+	}
+	return count;
+}
+
+/**
+ * @brief Read bytes into a buffer until the buffer is full or no more data is available.
+ * @param buffer buffer that receives the data
+ * @param length size of the buffer
+ * @return number of bytes read
+ */
+size_t Stream::readBytes(char *buffer, size_t length)
+{
+	return this->readBytes(reinterpret_cast<uint8_t *>(buffer), length);
+}
+
+/**
+ * @brief Set the read timeout. It is stored for compatibility, reading never waits on the host.
+ * @param timeout timeout in milliseconds
+ */
+void Stream::setTimeout(const unsigned long timeout)
+{
+	this->timeout_ = timeout;
+}
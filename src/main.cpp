@@ -23,6 +23,9 @@
 #include "bms/SmartBmsData.h"
 #include "bms/SmartBmsError.h"
 #include "bms/SmartBmsReader.h"
+#include "bms/SmartBmsSerializer.h"
+
+// Add -D SMART_BMS_FIXED_POINT to the build flags to decode into integer units without floating point math
 
 // Serial configuration, adjust as needed
 #define PC_SERIAL_BAUD 115200
@@ -32,10 +35,51 @@
 #define BMS_SERIAL_RX_PIN 26
 #define BMS_SERIAL_INVERT false
 
+// Output configuration, values are printed in the integer units of the field table
+#define BMS_OUTPUT_FORMAT SmartBmsSerializerFormat::SBMS_FORMAT_JSON
+
 // Serial connections
 HardwareSerial smartBmsSerial(BMS_SERIAL_PERIPHERAL);
 SmartBmsReader smartBmsReader(&smartBmsSerial);
 
+// The CSV header is printed once before the first line
+bool csvHeaderPrinted = false;
+
+/**
+ * @brief Print the BMS data to the serial monitor.
+ * @param smartBmsData data to print
+ */
+void printBmsData(const SmartBmsData &smartBmsData)
+{
+	// Format into a static buffer, so printing never touches the heap
+	static char buffer[SMART_BMS_SERIALIZER_BUFFER_SIZE];
+	if (BMS_OUTPUT_FORMAT == SmartBmsSerializerFormat::SBMS_FORMAT_CSV && !csvHeaderPrinted)
+	{
+		SmartBmsSerializer::toCsvHeader(buffer, sizeof(buffer));
+		Serial.println(buffer);
+		csvHeaderPrinted = true;
+	}
+	if (SmartBmsSerializer::serialize(smartBmsData, BMS_OUTPUT_FORMAT, buffer, sizeof(buffer)) > 0)
+	{
+		Serial.println(buffer);
+	}
+}
+
+/**
+ * @brief Print a change of a permission flag as soon as the frame arrives.
+ * This is where an inverter or a charger would be switched.
+ * @param field flag that changed
+ * @param value new value of the flag
+ * @param timestamp time in µs when the first byte of the frame was received
+ * @param context not used
+ */
+void printBmsFlagChange(const SmartBmsField field, const bool value, const uint32_t timestamp, void *context)
+{
+	Serial.print("Event: ");
+	Serial.print(SmartBmsFields::getDescriptor(field).name);
+	Serial.println(value ? " is set" : " is cleared");
+}
+
 /**
  * @brief Setup.
  */
@@ -44,6 +88,10 @@ void setup()
 	// Initialize the serial connections
 	Serial.begin(PC_SERIAL_BAUD);
 	smartBmsSerial.begin(BMS_SERIAL_BAUD_RATE, BMS_SERIAL_MODE, BMS_SERIAL_RX_PIN, -1, BMS_SERIAL_INVERT);
+
+	// Watch the permission flags, the callback is invoked by the reader before the frame is decoded
+	smartBmsReader.subscribe(SBMS_FIELD_ALLOWED_TO_CHARGE, SmartBmsFlagEdge::SBMS_EDGE_BOTH, printBmsFlagChange, nullptr);
+	smartBmsReader.subscribe(SBMS_FIELD_ALLOWED_TO_DISCHARGE, SmartBmsFlagEdge::SBMS_EDGE_BOTH, printBmsFlagChange, nullptr);
 }
 
 /**
@@ -60,36 +108,7 @@ void loop()
 		if (err == SmartBmsError::SBMS_OK)
 		{
 			// Data is ok, lets print it
-			Serial.println();
-			Serial.println("===========================");
-			Serial.println((String) "Cell-Count: " + smartBmsData.getCellCount());
-			Serial.println((String) "Min-Cell-Voltage: " + smartBmsData.getCellVoltageMin() + "V");
-			Serial.println((String) "Max-Cell-Voltage: " + smartBmsData.getCellVoltageMax() + "V");
-			Serial.println((String) "Balance-Voltage: " + smartBmsData.getCellVoltageBalance() + "V");
-			Serial.println((String) "Pack-SOC: " + smartBmsData.getPackSoc() + "%");
-			Serial.println((String) "Pack-Voltage: " + smartBmsData.getPackVoltage() + "V");
-			Serial.println((String) "Pack-Current: " + smartBmsData.getPackCurrent() + "A");
-			Serial.println((String) "Pack-Charge-Current: " + smartBmsData.getPackChargeCurrent() + "A");
-			Serial.println((String) "Pack-Discharge-Current: " + smartBmsData.getPackDischargeCurrent() + "A");
-			Serial.println((String) "Pack-Capacity: " + smartBmsData.getPackCapacity() + "kWh");
-			Serial.println((String) "Pack-Energy: " + smartBmsData.getPackRemainingEnergy() + "kWh");
-			Serial.println((String) "Lowest-Cell-Voltage: " + smartBmsData.getLowestCellVoltage() + "V");
-			Serial.println((String) "Lowest-Cell-Voltage-Numer: " + smartBmsData.getLowestCellVoltageNumber());
-			Serial.println((String) "Highest-Cell-Voltage: " + smartBmsData.getHighestCellVoltage() + "V");
-			Serial.println((String) "Highest-Cell-Voltage-Number: " + smartBmsData.getHighestCellVoltageNumber());
-			Serial.println((String) "Lowest-Cell-Temp: " + smartBmsData.getLowestCellTemperature() + "°C");
-			Serial.println((String) "Lowest-Cell-Temp-Number: " + smartBmsData.getLowestCellTemperatureNumber());
-			Serial.println((String) "Highest-Cell-Temp: " + smartBmsData.getHighestCellTemperature() + "°C");
-			Serial.println((String) "Highest-Cell-Temp-Number: " + smartBmsData.getHighestCellTemperatureNumber());
-			Serial.println((String) "Allowed-Charge: " + (smartBmsData.isAllowedToCharge() ? "Yes" : "No"));
-			Serial.println((String) "Allowed-Discharge: " + (smartBmsData.isAllowedToDischarge() ? "Yes" : "No"));
-			Serial.println((String) "Alarm-Communication-Error: " + (smartBmsData.hasCommunicationError() ? "Active" : "Inactive"));
-			Serial.println((String) "Alarm-Min-Voltage: " + (smartBmsData.isMinVoltageAlarmActive() ? "Active" : "Inactive"));
-			Serial.println((String) "Alarm-Max-Voltage: " + (smartBmsData.isMaxVoltageAlarmActive() ? "Active" : "Inactive"));
-			Serial.println((String) "Alarm-Min-Temp: " + (smartBmsData.isMinTemperatureAlarmActive() ? "Active" : "Inactive"));
-			Serial.println((String) "Alarm-Max-Temp: " + (smartBmsData.isMaxTemperatureAlarmActive() ? "Active" : "Inactive"));
-			Serial.println("===========================");
-			Serial.println();
+			printBmsData(smartBmsData);
 		}
 		else if (err == SmartBmsError::SBMS_ERR_READ_STREAM)
 		{
@@ -98,11 +117,9 @@ void loop()
 		}
 		else if (err == SmartBmsError::SBMS_ERR_INVALID_CHECKSUM)
 		{
-			// Checksum is invalid, something went very wrong
-			Serial.println("Error: Failed to read BMS data. The checksum is invalid.");
-
-			// You can try to clear the input stream to recover from the error
-			smartBmsSerial.flush();
+			// Checksum is invalid, the reader slides through the buffered data until it finds the next frame
+			Serial.print("Error: Failed to read BMS data. The checksum is invalid. Skipped bytes: ");
+			Serial.println(smartBmsReader.getSkippedByteCount());
 		}
 	}
 
@@ -0,0 +1,122 @@
+/**
+ * @file main.cpp
+ * @author TheRealKasumi
+ * @brief Simulates a bank of packs on the host, each on its own paced UART, and services them from one loop.
+ * @copyright Copyright (c) 2024 TheRealKasumi
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+
+#include "bms/SmartBmsBank.h"
+#include "bms/SmartBmsData.h"
+#include "host/PacedStream.h"
+#include "host/SmartBmsFrameGenerator.h"
+
+// Default simulation, can be overridden by the arguments
+#define BANKSIM_PACK_COUNT SMART_BMS_MAX_PACKS
+#define BANKSIM_SECONDS 600
+#define BANKSIM_SERVICE_INTERVAL_MS 5
+
+// Every pack has a slightly different cycle, as every end module runs on its own clock
+#define BANKSIM_FRAME_PERIOD_US 1000000
+#define BANKSIM_FRAME_PERIOD_STEP_US 700
+#define BANKSIM_CORRUPT_INTERVAL 20
+
+// Simulated time in µs, shared by the streams and the bank
+static uint32_t simulatedTime = 0;
+
+/**
+ * @brief Clock of the simulation.
+ * @return simulated time in µs
+ */
+static const uint32_t getSimulatedTime()
+{
+	return simulatedTime;
+}
+
+int main(int argc, char **argv)
+{
+	const size_t packCount = argc > 1 ? strtoul(argv[1], nullptr, 10) : BANKSIM_PACK_COUNT;
+	const size_t seconds = argc > 2 ? strtoul(argv[2], nullptr, 10) : BANKSIM_SECONDS;
+	const uint32_t serviceInterval = (argc > 3 ? strtoul(argv[3], nullptr, 10) : BANKSIM_SERVICE_INTERVAL_MS) * 1000;
+	if (packCount == 0 || packCount > SMART_BMS_MAX_PACKS || serviceInterval == 0)
+	{
+		fprintf(stderr, "Usage: %s [pack count 1 to %d] [seconds] [service interval in ms]\n", argv[0], SMART_BMS_MAX_PACKS);
+		return 1;
+	}
+
+	// Generate the frames of every pack, the second pack has a corrupt frame from time to time
+	const size_t frameCount = seconds;
+	std::vector<std::vector<uint8_t>> captures(packCount, std::vector<uint8_t>(frameCount * SMART_BMS_FRAME_SIZE));
+	std::vector<PacedStream *> streams;
+	SmartBmsBank bank;
+	bank.setClock(getSimulatedTime);
+	bank.setMaxDataAge(3 * BANKSIM_FRAME_PERIOD_US);
+	for (size_t i = 0; i < packCount; i++)
+	{
+		SmartBmsFrameGenerator generator(i + 1, 16);
+		generator.generate(captures[i].data(), frameCount);
+		for (size_t j = BANKSIM_CORRUPT_INTERVAL - 1; i == 1 && j < frameCount; j += BANKSIM_CORRUPT_INTERVAL)
+		{
+			captures[i][j * SMART_BMS_FRAME_SIZE + 20] ^= 0x10;
+		}
+
+		PacedStream *stream = new PacedStream(captures[i].data(), captures[i].size(), getSimulatedTime);
+		stream->setTiming(i * BANKSIM_FRAME_PERIOD_US / packCount, 1042, BANKSIM_FRAME_PERIOD_US + i * BANKSIM_FRAME_PERIOD_STEP_US);
+		streams.push_back(stream);
+		bank.addPack(stream);
+	}
+
+	// Service all packs from one loop and watch how many bytes wait in the slowest served stream
+	size_t maxBacklog = 0;
+	bool done = false;
+	while (!done)
+	{
+		simulatedTime += serviceInterval;
+		done = true;
+		for (size_t i = 0; i < packCount; i++)
+		{
+			const size_t backlog = streams[i]->available();
+			maxBacklog = backlog > maxBacklog ? backlog : maxBacklog;
+			done = done && streams[i]->isEndOfData() && streams[i]->getArrivedByteCount() == captures[i].size();
+		}
+		bank.service();
+	}
+
+	for (size_t i = 0; i < packCount; i++)
+	{
+		SmartBmsPack *pack = bank.getPack(i);
+		printf("{\"pack\":%zu,\"frames\":%u,\"skipped_bytes\":%u,\"missed_cycles\":%u,\"read_errors\":%u,\"cycle_period_us\":%u,\"jitter_us\":%u}\n",
+			   i, pack->getFrameCount(), pack->getSkippedByteCount(), pack->getMissedCycleCount(), pack->getReadErrorCount(),
+			   pack->getReader()->getCyclePeriod(), pack->getReader()->getJitter());
+	}
+
+	SmartBmsBankView view;
+	bank.getView(&view);
+	printf("{\"packs\":%u,\"stale_packs\":%u,\"current_ma\":%d,\"remaining_energy_wh\":%u,\"lowest_cell_mv\":%u,\"lowest_cell_pack\":%u,"
+		   "\"highest_cell_mv\":%u,\"highest_cell_pack\":%u,\"allowed_to_charge\":%s,\"allowed_to_discharge\":%s,\"max_backlog_bytes\":%zu}\n",
+		   view.getPackCount(), view.getStalePackCount(), view.getPackCurrentMilliamps(), view.getPackRemainingEnergyWattHours(),
+		   view.getLowestCellVoltageMillivolts(), view.getLowestCellVoltagePack(), view.getHighestCellVoltageMillivolts(), view.getHighestCellVoltagePack(),
+		   view.isAllowedToCharge() ? "true" : "false", view.isAllowedToDischarge() ? "true" : "false", maxBacklog);
+
+	for (size_t i = 0; i < packCount; i++)
+	{
+		delete streams[i];
+	}
+	return 0;
+}
@@ -0,0 +1,314 @@
+/**
+ * @file main.cpp
+ * @author TheRealKasumi
+ * @brief Decode benchmark suite for the host. Prints one JSON object per benchmark.
+ * @copyright Copyright (c) 2024 TheRealKasumi
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <atomic>
+#include <chrono>
+#include <new>
+#include <string>
+#include <vector>
+
+#include "bms/SmartBmsBatchDecoder.h"
+#include "bms/SmartBmsData.h"
+#include "bms/SmartBmsFrameView.h"
+#include "bms/SmartBmsReader.h"
+#include "bms/SmartBmsSerializer.h"
+#include "host/MemoryStream.h"
+#include "host/SmartBmsFrameGenerator.h"
+
+// Default number of frames per benchmark, can be overridden by the first argument
+#define BENCHMARK_FRAME_COUNT 200000
+#define BENCHMARK_SEED 0x5B35
+
+// Count every heap allocation made by the process
+static std::atomic<uint64_t> allocationCount(0);
+
+void *operator new(size_t size)
+{
+	allocationCount.fetch_add(1, std::memory_order_relaxed);
+	void *pointer = malloc(size);
+	if (pointer == nullptr)
+	{
+		throw std::bad_alloc();
+	}
+	return pointer;
+}
+
+void operator delete(void *pointer) noexcept
+{
+	free(pointer);
+}
+
+void operator delete(void *pointer, size_t) noexcept
+{
+	free(pointer);
+}
+
+/**
+ * @brief Measures a single benchmark run.
+ */
+class BenchmarkRun
+{
+public:
+	BenchmarkRun(const char *name)
+	{
+		this->name_ = name;
+		this->allocations_ = allocationCount.load();
+		this->start_ = std::chrono::steady_clock::now();
+	}
+
+	void finish(const size_t frameCount, const size_t byteCount)
+	{
+		const std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+		const double seconds = std::chrono::duration<double>(end - this->start_).count();
+		const uint64_t allocations = allocationCount.load() - this->allocations_;
+		printf("{\"benchmark\":\"%s\",\"frames\":%zu,\"bytes\":%zu,\"seconds\":%.6f,\"frames_per_second\":%.0f,\"ns_per_frame\":%.2f,\"allocations_per_frame\":%.4f}\n",
+			   this->name_, frameCount, byteCount, seconds, frameCount / seconds, seconds * 1e9 / frameCount,
+			   static_cast<double>(allocations) / frameCount);
+	}
+
+private:
+	const char *name_;
+	uint64_t allocations_;
+	std::chrono::steady_clock::time_point start_;
+};
+
+// Prevent the compiler from removing results that are not used otherwise
+static volatile int32_t benchmarkSink;
+
+/**
+ * @brief Create a stream with noise between the frames.
+ * Every frame is preceded by up to 7 random bytes and every 16th frame has a corrupted byte.
+ * @param frames clean frames
+ * @param frameCount number of frames
+ * @param generator random number source
+ * @return noisy byte stream
+ */
+static std::vector<uint8_t> createNoisyStream(const std::vector<uint8_t> &frames, const size_t frameCount, SmartBmsFrameGenerator &generator)
+{
+	std::vector<uint8_t> noisy;
+	noisy.reserve(frames.size() * 2);
+	for (size_t i = 0; i < frameCount; i++)
+	{
+		const size_t noiseLength = generator.nextRandom() % 8;
+		for (size_t j = 0; j < noiseLength; j++)
+		{
+			noisy.push_back(generator.nextRandom());
+		}
+		const size_t start = noisy.size();
+		noisy.insert(noisy.end(), &frames[i * SMART_BMS_FRAME_SIZE], &frames[(i + 1) * SMART_BMS_FRAME_SIZE]);
+		if (i % 16 == 15)
+		{
+			noisy[start + generator.nextRandom() % SMART_BMS_FRAME_SIZE] ^= 0x10;
+		}
+	}
+	return noisy;
+}
+
+/**
+ * @brief Decode the whole stream with decodeBmsData().
+ * @param name name of the benchmark
+ * @param data byte stream
+ */
+static void benchmarkDecodeBmsData(const char *name, const std::vector<uint8_t> &data)
+{
+	MemoryStream stream(data.data(), data.size());
+	SmartBmsReader reader(&stream);
+	SmartBmsData smartBmsData;
+	size_t frameCount = 0;
+	BenchmarkRun run(name);
+	while (stream.available() > 0)
+	{
+		if (reader.decodeBmsData(&smartBmsData) == SmartBmsError::SBMS_OK)
+		{
+			frameCount++;
+		}
+	}
+	benchmarkSink = smartBmsData.getPackSoc();
+	run.finish(frameCount, data.size());
+}
+
+/**
+ * @brief Push the whole stream through feed() in chunks of 64 bytes.
+ * @param name name of the benchmark
+ * @param data byte stream
+ */
+static void benchmarkFeed(const char *name, const std::vector<uint8_t> &data)
+{
+	SmartBmsReader reader;
+	size_t frameCount = 0;
+	BenchmarkRun run(name);
+	for (size_t offset = 0; offset < data.size(); offset += 64)
+	{
+		const size_t length = data.size() - offset < 64 ? data.size() - offset : 64;
+		frameCount += reader.feed(&data[offset], length);
+	}
+	run.finish(frameCount, data.size());
+}
+
+/**
+ * @brief Format the data like the former printBmsData() of main.cpp, one concatenated string per line.
+ * std::string stands in for the Arduino String class, both allocate for every concatenation.
+ * @param smartBmsData data to format
+ * @return total length of all lines
+ */
+static size_t formatWithStringConcatenation(const SmartBmsData &smartBmsData)
+{
+	size_t length = 0;
+	length += (std::string("Cell-Count: ") + std::to_string(smartBmsData.getCellCount())).size();
+	length += (std::string("Min-Cell-Voltage: ") + std::to_string(smartBmsData.getCellVoltageMinMillivolts()) + "mV").size();
+	length += (std::string("Max-Cell-Voltage: ") + std::to_string(smartBmsData.getCellVoltageMaxMillivolts()) + "mV").size();
+	length += (std::string("Balance-Voltage: ") + std::to_string(smartBmsData.getCellVoltageBalanceMillivolts()) + "mV").size();
+	length += (std::string("Pack-SOC: ") + std::to_string(smartBmsData.getPackSoc()) + "%").size();
+	length += (std::string("Pack-Voltage: ") + std::to_string(smartBmsData.getPackVoltageMillivolts()) + "mV").size();
+	length += (std::string("Pack-Current: ") + std::to_string(smartBmsData.getPackCurrentMilliamps()) + "mA").size();
+	length += (std::string("Pack-Charge-Current: ") + std::to_string(smartBmsData.getPackChargeCurrentMilliamps()) + "mA").size();
+	length += (std::string("Pack-Discharge-Current: ") + std::to_string(smartBmsData.getPackDischargeCurrentMilliamps()) + "mA").size();
+	length += (std::string("Pack-Capacity: ") + std::to_string(smartBmsData.getPackCapacityWattHours()) + "Wh").size();
+	length += (std::string("Pack-Energy: ") + std::to_string(smartBmsData.getPackRemainingEnergyWattHours()) + "Wh").size();
+	length += (std::string("Lowest-Cell-Voltage: ") + std::to_string(smartBmsData.getLowestCellVoltageMillivolts()) + "mV").size();
+	length += (std::string("Lowest-Cell-Voltage-Numer: ") + std::to_string(smartBmsData.getLowestCellVoltageNumber())).size();
+	length += (std::string("Highest-Cell-Voltage: ") + std::to_string(smartBmsData.getHighestCellVoltageMillivolts()) + "mV").size();
+	length += (std::string("Highest-Cell-Voltage-Number: ") + std::to_string(smartBmsData.getHighestCellVoltageNumber())).size();
+	length += (std::string("Lowest-Cell-Temp: ") + std::to_string(smartBmsData.getLowestCellTemperatureMillicelsius()) + "m°C").size();
+	length += (std::string("Lowest-Cell-Temp-Number: ") + std::to_string(smartBmsData.getLowestCellTemperatureNumber())).size();
+	length += (std::string("Highest-Cell-Temp: ") + std::to_string(smartBmsData.getHighestCellTemperatureMillicelsius()) + "m°C").size();
+	length += (std::string("Highest-Cell-Temp-Number: ") + std::to_string(smartBmsData.getHighestCellTemperatureNumber())).size();
+	length += (std::string("Allowed-Charge: ") + (smartBmsData.isAllowedToCharge() ? "Yes" : "No")).size();
+	length += (std::string("Allowed-Discharge: ") + (smartBmsData.isAllowedToDischarge() ? "Yes" : "No")).size();
+	length += (std::string("Alarm-Communication-Error: ") + (smartBmsData.hasCommunicationError() ? "Active" : "Inactive")).size();
+	length += (std::string("Alarm-Min-Voltage: ") + (smartBmsData.isMinVoltageAlarmActive() ? "Active" : "Inactive")).size();
+	length += (std::string("Alarm-Max-Voltage: ") + (smartBmsData.isMaxVoltageAlarmActive() ? "Active" : "Inactive")).size();
+	length += (std::string("Alarm-Min-Temp: ") + (smartBmsData.isMinTemperatureAlarmActive() ? "Active" : "Inactive")).size();
+	length += (std::string("Alarm-Max-Temp: ") + (smartBmsData.isMaxTemperatureAlarmActive() ? "Active" : "Inactive")).size();
+	return length;
+}
+
+/**
+ * @brief Serialize every frame in the given format into a fixed buffer.
+ * @param name name of the benchmark
+ * @param records decoded frames
+ * @param format output format
+ */
+static void benchmarkSerializer(const char *name, const std::vector<SmartBmsData> &records, const SmartBmsSerializerFormat format)
+{
+	char buffer[SMART_BMS_SERIALIZER_BUFFER_SIZE];
+	size_t byteCount = 0;
+	BenchmarkRun run(name);
+	for (size_t i = 0; i < records.size(); i++)
+	{
+		byteCount += SmartBmsSerializer::serialize(records[i], format, buffer, sizeof(buffer));
+	}
+	run.finish(records.size(), byteCount);
+}
+
+int main(int argc, char **argv)
+{
+	const size_t frameCount = argc > 1 ? strtoul(argv[1], nullptr, 10) : BENCHMARK_FRAME_COUNT;
+	if (frameCount == 0)
+	{
+		fprintf(stderr, "Usage: %s [frame count]\n", argv[0]);
+		return 1;
+	}
+
+	// Generate the same frames for every run
+	SmartBmsFrameGenerator generator(BENCHMARK_SEED);
+	std::vector<uint8_t> frames(frameCount * SMART_BMS_FRAME_SIZE);
+	generator.generate(frames.data(), frameCount);
+	const std::vector<uint8_t> noisy = createNoisyStream(frames, frameCount, generator);
+
+	// Checksum validation, byte wise reference and word wide
+	{
+		size_t validCount = 0;
+		BenchmarkRun run("checksum_bytewise");
+		for (size_t i = 0; i < frameCount; i++)
+		{
+			const uint8_t *frame = &frames[i * SMART_BMS_FRAME_SIZE];
+			validCount += SmartBmsReader::calculateChecksum(frame, SMART_BMS_FRAME_SIZE - 1) == frame[SMART_BMS_FRAME_SIZE - 1];
+		}
+		benchmarkSink = validCount;
+		run.finish(frameCount, frames.size());
+	}
+	{
+		std::vector<uint8_t> validBitmap((frameCount + 7) / 8);
+		BenchmarkRun run("checksum_swar");
+		benchmarkSink = SmartBmsBatchDecoder::validateFrames(frames.data(), frameCount, validBitmap.data());
+		run.finish(frameCount, frames.size());
+	}
+
+	// Construction of SmartBmsData, eager from a view and batched
+	{
+		SmartBmsData smartBmsData;
+		BenchmarkRun run("data_from_view");
+		for (size_t i = 0; i < frameCount; i++)
+		{
+			const SmartBmsFrameView frameView(&frames[i * SMART_BMS_FRAME_SIZE]);
+			frameView.decode(&smartBmsData);
+			benchmarkSink = smartBmsData.getPackSoc();
+		}
+		run.finish(frameCount, frames.size());
+	}
+	{
+		SmartBmsData smartBmsData;
+		BenchmarkRun run("data_from_view_soc_only");
+		for (size_t i = 0; i < frameCount; i++)
+		{
+			const SmartBmsFrameView frameView(&frames[i * SMART_BMS_FRAME_SIZE]);
+			frameView.decode(&smartBmsData, SBMS_FIELD_MASK(SBMS_FIELD_PACK_SOC));
+			benchmarkSink = smartBmsData.getPackSoc();
+		}
+		run.finish(frameCount, frames.size());
+	}
+	std::vector<SmartBmsData> records(frameCount);
+	{
+		BenchmarkRun run("data_batch");
+		benchmarkSink = SmartBmsBatchDecoder::decodeFrames(frames.data(), frameCount, records.data(), nullptr);
+		run.finish(frameCount, frames.size());
+	}
+	{
+		BenchmarkRun run("data_batch_changed_fields");
+		SmartBmsBatchDecoder::markChangedFields(frames.data(), frameCount, records.data());
+		benchmarkSink = records[frameCount - 1].getChangedMask();
+		run.finish(frameCount, frames.size());
+	}
+
+	// Text output, fixed buffer serializers and the former String concatenation
+	benchmarkSerializer("serialize_json", records, SmartBmsSerializerFormat::SBMS_FORMAT_JSON);
+	benchmarkSerializer("serialize_csv", records, SmartBmsSerializerFormat::SBMS_FORMAT_CSV);
+	benchmarkSerializer("serialize_line_protocol", records, SmartBmsSerializerFormat::SBMS_FORMAT_LINE_PROTOCOL);
+	{
+		size_t byteCount = 0;
+		BenchmarkRun run("serialize_string_concatenation");
+		for (size_t i = 0; i < frameCount; i++)
+		{
+			byteCount += formatWithStringConcatenation(records[i]);
+		}
+		run.finish(frameCount, byteCount);
+	}
+
+	// Full stream decoding
+	benchmarkDecodeBmsData("decode_clean", frames);
+	benchmarkDecodeBmsData("decode_noisy", noisy);
+	benchmarkFeed("feed_clean", frames);
+	benchmarkFeed("feed_noisy", noisy);
+	return 0;
+}
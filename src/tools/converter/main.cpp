@@ -0,0 +1,418 @@
+/**
+ * @file main.cpp
+ * @author TheRealKasumi
+ * @brief Converts raw UART captures into a columnar binary file and optionally CSV, using all cores.
+ * @copyright Copyright (c) 2024 TheRealKasumi
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "bms/SmartBmsField.h"
+#include "bms/SmartBmsFrameView.h"
+#include "bms/SmartBmsReader.h"
+#include "host/SmartBmsCaptureReplay.h"
+
+/*
+ * Layout of the columnar file, all values are little endian:
+ *   header      "SBMSCOL1", uint32 column count
+ *   columns     uint8 field (0xFF for the capture offset), uint8 byte width, uint8 encoding,
+ *               uint8 name length, name, int32 fixed scale, int32 fixed offset, uint8 unit length, unit
+ *   row groups  uint32 row count, then the values of each column one after another
+ *   end         uint32 row count of 0
+ * Values are stored raw, the fixed point value is raw * fixed scale + fixed offset.
+ */
+#define CONVERTER_MAGIC "SBMSCOL1"
+#define CONVERTER_OFFSET_COLUMN 0xFF
+#define CONVERTER_OFFSET_WIDTH 8
+
+// Default size of the chunks that are decoded in parallel
+#define CONVERTER_CHUNK_SIZE (16 * 1024 * 1024)
+
+// Bytes in front of a chunk that are decoded to find the frame boundary, frames found there belong to the previous chunk
+#define CONVERTER_SYNC_LENGTH (4 * SMART_BMS_FRAME_SIZE)
+
+/**
+ * @brief Decoded frames of one chunk of the capture, which becomes one row group.
+ */
+struct ConverterChunk
+{
+	size_t start;
+	size_t end;
+	size_t rowCount;
+	std::vector<uint8_t> columns[SBMS_FIELD_COUNT + 1];
+	std::string csv;
+};
+
+/**
+ * @brief Shared state of the worker threads.
+ */
+struct ConverterState
+{
+	const uint8_t *data;
+	size_t size;
+	size_t chunkSize;
+	size_t chunkCount;
+	size_t maxInFlight;
+	bool csv;
+	std::atomic<size_t> nextChunk;
+	std::vector<std::unique_ptr<ConverterChunk>> chunks;
+	size_t writtenCount;
+	std::mutex mutex;
+	std::condition_variable chunkDone;
+	std::condition_variable chunkWritten;
+};
+
+/**
+ * @brief Get the number of bytes a column uses per value.
+ * @param field field of the column
+ * @return 1, 2 or 4 bytes
+ */
+static const uint8_t getColumnWidth(const SmartBmsField field)
+{
+	const SmartBmsFieldDescriptor &descriptor = SmartBmsFields::getDescriptor(field);
+	if (descriptor.encoding == SBMS_ENCODING_FLAG || descriptor.width == 1)
+	{
+		return 1;
+	}
+	return descriptor.encoding == SBMS_ENCODING_SIGNED || descriptor.width == 3 ? 4 : 2;
+}
+
+/**
+ * @brief Append a value to a column in little endian order.
+ * @param column column to append to
+ * @param value value to append
+ * @param width number of bytes
+ */
+static void appendValue(std::vector<uint8_t> &column, const uint64_t value, const uint8_t width)
+{
+	for (uint8_t i = 0; i < width; i++)
+	{
+		column.push_back(static_cast<uint8_t>(value >> (i * 8)));
+	}
+}
+
+/**
+ * @brief Append an integer to a CSV line without going through printf.
+ * @param csv line to append to
+ * @param value value to append
+ */
+static void appendInteger(std::string &csv, const int64_t value)
+{
+	char buffer[24];
+	char *end = &buffer[sizeof(buffer)];
+	char *begin = end;
+	uint64_t magnitude = value < 0 ? 0 - static_cast<uint64_t>(value) : static_cast<uint64_t>(value);
+	do
+	{
+		*--begin = static_cast<char>('0' + magnitude % 10);
+		magnitude /= 10;
+	} while (magnitude != 0);
+	if (value < 0)
+	{
+		*--begin = '-';
+	}
+	csv.append(begin, end);
+}
+
+/**
+ * @brief Decode all frames that start inside a chunk.
+ * The reader starts a few frames in front of the chunk, so it is locked to the same frame boundary as the previous chunk.
+ * Frames that end behind the chunk are still decoded, as long as they start inside of it.
+ * @param state shared state
+ * @param chunk chunk to decode
+ */
+static void decodeChunk(const ConverterState &state, ConverterChunk &chunk)
+{
+	const size_t limit = state.size - chunk.end < SMART_BMS_FRAME_SIZE - 1 ? state.size : chunk.end + SMART_BMS_FRAME_SIZE - 1;
+	size_t position = chunk.start > CONVERTER_SYNC_LENGTH ? chunk.start - CONVERTER_SYNC_LENGTH : 0;
+
+	// Reserve space for a frame at every boundary
+	const size_t maxRowCount = (chunk.end - chunk.start) / SMART_BMS_FRAME_SIZE + 1;
+	chunk.columns[SBMS_FIELD_COUNT].reserve(maxRowCount * CONVERTER_OFFSET_WIDTH);
+	for (size_t i = 0; i < SBMS_FIELD_COUNT; i++)
+	{
+		chunk.columns[i].reserve(maxRowCount * getColumnWidth(static_cast<SmartBmsField>(i)));
+	}
+
+	SmartBmsReader smartBmsReader;
+	while (position < limit)
+	{
+		SmartBmsFrameView frameView;
+		size_t consumed = 0;
+		const SmartBmsError err = smartBmsReader.feed(&state.data[position], limit - position, &consumed, &frameView);
+		position += consumed;
+		if (err != SmartBmsError::SBMS_OK || position - SMART_BMS_FRAME_SIZE < chunk.start)
+		{
+			continue;
+		}
+
+		// Store the raw values of the frame
+		const size_t frameStart = position - SMART_BMS_FRAME_SIZE;
+		appendValue(chunk.columns[SBMS_FIELD_COUNT], frameStart, CONVERTER_OFFSET_WIDTH);
+		for (size_t i = 0; i < SBMS_FIELD_COUNT; i++)
+		{
+			const SmartBmsField field = static_cast<SmartBmsField>(i);
+			appendValue(chunk.columns[i], static_cast<uint32_t>(frameView.getRawValue(field)), getColumnWidth(field));
+		}
+		chunk.rowCount++;
+
+		// The CSV contains the fixed point values
+		if (state.csv)
+		{
+			appendInteger(chunk.csv, frameStart);
+			for (size_t i = 0; i < SBMS_FIELD_COUNT; i++)
+			{
+				chunk.csv.push_back(',');
+				appendInteger(chunk.csv, frameView.getFixedValue(static_cast<SmartBmsField>(i)));
+			}
+			chunk.csv.push_back('\n');
+		}
+	}
+}
+
+/**
+ * @brief Worker thread, decodes chunks until all chunks are taken.
+ * A worker waits when too many decoded chunks are not written yet, so the memory usage stays bounded.
+ * @param state shared state
+ */
+static void runWorker(ConverterState *state)
+{
+	while (true)
+	{
+		const size_t index = state->nextChunk.fetch_add(1);
+		if (index >= state->chunkCount)
+		{
+			return;
+		}
+
+		{
+			std::unique_lock<std::mutex> lock(state->mutex);
+			state->chunkWritten.wait(lock, [state, index]()
+									 { return index < state->writtenCount + state->maxInFlight; });
+		}
+
+		std::unique_ptr<ConverterChunk> chunk(new ConverterChunk());
+		chunk->start = index * state->chunkSize;
+		chunk->end = state->size - chunk->start < state->chunkSize ? state->size : chunk->start + state->chunkSize;
+		chunk->rowCount = 0;
+		decodeChunk(*state, *chunk);
+
+		std::lock_guard<std::mutex> lock(state->mutex);
+		state->chunks[index] = std::move(chunk);
+		state->chunkDone.notify_all();
+	}
+}
+
+/**
+ * @brief Write a little endian integer to a file.
+ * @param file output file
+ * @param value value to write
+ * @param width number of bytes
+ */
+static void writeValue(FILE *file, const uint64_t value, const uint8_t width)
+{
+	std::vector<uint8_t> buffer;
+	appendValue(buffer, value, width);
+	fwrite(buffer.data(), 1, buffer.size(), file);
+}
+
+/**
+ * @brief Write a column description to the header of the columnar file.
+ * @param file output file
+ * @param field field id
+ * @param width byte width
+ * @param encoding encoding of the value
+ * @param name name of the column
+ * @param fixedScale fixed point scale
+ * @param fixedOffset fixed point offset
+ * @param unit fixed point unit
+ */
+static void writeColumnHeader(FILE *file, const uint8_t field, const uint8_t width, const uint8_t encoding, const char *name,
+							  const int32_t fixedScale, const int32_t fixedOffset, const char *unit)
+{
+	writeValue(file, field, 1);
+	writeValue(file, width, 1);
+	writeValue(file, encoding, 1);
+	writeValue(file, strlen(name), 1);
+	fwrite(name, 1, strlen(name), file);
+	writeValue(file, static_cast<uint32_t>(fixedScale), 4);
+	writeValue(file, static_cast<uint32_t>(fixedOffset), 4);
+	writeValue(file, strlen(unit), 1);
+	fwrite(unit, 1, strlen(unit), file);
+}
+
+int main(int argc, char **argv)
+{
+	const char *capturePath = nullptr;
+	const char *outputPath = nullptr;
+	const char *csvPath = nullptr;
+	size_t threadCount = std::thread::hardware_concurrency();
+	size_t chunkSize = CONVERTER_CHUNK_SIZE;
+
+	// Parse the arguments
+	for (int i = 1; i < argc; i++)
+	{
+		if (strcmp(argv[i], "--csv") == 0 && i + 1 < argc)
+		{
+			csvPath = argv[++i];
+		}
+		else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc)
+		{
+			threadCount = strtoul(argv[++i], nullptr, 10);
+		}
+		else if (strcmp(argv[i], "--chunk-size") == 0 && i + 1 < argc)
+		{
+			chunkSize = strtoul(argv[++i], nullptr, 10);
+		}
+		else if (capturePath == nullptr)
+		{
+			capturePath = argv[i];
+		}
+		else if (outputPath == nullptr)
+		{
+			outputPath = argv[i];
+		}
+		else
+		{
+			outputPath = nullptr;
+			break;
+		}
+	}
+	if (capturePath == nullptr || outputPath == nullptr || chunkSize <= CONVERTER_SYNC_LENGTH)
+	{
+		fprintf(stderr, "Usage: %s <capture file> <output file> [--csv <csv file>] [--threads <count>] [--chunk-size <bytes>]\n", argv[0]);
+		return 1;
+	}
+	threadCount = threadCount == 0 ? 1 : threadCount;
+
+	// Map the capture and open the outputs
+	SmartBmsCaptureReplay capture;
+	if (!capture.open(capturePath))
+	{
+		fprintf(stderr, "Failed to open capture %s.\n", capturePath);
+		return 1;
+	}
+	FILE *output = fopen(outputPath, "wb");
+	FILE *csv = csvPath != nullptr ? fopen(csvPath, "w") : nullptr;
+	if (output == nullptr || (csvPath != nullptr && csv == nullptr))
+	{
+		fprintf(stderr, "Failed to open the output files.\n");
+		return 1;
+	}
+
+	// Write the headers
+	fwrite(CONVERTER_MAGIC, 1, strlen(CONVERTER_MAGIC), output);
+	writeValue(output, SBMS_FIELD_COUNT + 1, 4);
+	writeColumnHeader(output, CONVERTER_OFFSET_COLUMN, CONVERTER_OFFSET_WIDTH, SBMS_ENCODING_UNSIGNED, "captureOffset", 1, 0, "B");
+	if (csv != nullptr)
+	{
+		fputs("captureOffset", csv);
+	}
+	for (size_t i = 0; i < SBMS_FIELD_COUNT; i++)
+	{
+		const SmartBmsFieldDescriptor &descriptor = SmartBmsFields::getDescriptor(static_cast<SmartBmsField>(i));
+		writeColumnHeader(output, descriptor.field, getColumnWidth(descriptor.field), descriptor.encoding, descriptor.name,
+						  descriptor.fixedScale, descriptor.fixedOffset, descriptor.fixedUnit);
+		if (csv != nullptr)
+		{
+			fprintf(csv, descriptor.fixedUnit[0] != '\0' ? ",%s[%s]" : ",%s", descriptor.name, descriptor.fixedUnit);
+		}
+	}
+	if (csv != nullptr)
+	{
+		fputc('\n', csv);
+	}
+
+	// Decode the chunks in parallel
+	ConverterState state;
+	state.data = capture.getData();
+	state.size = capture.getSize();
+	state.chunkSize = chunkSize;
+	state.chunkCount = (state.size + chunkSize - 1) / chunkSize;
+	state.maxInFlight = threadCount * 2;
+	state.csv = csv != nullptr;
+	state.nextChunk = 0;
+	state.chunks.resize(state.chunkCount);
+	state.writtenCount = 0;
+
+	const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	std::vector<std::thread> workers;
+	for (size_t i = 0; i < threadCount; i++)
+	{
+		workers.push_back(std::thread(runWorker, &state));
+	}
+
+	// Write the row groups in the order of the capture
+	size_t frameCount = 0;
+	for (size_t i = 0; i < state.chunkCount; i++)
+	{
+		std::unique_ptr<ConverterChunk> chunk;
+		{
+			std::unique_lock<std::mutex> lock(state.mutex);
+			state.chunkDone.wait(lock, [&state, i]()
+								 { return state.chunks[i] != nullptr; });
+			chunk = std::move(state.chunks[i]);
+		}
+
+		if (chunk->rowCount > 0)
+		{
+			writeValue(output, chunk->rowCount, 4);
+			for (size_t j = 0; j <= SBMS_FIELD_COUNT; j++)
+			{
+				fwrite(chunk->columns[j].data(), 1, chunk->columns[j].size(), output);
+			}
+		}
+		if (csv != nullptr)
+		{
+			fwrite(chunk->csv.data(), 1, chunk->csv.size(), csv);
+		}
+		frameCount += chunk->rowCount;
+		chunk.reset();
+
+		std::lock_guard<std::mutex> lock(state.mutex);
+		state.writtenCount++;
+		state.chunkWritten.notify_all();
+	}
+	writeValue(output, 0, 4);
+
+	for (size_t i = 0; i < workers.size(); i++)
+	{
+		workers[i].join();
+	}
+	const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	// Check if everything was written
+	const bool writeFailed = ferror(output) != 0 || fclose(output) != 0 || (csv != nullptr && (ferror(csv) != 0 || fclose(csv) != 0));
+	if (writeFailed)
+	{
+		fprintf(stderr, "Failed to write the output files.\n");
+		return 1;
+	}
+
+	printf("{\"bytes\":%zu,\"frames\":%zu,\"chunks\":%zu,\"threads\":%zu,\"seconds\":%.6f,\"megabytes_per_second\":%.1f}\n",
+		   state.size, frameCount, state.chunkCount, threadCount, seconds, state.size / seconds / 1e6);
+	return 0;
+}
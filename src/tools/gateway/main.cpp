@@ -0,0 +1,280 @@
+#include <fcntl.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "bms/SmartBmsFrameView.h"
+#include "bms/SmartBmsSerializer.h"
+#include "host/SmartBmsFrameGenerator.h"
+#include "host/SmartBmsSharedRing.h"
+#include "host/SmartBmsTtyReader.h"
+
+// Name of the shared memory ring, can be overridden by the arguments
+#define GATEWAY_RING_NAME "/smartbms"
+
+// Consumers have no way to be woken up by the producer, a frame arrives every second, so polling is cheap enough
+#define GATEWAY_CONSUMER_POLL_INTERVAL_MS 20
+
+// Self test with a pseudo terminal standing in for the BMS
+#define GATEWAY_SELFTEST_RING_NAME "/smartbms-selftest"
+#define GATEWAY_SELFTEST_FRAME_COUNT 2000
+#define GATEWAY_SELFTEST_CONSUMER_COUNT 3
+#define GATEWAY_SELFTEST_SEED 1
+#define GATEWAY_SELFTEST_TIMEOUT_MS 30000
+
+// Reader of the running gateway, so the signal handler can stop it
+static SmartBmsTtyReader *runningTtyReader = nullptr;
+static volatile sig_atomic_t consumerStopped = 0;
+
+/**
+ * @brief Stop the gateway or the consumer on SIGINT or SIGTERM.
+ * @param signalNumber number of the signal
+ */
+static void onSignal(int signalNumber)
+{
+	(void)signalNumber;
+	consumerStopped = 1;
+	if (runningTtyReader != nullptr)
+	{
+		runningTtyReader->stop();
+	}
+}
+
+/**
+ * @brief Called for every frame of the port, publishes it into the ring.
+ * @param frameView completed frame
+ * @param context ring to publish to
+ */
+static void onFrame(const SmartBmsFrameView *frameView, void *context)
+{
+	static_cast<SmartBmsSharedRing *>(context)->publish(*frameView);
+}
+
+/**
+ * @brief Read the port and publish every frame until the gateway is stopped.
+ * @param path path of the port
+ * @param ringName name of the ring
+ * @param slotCount number of frames the ring holds
+ * @return exit code
+ */
+static int runGateway(const char *path, const char *ringName, const uint32_t slotCount)
+{
+	SmartBmsSharedRing ring;
+	if (!ring.create(ringName, slotCount))
+	{
+		fprintf(stderr, "Failed to create the ring %s.\n", ringName);
+		return 1;
+	}
+
+	SmartBmsTtyReader ttyReader;
+	if (!ttyReader.open(path))
+	{
+		fprintf(stderr, "Failed to open the port %s.\n", path);
+		SmartBmsSharedRing::remove(ringName);
+		return 1;
+	}
+	ttyReader.setFrameCallback(onFrame, &ring);
+
+	runningTtyReader = &ttyReader;
+	signal(SIGINT, onSignal);
+	signal(SIGTERM, onSignal);
+	const bool stopped = ttyReader.run();
+	runningTtyReader = nullptr;
+
+	SmartBmsReader *smartBmsReader = ttyReader.getReader();
+	printf("{\"stopped\":%s,\"bytes\":%llu,\"frames\":%u,\"skipped_bytes\":%u,\"missed_cycles\":%u,\"cycle_period_us\":%u,\"jitter_us\":%u}\n",
+		   stopped ? "true" : "false", static_cast<unsigned long long>(ttyReader.getReceivedByteCount()), ttyReader.getFrameCount(),
+		   smartBmsReader->getSkippedByteCount(), smartBmsReader->getMissedCycleCount(), smartBmsReader->getCyclePeriod(), smartBmsReader->getJitter());
+	SmartBmsSharedRing::remove(ringName);
+	return stopped ? 0 : 1;
+}
+
+/**
+ * @brief Follow the ring and print every frame as JSON until the consumer is stopped.
+ * @param ringName name of the ring
+ * @return exit code
+ */
+static int runConsumer(const char *ringName)
+{
+	SmartBmsSharedRing ring;
+	if (!ring.open(ringName))
+	{
+		fprintf(stderr, "Failed to open the ring %s.\n", ringName);
+		return 1;
+	}
+
+	signal(SIGINT, onSignal);
+	signal(SIGTERM, onSignal);
+	char buffer[SMART_BMS_SERIALIZER_BUFFER_SIZE];
+	SmartBmsFrameView frameView;
+	while (!consumerStopped)
+	{
+		while (ring.read(&frameView))
+		{
+			SmartBmsSerializer::toJson(frameView, buffer, sizeof(buffer));
+			printf("%s\n", buffer);
+		}
+		fflush(stdout);
+		std::this_thread::sleep_for(std::chrono::milliseconds(GATEWAY_CONSUMER_POLL_INTERVAL_MS));
+	}
+	fprintf(stderr, "Lost %u frames.\n", ring.getLostFrameCount());
+	return 0;
+}
+
+/**
+ * @brief Consumer process of the self test. Reads the frames in place and compares them with the generated frames.
+ * @param ready pipe that is written as soon as the ring is open
+ * @return number of matching frames, 0 on failure
+ */
+static int runSelfTestConsumer(const int ready)
+{
+	SmartBmsSharedRing ring;
+	const bool opened = ring.open(GATEWAY_SELFTEST_RING_NAME);
+	const uint8_t status = opened ? 1 : 0;
+	if (write(ready, &status, 1) != 1 || !opened)
+	{
+		return 0;
+	}
+
+	SmartBmsFrameGenerator generator(GATEWAY_SELFTEST_SEED);
+	uint8_t expected[SMART_BMS_FRAME_SIZE];
+	int matchCount = 0;
+	const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	while (matchCount < GATEWAY_SELFTEST_FRAME_COUNT &&
+		   std::chrono::steady_clock::now() - start < std::chrono::milliseconds(GATEWAY_SELFTEST_TIMEOUT_MS))
+	{
+		const uint8_t *frame = ring.peek();
+		if (frame == nullptr)
+		{
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+			continue;
+		}
+
+		generator.generate(expected);
+		const bool match = memcmp(frame, expected, SMART_BMS_FRAME_SIZE) == 0;
+		if (!ring.advance() || !match)
+		{
+			return 0;
+		}
+		matchCount++;
+	}
+	return matchCount;
+}
+
+/**
+ * @brief Run the gateway against a pseudo terminal that stands in for the BMS, while several processes consume the ring.
+ * @return exit code
+ */
+static int runSelfTest()
+{
+	SmartBmsSharedRing ring;
+	if (!ring.create(GATEWAY_SELFTEST_RING_NAME))
+	{
+		fprintf(stderr, "Failed to create the ring.\n");
+		return 1;
+	}
+
+	// The consumers must have opened the ring before the first frame is published
+	std::vector<pid_t> consumers;
+	int ready[2];
+	if (pipe(ready) != 0)
+	{
+		return 1;
+	}
+	for (int i = 0; i < GATEWAY_SELFTEST_CONSUMER_COUNT; i++)
+	{
+		const pid_t pid = fork();
+		if (pid == 0)
+		{
+			ring.close();
+			const int matchCount = runSelfTestConsumer(ready[1]);
+			_exit(matchCount == GATEWAY_SELFTEST_FRAME_COUNT ? 0 : 1);
+		}
+		else if (pid > 0)
+		{
+			consumers.push_back(pid);
+		}
+	}
+	uint8_t status = 0;
+	size_t readyCount = 0;
+	while (readyCount < consumers.size() && read(ready[0], &status, 1) == 1 && status == 1)
+	{
+		readyCount++;
+	}
+
+	// The master side of the pseudo terminal plays the BMS, the gateway opens the slave like a real port
+	const int master = posix_openpt(O_RDWR | O_NOCTTY);
+	SmartBmsTtyReader ttyReader;
+	if (master < 0 || grantpt(master) != 0 || unlockpt(master) != 0 || !ttyReader.open(ptsname(master)))
+	{
+		fprintf(stderr, "Failed to open a pseudo terminal.\n");
+		return 1;
+	}
+	ttyReader.setFrameCallback(onFrame, &ring);
+
+	// Garbage in front of the first frame forces the reader to find the alignment
+	std::thread bms([master]() {
+		SmartBmsFrameGenerator generator(GATEWAY_SELFTEST_SEED);
+		uint8_t frame[SMART_BMS_FRAME_SIZE];
+		const uint8_t garbage[] = {0x13, 0x37, 0x00, 0xff, 0x42};
+		bool failed = write(master, garbage, sizeof(garbage)) != sizeof(garbage);
+		for (int i = 0; i < GATEWAY_SELFTEST_FRAME_COUNT && !failed; i++)
+		{
+			generator.generate(frame);
+			failed = write(master, frame, sizeof(frame)) != sizeof(frame);
+		}
+	});
+
+	const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	while (ttyReader.getFrameCount() < GATEWAY_SELFTEST_FRAME_COUNT &&
+		   std::chrono::steady_clock::now() - start < std::chrono::milliseconds(GATEWAY_SELFTEST_TIMEOUT_MS) && ttyReader.poll(100) >= 0)
+	{
+	}
+	const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	bms.join();
+	close(master);
+
+	size_t passedCount = 0;
+	for (size_t i = 0; i < consumers.size(); i++)
+	{
+		int exitStatus = 0;
+		waitpid(consumers[i], &exitStatus, 0);
+		passedCount += WIFEXITED(exitStatus) && WEXITSTATUS(exitStatus) == 0 ? 1 : 0;
+	}
+	SmartBmsSharedRing::remove(GATEWAY_SELFTEST_RING_NAME);
+
+	const bool passed = ttyReader.getFrameCount() == GATEWAY_SELFTEST_FRAME_COUNT && ring.getWriteIndex() == GATEWAY_SELFTEST_FRAME_COUNT &&
+						readyCount == GATEWAY_SELFTEST_CONSUMER_COUNT && passedCount == GATEWAY_SELFTEST_CONSUMER_COUNT;
+	printf("{\"passed\":%s,\"frames\":%u,\"published\":%u,\"skipped_bytes\":%u,\"consumers\":%zu,\"passed_consumers\":%zu,\"seconds\":%.3f}\n",
+		   passed ? "true" : "false", ttyReader.getFrameCount(), ring.getWriteIndex(), ttyReader.getReader()->getSkippedByteCount(),
+		   consumers.size(), passedCount, seconds);
+	return passed ? 0 : 1;
+}
+
+int main(int argc, char **argv)
+{
+	if (argc == 2 && strcmp(argv[1], "--selftest") == 0)
+	{
+		return runSelfTest();
+	}
+	else if (argc >= 2 && argc <= 3 && strcmp(argv[1], "--consume") == 0)
+	{
+		return runConsumer(argc > 2 ? argv[2] : GATEWAY_RING_NAME);
+	}
+	else if (argc >= 2 && argc <= 4 && argv[1][0] != '-')
+	{
+		const uint32_t slotCount = argc > 3 ? strtoul(argv[3], nullptr, 10) : SMART_BMS_SHARED_RING_DEFAULT_SLOT_COUNT;
+		return runGateway(argv[1], argc > 2 ? argv[2] : GATEWAY_RING_NAME, slotCount);
+	}
+
+	fprintf(stderr, "Usage: %s <port> [ring name] [slot count]\n", argv[0]);
+	fprintf(stderr, "       %s --consume [ring name]\n", argv[0]);
+	fprintf(stderr, "       %s --selftest\n", argv[0]);
+	return 1;
+}
@@ -0,0 +1,145 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+
+#include "bms/SmartBmsLinkDetector.h"
+#include "host/SmartBmsCaptureReplay.h"
+#include "host/SmartBmsFrameGenerator.h"
+
+// Synthetic streams, every offset and polarity is tried with several seeds
+#define LINKDETECT_SEED_COUNT 20
+#define LINKDETECT_FRAME_COUNT 4
+#define LINKDETECT_CHUNK_SIZE 16
+
+// Amount of random bytes that is searched for a lock that should not happen
+#define LINKDETECT_NOISE_SIZE (16 * 1024 * 1024)
+
+/**
+ * @brief Feed a stream in small chunks, like a UART would deliver it.
+ * @param detector detector to feed
+ * @param data bytes of the stream
+ * @param length number of bytes
+ * @return number of bytes used until the link locked
+ */
+static size_t feedStream(SmartBmsLinkDetector *detector, const uint8_t *data, const size_t length)
+{
+	size_t offset = 0;
+	while (offset < length)
+	{
+		size_t consumed = 0;
+		const size_t chunkLength = length - offset < LINKDETECT_CHUNK_SIZE ? length - offset : LINKDETECT_CHUNK_SIZE;
+		const SmartBmsLinkState state = detector->feed(&data[offset], chunkLength, &consumed);
+		offset += consumed;
+		if (state == SmartBmsLinkState::SBMS_LINK_LOCKED)
+		{
+			break;
+		}
+	}
+	return offset;
+}
+
+/**
+ * @brief Detect the link settings of a capture file.
+ * @param path path of the capture
+ * @return exit code
+ */
+static int detectCapture(const char *path)
+{
+	SmartBmsCaptureReplay replay;
+	if (!replay.open(path))
+	{
+		fprintf(stderr, "Failed to open capture %s.\n", path);
+		return 1;
+	}
+
+	SmartBmsLinkDetector detector;
+	const size_t usedLength = feedStream(&detector, replay.getData(), replay.getSize());
+	const bool locked = detector.getState() == SmartBmsLinkState::SBMS_LINK_LOCKED;
+	printf("{\"locked\":%s,\"inverted\":%s,\"alignment\":%u,\"bytes\":%zu,\"rejected_frames\":%u}\n",
+		   locked ? "true" : "false", detector.getPolarity() == SmartBmsLinkPolarity::SBMS_LINK_INVERTED ? "true" : "false",
+		   detector.getAlignment(), usedLength, detector.getRejectedFrameCount());
+	return locked ? 0 : 1;
+}
+
+/**
+ * @brief Try every offset and polarity with generated frames and search random bytes for false locks.
+ * @return exit code
+ */
+static int detectSynthetic()
+{
+	size_t trialCount = 0;
+	size_t lockCount = 0;
+	size_t wrongCount = 0;
+	size_t maxFrames = 0;
+	std::vector<uint8_t> stream;
+	for (uint32_t seed = 1; seed <= LINKDETECT_SEED_COUNT; seed++)
+	{
+		for (uint8_t polarity = 0; polarity < SBMS_LINK_POLARITY_COUNT; polarity++)
+		{
+			for (uint8_t offset = 0; offset < SMART_BMS_FRAME_SIZE; offset++)
+			{
+				// The sample starts somewhere in a frame, so the first bytes are the tail of a frame that is cut off
+				SmartBmsFrameGenerator generator(seed * SMART_BMS_FRAME_SIZE + offset, 1 + seed % 24);
+				stream.assign(offset + LINKDETECT_FRAME_COUNT * SMART_BMS_FRAME_SIZE, 0);
+				uint8_t frame[SMART_BMS_FRAME_SIZE];
+				generator.generate(frame);
+				for (uint8_t i = 0; i < offset; i++)
+				{
+					stream[i] = frame[SMART_BMS_FRAME_SIZE - offset + i];
+				}
+				generator.generate(&stream[offset], LINKDETECT_FRAME_COUNT);
+				for (size_t i = 0; polarity == SmartBmsLinkPolarity::SBMS_LINK_INVERTED && i < stream.size(); i++)
+				{
+					stream[i] = ~stream[i];
+				}
+
+				SmartBmsLinkDetector detector;
+				const size_t usedLength = feedStream(&detector, stream.data(), stream.size());
+				trialCount++;
+				if (detector.getState() != SmartBmsLinkState::SBMS_LINK_LOCKED)
+				{
+					continue;
+				}
+				lockCount++;
+				wrongCount += detector.getPolarity() != polarity || detector.getAlignment() != offset ? 1 : 0;
+				const size_t frames = (usedLength + SMART_BMS_FRAME_SIZE - 1 - offset) / SMART_BMS_FRAME_SIZE;
+				maxFrames = frames > maxFrames ? frames : maxFrames;
+			}
+		}
+	}
+
+	// Random bytes must never lock, the checksum alone would match one window in 256
+	SmartBmsFrameGenerator noise(0xC0FFEE);
+	std::vector<uint8_t> noiseStream(LINKDETECT_NOISE_SIZE);
+	for (size_t i = 0; i < noiseStream.size(); i++)
+	{
+		noiseStream[i] = noise.nextRandom() >> 24;
+	}
+	SmartBmsLinkDetector detector;
+	size_t falseLockCount = 0;
+	for (size_t offset = 0; offset < noiseStream.size();)
+	{
+		size_t consumed = 0;
+		if (detector.feed(&noiseStream[offset], noiseStream.size() - offset, &consumed) == SmartBmsLinkState::SBMS_LINK_LOCKED)
+		{
+			falseLockCount++;
+			detector.reset();
+		}
+		offset += consumed;
+	}
+
+	const bool passed = lockCount == trialCount && wrongCount == 0 && falseLockCount == 0;
+	printf("{\"passed\":%s,\"trials\":%zu,\"locks\":%zu,\"wrong_locks\":%zu,\"max_frames_to_lock\":%zu,\"noise_bytes\":%zu,\"false_locks\":%zu,\"rejected_noise_frames\":%u}\n",
+		   passed ? "true" : "false", trialCount, lockCount, wrongCount, maxFrames, noiseStream.size(), falseLockCount, detector.getRejectedFrameCount());
+	return passed ? 0 : 1;
+}
+
+int main(int argc, char **argv)
+{
+	if (argc > 2)
+	{
+		fprintf(stderr, "Usage: %s [capture file]\n", argv[0]);
+		return 1;
+	}
+	return argc == 2 ? detectCapture(argv[1]) : detectSynthetic();
+}
@@ -0,0 +1,88 @@
+/**
+ * @file main.cpp
+ * @author TheRealKasumi
+ * @brief Prints a BMS log that was copied from the flash as CSV, both files of the log are needed.
+ * @copyright Copyright (c) 2024 TheRealKasumi
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "bms/SmartBmsData.h"
+#include "bms/SmartBmsLog.h"
+#include "bms/SmartBmsLogStorage.h"
+#include "bms/SmartBmsSerializer.h"
+
+/**
+ * @brief Print a record of the log as a CSV line with the timestamp in front.
+ * @param smartBmsData data of the record
+ * @param timestamp time of the record in ms
+ * @param context not used
+ * @return true to continue with the next record
+ */
+static bool onRecord(const SmartBmsData *smartBmsData, const uint32_t timestamp, void *context)
+{
+	(void)context;
+	static char buffer[SMART_BMS_SERIALIZER_BUFFER_SIZE];
+	if (SmartBmsSerializer::toCsv(*smartBmsData, buffer, sizeof(buffer)) > 0)
+	{
+		printf("%u,%s\n", timestamp, buffer);
+	}
+	return true;
+}
+
+int main(int argc, char **argv)
+{
+	if (argc < 3 || argc > 4)
+	{
+		fprintf(stderr, "Usage: %s <first log file> <second log file> [from timestamp]\n", argv[0]);
+		return 1;
+	}
+
+	SmartBmsFileLogStorage storages[2];
+	for (size_t i = 0; i < 2; i++)
+	{
+		if (!storages[i].open(argv[i + 1]))
+		{
+			fprintf(stderr, "Failed to open log %s.\n", argv[i + 1]);
+			return 1;
+		}
+	}
+
+	// Check the blocks, a damaged tail is cut off like it would be on the device
+	SmartBmsLog log(&storages[0], &storages[1]);
+	if (log.begin() != SmartBmsError::SBMS_OK)
+	{
+		fprintf(stderr, "Failed to check log %s.\n", argv[1]);
+		return 1;
+	}
+	if (log.getTruncatedByteCount() > 0)
+	{
+		fprintf(stderr, "Removed %zu bytes of a damaged block at the end of the log.\n", log.getTruncatedByteCount());
+	}
+
+	char header[SMART_BMS_SERIALIZER_BUFFER_SIZE];
+	SmartBmsSerializer::toCsvHeader(header, sizeof(header));
+	printf("timestamp,%s\n", header);
+	const SmartBmsError err = argc > 3 ? log.forEach(strtoul(argv[3], nullptr, 10), onRecord, nullptr) : log.forEach(onRecord, nullptr);
+	if (err != SmartBmsError::SBMS_OK)
+	{
+		fprintf(stderr, "Failed to read log %s.\n", argv[1]);
+		return 1;
+	}
+	fprintf(stderr, "%u records in %u blocks.\n", log.getRecordCount(), log.getBlockCount());
+	return 0;
+}
@@ -0,0 +1,85 @@
+/**
+ * @file main.cpp
+ * @author TheRealKasumi
+ * @brief Replays a raw UART capture through the reader and prints a summary.
+ * @copyright Copyright (c) 2024 TheRealKasumi
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#include <stdio.h>
+#include <string.h>
+#include <chrono>
+
+#include "bms/SmartBmsData.h"
+#include "bms/SmartBmsFrameView.h"
+#include "bms/SmartBmsReader.h"
+#include "host/SmartBmsCaptureReplay.h"
+
+/**
+ * @brief Summary of the decoded frames.
+ */
+struct ReplaySummary
+{
+	size_t frameCount;
+	uint8_t minSoc;
+	uint8_t maxSoc;
+};
+
+/**
+ * @brief Called for every decoded frame.
+ * @param frameView decoded frame
+ * @param context summary to update
+ */
+static void onFrame(const SmartBmsFrameView *frameView, void *context)
+{
+	ReplaySummary *summary = static_cast<ReplaySummary *>(context);
+	const uint8_t soc = frameView->getPackSoc();
+	summary->minSoc = soc < summary->minSoc ? soc : summary->minSoc;
+	summary->maxSoc = soc > summary->maxSoc ? soc : summary->maxSoc;
+	summary->frameCount++;
+}
+
+int main(int argc, char **argv)
+{
+	if (argc < 2 || (argc > 2 && strcmp(argv[2], "--paced") != 0))
+	{
+		fprintf(stderr, "Usage: %s <capture file> [--paced]\n", argv[0]);
+		return 1;
+	}
+
+	SmartBmsCaptureReplay replay;
+	if (!replay.open(argv[1]))
+	{
+		fprintf(stderr, "Failed to open capture %s.\n", argv[1]);
+		return 1;
+	}
+	if (argc > 2)
+	{
+		replay.setPacing(SmartBmsReplayPacing::SBMS_REPLAY_ORIGINAL_PACING);
+	}
+
+	// Decode the whole capture, only the SOC is read from the frames
+	ReplaySummary summary = {0, UINT8_MAX, 0};
+	SmartBmsReader smartBmsReader;
+	smartBmsReader.setFrameCallback(onFrame, &summary);
+	const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	replay.replay(&smartBmsReader);
+	const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	printf("{\"bytes\":%zu,\"frames\":%zu,\"skipped_bytes\":%u,\"min_soc\":%u,\"max_soc\":%u,\"seconds\":%.6f,\"megabytes_per_second\":%.1f}\n",
+		   replay.getSize(), summary.frameCount, smartBmsReader.getSkippedByteCount(),
+		   summary.frameCount > 0 ? summary.minSoc : 0, summary.maxSoc, seconds, replay.getSize() / seconds / 1e6);
+	return 0;
+}
@@ -0,0 +1,149 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+#include "bms/SmartBmsScheduler.h"
+#include "host/SmartBmsFrameGenerator.h"
+
+// Synthetic timeline, the BMS clock is a little slow, the arrivals jitter, some frames are missing and the BMS restarts halfway
+#define SCHEDULER_FRAME_COUNT 3000
+#define SCHEDULER_FRAME_PERIOD_US 1000040
+#define SCHEDULER_JITTER_US 1500
+#define SCHEDULER_MISSING_INTERVAL 97
+#define SCHEDULER_RESTART_SHIFT_US 370000
+#define SCHEDULER_SEED 0x5C4E
+
+// The application polls in steps of one ms while it is awake
+#define SCHEDULER_POLL_INTERVAL_US 1000
+
+// Simulated time in µs, shared by the timeline and the scheduler
+static uint32_t simulatedTime = 0;
+
+/**
+ * @brief Clock of the simulation.
+ * @return simulated time in µs
+ */
+static const uint32_t getSimulatedTime()
+{
+	return simulatedTime;
+}
+
+/**
+ * @brief Generate the arrival times of a synthetic timeline.
+ * @param frameCount number of cycles
+ * @param arrivals vector that receives the start time of every frame in µs
+ */
+static void generateTimeline(const size_t frameCount, std::vector<uint32_t> *arrivals)
+{
+	SmartBmsFrameGenerator random(SCHEDULER_SEED);
+	uint32_t cycleStart = SCHEDULER_FRAME_PERIOD_US;
+	for (size_t i = 0; i < frameCount; i++)
+	{
+		cycleStart += SCHEDULER_FRAME_PERIOD_US + (i == frameCount / 2 ? SCHEDULER_RESTART_SHIFT_US : 0);
+		if (i % SCHEDULER_MISSING_INTERVAL != SCHEDULER_MISSING_INTERVAL - 1)
+		{
+			arrivals->push_back(cycleStart + random.nextRandom() % (2 * SCHEDULER_JITTER_US) - SCHEDULER_JITTER_US);
+		}
+	}
+}
+
+/**
+ * @brief Read a recorded timeline, one arrival time in µs per line, lines starting with # are ignored.
+ * @param path path of the timeline
+ * @param arrivals vector that receives the start time of every frame in µs
+ * @return true when the timeline was read
+ */
+static bool readTimeline(const char *path, std::vector<uint32_t> *arrivals)
+{
+	FILE *file = fopen(path, "r");
+	if (file == nullptr)
+	{
+		return false;
+	}
+	char line[64];
+	while (fgets(line, sizeof(line), file) != nullptr)
+	{
+		if (line[0] != '#' && line[0] != '\n')
+		{
+			arrivals->push_back(strtoul(line, nullptr, 10));
+		}
+	}
+	fclose(file);
+	return !arrivals->empty();
+}
+
+int main(int argc, char **argv)
+{
+	std::vector<uint32_t> arrivals;
+	if (argc >= 2 && strcmp(argv[1], "--generate") == 0)
+	{
+		generateTimeline(argc > 2 ? strtoul(argv[2], nullptr, 10) : SCHEDULER_FRAME_COUNT, &arrivals);
+		for (size_t i = 0; i < arrivals.size(); i++)
+		{
+			printf("%u\n", arrivals[i]);
+		}
+		return 0;
+	}
+	else if (argc > 2 || (argc == 2 && !readTimeline(argv[1], &arrivals)))
+	{
+		fprintf(stderr, "Usage: %s [timeline file]\n", argv[0]);
+		fprintf(stderr, "       %s --generate [frame count]\n", argv[0]);
+		return 1;
+	}
+	else if (argc == 1)
+	{
+		generateTimeline(SCHEDULER_FRAME_COUNT, &arrivals);
+	}
+
+	// The application sleeps whenever the scheduler allows it, a frame that starts while it sleeps is lost
+	// After the restart the frames arrive at a new phase, so some are lost until the scheduler drops the lock
+	SmartBmsScheduler scheduler(getSimulatedTime);
+	simulatedTime = arrivals[0] - SCHEDULER_POLL_INTERVAL_US;
+	const uint32_t startTime = simulatedTime;
+	uint64_t sleepTime = 0;
+	uint64_t wakeLeadSum = 0;
+	uint32_t wakeTime = startTime;
+	size_t next = 0;
+	size_t receivedCount = 0;
+	size_t lostCount = 0;
+	size_t sleepCount = 0;
+	while (next < arrivals.size())
+	{
+		const uint32_t sleep = scheduler.getSleepTime();
+		if (sleep > 0)
+		{
+			const uint32_t end = simulatedTime + sleep;
+			while (next < arrivals.size() && static_cast<int32_t>(arrivals[next] - end) < 0)
+			{
+				lostCount++;
+				next++;
+			}
+			simulatedTime = end;
+			wakeTime = end;
+			sleepTime += sleep;
+			sleepCount++;
+		}
+		else
+		{
+			simulatedTime += SCHEDULER_POLL_INTERVAL_US;
+		}
+
+		// A frame is complete once its last byte arrived, the application was awake for all of it
+		while (next < arrivals.size() && static_cast<int32_t>(simulatedTime - arrivals[next] - SMART_BMS_SCHEDULER_FRAME_DURATION_US) >= 0)
+		{
+			scheduler.onFrame(arrivals[next]);
+			wakeLeadSum += arrivals[next] - wakeTime;
+			receivedCount++;
+			next++;
+		}
+	}
+
+	const uint32_t totalTime = simulatedTime - startTime;
+	printf("{\"frames\":%zu,\"received\":%zu,\"lost\":%zu,\"sleeps\":%zu,\"sleep_ratio\":%.4f,\"mean_wake_lead_us\":%.0f,"
+		   "\"cycle_period_us\":%u,\"jitter_us\":%u,\"margin_us\":%u,\"missed_cycles\":%u,\"relearns\":%u}\n",
+		   arrivals.size(), receivedCount, lostCount, sleepCount, static_cast<double>(sleepTime) / totalTime,
+		   receivedCount > 0 ? static_cast<double>(wakeLeadSum) / receivedCount : 0.0, scheduler.getCyclePeriod(), scheduler.getJitter(),
+		   scheduler.getMargin(), scheduler.getMissedCycleCount(), scheduler.getRelearnCount());
+	return 0;
+}
@@ -0,0 +1,173 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+#include "bms/SmartBmsFrameView.h"
+#include "bms/SmartBmsReader.h"
+#include "host/MemoryStream.h"
+#include "host/SmartBmsFrameGenerator.h"
+#include "host/SmartBmsNoiseInjector.h"
+
+// Default run, can be overridden by the arguments
+#define STRESS_FRAME_COUNT 100000
+#define STRESS_SEED 0x5EED
+
+// Noise profiles, the rates are given per million bytes
+static const SmartBmsNoiseProfile STRESS_PROFILES[] = {
+	{"clean", 0, 0, 0, 0, 0},
+	{"bit_flip", 500, 0, 0, 0, 0},
+	{"drop", 0, 500, 0, 0, 0},
+	{"duplicate", 0, 0, 500, 0, 0},
+	{"burst", 0, 0, 0, 50, 32},
+	{"mixed", 200, 200, 200, 20, 32}};
+
+/**
+ * @brief Result of one noise profile.
+ */
+struct StressResult
+{
+	size_t faultedFrameCount;
+	size_t deliveredFrameCount;
+	size_t lostFrameCount;
+	size_t lostIntactFrameCount;
+	size_t falseAcceptCount;
+	size_t episodeCount;
+	size_t resyncFrameSum;
+	size_t resyncFrameMax;
+	size_t resyncByteSum;
+	size_t resyncByteMax;
+};
+
+/**
+ * @brief Run the reader over a corrupted stream and compare the frames it accepts with the original frames.
+ * @param profile noise profile
+ * @param frames original frames
+ * @param frameCount number of frames
+ * @param seed seed of the noise
+ * @return exit code
+ */
+static int runProfile(const SmartBmsNoiseProfile &profile, const uint8_t *frames, const size_t frameCount, const uint32_t seed)
+{
+	// Corrupt the stream frame by frame, so every frame knows where it ended up and if it was hit
+	SmartBmsNoiseInjector injector(seed, profile);
+	std::vector<uint8_t> stream;
+	stream.reserve(frameCount * SMART_BMS_FRAME_SIZE * 2);
+	std::vector<size_t> frameStarts(frameCount);
+	std::vector<size_t> frameEnds(frameCount);
+	std::vector<uint32_t> frameFaults(frameCount);
+	for (size_t i = 0; i < frameCount; i++)
+	{
+		frameStarts[i] = stream.size();
+		frameFaults[i] = injector.inject(&frames[i * SMART_BMS_FRAME_SIZE], SMART_BMS_FRAME_SIZE, &stream);
+		frameEnds[i] = stream.size();
+	}
+
+	// Decode through a stream like on the device, the reader never reads beyond a frame, so the position is the end of the accepted frame
+	MemoryStream memoryStream(stream.data(), stream.size());
+	SmartBmsReader smartBmsReader(&memoryStream);
+	std::vector<size_t> acceptedEnds;
+	std::vector<SmartBmsFrameView> acceptedFrames;
+	acceptedEnds.reserve(frameCount);
+	acceptedFrames.reserve(frameCount);
+	SmartBmsFrameView frameView;
+	const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	while (memoryStream.available() > 0)
+	{
+		if (smartBmsReader.decodeBmsData(&frameView) == SmartBmsError::SBMS_OK)
+		{
+			acceptedEnds.push_back(memoryStream.getPosition());
+			acceptedFrames.push_back(frameView);
+		}
+	}
+	const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	// An accepted frame is only correct when it ends within the bytes of an original frame and has the same content
+	// A duplicated checksum byte leaves the frame intact, so the frame can end one byte before the original frame
+	StressResult result = {};
+	std::vector<bool> delivered(frameCount, false);
+	for (size_t i = 0; i < acceptedEnds.size(); i++)
+	{
+		const std::vector<size_t>::iterator end = std::lower_bound(frameEnds.begin(), frameEnds.end(), acceptedEnds[i]);
+		const size_t index = end - frameEnds.begin();
+		if (end != frameEnds.end() && !delivered[index] &&
+			memcmp(acceptedFrames[i].getFrame(), &frames[index * SMART_BMS_FRAME_SIZE], SMART_BMS_FRAME_SIZE) == 0)
+		{
+			delivered[index] = true;
+			result.deliveredFrameCount++;
+		}
+		else
+		{
+			result.falseAcceptCount++;
+		}
+	}
+
+	// A fault episode is a run of hit frames, the resync is measured from its end to the next delivered frame
+	for (size_t i = 0; i < frameCount; i++)
+	{
+		result.faultedFrameCount += frameFaults[i] > 0 ? 1 : 0;
+		result.lostFrameCount += delivered[i] ? 0 : 1;
+		result.lostIntactFrameCount += !delivered[i] && frameFaults[i] == 0 ? 1 : 0;
+		if (frameFaults[i] == 0 || (i + 1 < frameCount && frameFaults[i + 1] > 0))
+		{
+			continue;
+		}
+
+		size_t next = i + 1;
+		while (next < frameCount && !delivered[next])
+		{
+			next++;
+		}
+		if (next == frameCount)
+		{
+			continue;
+		}
+		const size_t resyncFrames = next - i - 1;
+		const size_t resyncBytes = frameStarts[next] - frameEnds[i];
+		result.episodeCount++;
+		result.resyncFrameSum += resyncFrames;
+		result.resyncFrameMax = resyncFrames > result.resyncFrameMax ? resyncFrames : result.resyncFrameMax;
+		result.resyncByteSum += resyncBytes;
+		result.resyncByteMax = resyncBytes > result.resyncByteMax ? resyncBytes : result.resyncByteMax;
+	}
+
+	const size_t faultCount = injector.getFaultCount();
+	printf("{\"profile\":\"%s\",\"frames\":%zu,\"bytes\":%zu,\"faults\":%zu,\"bit_flips\":%u,\"drops\":%u,\"duplicates\":%u,\"bursts\":%u,"
+		   "\"faulted_frames\":%zu,\"delivered_frames\":%zu,\"lost_frames\":%zu,\"lost_intact_frames\":%zu,\"lost_frames_per_fault\":%.4f,"
+		   "\"false_accepts\":%zu,\"false_accept_rate\":%.6f,\"resync_frames_mean\":%.4f,\"resync_frames_max\":%zu,"
+		   "\"resync_bytes_mean\":%.2f,\"resync_bytes_max\":%zu,\"skipped_bytes\":%u,\"megabytes_per_second\":%.1f,\"nanoseconds_per_frame\":%.1f}\n",
+		   profile.name, frameCount, stream.size(), faultCount, injector.getBitFlipCount(), injector.getDropCount(), injector.getDuplicateCount(),
+		   injector.getBurstCount(), result.faultedFrameCount, result.deliveredFrameCount, result.lostFrameCount, result.lostIntactFrameCount,
+		   faultCount > 0 ? static_cast<double>(result.lostFrameCount) / faultCount : 0.0, result.falseAcceptCount,
+		   result.faultedFrameCount > 0 ? static_cast<double>(result.falseAcceptCount) / result.faultedFrameCount : 0.0,
+		   result.episodeCount > 0 ? static_cast<double>(result.resyncFrameSum) / result.episodeCount : 0.0, result.resyncFrameMax,
+		   result.episodeCount > 0 ? static_cast<double>(result.resyncByteSum) / result.episodeCount : 0.0, result.resyncByteMax,
+		   smartBmsReader.getSkippedByteCount(), stream.size() / seconds / 1e6, seconds * 1e9 / frameCount);
+
+	// Without noise every frame must arrive, otherwise the reader itself is broken
+	return result.faultedFrameCount == 0 && result.lostFrameCount > 0 ? 1 : 0;
+}
+
+int main(int argc, char **argv)
+{
+	const size_t frameCount = argc > 1 ? strtoul(argv[1], nullptr, 10) : STRESS_FRAME_COUNT;
+	const uint32_t seed = argc > 2 ? strtoul(argv[2], nullptr, 0) : STRESS_SEED;
+	if (argc > 3 || frameCount == 0)
+	{
+		fprintf(stderr, "Usage: %s [frame count] [seed]\n", argv[0]);
+		return 1;
+	}
+
+	// Every profile corrupts the same frames with the same seed, only the throughput differs between runs
+	std::vector<uint8_t> frames(frameCount * SMART_BMS_FRAME_SIZE);
+	SmartBmsFrameGenerator generator(seed);
+	generator.generate(frames.data(), frameCount);
+	int exitCode = 0;
+	for (size_t i = 0; i < sizeof(STRESS_PROFILES) / sizeof(STRESS_PROFILES[0]); i++)
+	{
+		exitCode |= runProfile(STRESS_PROFILES[i], frames.data(), frameCount, seed);
+	}
+	return exitCode;
+}
@@ -0,0 +1,152 @@
+#include <stdint.h>
+#include <vector>
+#include <unity.h>
+
+#include "bms/SmartBmsAggregator.h"
+#include "bms/SmartBmsData.h"
+#include "bms/SmartBmsFrameView.h"
+#include "host/SmartBmsFrameGenerator.h"
+
+/**
+ * @brief Create a sample with a few fields.
+ * @param packVoltage raw pack voltage
+ * @param cellNumber number of the lowest cell
+ * @param alarm state of the max voltage alarm
+ * @param smartBmsData reference to a SmartBmsData object that will receive the data
+ */
+static void makeSample(const int32_t packVoltage, const uint8_t cellNumber, const bool alarm, SmartBmsData *smartBmsData)
+{
+	uint8_t frame[SMART_BMS_FRAME_SIZE] = {};
+	SmartBmsFrameGenerator::encodeRawValue(frame, SBMS_FIELD_PACK_VOLTAGE, packVoltage);
+	SmartBmsFrameGenerator::encodeRawValue(frame, SBMS_FIELD_LOWEST_CELL_VOLTAGE_NUMBER, cellNumber);
+	SmartBmsFrameGenerator::encodeRawValue(frame, SBMS_FIELD_MAX_VOLTAGE_ALARM, alarm ? 1 : 0);
+	SmartBmsFrameGenerator::updateChecksum(frame);
+	SmartBmsFrameView(frame).decode(smartBmsData);
+}
+
+/**
+ * @brief Collect the start times of the closed windows.
+ * @param aggregate aggregate of a closed window
+ * @param context vector of start times
+ */
+static void collectAggregate(const SmartBmsAggregate *aggregate, void *context)
+{
+	static_cast<std::vector<uint32_t> *>(context)->push_back(aggregate->getStartTime());
+}
+
+void setUp()
+{
+}
+
+void tearDown()
+{
+}
+
+void test_windows_start_at_the_first_sample()
+{
+	// Advancing the time before the first sample must not anchor the windows
+	SmartBmsAggregator aggregator;
+	std::vector<uint32_t> startTimes;
+	aggregator.addWindow(1000);
+	aggregator.setAggregateCallback(collectAggregate, &startTimes);
+	aggregator.advance(300);
+	aggregator.advance(700);
+
+	SmartBmsData smartBmsData;
+	makeSample(100, 1, false, &smartBmsData);
+	aggregator.addSample(smartBmsData, 1250);
+	TEST_ASSERT_EQUAL(1250, aggregator.getWindow(0)->getStartTime());
+	aggregator.addSample(smartBmsData, 2249);
+	aggregator.addSample(smartBmsData, 2250);
+	TEST_ASSERT_EQUAL(1, startTimes.size());
+	TEST_ASSERT_EQUAL(1250, startTimes[0]);
+	TEST_ASSERT_EQUAL(2250, aggregator.getWindow(0)->getStartTime());
+}
+
+void test_window_added_later_is_aligned_to_the_first_sample()
+{
+	SmartBmsAggregator aggregator;
+	SmartBmsData smartBmsData;
+	makeSample(100, 1, false, &smartBmsData);
+	aggregator.addSample(smartBmsData, 1250);
+	aggregator.advance(3700);
+
+	// The window contains the latest time and is on the grid of the first sample
+	TEST_ASSERT_TRUE(aggregator.addWindow(1000));
+	TEST_ASSERT_EQUAL(3250, aggregator.getWindow(0)->getStartTime());
+	TEST_ASSERT_TRUE(aggregator.addWindow(60000));
+	TEST_ASSERT_EQUAL(1250, aggregator.getWindow(1)->getStartTime());
+
+	aggregator.addSample(smartBmsData, 3800);
+	TEST_ASSERT_EQUAL(1, aggregator.getWindow(0)->getSampleCount());
+	TEST_ASSERT_EQUAL(3250, aggregator.getWindow(0)->getStartTime());
+}
+
+void test_only_measurements_get_statistics()
+{
+	SmartBmsAggregator aggregator;
+	aggregator.addWindow(1000);
+	const int32_t voltages[] = {100, 300, 200};
+	const uint8_t cellNumbers[] = {3, 1, 5};
+	const bool alarms[] = {false, true, false};
+	SmartBmsData smartBmsData;
+	for (size_t i = 0; i < 3; i++)
+	{
+		makeSample(voltages[i], cellNumbers[i], alarms[i], &smartBmsData);
+		aggregator.addSample(smartBmsData, i * 10);
+	}
+
+	const SmartBmsAggregate *aggregate = aggregator.getWindow(0);
+	TEST_ASSERT_EQUAL(3, aggregate->getSampleCount());
+	TEST_ASSERT_EQUAL(3, aggregate->getCount(SBMS_FIELD_PACK_VOLTAGE));
+	TEST_ASSERT_EQUAL(500, aggregate->getMin(SBMS_FIELD_PACK_VOLTAGE));
+	TEST_ASSERT_EQUAL(1000, aggregate->getMean(SBMS_FIELD_PACK_VOLTAGE));
+	TEST_ASSERT_EQUAL(1500, aggregate->getMax(SBMS_FIELD_PACK_VOLTAGE));
+	TEST_ASSERT_EQUAL(1000, aggregate->getLast(SBMS_FIELD_PACK_VOLTAGE));
+
+	// A cell number has no mean, every statistic is the last value
+	TEST_ASSERT_EQUAL(0, aggregate->getCount(SBMS_FIELD_LOWEST_CELL_VOLTAGE_NUMBER));
+	TEST_ASSERT_TRUE(aggregate->hasField(SBMS_FIELD_LOWEST_CELL_VOLTAGE_NUMBER));
+	TEST_ASSERT_EQUAL(5, aggregate->getMin(SBMS_FIELD_LOWEST_CELL_VOLTAGE_NUMBER));
+	TEST_ASSERT_EQUAL(5, aggregate->getMean(SBMS_FIELD_LOWEST_CELL_VOLTAGE_NUMBER));
+	TEST_ASSERT_EQUAL(5, aggregate->getMax(SBMS_FIELD_LOWEST_CELL_VOLTAGE_NUMBER));
+
+	// A short alarm is kept although the last sample cleared it
+	TEST_ASSERT_EQUAL(0, aggregate->getLast(SBMS_FIELD_MAX_VOLTAGE_ALARM));
+	TEST_ASSERT_TRUE(aggregate->wasActive(SBMS_FIELD_MAX_VOLTAGE_ALARM));
+	TEST_ASSERT_FALSE(aggregate->wasActive(SBMS_FIELD_MIN_VOLTAGE_ALARM));
+}
+
+void test_statistics_of_every_measurement()
+{
+	// Every measurement must land in its own statistics slot
+	SmartBmsAggregator aggregator;
+	aggregator.addWindow(1000);
+	SmartBmsFrameGenerator generator(1);
+	uint8_t frame[SMART_BMS_FRAME_SIZE];
+	generator.generate(frame);
+	SmartBmsData smartBmsData;
+	SmartBmsFrameView(frame).decode(&smartBmsData);
+	aggregator.addSample(smartBmsData, 0);
+
+	const SmartBmsAggregate *aggregate = aggregator.getWindow(0);
+	for (size_t i = 0; i < SBMS_FIELD_COUNT; i++)
+	{
+		const SmartBmsField field = static_cast<SmartBmsField>(i);
+		const int32_t value = smartBmsData.getFixedValue(field);
+		TEST_ASSERT_EQUAL(value, aggregate->getMin(field));
+		TEST_ASSERT_EQUAL(value, aggregate->getMean(field));
+		TEST_ASSERT_EQUAL(value, aggregate->getMax(field));
+		TEST_ASSERT_EQUAL((SBMS_FIELD_MASK_MEASUREMENTS & SBMS_FIELD_MASK(i)) ? 1 : 0, aggregate->getCount(field));
+	}
+}
+
+int main()
+{
+	UNITY_BEGIN();
+	RUN_TEST(test_windows_start_at_the_first_sample);
+	RUN_TEST(test_window_added_later_is_aligned_to_the_first_sample);
+	RUN_TEST(test_only_measurements_get_statistics);
+	RUN_TEST(test_statistics_of_every_measurement);
+	return UNITY_END();
+}
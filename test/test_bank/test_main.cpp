@@ -0,0 +1,204 @@
+#include <stdint.h>
+#include <vector>
+#include <unity.h>
+
+#include "bms/SmartBmsBank.h"
+#include "bms/SmartBmsData.h"
+#include "host/PacedStream.h"
+#include "host/SmartBmsFrameGenerator.h"
+
+#define TEST_PACK_COUNT 3
+#define TEST_FRAME_COUNT 30
+#define TEST_BYTE_DURATION_US 1042
+#define TEST_FRAME_PERIOD_US 1000000
+#define TEST_FRAME_PERIOD_STEP_US 700
+#define TEST_SERVICE_INTERVAL_US 5000
+
+// Simulated time in µs, shared by the streams and the bank
+static uint32_t simulatedTime = 0;
+
+/**
+ * @brief Clock of the simulation.
+ * @return simulated time in µs
+ */
+static const uint32_t getSimulatedTime()
+{
+	return simulatedTime;
+}
+
+/**
+ * @brief Packs of a simulated bank, each on its own paced stream with a slightly different cycle.
+ */
+struct TestBank
+{
+	std::vector<uint8_t> captures[TEST_PACK_COUNT];
+	PacedStream *streams[TEST_PACK_COUNT];
+	SmartBmsBank bank;
+
+	/**
+	 * @brief Generate the frames of every pack and add the packs to the bank.
+	 * @param frameCounts number of frames of every pack
+	 */
+	TestBank(const size_t frameCounts[TEST_PACK_COUNT])
+	{
+		simulatedTime = 0;
+		this->bank.setClock(getSimulatedTime);
+		this->bank.setMaxDataAge(3 * TEST_FRAME_PERIOD_US);
+		for (size_t i = 0; i < TEST_PACK_COUNT; i++)
+		{
+			SmartBmsFrameGenerator generator(i + 1);
+			this->captures[i].resize(frameCounts[i] * SMART_BMS_FRAME_SIZE);
+			generator.generate(this->captures[i].data(), frameCounts[i]);
+			this->streams[i] = new PacedStream(this->captures[i].data(), this->captures[i].size(), getSimulatedTime);
+			this->streams[i]->setTiming(i * TEST_FRAME_PERIOD_US / TEST_PACK_COUNT, TEST_BYTE_DURATION_US, TEST_FRAME_PERIOD_US + i * TEST_FRAME_PERIOD_STEP_US);
+			TEST_ASSERT_TRUE(this->bank.addPack(this->streams[i]));
+		}
+	}
+
+	~TestBank()
+	{
+		for (size_t i = 0; i < TEST_PACK_COUNT; i++)
+		{
+			delete this->streams[i];
+		}
+	}
+
+	/**
+	 * @brief Service the bank from a simulated loop.
+	 * @param duration simulated time in µs
+	 */
+	void run(const uint32_t duration)
+	{
+		const uint32_t end = simulatedTime + duration;
+		while (static_cast<int32_t>(end - simulatedTime) > 0)
+		{
+			simulatedTime += TEST_SERVICE_INTERVAL_US;
+			this->bank.service();
+		}
+	}
+};
+
+void setUp()
+{
+}
+
+void tearDown()
+{
+}
+
+void test_paced_packs_deliver_every_frame()
+{
+	const size_t frameCounts[TEST_PACK_COUNT] = {TEST_FRAME_COUNT, TEST_FRAME_COUNT, TEST_FRAME_COUNT};
+	TestBank testBank(frameCounts);
+	testBank.run((TEST_FRAME_COUNT + 1) * (TEST_FRAME_PERIOD_US + TEST_PACK_COUNT * TEST_FRAME_PERIOD_STEP_US));
+
+	int32_t current = 0;
+	uint32_t lowestCellVoltage = UINT32_MAX;
+	uint8_t lowestCellVoltagePack = SMART_BMS_BANK_NO_PACK;
+	for (uint8_t i = 0; i < TEST_PACK_COUNT; i++)
+	{
+		SmartBmsPack *pack = testBank.bank.getPack(i);
+		TEST_ASSERT_EQUAL(TEST_FRAME_COUNT, pack->getFrameCount());
+		TEST_ASSERT_EQUAL(0, pack->getSkippedByteCount());
+		TEST_ASSERT_EQUAL(0, pack->getReadErrorCount());
+		// The frames are only seen when the loop services the pack
+		TEST_ASSERT_UINT32_WITHIN(TEST_SERVICE_INTERVAL_US, TEST_FRAME_PERIOD_US + i * TEST_FRAME_PERIOD_STEP_US, pack->getReader()->getCyclePeriod());
+
+		const SmartBmsData &smartBmsData = pack->getData();
+		current += smartBmsData.getPackCurrentMilliamps();
+		if (smartBmsData.getLowestCellVoltageMillivolts() < lowestCellVoltage)
+		{
+			lowestCellVoltage = smartBmsData.getLowestCellVoltageMillivolts();
+			lowestCellVoltagePack = i;
+		}
+	}
+
+	SmartBmsBankView view;
+	testBank.bank.getView(&view);
+	TEST_ASSERT_EQUAL(TEST_PACK_COUNT, view.getPackCount());
+	TEST_ASSERT_EQUAL(0, view.getStalePackCount());
+	TEST_ASSERT_EQUAL(current, view.getPackCurrentMilliamps());
+	TEST_ASSERT_EQUAL(lowestCellVoltage, view.getLowestCellVoltageMillivolts());
+	TEST_ASSERT_EQUAL(lowestCellVoltagePack, view.getLowestCellVoltagePack());
+	TEST_ASSERT_TRUE(view.isAllowedToCharge());
+	TEST_ASSERT_TRUE(view.isAllowedToDischarge());
+	TEST_ASSERT_EQUAL(0, view.getAlarmPackMask());
+}
+
+void test_silent_pack_becomes_stale()
+{
+	// The second pack stops sending after a few frames and must no longer allow charging for the bank
+	const size_t frameCounts[TEST_PACK_COUNT] = {TEST_FRAME_COUNT, 5, TEST_FRAME_COUNT};
+	TestBank testBank(frameCounts);
+	testBank.run(6 * TEST_FRAME_PERIOD_US);
+
+	SmartBmsBankView view;
+	testBank.bank.getView(&view);
+	TEST_ASSERT_EQUAL(TEST_PACK_COUNT, view.getPackCount());
+	TEST_ASSERT_TRUE(view.isAllowedToCharge());
+
+	testBank.run(3 * TEST_FRAME_PERIOD_US);
+	testBank.bank.getView(&view);
+	TEST_ASSERT_EQUAL(TEST_PACK_COUNT - 1, view.getPackCount());
+	TEST_ASSERT_EQUAL(1, view.getStalePackCount());
+	TEST_ASSERT_FALSE(view.isAllowedToCharge());
+	TEST_ASSERT_FALSE(view.isAllowedToDischarge());
+	TEST_ASSERT_NOT_EQUAL(1, view.getLowestCellVoltagePack());
+}
+
+void test_alarm_is_kept_with_its_pack()
+{
+	const size_t frameCounts[TEST_PACK_COUNT] = {TEST_FRAME_COUNT, TEST_FRAME_COUNT, TEST_FRAME_COUNT};
+	TestBank testBank(frameCounts);
+	for (size_t i = 0; i < TEST_FRAME_COUNT; i++)
+	{
+		uint8_t *frame = &testBank.captures[2][i * SMART_BMS_FRAME_SIZE];
+		SmartBmsFrameGenerator::encodeRawValue(frame, SBMS_FIELD_MAX_VOLTAGE_ALARM, 1);
+		SmartBmsFrameGenerator::updateChecksum(frame);
+	}
+	testBank.run(3 * TEST_FRAME_PERIOD_US);
+
+	SmartBmsBankView view;
+	testBank.bank.getView(&view);
+	TEST_ASSERT_EQUAL(TEST_PACK_COUNT, view.getPackCount());
+	TEST_ASSERT_TRUE(view.isMaxVoltageAlarmActive());
+	TEST_ASSERT_FALSE(view.isMinVoltageAlarmActive());
+	TEST_ASSERT_EQUAL(1 << 2, view.getAlarmPackMask());
+}
+
+void test_backlog_does_not_starve_other_packs()
+{
+	// The first pack has a lot of bytes waiting, the others still get their bytes in the same round
+	const size_t frameCounts[TEST_PACK_COUNT] = {TEST_FRAME_COUNT, TEST_FRAME_COUNT, TEST_FRAME_COUNT};
+	TestBank testBank(frameCounts);
+	for (size_t i = 0; i < TEST_PACK_COUNT; i++)
+	{
+		testBank.streams[i]->setTiming(0, TEST_BYTE_DURATION_US, TEST_FRAME_PERIOD_US);
+	}
+	testBank.streams[0]->setTiming(0, 1, SMART_BMS_FRAME_SIZE);
+	simulatedTime = 40 * TEST_BYTE_DURATION_US;
+	testBank.bank.service();
+	TEST_ASSERT_EQUAL(SMART_BMS_BANK_BYTE_BUDGET, testBank.streams[0]->getPosition());
+	TEST_ASSERT_EQUAL(40, testBank.streams[1]->getPosition());
+	TEST_ASSERT_EQUAL(40, testBank.streams[2]->getPosition());
+
+	// The backlog is worked off round by round
+	simulatedTime += SMART_BMS_FRAME_SIZE * TEST_BYTE_DURATION_US;
+	while (testBank.streams[0]->available() > 0)
+	{
+		testBank.bank.service();
+	}
+	TEST_ASSERT_EQUAL(TEST_FRAME_COUNT, testBank.bank.getPack(0)->getFrameCount());
+	TEST_ASSERT_EQUAL(1, testBank.bank.getPack(1)->getFrameCount());
+	TEST_ASSERT_EQUAL(1, testBank.bank.getPack(2)->getFrameCount());
+}
+
+int main()
+{
+	UNITY_BEGIN();
+	RUN_TEST(test_paced_packs_deliver_every_frame);
+	RUN_TEST(test_silent_pack_becomes_stale);
+	RUN_TEST(test_alarm_is_kept_with_its_pack);
+	RUN_TEST(test_backlog_does_not_starve_other_packs);
+	return UNITY_END();
+}
@@ -0,0 +1,203 @@
+#include <stdint.h>
+#include <string.h>
+#include <vector>
+#include <unity.h>
+
+#include "bms/SmartBmsBatchDecoder.h"
+#include "bms/SmartBmsData.h"
+#include "bms/SmartBmsFrameView.h"
+#include "bms/SmartBmsReader.h"
+#include "host/SmartBmsFrameGenerator.h"
+
+#define TEST_RANDOM_FRAME_COUNT 100000
+#define TEST_FRAME_COUNT 1000
+#define TEST_SEED 0x5EED
+
+/**
+ * @brief Check the word wide checksum against the byte wise reference.
+ * @param frame buffer of 58 bytes
+ * @return true when both agree
+ */
+static const bool checksumsAgree(const uint8_t frame[SMART_BMS_FRAME_SIZE])
+{
+	const bool reference = SmartBmsReader::calculateChecksum(frame, SMART_BMS_FRAME_SIZE - 1) == frame[SMART_BMS_FRAME_SIZE - 1];
+	return SmartBmsBatchDecoder::isChecksumValid(frame) == reference;
+}
+
+void setUp()
+{
+}
+
+void tearDown()
+{
+}
+
+void test_swar_checksum_matches_reference_on_random_bytes()
+{
+	// Random bytes almost never match, so every other frame gets the reference checksum to test both outcomes
+	SmartBmsFrameGenerator generator(TEST_SEED);
+	uint8_t frame[SMART_BMS_FRAME_SIZE];
+	for (size_t i = 0; i < TEST_RANDOM_FRAME_COUNT; i++)
+	{
+		for (size_t j = 0; j < SMART_BMS_FRAME_SIZE; j++)
+		{
+			frame[j] = generator.nextRandom() >> 24;
+		}
+		if (i % 2 == 0)
+		{
+			SmartBmsFrameGenerator::updateChecksum(frame);
+		}
+		TEST_ASSERT_TRUE(checksumsAgree(frame));
+	}
+}
+
+void test_swar_checksum_matches_reference_on_extreme_bytes()
+{
+	// All bytes at 0xFF fill every lane to its maximum
+	const uint8_t values[] = {0x00, 0x01, 0x7F, 0x80, 0xFE, 0xFF};
+	uint8_t frame[SMART_BMS_FRAME_SIZE];
+	for (size_t i = 0; i < sizeof(values); i++)
+	{
+		memset(frame, values[i], sizeof(frame));
+		TEST_ASSERT_TRUE(checksumsAgree(frame));
+		SmartBmsFrameGenerator::updateChecksum(frame);
+		TEST_ASSERT_TRUE(SmartBmsBatchDecoder::isChecksumValid(frame));
+
+		// A single changed bit in any byte must be detected
+		for (size_t j = 0; j < SMART_BMS_FRAME_SIZE; j++)
+		{
+			frame[j] ^= 0x01;
+			TEST_ASSERT_TRUE(checksumsAgree(frame));
+			TEST_ASSERT_FALSE(SmartBmsBatchDecoder::isChecksumValid(frame));
+			frame[j] ^= 0x01;
+		}
+	}
+}
+
+void test_validate_frames_marks_invalid_frames()
+{
+	std::vector<uint8_t> frames(TEST_FRAME_COUNT * SMART_BMS_FRAME_SIZE);
+	SmartBmsFrameGenerator generator(TEST_SEED);
+	generator.generate(frames.data(), TEST_FRAME_COUNT);
+	for (size_t i = 0; i < TEST_FRAME_COUNT; i += 7)
+	{
+		frames[i * SMART_BMS_FRAME_SIZE + i % SMART_BMS_FRAME_SIZE] ^= 0x10;
+	}
+
+	std::vector<uint8_t> validBitmap((TEST_FRAME_COUNT + 7) / 8);
+	const size_t validCount = SmartBmsBatchDecoder::validateFrames(frames.data(), TEST_FRAME_COUNT, validBitmap.data());
+	TEST_ASSERT_EQUAL(TEST_FRAME_COUNT - (TEST_FRAME_COUNT + 6) / 7, validCount);
+	for (size_t i = 0; i < TEST_FRAME_COUNT; i++)
+	{
+		TEST_ASSERT_EQUAL(i % 7 != 0, (validBitmap[i / 8] >> (i % 8)) & 1);
+	}
+}
+
+void test_batch_decode_matches_single_frame_decode()
+{
+	std::vector<uint8_t> frames(TEST_FRAME_COUNT * SMART_BMS_FRAME_SIZE);
+	SmartBmsFrameGenerator generator(TEST_SEED);
+	generator.generate(frames.data(), TEST_FRAME_COUNT);
+	frames[5 * SMART_BMS_FRAME_SIZE] ^= 0x01;
+
+	std::vector<SmartBmsData> records(TEST_FRAME_COUNT);
+	TEST_ASSERT_EQUAL(TEST_FRAME_COUNT - 1, SmartBmsBatchDecoder::decodeFrames(frames.data(), TEST_FRAME_COUNT, records.data(), nullptr));
+	TEST_ASSERT_EQUAL(0, records[5].getFieldMask());
+	for (size_t i = 0; i < TEST_FRAME_COUNT; i++)
+	{
+		if (i == 5)
+		{
+			continue;
+		}
+		SmartBmsData smartBmsData;
+		SmartBmsFrameView(&frames[i * SMART_BMS_FRAME_SIZE]).decode(&smartBmsData);
+		TEST_ASSERT_EQUAL(smartBmsData.getFieldMask(), records[i].getFieldMask());
+		TEST_ASSERT_EQUAL(SBMS_FIELD_MASK_ALL, records[i].getChangedMask());
+		for (size_t j = 0; j < SBMS_FIELD_COUNT; j++)
+		{
+			TEST_ASSERT_EQUAL(smartBmsData.getRawValue(static_cast<SmartBmsField>(j)), records[i].getRawValue(static_cast<SmartBmsField>(j)));
+		}
+	}
+}
+
+void test_changed_fields_match_single_frame_decode()
+{
+	std::vector<uint8_t> frames(TEST_FRAME_COUNT * SMART_BMS_FRAME_SIZE);
+	SmartBmsFrameGenerator generator(TEST_SEED);
+	generator.generate(frames.data(), TEST_FRAME_COUNT);
+	frames[5 * SMART_BMS_FRAME_SIZE] ^= 0x01;
+
+	// The changes are relative to the previous valid frame, so the invalid frame is skipped
+	std::vector<SmartBmsData> records(TEST_FRAME_COUNT);
+	SmartBmsBatchDecoder::decodeFrames(frames.data(), TEST_FRAME_COUNT, records.data(), nullptr);
+	SmartBmsBatchDecoder::markChangedFields(frames.data(), TEST_FRAME_COUNT, records.data());
+	TEST_ASSERT_EQUAL(SBMS_FIELD_MASK_ALL, records[0].getChangedMask());
+	TEST_ASSERT_EQUAL(0, records[5].getChangedMask());
+	for (size_t i = 1; i < TEST_FRAME_COUNT; i++)
+	{
+		if (i == 5)
+		{
+			continue;
+		}
+		const size_t previous = i == 6 ? 4 : i - 1;
+		SmartBmsData smartBmsData;
+		SmartBmsFrameView(&frames[i * SMART_BMS_FRAME_SIZE]).decode(&smartBmsData, SBMS_FIELD_MASK_ALL, SmartBmsFrameView(&frames[previous * SMART_BMS_FRAME_SIZE]));
+		TEST_ASSERT_EQUAL(smartBmsData.getChangedMask(), records[i].getChangedMask());
+	}
+}
+
+void test_batch_decode_agrees_with_reader()
+{
+	// Frames with a broken checksum, frames that are not well formed and a frame of a failed cell
+	std::vector<uint8_t> frames(TEST_FRAME_COUNT * SMART_BMS_FRAME_SIZE);
+	SmartBmsFrameGenerator generator(TEST_SEED);
+	generator.generate(frames.data(), TEST_FRAME_COUNT);
+	for (size_t i = 10; i < TEST_FRAME_COUNT; i += 50)
+	{
+		frames[i * SMART_BMS_FRAME_SIZE + 30] ^= 0x01;
+	}
+	for (size_t i = 35; i < TEST_FRAME_COUNT; i += 50)
+	{
+		SmartBmsFrameGenerator::encodeRawValue(&frames[i * SMART_BMS_FRAME_SIZE], SBMS_FIELD_PACK_SOC, 101);
+		SmartBmsFrameGenerator::updateChecksum(&frames[i * SMART_BMS_FRAME_SIZE]);
+	}
+	SmartBmsFrameGenerator::encodeRawValue(&frames[3 * SMART_BMS_FRAME_SIZE], SBMS_FIELD_LOWEST_CELL_VOLTAGE, 900 / 5);
+	SmartBmsFrameGenerator::updateChecksum(&frames[3 * SMART_BMS_FRAME_SIZE]);
+
+	std::vector<uint8_t> validBitmap((TEST_FRAME_COUNT + 7) / 8);
+	const size_t validCount = SmartBmsBatchDecoder::validateFrames(frames.data(), TEST_FRAME_COUNT, validBitmap.data());
+	TEST_ASSERT_EQUAL(TEST_FRAME_COUNT - 2 * TEST_FRAME_COUNT / 50, validCount);
+
+	// The reader must deliver exactly the frames that the batch decoder accepts
+	SmartBmsReader smartBmsReader(nullptr);
+	std::vector<bool> delivered(TEST_FRAME_COUNT, false);
+	size_t offset = 0;
+	while (offset < frames.size())
+	{
+		SmartBmsFrameView frameView;
+		size_t consumed = 0;
+		const SmartBmsError err = smartBmsReader.feed(&frames[offset], frames.size() - offset, &consumed, &frameView);
+		offset += consumed;
+		if (err == SmartBmsError::SBMS_OK)
+		{
+			TEST_ASSERT_EQUAL(0, offset % SMART_BMS_FRAME_SIZE);
+			delivered[offset / SMART_BMS_FRAME_SIZE - 1] = true;
+		}
+	}
+	for (size_t i = 0; i < TEST_FRAME_COUNT; i++)
+	{
+		TEST_ASSERT_EQUAL(delivered[i], (validBitmap[i / 8] >> (i % 8)) & 1);
+	}
+}
+
+int main()
+{
+	UNITY_BEGIN();
+	RUN_TEST(test_swar_checksum_matches_reference_on_random_bytes);
+	RUN_TEST(test_swar_checksum_matches_reference_on_extreme_bytes);
+	RUN_TEST(test_validate_frames_marks_invalid_frames);
+	RUN_TEST(test_batch_decode_matches_single_frame_decode);
+	RUN_TEST(test_changed_fields_match_single_frame_decode);
+	RUN_TEST(test_batch_decode_agrees_with_reader);
+	return UNITY_END();
+}
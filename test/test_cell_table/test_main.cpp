@@ -0,0 +1,135 @@
+#include <stdint.h>
+#include <unity.h>
+
+#include "bms/SmartBmsCellTable.h"
+#include "bms/SmartBmsFrameView.h"
+#include "host/SmartBmsFrameGenerator.h"
+
+#ifdef SMART_BMS_CELL_DATA
+#define TEST_CELL_COUNT 16
+
+/**
+ * @brief Create a frame with the data of a single cell.
+ * @param cellCount number of cells
+ * @param cellNumber number of the cell, starting at 1
+ * @param frame buffer of 58 bytes that receives the frame
+ */
+static void makeFrame(const uint8_t cellCount, const uint8_t cellNumber, uint8_t frame[SMART_BMS_FRAME_SIZE])
+{
+	SmartBmsFrameGenerator generator(1);
+	generator.generate(frame);
+	SmartBmsFrameGenerator::encodeRawValue(frame, SBMS_FIELD_CELL_COUNT, cellCount);
+	SmartBmsFrameGenerator::encodeRawValue(frame, SBMS_FIELD_CELL_NUMBER, cellNumber);
+	SmartBmsFrameGenerator::encodeRawValue(frame, SBMS_FIELD_CELL_VOLTAGE, 600 + cellNumber);
+	SmartBmsFrameGenerator::updateChecksum(frame);
+}
+
+/**
+ * @brief Pass the data of a range of cells to the table.
+ * @param cellTable table to update
+ * @param cellCount number of cells in the frames
+ * @param first first cell number
+ * @param last last cell number
+ */
+static void updateCells(SmartBmsCellTable *cellTable, const uint8_t cellCount, const uint8_t first, const uint8_t last)
+{
+	uint8_t frame[SMART_BMS_FRAME_SIZE];
+	for (uint8_t i = first; i <= last; i++)
+	{
+		makeFrame(cellCount, i, frame);
+		cellTable->update(SmartBmsFrameView(frame));
+	}
+}
+#endif
+
+void setUp()
+{
+}
+
+void tearDown()
+{
+}
+
+#ifdef SMART_BMS_CELL_DATA
+void test_sweep_completes_the_table()
+{
+	SmartBmsCellTable cellTable;
+	updateCells(&cellTable, TEST_CELL_COUNT, 1, TEST_CELL_COUNT - 1);
+	TEST_ASSERT_FALSE(cellTable.isComplete());
+	TEST_ASSERT_EQUAL(0, cellTable.getSweepCount());
+
+	updateCells(&cellTable, TEST_CELL_COUNT, TEST_CELL_COUNT, TEST_CELL_COUNT);
+	TEST_ASSERT_TRUE(cellTable.isComplete());
+	TEST_ASSERT_EQUAL(1, cellTable.getSweepCount());
+	TEST_ASSERT_EQUAL(TEST_CELL_COUNT, cellTable.getCellCount());
+	TEST_ASSERT_EQUAL(SmartBmsFields::toFixedValue(SBMS_FIELD_CELL_VOLTAGE, 603), cellTable.getCellVoltageMillivolts(3));
+	TEST_ASSERT_EQUAL(TEST_CELL_COUNT - 3, cellTable.getCellAge(3));
+	TEST_ASSERT_EQUAL(SMART_BMS_CELL_AGE_UNKNOWN, cellTable.getCellAge(TEST_CELL_COUNT + 1));
+}
+
+void test_single_frame_with_other_cell_count_is_ignored()
+{
+	SmartBmsCellTable cellTable;
+	updateCells(&cellTable, TEST_CELL_COUNT, 1, TEST_CELL_COUNT);
+	TEST_ASSERT_TRUE(cellTable.isComplete());
+
+	// A corrupted cell count in one frame keeps the table, the next frame continues the sweep
+	uint8_t frame[SMART_BMS_FRAME_SIZE];
+	makeFrame(TEST_CELL_COUNT / 2, 1, frame);
+	TEST_ASSERT_FALSE(cellTable.update(SmartBmsFrameView(frame)));
+	TEST_ASSERT_TRUE(cellTable.isComplete());
+	TEST_ASSERT_EQUAL(TEST_CELL_COUNT, cellTable.getCellCount());
+	makeFrame(TEST_CELL_COUNT, 2, frame);
+	TEST_ASSERT_TRUE(cellTable.update(SmartBmsFrameView(frame)));
+	TEST_ASSERT_TRUE(cellTable.isComplete());
+
+	// Two different glitches in a row are no confirmation either
+	makeFrame(TEST_CELL_COUNT / 2, 1, frame);
+	TEST_ASSERT_FALSE(cellTable.update(SmartBmsFrameView(frame)));
+	makeFrame(TEST_CELL_COUNT / 4, 1, frame);
+	TEST_ASSERT_FALSE(cellTable.update(SmartBmsFrameView(frame)));
+	TEST_ASSERT_EQUAL(TEST_CELL_COUNT, cellTable.getCellCount());
+	TEST_ASSERT_TRUE(cellTable.isComplete());
+}
+
+void test_cell_count_change_in_two_frames_clears_the_table()
+{
+	SmartBmsCellTable cellTable;
+	updateCells(&cellTable, TEST_CELL_COUNT, 1, TEST_CELL_COUNT);
+	TEST_ASSERT_TRUE(cellTable.isComplete());
+
+	uint8_t frame[SMART_BMS_FRAME_SIZE];
+	makeFrame(TEST_CELL_COUNT / 2, 1, frame);
+	TEST_ASSERT_FALSE(cellTable.update(SmartBmsFrameView(frame)));
+	makeFrame(TEST_CELL_COUNT / 2, 2, frame);
+	TEST_ASSERT_TRUE(cellTable.update(SmartBmsFrameView(frame)));
+	TEST_ASSERT_EQUAL(TEST_CELL_COUNT / 2, cellTable.getCellCount());
+	TEST_ASSERT_FALSE(cellTable.isComplete());
+	TEST_ASSERT_FALSE(cellTable.hasCell(1));
+	TEST_ASSERT_TRUE(cellTable.hasCell(2));
+	TEST_ASSERT_EQUAL(0, cellTable.getSweepCount());
+}
+
+void test_first_frame_sets_the_cell_count()
+{
+	// An empty table has nothing to protect, so it takes the count of the first frame
+	SmartBmsCellTable cellTable;
+	uint8_t frame[SMART_BMS_FRAME_SIZE];
+	makeFrame(TEST_CELL_COUNT, 5, frame);
+	TEST_ASSERT_TRUE(cellTable.update(SmartBmsFrameView(frame)));
+	TEST_ASSERT_EQUAL(TEST_CELL_COUNT, cellTable.getCellCount());
+	TEST_ASSERT_TRUE(cellTable.hasCell(5));
+}
+#endif
+
+int main()
+{
+	UNITY_BEGIN();
+#ifdef SMART_BMS_CELL_DATA
+	RUN_TEST(test_sweep_completes_the_table);
+	RUN_TEST(test_single_frame_with_other_cell_count_is_ignored);
+	RUN_TEST(test_cell_count_change_in_two_frames_clears_the_table);
+	RUN_TEST(test_first_frame_sets_the_cell_count);
+#endif
+	return UNITY_END();
+}
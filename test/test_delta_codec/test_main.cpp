@@ -0,0 +1,276 @@
+#include <stdint.h>
+#include <string.h>
+#include <unity.h>
+
+#include "bms/SmartBmsData.h"
+#include "bms/SmartBmsDeltaCodec.h"
+#include "bms/SmartBmsFrameView.h"
+#include "host/SmartBmsFrameGenerator.h"
+
+#define TEST_FRAME_COUNT 1000
+#define TEST_SEED 0x5EED
+
+/**
+ * @brief Check that two data objects hold the same fields with the same values.
+ * @param expected expected data
+ * @param actual actual data
+ */
+static void assertSameData(const SmartBmsData &expected, const SmartBmsData &actual)
+{
+	TEST_ASSERT_EQUAL_HEX32(expected.getFieldMask(), actual.getFieldMask());
+	TEST_ASSERT_EQUAL_HEX32(expected.getChangedMask(), actual.getChangedMask());
+	for (size_t i = 0; i < SBMS_FIELD_COUNT; i++)
+	{
+		const SmartBmsField field = static_cast<SmartBmsField>(i);
+		if (expected.hasField(field))
+		{
+			TEST_ASSERT_EQUAL_INT32(expected.getRawValue(field), actual.getRawValue(field));
+		}
+	}
+}
+
+/**
+ * @brief Decode a generated frame with a negative current into a data object.
+ * @param smartBmsData data that receives the frame
+ */
+static void decodeNegativeFrame(SmartBmsData *smartBmsData)
+{
+	SmartBmsFrameGenerator generator(TEST_SEED);
+	uint8_t frame[SMART_BMS_FRAME_SIZE];
+	generator.generate(frame);
+	SmartBmsFrameGenerator::encodeRawValue(frame, SBMS_FIELD_PACK_CURRENT, -1);
+	SmartBmsFrameGenerator::encodeRawValue(frame, SBMS_FIELD_PACK_CHARGE_CURRENT, 0);
+	SmartBmsFrameGenerator::encodeRawValue(frame, SBMS_FIELD_PACK_DISCHARGE_CURRENT, -0xFFFF);
+	SmartBmsFrameView(frame).decode(smartBmsData);
+}
+
+void setUp()
+{
+}
+
+void tearDown()
+{
+}
+
+void test_zigzag_keeps_small_values_small()
+{
+	const int32_t values[] = {0, -1, 1, -2, 2, 0xFFFF, -0xFFFF, INT32_MAX, INT32_MIN};
+	const uint32_t encoded[] = {0, 1, 2, 3, 4, 0x1FFFE, 0x1FFFD, 0xFFFFFFFE, 0xFFFFFFFF};
+	for (size_t i = 0; i < sizeof(values) / sizeof(values[0]); i++)
+	{
+		TEST_ASSERT_EQUAL_HEX32(encoded[i], SmartBmsDeltaCodec::zigzagEncode(values[i]));
+		TEST_ASSERT_EQUAL_INT32(values[i], SmartBmsDeltaCodec::zigzagDecode(encoded[i]));
+	}
+}
+
+void test_varint_round_trips()
+{
+	const uint32_t values[] = {0, 1, 0x7F, 0x80, 0x3FFF, 0x4000, 0x1FFFFF, 0x200000, 0xFFFFFFF, 0x10000000, UINT32_MAX};
+	const size_t sizes[] = {1, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5};
+	for (size_t i = 0; i < sizeof(values) / sizeof(values[0]); i++)
+	{
+		uint8_t buffer[5];
+		size_t position = 0;
+		TEST_ASSERT_TRUE(SmartBmsDeltaCodec::writeVarint(buffer, sizeof(buffer), &position, values[i]));
+		TEST_ASSERT_EQUAL(sizes[i], position);
+
+		// A buffer that is one byte too small is detected
+		size_t shortPosition = 0;
+		TEST_ASSERT_FALSE(SmartBmsDeltaCodec::writeVarint(buffer, sizes[i] - 1, &shortPosition, values[i]));
+
+		uint32_t value = 0;
+		position = 0;
+		TEST_ASSERT_EQUAL(SmartBmsError::SBMS_OK, SmartBmsDeltaCodec::readVarint(buffer, sizes[i], &position, &value));
+		TEST_ASSERT_EQUAL(sizes[i], position);
+		TEST_ASSERT_EQUAL_HEX32(values[i], value);
+
+		position = 0;
+		TEST_ASSERT_EQUAL(SmartBmsError::SBMS_ERR_NOT_ENOUGH_DATA, SmartBmsDeltaCodec::readVarint(buffer, sizes[i] - 1, &position, &value));
+	}
+
+	// More than 5 bytes can not hold a 32 bit value
+	const uint8_t tooLong[] = {0x80, 0x80, 0x80, 0x80, 0x80, 0x00};
+	uint32_t value = 0;
+	size_t position = 0;
+	TEST_ASSERT_EQUAL(SmartBmsError::SBMS_ERR_INVALID_DATA, SmartBmsDeltaCodec::readVarint(tooLong, sizeof(tooLong), &position, &value));
+}
+
+void test_full_records_round_trip()
+{
+	SmartBmsFrameGenerator generator(TEST_SEED);
+	uint8_t frame[SMART_BMS_FRAME_SIZE];
+	for (size_t i = 0; i < TEST_FRAME_COUNT; i++)
+	{
+		generator.generate(frame);
+		SmartBmsData expected;
+		SmartBmsFrameView(frame).decode(&expected);
+
+		uint8_t buffer[SMART_BMS_DELTA_MAX_SIZE];
+		const size_t size = SmartBmsDeltaCodec::encode(expected, expected.getFieldMask(), buffer, sizeof(buffer));
+		TEST_ASSERT_GREATER_THAN(0, size);
+
+		SmartBmsData actual;
+		size_t consumed = 0;
+		TEST_ASSERT_EQUAL(SmartBmsError::SBMS_OK, SmartBmsDeltaCodec::decode(buffer, size, &consumed, &actual));
+		TEST_ASSERT_EQUAL(size, consumed);
+		assertSameData(expected, actual);
+	}
+}
+
+void test_changed_records_round_trip()
+{
+	// The receiver starts from a full record and then applies only the changed fields
+	SmartBmsFrameGenerator generator(TEST_SEED);
+	uint8_t frames[2][SMART_BMS_FRAME_SIZE];
+	SmartBmsData expected;
+	SmartBmsData actual;
+	size_t fullSize = 0;
+	for (size_t i = 0; i < TEST_FRAME_COUNT; i++)
+	{
+		uint8_t *frame = frames[i % 2];
+		generator.generate(frame);
+		if (i == 0)
+		{
+			SmartBmsFrameView(frame).decode(&expected);
+		}
+		else
+		{
+			SmartBmsFrameView(frame).decode(&expected, SBMS_FIELD_MASK_ALL, SmartBmsFrameView(frames[(i + 1) % 2]));
+		}
+
+		uint8_t buffer[SMART_BMS_DELTA_MAX_SIZE];
+		const size_t size = SmartBmsDeltaCodec::encode(expected, expected.getChangedMask(), buffer, sizeof(buffer));
+		TEST_ASSERT_GREATER_THAN(0, size);
+		fullSize = i == 0 ? size : fullSize;
+		TEST_ASSERT_LESS_OR_EQUAL(fullSize, size);
+
+		size_t consumed = 0;
+		TEST_ASSERT_EQUAL(SmartBmsError::SBMS_OK, SmartBmsDeltaCodec::decode(buffer, size, &consumed, &actual));
+		TEST_ASSERT_EQUAL(size, consumed);
+		assertSameData(expected, actual);
+	}
+}
+
+void test_partial_mask_keeps_other_fields()
+{
+	SmartBmsData expected;
+	decodeNegativeFrame(&expected);
+	const uint32_t mask = SBMS_FIELD_MASK(SBMS_FIELD_PACK_VOLTAGE) | SBMS_FIELD_MASK(SBMS_FIELD_PACK_CURRENT) | SBMS_FIELD_MASK(SBMS_FIELD_ALLOWED_TO_CHARGE);
+
+	// The mask needs 3 bytes as varint, followed by the flag byte and two values of 3 bytes
+	uint8_t buffer[SMART_BMS_DELTA_MAX_SIZE];
+	const size_t size = SmartBmsDeltaCodec::encode(expected, mask, buffer, sizeof(buffer));
+	TEST_ASSERT_EQUAL(3 + 1 + 3 + 3, size);
+
+	SmartBmsData actual;
+	SmartBmsFrameGenerator generator(TEST_SEED + 1);
+	uint8_t frame[SMART_BMS_FRAME_SIZE];
+	generator.generate(frame);
+	SmartBmsFrameView(frame).decode(&actual);
+	const SmartBmsData before = actual;
+
+	size_t consumed = 0;
+	TEST_ASSERT_EQUAL(SmartBmsError::SBMS_OK, SmartBmsDeltaCodec::decode(buffer, size, &consumed, &actual));
+	TEST_ASSERT_EQUAL(size, consumed);
+	TEST_ASSERT_EQUAL_HEX32(mask, actual.getChangedMask());
+	for (size_t i = 0; i < SBMS_FIELD_COUNT; i++)
+	{
+		const SmartBmsField field = static_cast<SmartBmsField>(i);
+		TEST_ASSERT_EQUAL_INT32((mask & SBMS_FIELD_MASK(i)) ? expected.getRawValue(field) : before.getRawValue(field), actual.getRawValue(field));
+	}
+}
+
+void test_negative_values_round_trip()
+{
+	SmartBmsData expected;
+	decodeNegativeFrame(&expected);
+	TEST_ASSERT_EQUAL_INT32(-1, expected.getRawValue(SBMS_FIELD_PACK_CURRENT));
+	TEST_ASSERT_EQUAL_INT32(-0xFFFF, expected.getRawValue(SBMS_FIELD_PACK_DISCHARGE_CURRENT));
+
+	// A current of -1 is zigzag encoded as 1
+	uint8_t buffer[SMART_BMS_DELTA_MAX_SIZE];
+	const uint32_t mask = SBMS_FIELD_MASK(SBMS_FIELD_PACK_CURRENT);
+	size_t size = SmartBmsDeltaCodec::encode(expected, mask, buffer, sizeof(buffer));
+	const uint8_t record[] = {static_cast<uint8_t>(mask), 0x01, 0x00, 0x00};
+	TEST_ASSERT_EQUAL(sizeof(record), size);
+	TEST_ASSERT_EQUAL_MEMORY(record, buffer, sizeof(record));
+
+	size = SmartBmsDeltaCodec::encode(expected, expected.getFieldMask(), buffer, sizeof(buffer));
+	SmartBmsData actual;
+	size_t consumed = 0;
+	TEST_ASSERT_EQUAL(SmartBmsError::SBMS_OK, SmartBmsDeltaCodec::decode(buffer, size, &consumed, &actual));
+	assertSameData(expected, actual);
+}
+
+void test_truncated_record_is_rejected()
+{
+	SmartBmsData expected;
+	decodeNegativeFrame(&expected);
+	uint8_t buffer[SMART_BMS_DELTA_MAX_SIZE];
+	const size_t size = SmartBmsDeltaCodec::encode(expected, expected.getFieldMask(), buffer, sizeof(buffer));
+	TEST_ASSERT_GREATER_THAN(0, size);
+
+	SmartBmsFrameGenerator generator(TEST_SEED + 1);
+	uint8_t frame[SMART_BMS_FRAME_SIZE];
+	generator.generate(frame);
+	for (size_t length = 0; length < size; length++)
+	{
+		// The encoder needs the whole record
+		uint8_t shortBuffer[SMART_BMS_DELTA_MAX_SIZE];
+		TEST_ASSERT_EQUAL(0, SmartBmsDeltaCodec::encode(expected, expected.getFieldMask(), shortBuffer, length));
+
+		// The decoder does not apply a part of the record
+		SmartBmsData actual;
+		SmartBmsFrameView(frame).decode(&actual);
+		const SmartBmsData before = actual;
+		size_t consumed = 0;
+		TEST_ASSERT_EQUAL(SmartBmsError::SBMS_ERR_NOT_ENOUGH_DATA, SmartBmsDeltaCodec::decode(buffer, length, &consumed, &actual));
+		assertSameData(before, actual);
+	}
+}
+
+void test_unknown_fields_are_rejected()
+{
+	SmartBmsFrameGenerator generator(TEST_SEED);
+	uint8_t frame[SMART_BMS_FRAME_SIZE];
+	generator.generate(frame);
+
+	// Every bit behind the last field is unknown, the values are all zero and long enough for any mask
+	const uint8_t unknownBits[] = {static_cast<uint8_t>(SBMS_FIELD_COUNT), 31};
+	for (size_t i = 0; i < sizeof(unknownBits); i++)
+	{
+		uint8_t buffer[SMART_BMS_DELTA_MAX_SIZE + 5] = {};
+		size_t position = 0;
+		TEST_ASSERT_TRUE(SmartBmsDeltaCodec::writeVarint(buffer, sizeof(buffer), &position, SBMS_FIELD_MASK(SBMS_FIELD_PACK_VOLTAGE) | (1UL << unknownBits[i])));
+
+		SmartBmsData actual;
+		SmartBmsFrameView(frame).decode(&actual);
+		const SmartBmsData before = actual;
+		size_t consumed = 0;
+		TEST_ASSERT_EQUAL(SmartBmsError::SBMS_ERR_INVALID_DATA, SmartBmsDeltaCodec::decode(buffer, sizeof(buffer), &consumed, &actual));
+		assertSameData(before, actual);
+	}
+
+	// A mask that is longer than 5 bytes is invalid as well
+	const uint8_t tooLong[SMART_BMS_DELTA_MAX_SIZE + 6] = {0x80, 0x80, 0x80, 0x80, 0x80, 0x00};
+	SmartBmsData actual;
+	SmartBmsFrameView(frame).decode(&actual);
+	const SmartBmsData before = actual;
+	size_t consumed = 0;
+	TEST_ASSERT_EQUAL(SmartBmsError::SBMS_ERR_INVALID_DATA, SmartBmsDeltaCodec::decode(tooLong, sizeof(tooLong), &consumed, &actual));
+	assertSameData(before, actual);
+}
+
+int main()
+{
+	UNITY_BEGIN();
+	RUN_TEST(test_zigzag_keeps_small_values_small);
+	RUN_TEST(test_varint_round_trips);
+	RUN_TEST(test_full_records_round_trip);
+	RUN_TEST(test_changed_records_round_trip);
+	RUN_TEST(test_partial_mask_keeps_other_fields);
+	RUN_TEST(test_negative_values_round_trip);
+	RUN_TEST(test_truncated_record_is_rejected);
+	RUN_TEST(test_unknown_fields_are_rejected);
+	return UNITY_END();
+}
@@ -0,0 +1,78 @@
+#include <string.h>
+#include <unity.h>
+
+#include "bms/SmartBmsFrameView.h"
+#include "bms/SmartBmsReader.h"
+#include "host/SmartBmsFrameGenerator.h"
+
+#define TEST_FRAME_COUNT 300000
+#define TEST_SEED 7
+
+void setUp()
+{
+}
+
+void tearDown()
+{
+}
+
+void test_long_runs_stay_plausible()
+{
+	SmartBmsFrameGenerator generator(TEST_SEED);
+	uint8_t frame[SMART_BMS_FRAME_SIZE];
+	for (size_t i = 0; i < TEST_FRAME_COUNT; i++)
+	{
+		generator.generate(frame);
+		const SmartBmsFrameView frameView(frame);
+		TEST_ASSERT_TRUE(frameView.isPlausible());
+		TEST_ASSERT_EQUAL_UINT8(SmartBmsReader::calculateChecksum(frame, SMART_BMS_FRAME_SIZE - 1), frame[SMART_BMS_FRAME_SIZE - 1]);
+
+		// A LiFePo4 cell at rest stays between 3.0 V and 3.45 V
+		TEST_ASSERT_UINT32_WITHIN(225, 3225, frameView.getLowestCellVoltageMillivolts());
+		TEST_ASSERT_UINT32_WITHIN(225, 3225, frameView.getHighestCellVoltageMillivolts());
+		TEST_ASSERT_INT32_WITHIN(20000, 25000, frameView.getLowestCellTemperatureMillicelsius());
+		TEST_ASSERT_INT32_WITHIN(20000, 25000, frameView.getHighestCellTemperatureMillicelsius());
+	}
+}
+
+void test_soc_follows_the_remaining_energy()
+{
+	SmartBmsFrameGenerator generator(TEST_SEED);
+	uint8_t frame[SMART_BMS_FRAME_SIZE];
+	for (size_t i = 0; i < TEST_FRAME_COUNT; i += 1000)
+	{
+		for (size_t j = 0; j < 1000; j++)
+		{
+			generator.generate(frame);
+		}
+		const SmartBmsFrameView frameView(frame);
+		TEST_ASSERT_EQUAL_UINT8(frameView.getPackRemainingEnergyWattHours() * 100 / frameView.getPackCapacityWattHours(), frameView.getPackSoc());
+
+		// The cell voltage is close to the open circuit voltage of the state of charge
+		const uint32_t restVoltage = 3000 + 450 * frameView.getPackSoc() / 100;
+		TEST_ASSERT_UINT32_WITHIN(100, restVoltage, frameView.getPackVoltageMillivolts() / frameView.getCellCount());
+	}
+}
+
+void test_same_seed_gives_same_frames()
+{
+	SmartBmsFrameGenerator first(TEST_SEED);
+	SmartBmsFrameGenerator second(TEST_SEED);
+	uint8_t firstFrame[SMART_BMS_FRAME_SIZE];
+	uint8_t secondFrame[SMART_BMS_FRAME_SIZE];
+	for (size_t i = 0; i < 1000; i++)
+	{
+		first.generate(firstFrame);
+		second.generate(secondFrame);
+		TEST_ASSERT_EQUAL_MEMORY(firstFrame, secondFrame, SMART_BMS_FRAME_SIZE);
+	}
+}
+
+int main()
+{
+	UNITY_BEGIN();
+	RUN_TEST(test_long_runs_stay_plausible);
+	RUN_TEST(test_soc_follows_the_remaining_energy);
+	RUN_TEST(test_same_seed_gives_same_frames);
+	return UNITY_END();
+}
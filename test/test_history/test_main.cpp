@@ -0,0 +1,112 @@
+#include <stdint.h>
+#include <vector>
+#include <unity.h>
+
+#include "bms/SmartBmsData.h"
+#include "bms/SmartBmsHistory.h"
+
+#define TEST_CAPACITY 8
+
+/**
+ * @brief Collect the timestamps of the visited records.
+ * @param record visited record
+ * @param context vector of timestamps
+ * @return true to continue
+ */
+static bool collectRecord(const SmartBmsHistoryRecord *record, void *context)
+{
+	static_cast<std::vector<uint32_t> *>(context)->push_back(record->getTimestamp());
+	return true;
+}
+
+/**
+ * @brief Fill a history with records that are one second apart.
+ * @param history history to fill
+ * @param first timestamp of the first record
+ * @param count number of records
+ */
+static void fillHistory(SmartBmsHistory *history, const uint32_t first, const size_t count)
+{
+	SmartBmsData smartBmsData;
+	for (size_t i = 0; i < count; i++)
+	{
+		history->add(smartBmsData, first + i * 1000);
+	}
+}
+
+/**
+ * @brief Visit a range and collect the timestamps.
+ * @param history history to visit
+ * @param from start of the range
+ * @param to end of the range
+ * @param interval minimum time between two records
+ * @return timestamps of the visited records
+ */
+static std::vector<uint32_t> visit(const SmartBmsHistory &history, const uint32_t from, const uint32_t to, const uint32_t interval)
+{
+	std::vector<uint32_t> timestamps;
+	TEST_ASSERT_EQUAL(history.forEach(from, to, interval, collectRecord, &timestamps), timestamps.size());
+	return timestamps;
+}
+
+void setUp()
+{
+}
+
+void tearDown()
+{
+}
+
+void test_range_before_the_oldest_record_is_empty()
+{
+	SmartBmsHistoryRecord records[TEST_CAPACITY];
+	SmartBmsHistory history(records, TEST_CAPACITY);
+	TEST_ASSERT_EQUAL(0, visit(history, 0, 10000, 0).size());
+
+	fillHistory(&history, 10000, 4);
+	TEST_ASSERT_EQUAL(0, visit(history, 0, 9999, 0).size());
+	TEST_ASSERT_EQUAL(0, visit(history, 5000, 5000, 0).size());
+
+	// The boundaries are inclusive
+	const std::vector<uint32_t> first = visit(history, 0, 10000, 0);
+	TEST_ASSERT_EQUAL(1, first.size());
+	TEST_ASSERT_EQUAL(10000, first[0]);
+	const std::vector<uint32_t> last = visit(history, 13000, 20000, 0);
+	TEST_ASSERT_EQUAL(1, last.size());
+	TEST_ASSERT_EQUAL(13000, last[0]);
+}
+
+void test_range_after_the_newest_record_is_empty()
+{
+	SmartBmsHistoryRecord records[TEST_CAPACITY];
+	SmartBmsHistory history(records, TEST_CAPACITY);
+	fillHistory(&history, 10000, 4);
+	TEST_ASSERT_EQUAL(0, visit(history, 13001, 20000, 0).size());
+	TEST_ASSERT_EQUAL(0, visit(history, 12000, 11000, 0).size());
+}
+
+void test_range_after_overwrite_and_wrap_around()
+{
+	// The oldest records are overwritten and the timestamps wrap around in the middle of the history
+	SmartBmsHistoryRecord records[TEST_CAPACITY];
+	SmartBmsHistory history(records, TEST_CAPACITY);
+	fillHistory(&history, UINT32_MAX - 9999, TEST_CAPACITY + 4);
+	TEST_ASSERT_EQUAL(TEST_CAPACITY, history.size());
+	const uint32_t oldest = history.get(0)->getTimestamp();
+	TEST_ASSERT_EQUAL(UINT32_MAX - 5999, oldest);
+
+	TEST_ASSERT_EQUAL(0, visit(history, oldest - 5000, oldest - 1, 0).size());
+	TEST_ASSERT_EQUAL(TEST_CAPACITY, visit(history, oldest - 5000, oldest + 7000, 0).size());
+	const std::vector<uint32_t> sampled = visit(history, oldest, oldest + 7000, 2000);
+	TEST_ASSERT_EQUAL(4, sampled.size());
+	TEST_ASSERT_EQUAL(oldest + 6000, sampled[3]);
+}
+
+int main()
+{
+	UNITY_BEGIN();
+	RUN_TEST(test_range_before_the_oldest_record_is_empty);
+	RUN_TEST(test_range_after_the_newest_record_is_empty);
+	RUN_TEST(test_range_after_overwrite_and_wrap_around);
+	return UNITY_END();
+}
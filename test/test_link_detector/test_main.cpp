@@ -0,0 +1,141 @@
+#include <stdint.h>
+#include <string.h>
+#include <vector>
+#include <unity.h>
+
+#include "bms/SmartBmsLinkDetector.h"
+#include "host/SmartBmsFrameGenerator.h"
+
+#define TEST_SEED_COUNT 4
+#define TEST_FRAME_COUNT 4
+#define TEST_NOISE_SIZE 200000
+
+/**
+ * @brief Create a sample of a link that starts somewhere in a frame.
+ * @param seed seed of the frames
+ * @param offset number of bytes of the cut off frame in front of the first complete frame
+ * @param polarity polarity of the link
+ * @param frames receives the complete frames
+ * @return sampled bytes
+ */
+static std::vector<uint8_t> makeSample(const uint32_t seed, const uint8_t offset, const SmartBmsLinkPolarity polarity, std::vector<uint8_t> *frames)
+{
+	SmartBmsFrameGenerator generator(seed);
+	uint8_t frame[SMART_BMS_FRAME_SIZE];
+	generator.generate(frame);
+	frames->resize(TEST_FRAME_COUNT * SMART_BMS_FRAME_SIZE);
+	generator.generate(frames->data(), TEST_FRAME_COUNT);
+
+	std::vector<uint8_t> sample(frame + SMART_BMS_FRAME_SIZE - offset, frame + SMART_BMS_FRAME_SIZE);
+	sample.insert(sample.end(), frames->begin(), frames->end());
+	for (size_t i = 0; polarity == SmartBmsLinkPolarity::SBMS_LINK_INVERTED && i < sample.size(); i++)
+	{
+		sample[i] = ~sample[i];
+	}
+	return sample;
+}
+
+void setUp()
+{
+}
+
+void tearDown()
+{
+}
+
+void test_every_alignment_and_polarity_locks()
+{
+	std::vector<uint8_t> frames;
+	for (uint32_t seed = 1; seed <= TEST_SEED_COUNT; seed++)
+	{
+		for (uint8_t polarity = 0; polarity < SBMS_LINK_POLARITY_COUNT; polarity++)
+		{
+			for (uint8_t offset = 0; offset < SMART_BMS_FRAME_SIZE; offset++)
+			{
+				const std::vector<uint8_t> sample = makeSample(seed * SMART_BMS_FRAME_SIZE + offset, offset, static_cast<SmartBmsLinkPolarity>(polarity), &frames);
+				SmartBmsLinkDetector detector;
+				size_t consumed = 0;
+				TEST_ASSERT_EQUAL(SmartBmsLinkState::SBMS_LINK_LOCKED, detector.feed(sample.data(), sample.size(), &consumed));
+				TEST_ASSERT_EQUAL(polarity, detector.getPolarity());
+				TEST_ASSERT_EQUAL(offset, detector.getAlignment());
+
+				// The link locks with the end of the second complete frame, which is kept in its original polarity
+				TEST_ASSERT_EQUAL(offset + SMART_BMS_LINK_LOCK_FRAME_COUNT * SMART_BMS_FRAME_SIZE, consumed);
+				TEST_ASSERT_EQUAL(consumed, detector.getSampledByteCount());
+				const uint8_t *lockingFrame = &frames[(SMART_BMS_LINK_LOCK_FRAME_COUNT - 1) * SMART_BMS_FRAME_SIZE];
+				TEST_ASSERT_EQUAL(0, memcmp(lockingFrame, detector.getFrame().getFrame(), SMART_BMS_FRAME_SIZE));
+			}
+		}
+	}
+}
+
+void test_sample_can_arrive_in_small_chunks()
+{
+	std::vector<uint8_t> frames;
+	const std::vector<uint8_t> sample = makeSample(1, 23, SmartBmsLinkPolarity::SBMS_LINK_INVERTED, &frames);
+	SmartBmsLinkDetector detector;
+	size_t offset = 0;
+	while (offset < sample.size() && detector.getState() == SmartBmsLinkState::SBMS_LINK_SEARCHING)
+	{
+		size_t consumed = 0;
+		detector.feed(&sample[offset], sample.size() - offset < 5 ? sample.size() - offset : 5, &consumed);
+		offset += consumed;
+	}
+	TEST_ASSERT_EQUAL(SmartBmsLinkState::SBMS_LINK_LOCKED, detector.getState());
+	TEST_ASSERT_EQUAL(SmartBmsLinkPolarity::SBMS_LINK_INVERTED, detector.getPolarity());
+	TEST_ASSERT_EQUAL(23, detector.getAlignment());
+	TEST_ASSERT_EQUAL(23 + SMART_BMS_LINK_LOCK_FRAME_COUNT * SMART_BMS_FRAME_SIZE, offset);
+
+	// A locked detector uses no more bytes until it is reset
+	size_t consumed = 1;
+	TEST_ASSERT_EQUAL(SmartBmsLinkState::SBMS_LINK_LOCKED, detector.feed(sample.data(), sample.size(), &consumed));
+	TEST_ASSERT_EQUAL(0, consumed);
+	detector.reset();
+	TEST_ASSERT_EQUAL(SmartBmsLinkState::SBMS_LINK_SEARCHING, detector.getState());
+	TEST_ASSERT_EQUAL(0, detector.getSampledByteCount());
+}
+
+void test_random_bytes_never_lock()
+{
+	// The checksum alone matches one window in 256, the plausibility check has to reject them
+	SmartBmsFrameGenerator noise(0xC0FFEE);
+	std::vector<uint8_t> noiseStream(TEST_NOISE_SIZE);
+	for (size_t i = 0; i < noiseStream.size(); i++)
+	{
+		noiseStream[i] = noise.nextRandom() >> 24;
+	}
+	SmartBmsLinkDetector detector;
+	size_t consumed = 0;
+	TEST_ASSERT_EQUAL(SmartBmsLinkState::SBMS_LINK_SEARCHING, detector.feed(noiseStream.data(), noiseStream.size(), &consumed));
+	TEST_ASSERT_EQUAL(noiseStream.size(), consumed);
+	TEST_ASSERT_GREATER_THAN(0, detector.getRejectedFrameCount());
+}
+
+void test_frames_after_noise_lock()
+{
+	// Garbage while the BMS powers up is followed by frames, the alignment follows the garbage
+	SmartBmsFrameGenerator noise(0xC0FFEE);
+	std::vector<uint8_t> sample(1000);
+	for (size_t i = 0; i < sample.size(); i++)
+	{
+		sample[i] = noise.nextRandom() >> 24;
+	}
+	std::vector<uint8_t> frames;
+	makeSample(7, 0, SmartBmsLinkPolarity::SBMS_LINK_NORMAL, &frames);
+	sample.insert(sample.end(), frames.begin(), frames.end());
+
+	SmartBmsLinkDetector detector;
+	TEST_ASSERT_EQUAL(SmartBmsLinkState::SBMS_LINK_LOCKED, detector.feed(sample.data(), sample.size()));
+	TEST_ASSERT_EQUAL(SmartBmsLinkPolarity::SBMS_LINK_NORMAL, detector.getPolarity());
+	TEST_ASSERT_EQUAL(1000 % SMART_BMS_FRAME_SIZE, detector.getAlignment());
+}
+
+int main()
+{
+	UNITY_BEGIN();
+	RUN_TEST(test_every_alignment_and_polarity_locks);
+	RUN_TEST(test_sample_can_arrive_in_small_chunks);
+	RUN_TEST(test_random_bytes_never_lock);
+	RUN_TEST(test_frames_after_noise_lock);
+	return UNITY_END();
+}
@@ -0,0 +1,356 @@
+#include <stdint.h>
+#include <string.h>
+#include <vector>
+#include <unity.h>
+
+#include "bms/SmartBmsData.h"
+#include "bms/SmartBmsFrameView.h"
+#include "bms/SmartBmsLog.h"
+#include "bms/SmartBmsLogStorage.h"
+#include "host/SmartBmsFrameGenerator.h"
+
+#define TEST_SEED 0x5EED
+#define TEST_MAX_STORAGE_SIZE 4096
+
+// A storage that is full except for one block holds more records than this, so at least this many of the newest records are always kept
+#define TEST_MIN_KEPT_RECORD_COUNT 150
+
+/**
+ * @brief Storage in memory that can simulate a power loss in the middle of a write.
+ */
+class MemoryLogStorage : public SmartBmsLogStorage
+{
+public:
+	MemoryLogStorage()
+	{
+		this->remainingBytes_ = SIZE_MAX;
+	}
+
+	// After the given number of bytes nothing is written anymore, like after a power loss
+	void cutPowerAfter(const size_t byteCount)
+	{
+		this->remainingBytes_ = byteCount;
+	}
+
+	std::vector<uint8_t> &getData()
+	{
+		return this->data_;
+	}
+
+	const size_t getSize() override
+	{
+		return this->data_.size();
+	}
+
+	const bool read(const size_t offset, uint8_t *buffer, const size_t length) override
+	{
+		if (offset + length > this->data_.size())
+		{
+			return false;
+		}
+		memcpy(buffer, &this->data_[offset], length);
+		return true;
+	}
+
+	const bool append(const uint8_t *buffer, const size_t length) override
+	{
+		const size_t written = length < this->remainingBytes_ ? length : this->remainingBytes_;
+		this->data_.insert(this->data_.end(), buffer, buffer + written);
+		this->remainingBytes_ = this->remainingBytes_ == SIZE_MAX ? SIZE_MAX : this->remainingBytes_ - written;
+		return written == length;
+	}
+
+	const bool truncate(const size_t size) override
+	{
+		if (this->remainingBytes_ != SIZE_MAX && this->remainingBytes_ == 0)
+		{
+			return false;
+		}
+		this->data_.resize(size < this->data_.size() ? size : this->data_.size());
+		return true;
+	}
+
+	const bool sync() override
+	{
+		return this->remainingBytes_ == SIZE_MAX || this->remainingBytes_ > 0;
+	}
+
+private:
+	std::vector<uint8_t> data_;
+	size_t remainingBytes_;
+};
+
+struct TestRecord
+{
+	uint32_t timestamp;
+	int32_t packVoltage;
+	int32_t packCurrent;
+};
+
+/**
+ * @brief Collect the records of a log.
+ * @param smartBmsData data of the record
+ * @param timestamp time of the record
+ * @param context vector of records
+ * @return true to continue
+ */
+static bool collectRecord(const SmartBmsData *smartBmsData, const uint32_t timestamp, void *context)
+{
+	const TestRecord record = {timestamp, smartBmsData->getRawValue(SBMS_FIELD_PACK_VOLTAGE), smartBmsData->getRawValue(SBMS_FIELD_PACK_CURRENT)};
+	static_cast<std::vector<TestRecord> *>(context)->push_back(record);
+	return true;
+}
+
+/**
+ * @brief Append generated frames to a log.
+ * @param log log to append to
+ * @param generator generator of the frames
+ * @param first timestamp of the first frame
+ * @param count number of frames
+ * @param records receives the appended records
+ */
+static void appendFrames(SmartBmsLog *log, SmartBmsFrameGenerator *generator, const uint32_t first, const size_t count, std::vector<TestRecord> *records)
+{
+	uint8_t frame[SMART_BMS_FRAME_SIZE];
+	for (size_t i = 0; i < count; i++)
+	{
+		generator->generate(frame);
+		SmartBmsData smartBmsData;
+		SmartBmsFrameView(frame).decode(&smartBmsData);
+		log->append(smartBmsData, first + i * 1000);
+		collectRecord(&smartBmsData, first + i * 1000, records);
+	}
+}
+
+/**
+ * @brief Check that the records of a log are the expected ones.
+ * @param log log to read
+ * @param expected expected records
+ */
+static void checkRecords(SmartBmsLog *log, const std::vector<TestRecord> &expected)
+{
+	std::vector<TestRecord> records;
+	TEST_ASSERT_EQUAL(SmartBmsError::SBMS_OK, log->forEach(collectRecord, &records));
+	TEST_ASSERT_EQUAL(expected.size(), records.size());
+	for (size_t i = 0; i < records.size(); i++)
+	{
+		TEST_ASSERT_EQUAL(expected[i].timestamp, records[i].timestamp);
+		TEST_ASSERT_EQUAL(expected[i].packVoltage, records[i].packVoltage);
+		TEST_ASSERT_EQUAL(expected[i].packCurrent, records[i].packCurrent);
+	}
+}
+
+void setUp()
+{
+}
+
+void tearDown()
+{
+}
+
+void test_records_survive_a_restart()
+{
+	MemoryLogStorage storages[2];
+	SmartBmsFrameGenerator generator(TEST_SEED);
+	std::vector<TestRecord> expected;
+	{
+		SmartBmsLog log(&storages[0], &storages[1], TEST_MAX_STORAGE_SIZE);
+		TEST_ASSERT_EQUAL(SmartBmsError::SBMS_OK, log.begin());
+		appendFrames(&log, &generator, 1000, 300, &expected);
+		TEST_ASSERT_EQUAL(SmartBmsError::SBMS_OK, log.flush());
+		checkRecords(&log, expected);
+	}
+
+	SmartBmsLog log(&storages[0], &storages[1], TEST_MAX_STORAGE_SIZE);
+	TEST_ASSERT_EQUAL(SmartBmsError::SBMS_OK, log.begin());
+	TEST_ASSERT_EQUAL(0, log.getTruncatedByteCount());
+	TEST_ASSERT_EQUAL(300, log.getRecordCount());
+	checkRecords(&log, expected);
+}
+
+void test_power_loss_during_a_write_keeps_the_older_blocks()
+{
+	// A cut at any position within the block must be recovered
+	for (size_t cut = 0; cut < 64; cut++)
+	{
+		MemoryLogStorage storages[2];
+		SmartBmsFrameGenerator generator(TEST_SEED);
+		std::vector<TestRecord> expected;
+		{
+			SmartBmsLog log(&storages[0], &storages[1], TEST_MAX_STORAGE_SIZE);
+			TEST_ASSERT_EQUAL(SmartBmsError::SBMS_OK, log.begin());
+			appendFrames(&log, &generator, 1000, 50, &expected);
+			TEST_ASSERT_EQUAL(SmartBmsError::SBMS_OK, log.flush());
+
+			// The power is cut while the next block is written, the truncate after the failed write does not happen either
+			std::vector<TestRecord> lost;
+			appendFrames(&log, &generator, 51000, 20, &lost);
+			storages[0].cutPowerAfter(cut * 7 % 100 + 1);
+			TEST_ASSERT_EQUAL(SmartBmsError::SBMS_ERR_STORAGE, log.flush());
+		}
+
+		// After the restart the partial block is gone and the older records are complete
+		const size_t size = storages[0].getSize();
+		storages[0].cutPowerAfter(SIZE_MAX);
+		SmartBmsLog log(&storages[0], &storages[1], TEST_MAX_STORAGE_SIZE);
+		TEST_ASSERT_EQUAL(SmartBmsError::SBMS_OK, log.begin());
+		TEST_ASSERT_GREATER_THAN(0, log.getTruncatedByteCount());
+		TEST_ASSERT_EQUAL(size - log.getTruncatedByteCount(), storages[0].getSize());
+		TEST_ASSERT_EQUAL(50, log.getRecordCount());
+		checkRecords(&log, expected);
+
+		// The log continues behind the last valid block
+		appendFrames(&log, &generator, 80000, 10, &expected);
+		TEST_ASSERT_EQUAL(SmartBmsError::SBMS_OK, log.flush());
+		checkRecords(&log, expected);
+	}
+}
+
+void test_damaged_block_is_dropped()
+{
+	MemoryLogStorage storages[2];
+	SmartBmsFrameGenerator generator(TEST_SEED);
+	std::vector<TestRecord> expected;
+	{
+		SmartBmsLog log(&storages[0], &storages[1], TEST_MAX_STORAGE_SIZE);
+		TEST_ASSERT_EQUAL(SmartBmsError::SBMS_OK, log.begin());
+		appendFrames(&log, &generator, 1000, 20, &expected);
+		TEST_ASSERT_EQUAL(SmartBmsError::SBMS_OK, log.flush());
+		const size_t size = storages[0].getSize();
+		std::vector<TestRecord> lost;
+		appendFrames(&log, &generator, 21000, 20, &lost);
+		TEST_ASSERT_EQUAL(SmartBmsError::SBMS_OK, log.flush());
+		storages[0].getData()[size + SMART_BMS_LOG_HEADER_SIZE + 3] ^= 0x01;
+	}
+
+	SmartBmsLog log(&storages[0], &storages[1], TEST_MAX_STORAGE_SIZE);
+	TEST_ASSERT_EQUAL(SmartBmsError::SBMS_OK, log.begin());
+	TEST_ASSERT_GREATER_THAN(0, log.getTruncatedByteCount());
+	checkRecords(&log, expected);
+}
+
+void test_size_is_limited_and_the_newest_records_are_kept()
+{
+	MemoryLogStorage storages[2];
+	SmartBmsFrameGenerator generator(TEST_SEED);
+	std::vector<TestRecord> appended;
+	SmartBmsLog log(&storages[0], &storages[1], TEST_MAX_STORAGE_SIZE);
+	TEST_ASSERT_EQUAL(SmartBmsError::SBMS_OK, log.begin());
+	for (size_t i = 0; i < 100; i++)
+	{
+		appendFrames(&log, &generator, 1000 + i * 30000, 30, &appended);
+		TEST_ASSERT_EQUAL(SmartBmsError::SBMS_OK, log.flush());
+		TEST_ASSERT_LESS_OR_EQUAL(TEST_MAX_STORAGE_SIZE, storages[0].getSize());
+		TEST_ASSERT_LESS_OR_EQUAL(TEST_MAX_STORAGE_SIZE, storages[1].getSize());
+	}
+
+	// The log holds a continuous range of the newest records, at least one full storage of them
+	std::vector<TestRecord> records;
+	TEST_ASSERT_EQUAL(SmartBmsError::SBMS_OK, log.forEach(collectRecord, &records));
+	TEST_ASSERT_LESS_THAN(appended.size(), records.size());
+	TEST_ASSERT_EQUAL(log.getRecordCount(), records.size());
+	const std::vector<TestRecord> expected(appended.end() - records.size(), appended.end());
+	checkRecords(&log, expected);
+	TEST_ASSERT_GREATER_OR_EQUAL(TEST_MAX_STORAGE_SIZE - SMART_BMS_LOG_BLOCK_SIZE, storages[0].getSize() + storages[1].getSize());
+
+	// After a restart the log continues with the storage that has the newer records
+	SmartBmsLog restarted(&storages[0], &storages[1], TEST_MAX_STORAGE_SIZE);
+	TEST_ASSERT_EQUAL(SmartBmsError::SBMS_OK, restarted.begin());
+	checkRecords(&restarted, expected);
+	std::vector<TestRecord> continued(expected);
+	for (size_t i = 0; i < 20; i++)
+	{
+		appendFrames(&restarted, &generator, 4000000 + i * 30000, 30, &continued);
+		TEST_ASSERT_EQUAL(SmartBmsError::SBMS_OK, restarted.flush());
+	}
+	std::vector<TestRecord> newest;
+	TEST_ASSERT_EQUAL(SmartBmsError::SBMS_OK, restarted.forEach(collectRecord, &newest));
+	checkRecords(&restarted, std::vector<TestRecord>(continued.end() - newest.size(), continued.end()));
+}
+
+void test_newest_records_are_kept_when_the_timestamps_restart()
+{
+	// Every boot starts the clock at 0 again, like millis() does on the device
+	const size_t bootRecordCounts[] = {700, 500, 60, 60};
+	MemoryLogStorage storages[2];
+	SmartBmsFrameGenerator generator(TEST_SEED);
+	std::vector<TestRecord> appended;
+	for (size_t i = 0; i < sizeof(bootRecordCounts) / sizeof(bootRecordCounts[0]); i++)
+	{
+		SmartBmsLog log(&storages[0], &storages[1], TEST_MAX_STORAGE_SIZE);
+		TEST_ASSERT_EQUAL(SmartBmsError::SBMS_OK, log.begin());
+		for (size_t j = 0; j < bootRecordCounts[i]; j += 30)
+		{
+			appendFrames(&log, &generator, 1000 + j * 1000, bootRecordCounts[i] - j < 30 ? bootRecordCounts[i] - j : 30, &appended);
+			TEST_ASSERT_EQUAL(SmartBmsError::SBMS_OK, log.flush());
+		}
+
+		// The log holds the newest records in order, including the ones of the previous boot
+		std::vector<TestRecord> records;
+		TEST_ASSERT_EQUAL(SmartBmsError::SBMS_OK, log.forEach(collectRecord, &records));
+		TEST_ASSERT_GREATER_OR_EQUAL(appended.size() < TEST_MIN_KEPT_RECORD_COUNT ? appended.size() : TEST_MIN_KEPT_RECORD_COUNT, records.size());
+		checkRecords(&log, std::vector<TestRecord>(appended.end() - records.size(), appended.end()));
+	}
+}
+
+void test_power_loss_after_clearing_the_other_storage()
+{
+	// The older storage was cleared by the rotation, but the first block in it was never written
+	MemoryLogStorage storages[2];
+	SmartBmsFrameGenerator generator(TEST_SEED);
+	std::vector<TestRecord> expected;
+	{
+		SmartBmsLog log(&storages[0], &storages[1], TEST_MAX_STORAGE_SIZE);
+		TEST_ASSERT_EQUAL(SmartBmsError::SBMS_OK, log.begin());
+		while (storages[1].getSize() == 0)
+		{
+			appendFrames(&log, &generator, 1000 + expected.size() * 1000, 30, &expected);
+			TEST_ASSERT_EQUAL(SmartBmsError::SBMS_OK, log.flush());
+		}
+		while (storages[0].getSize() + SMART_BMS_LOG_BLOCK_SIZE <= TEST_MAX_STORAGE_SIZE || storages[1].getSize() + SMART_BMS_LOG_BLOCK_SIZE <= TEST_MAX_STORAGE_SIZE)
+		{
+			appendFrames(&log, &generator, 1000 + expected.size() * 1000, 30, &expected);
+			TEST_ASSERT_EQUAL(SmartBmsError::SBMS_OK, log.flush());
+		}
+	}
+	std::vector<TestRecord> before;
+	{
+		SmartBmsLog log(&storages[0], &storages[1], TEST_MAX_STORAGE_SIZE);
+		TEST_ASSERT_EQUAL(SmartBmsError::SBMS_OK, log.begin());
+		TEST_ASSERT_EQUAL(SmartBmsError::SBMS_OK, log.forEach(collectRecord, &before));
+	}
+
+	// Clear the storage with the older records, like the rotation does before its first write
+	uint32_t firstTimestamps[2];
+	for (size_t i = 0; i < 2; i++)
+	{
+		firstTimestamps[i] = storages[i].getData()[8] | (storages[i].getData()[9] << 8) | (storages[i].getData()[10] << 16) | (storages[i].getData()[11] << 24);
+	}
+	const size_t older = firstTimestamps[0] < firstTimestamps[1] ? 0 : 1;
+	storages[older].truncate(0);
+
+	SmartBmsLog log(&storages[0], &storages[1], TEST_MAX_STORAGE_SIZE);
+	TEST_ASSERT_EQUAL(SmartBmsError::SBMS_OK, log.begin());
+	std::vector<TestRecord> after;
+	TEST_ASSERT_EQUAL(SmartBmsError::SBMS_OK, log.forEach(collectRecord, &after));
+	TEST_ASSERT_GREATER_THAN(0, after.size());
+	checkRecords(&log, std::vector<TestRecord>(before.end() - after.size(), before.end()));
+
+	// The next block goes into the cleared storage, the newer records are kept
+	std::vector<TestRecord> continued(after);
+	appendFrames(&log, &generator, 10000000, 30, &continued);
+	TEST_ASSERT_EQUAL(SmartBmsError::SBMS_OK, log.flush());
+	checkRecords(&log, continued);
+}
+
+int main()
+{
+	UNITY_BEGIN();
+	RUN_TEST(test_records_survive_a_restart);
+	RUN_TEST(test_power_loss_during_a_write_keeps_the_older_blocks);
+	RUN_TEST(test_damaged_block_is_dropped);
+	RUN_TEST(test_size_is_limited_and_the_newest_records_are_kept);
+	RUN_TEST(test_newest_records_are_kept_when_the_timestamps_restart);
+	RUN_TEST(test_power_loss_after_clearing_the_other_storage);
+	return UNITY_END();
+}
@@ -0,0 +1,137 @@
+#include <stdint.h>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <unity.h>
+
+#include "bms/SmartBmsData.h"
+#include "bms/SmartBmsFrameView.h"
+#include "bms/SmartBmsPublisher.h"
+#include "host/SmartBmsFrameGenerator.h"
+
+#define TEST_PUBLICATION_COUNT 1024
+#define TEST_SNAPSHOT_COUNT 200000
+#define TEST_READER_COUNT 3
+
+/**
+ * @brief Create data where several fields at both ends of SmartBmsData carry the same number.
+ * @param number number of the publication
+ * @param smartBmsData reference to a SmartBmsData object that will receive the data
+ */
+static void makeData(const uint32_t number, SmartBmsData *smartBmsData)
+{
+	uint8_t frame[SMART_BMS_FRAME_SIZE] = {};
+	const int32_t value = number & 0xFFFF;
+	SmartBmsFrameGenerator::encodeRawValue(frame, SBMS_FIELD_CELL_COUNT, number & 0xFF);
+	SmartBmsFrameGenerator::encodeRawValue(frame, SBMS_FIELD_PACK_VOLTAGE, value);
+	SmartBmsFrameGenerator::encodeRawValue(frame, SBMS_FIELD_PACK_REMAINING_ENERGY, value);
+	SmartBmsFrameGenerator::encodeRawValue(frame, SBMS_FIELD_HIGHEST_CELL_TEMPERATURE, value);
+	SmartBmsFrameGenerator::updateChecksum(frame);
+	SmartBmsFrameView(frame, number).decode(smartBmsData);
+}
+
+/**
+ * @brief Check if all fields of a copy belong to the same publication.
+ * @param smartBmsData copy to check
+ * @return true when the copy is consistent
+ */
+static const bool isConsistent(const SmartBmsData &smartBmsData)
+{
+	const uint32_t number = smartBmsData.getTimestamp();
+	const int32_t value = number & 0xFFFF;
+	return smartBmsData.getRawValue(SBMS_FIELD_CELL_COUNT) == static_cast<int32_t>(number & 0xFF) &&
+		   smartBmsData.getRawValue(SBMS_FIELD_PACK_VOLTAGE) == value &&
+		   smartBmsData.getRawValue(SBMS_FIELD_PACK_REMAINING_ENERGY) == value &&
+		   smartBmsData.getRawValue(SBMS_FIELD_HIGHEST_CELL_TEMPERATURE) == value;
+}
+
+void setUp()
+{
+}
+
+void tearDown()
+{
+}
+
+void test_snapshot_before_first_publication()
+{
+	SmartBmsPublisher publisher;
+	SmartBmsData smartBmsData;
+	TEST_ASSERT_FALSE(publisher.getSnapshot(&smartBmsData));
+	TEST_ASSERT_EQUAL(0, publisher.getVersion());
+
+	SmartBmsData published;
+	makeData(7, &published);
+	publisher.publish(published);
+	TEST_ASSERT_TRUE(publisher.getSnapshot(&smartBmsData));
+	TEST_ASSERT_EQUAL(7, smartBmsData.getTimestamp());
+	TEST_ASSERT_EQUAL(1, publisher.getVersion());
+}
+
+void test_no_torn_reads()
+{
+	// The writer publishes as fast as it can, which is far more often than the BMS sends frames
+	std::vector<SmartBmsData> publications(TEST_PUBLICATION_COUNT);
+	for (uint32_t i = 0; i < TEST_PUBLICATION_COUNT; i++)
+	{
+		makeData(i + 1, &publications[i]);
+	}
+	SmartBmsPublisher publisher;
+	publisher.publish(publications[0]);
+	std::atomic<bool> done(false);
+	std::atomic<uint32_t> publicationCount(1);
+	std::thread writer([&publisher, &publications, &done, &publicationCount]() {
+		for (uint32_t i = 1; !done.load(std::memory_order_acquire); i++)
+		{
+			publisher.publish(publications[i % TEST_PUBLICATION_COUNT]);
+			publicationCount.store(i + 1, std::memory_order_relaxed);
+		}
+	});
+
+	// A snapshot may fail under this load, but a snapshot that succeeds must never mix two publications
+	std::atomic<uint32_t> snapshotCount(0);
+	std::atomic<uint32_t> failedCount(0);
+	std::atomic<uint32_t> tornCount(0);
+	std::vector<std::thread> readers;
+	for (uint8_t i = 0; i < TEST_READER_COUNT; i++)
+	{
+		readers.push_back(std::thread([&publisher, &snapshotCount, &failedCount, &tornCount]() {
+			SmartBmsData smartBmsData;
+			for (uint32_t j = 0; j < TEST_SNAPSHOT_COUNT; j++)
+			{
+				if (!publisher.getSnapshot(&smartBmsData))
+				{
+					failedCount.fetch_add(1, std::memory_order_relaxed);
+					continue;
+				}
+				snapshotCount.fetch_add(1, std::memory_order_relaxed);
+				tornCount.fetch_add(isConsistent(smartBmsData) ? 0 : 1, std::memory_order_relaxed);
+			}
+		}));
+	}
+	for (size_t i = 0; i < readers.size(); i++)
+	{
+		readers[i].join();
+	}
+	done.store(true, std::memory_order_release);
+	writer.join();
+
+	TEST_ASSERT_GREATER_THAN(0, snapshotCount.load());
+	TEST_ASSERT_EQUAL(0, tornCount.load());
+	TEST_ASSERT_EQUAL(TEST_READER_COUNT * TEST_SNAPSHOT_COUNT, snapshotCount.load() + failedCount.load());
+
+	// Once the writer is done, every snapshot succeeds with the last publication
+	SmartBmsData smartBmsData;
+	const uint32_t last = publicationCount.load() - 1;
+	TEST_ASSERT_TRUE(publisher.getSnapshot(&smartBmsData));
+	TEST_ASSERT_EQUAL(last % TEST_PUBLICATION_COUNT + 1, smartBmsData.getTimestamp());
+	TEST_ASSERT_EQUAL(last + 1, publisher.getVersion());
+}
+
+int main()
+{
+	UNITY_BEGIN();
+	RUN_TEST(test_snapshot_before_first_publication);
+	RUN_TEST(test_no_torn_reads);
+	return UNITY_END();
+}
@@ -0,0 +1,157 @@
+#include <stdint.h>
+#include <atomic>
+#include <thread>
+#include <unity.h>
+
+#include "bms/SmartBmsFrameView.h"
+#include "bms/SmartBmsQueue.h"
+#include "bms/SmartBmsReader.h"
+#include "host/SmartBmsFrameGenerator.h"
+
+#define TEST_CAPACITY 16
+#define TEST_ITEM_COUNT 1000000
+#define TEST_FRAME_COUNT 100000
+
+typedef SmartBmsQueue<uint32_t, TEST_CAPACITY> TestQueue;
+
+void setUp()
+{
+}
+
+void tearDown()
+{
+}
+
+void test_items_are_popped_in_order()
+{
+	TestQueue queue;
+	uint32_t item = 0;
+	TEST_ASSERT_FALSE(queue.pop(&item));
+	for (uint32_t i = 0; i < 10; i++)
+	{
+		TEST_ASSERT_TRUE(queue.push(i));
+	}
+	TEST_ASSERT_EQUAL(10, queue.size());
+	for (uint32_t i = 0; i < 10; i++)
+	{
+		TEST_ASSERT_TRUE(queue.pop(&item));
+		TEST_ASSERT_EQUAL(i, item);
+	}
+	TEST_ASSERT_FALSE(queue.pop(&item));
+	TEST_ASSERT_EQUAL(0, queue.size());
+}
+
+void test_full_queue_drops_and_counts_new_items()
+{
+	TestQueue queue;
+	for (uint32_t i = 0; i < TEST_CAPACITY; i++)
+	{
+		TEST_ASSERT_TRUE(queue.push(i));
+	}
+	TEST_ASSERT_FALSE(queue.push(100));
+	TEST_ASSERT_FALSE(queue.push(101));
+	TEST_ASSERT_EQUAL(2, queue.getDroppedCount());
+	TEST_ASSERT_EQUAL(TEST_CAPACITY, queue.size());
+
+	// The items that were in the queue are kept, the dropped ones never show up
+	uint32_t item = 0;
+	for (uint32_t i = 0; i < TEST_CAPACITY; i++)
+	{
+		TEST_ASSERT_TRUE(queue.pop(&item));
+		TEST_ASSERT_EQUAL(i, item);
+	}
+	TEST_ASSERT_TRUE(queue.push(102));
+	TEST_ASSERT_TRUE(queue.pop(&item));
+	TEST_ASSERT_EQUAL(102, item);
+	TEST_ASSERT_EQUAL(2, queue.getDroppedCount());
+}
+
+void test_producer_and_consumer_on_separate_threads()
+{
+	// The producer pushes a sequence as fast as it can, so the small queue overflows every now and then
+	TestQueue queue;
+	std::atomic<bool> done(false);
+	uint32_t pushedCount = 0;
+	std::thread producer([&queue, &done, &pushedCount]() {
+		for (uint32_t i = 0; i < TEST_ITEM_COUNT; i++)
+		{
+			pushedCount += queue.push(i) ? 1 : 0;
+		}
+		done.store(true, std::memory_order_release);
+	});
+
+	// Items may be missing, but the ones that arrive must be strictly increasing
+	uint32_t poppedCount = 0;
+	uint32_t outOfOrderCount = 0;
+	int64_t previous = -1;
+	uint32_t item = 0;
+	while (true)
+	{
+		const bool finished = done.load(std::memory_order_acquire);
+		while (queue.pop(&item))
+		{
+			outOfOrderCount += static_cast<int64_t>(item) > previous ? 0 : 1;
+			previous = item;
+			poppedCount++;
+		}
+		if (finished)
+		{
+			break;
+		}
+	}
+	producer.join();
+
+	TEST_ASSERT_EQUAL(0, outOfOrderCount);
+	TEST_ASSERT_EQUAL(pushedCount, poppedCount);
+	TEST_ASSERT_EQUAL(TEST_ITEM_COUNT, pushedCount + queue.getDroppedCount());
+	TEST_ASSERT_EQUAL(0, queue.size());
+}
+
+void test_frames_are_not_torn()
+{
+	// Frames are much larger than a word, a frame read while it is written would break its checksum
+	SmartBmsQueue<SmartBmsFrameView, TEST_CAPACITY> queue;
+	std::atomic<bool> done(false);
+	std::thread producer([&queue, &done]() {
+		SmartBmsFrameGenerator generator(1);
+		uint8_t frame[SMART_BMS_FRAME_SIZE];
+		for (uint32_t i = 0; i < TEST_FRAME_COUNT; i++)
+		{
+			generator.generate(frame);
+			queue.push(SmartBmsFrameView(frame, i));
+		}
+		done.store(true, std::memory_order_release);
+	});
+
+	uint32_t poppedCount = 0;
+	uint32_t tornCount = 0;
+	SmartBmsFrameView frameView;
+	while (true)
+	{
+		const bool finished = done.load(std::memory_order_acquire);
+		while (queue.pop(&frameView))
+		{
+			const uint8_t *frame = frameView.getFrame();
+			tornCount += SmartBmsReader::calculateChecksum(frame, SMART_BMS_FRAME_SIZE - 1) == frame[SMART_BMS_FRAME_SIZE - 1] ? 0 : 1;
+			poppedCount++;
+		}
+		if (finished)
+		{
+			break;
+		}
+	}
+	producer.join();
+
+	TEST_ASSERT_EQUAL(0, tornCount);
+	TEST_ASSERT_EQUAL(TEST_FRAME_COUNT, poppedCount + queue.getDroppedCount());
+}
+
+int main()
+{
+	UNITY_BEGIN();
+	RUN_TEST(test_items_are_popped_in_order);
+	RUN_TEST(test_full_queue_drops_and_counts_new_items);
+	RUN_TEST(test_producer_and_consumer_on_separate_threads);
+	RUN_TEST(test_frames_are_not_torn);
+	return UNITY_END();
+}
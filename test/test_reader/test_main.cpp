@@ -0,0 +1,370 @@
+#include <string.h>
+#include <algorithm>
+#include <vector>
+#include <unity.h>
+
+#include "bms/SmartBmsFrameView.h"
+#include "bms/SmartBmsReader.h"
+#include "host/MemoryStream.h"
+#include "host/SmartBmsFrameGenerator.h"
+#include "host/SmartBmsNoiseInjector.h"
+
+#define TEST_FRAME_COUNT 20000
+#define TEST_SEED 0x5EED
+
+// Accepted frames that are not an original frame, per thousand frames that were hit by noise, rounded up
+// A frame that was corrupted in place still matches the 8 bit checksum once in 256 times, so a profile with few hit frames may see one
+#define TEST_MAX_FALSE_ACCEPTS_PER_MILLE 5
+
+/**
+ * @brief Decode a stream that was corrupted by a noise profile.
+ * @param profile noise profile
+ * @param faultedFrameCount receives the number of frames that were hit by noise
+ * @param deliveredFrameCount receives the number of original frames that were accepted
+ * @return number of accepted frames that are not an original frame
+ */
+static size_t countFalseAccepts(const SmartBmsNoiseProfile &profile, size_t *faultedFrameCount, size_t *deliveredFrameCount)
+{
+	std::vector<uint8_t> frames(TEST_FRAME_COUNT * SMART_BMS_FRAME_SIZE);
+	SmartBmsFrameGenerator generator(TEST_SEED);
+	generator.generate(frames.data(), TEST_FRAME_COUNT);
+
+	SmartBmsNoiseInjector injector(TEST_SEED, profile);
+	std::vector<uint8_t> stream;
+	std::vector<size_t> frameEnds(TEST_FRAME_COUNT);
+	*faultedFrameCount = 0;
+	for (size_t i = 0; i < TEST_FRAME_COUNT; i++)
+	{
+		*faultedFrameCount += injector.inject(&frames[i * SMART_BMS_FRAME_SIZE], SMART_BMS_FRAME_SIZE, &stream) > 0 ? 1 : 0;
+		frameEnds[i] = stream.size();
+	}
+
+	// An accepted frame is correct when it has the content of the original frame its last byte belongs to
+	MemoryStream memoryStream(stream.data(), stream.size());
+	SmartBmsReader smartBmsReader(&memoryStream);
+	SmartBmsFrameView frameView;
+	size_t falseAcceptCount = 0;
+	*deliveredFrameCount = 0;
+	while (memoryStream.available() > 0)
+	{
+		if (smartBmsReader.decodeBmsData(&frameView) != SmartBmsError::SBMS_OK)
+		{
+			continue;
+		}
+		const size_t index = std::lower_bound(frameEnds.begin(), frameEnds.end(), memoryStream.getPosition()) - frameEnds.begin();
+		if (index < TEST_FRAME_COUNT && memcmp(frameView.getFrame(), &frames[index * SMART_BMS_FRAME_SIZE], SMART_BMS_FRAME_SIZE) == 0)
+		{
+			(*deliveredFrameCount)++;
+		}
+		else
+		{
+			falseAcceptCount++;
+		}
+	}
+	return falseAcceptCount;
+}
+
+/**
+ * @brief Check the false accept rate of a noise profile.
+ * @param profile noise profile
+ */
+static void checkProfile(const SmartBmsNoiseProfile &profile)
+{
+	size_t faultedFrameCount = 0;
+	size_t deliveredFrameCount = 0;
+	const size_t falseAcceptCount = countFalseAccepts(profile, &faultedFrameCount, &deliveredFrameCount);
+	TEST_ASSERT_GREATER_THAN(0, faultedFrameCount);
+	TEST_ASSERT_LESS_OR_EQUAL_MESSAGE((faultedFrameCount * TEST_MAX_FALSE_ACCEPTS_PER_MILLE + 999) / 1000, falseAcceptCount, profile.name);
+
+	// Most frames that were not hit must still arrive
+	TEST_ASSERT_GREATER_OR_EQUAL((TEST_FRAME_COUNT - faultedFrameCount) * 9 / 10, deliveredFrameCount);
+}
+
+// Time of the fake clock in µs
+static uint32_t fakeTime = 0;
+
+/**
+ * @brief Clock that returns the time set by the test.
+ * @return fake time in µs
+ */
+static const uint32_t getFakeTime()
+{
+	return fakeTime;
+}
+
+/**
+ * @brief Feed frames to a reader at a given time, as if they were received back to back just now.
+ * @param smartBmsReader reader to feed
+ * @param generator generator of the frames
+ * @param frameCount number of frames
+ * @param time time in µs when the last byte was received
+ */
+static void feedFramesAt(SmartBmsReader *smartBmsReader, SmartBmsFrameGenerator *generator, const size_t frameCount, const uint32_t time)
+{
+	std::vector<uint8_t> frames(frameCount * SMART_BMS_FRAME_SIZE);
+	generator->generate(frames.data(), frameCount);
+	fakeTime = time;
+	SmartBmsFrameView frameView;
+	size_t position = 0;
+	while (position < frames.size())
+	{
+		size_t consumed = 0;
+		TEST_ASSERT_EQUAL(SmartBmsError::SBMS_OK, smartBmsReader->feed(&frames[position], frames.size() - position, &consumed, &frameView));
+		position += consumed;
+	}
+}
+
+void setUp()
+{
+}
+
+void tearDown()
+{
+}
+
+void test_clean_stream_delivers_every_frame()
+{
+	const SmartBmsNoiseProfile profile = {"clean", 0, 0, 0, 0, 0};
+	size_t faultedFrameCount = 0;
+	size_t deliveredFrameCount = 0;
+	TEST_ASSERT_EQUAL(0, countFalseAccepts(profile, &faultedFrameCount, &deliveredFrameCount));
+	TEST_ASSERT_EQUAL(TEST_FRAME_COUNT, deliveredFrameCount);
+}
+
+void test_bit_flip_false_accepts()
+{
+	const SmartBmsNoiseProfile profile = {"bit_flip", 500, 0, 0, 0, 0};
+	checkProfile(profile);
+}
+
+void test_drop_false_accepts()
+{
+	const SmartBmsNoiseProfile profile = {"drop", 0, 500, 0, 0, 0};
+	checkProfile(profile);
+}
+
+void test_duplicate_false_accepts()
+{
+	const SmartBmsNoiseProfile profile = {"duplicate", 0, 0, 500, 0, 0};
+	checkProfile(profile);
+}
+
+void test_burst_false_accepts()
+{
+	const SmartBmsNoiseProfile profile = {"burst", 0, 0, 0, 50, 32};
+	checkProfile(profile);
+}
+
+void test_mixed_false_accepts()
+{
+	const SmartBmsNoiseProfile profile = {"mixed", 200, 200, 200, 20, 32};
+	checkProfile(profile);
+}
+
+void test_implausible_window_is_rejected()
+{
+	// A window with a valid checksum but without cells is not a frame
+	uint8_t frame[SMART_BMS_FRAME_SIZE];
+	SmartBmsFrameGenerator generator(TEST_SEED);
+	generator.generate(frame);
+	SmartBmsFrameGenerator::encodeRawValue(frame, SBMS_FIELD_CELL_COUNT, 0);
+	SmartBmsFrameGenerator::updateChecksum(frame);
+
+	SmartBmsReader smartBmsReader(nullptr);
+	SmartBmsFrameView frameView;
+	size_t consumed = 0;
+	TEST_ASSERT_EQUAL(SmartBmsError::SBMS_ERR_NOT_ENOUGH_DATA, smartBmsReader.feed(frame, SMART_BMS_FRAME_SIZE, &consumed, &frameView));
+
+	// The reader slides on and locks to the next frame
+	generator.generate(frame);
+	TEST_ASSERT_EQUAL(SmartBmsError::SBMS_OK, smartBmsReader.feed(frame, SMART_BMS_FRAME_SIZE, &consumed, &frameView));
+	TEST_ASSERT_EQUAL_MEMORY(frame, frameView.getFrame(), SMART_BMS_FRAME_SIZE);
+}
+
+void test_failed_cell_on_aligned_stream_is_delivered()
+{
+	SmartBmsFrameGenerator generator(TEST_SEED);
+	SmartBmsReader smartBmsReader(nullptr);
+	SmartBmsFrameView frameView;
+	size_t consumed = 0;
+	uint8_t frame[SMART_BMS_FRAME_SIZE];
+	generator.generate(frame);
+	TEST_ASSERT_EQUAL(SmartBmsError::SBMS_OK, smartBmsReader.feed(frame, SMART_BMS_FRAME_SIZE, &consumed, &frameView));
+
+	// A cell at 900 mV is below the plausible range, but the frame directly follows the previous one
+	generator.generate(frame);
+	SmartBmsFrameGenerator::encodeRawValue(frame, SBMS_FIELD_LOWEST_CELL_VOLTAGE, 900 / 5);
+	SmartBmsFrameGenerator::encodeRawValue(frame, SBMS_FIELD_MIN_VOLTAGE_ALARM, 1);
+	SmartBmsFrameGenerator::updateChecksum(frame);
+	TEST_ASSERT_EQUAL(SmartBmsError::SBMS_OK, smartBmsReader.feed(frame, SMART_BMS_FRAME_SIZE, &consumed, &frameView));
+	TEST_ASSERT_EQUAL_MEMORY(frame, frameView.getFrame(), SMART_BMS_FRAME_SIZE);
+	TEST_ASSERT_EQUAL_UINT32(900, frameView.getLowestCellVoltageMillivolts());
+	TEST_ASSERT_TRUE(frameView.isMinVoltageAlarmActive());
+	TEST_ASSERT_EQUAL_UINT32(0, smartBmsReader.getSkippedByteCount());
+}
+
+void test_failed_cell_after_resync_is_rejected()
+{
+	SmartBmsFrameGenerator generator(TEST_SEED);
+	SmartBmsReader smartBmsReader(nullptr);
+	SmartBmsFrameView frameView;
+	size_t consumed = 0;
+	uint8_t frame[SMART_BMS_FRAME_SIZE];
+	generator.generate(frame);
+	TEST_ASSERT_EQUAL(SmartBmsError::SBMS_OK, smartBmsReader.feed(frame, SMART_BMS_FRAME_SIZE, &consumed, &frameView));
+
+	// A lost byte breaks the alignment, so the values of the next candidate must be plausible again
+	generator.generate(frame);
+	TEST_ASSERT_EQUAL(SmartBmsError::SBMS_ERR_NOT_ENOUGH_DATA, smartBmsReader.feed(&frame[1], SMART_BMS_FRAME_SIZE - 1, &consumed, &frameView));
+	generator.generate(frame);
+	SmartBmsFrameGenerator::encodeRawValue(frame, SBMS_FIELD_LOWEST_CELL_VOLTAGE, 900 / 5);
+	SmartBmsFrameGenerator::updateChecksum(frame);
+	TEST_ASSERT_EQUAL(SmartBmsError::SBMS_ERR_NOT_ENOUGH_DATA, smartBmsReader.feed(frame, SMART_BMS_FRAME_SIZE, &consumed, &frameView));
+
+	// A plausible frame restores the alignment
+	generator.generate(frame);
+	TEST_ASSERT_EQUAL(SmartBmsError::SBMS_OK, smartBmsReader.feed(frame, SMART_BMS_FRAME_SIZE, &consumed, &frameView));
+	TEST_ASSERT_EQUAL_MEMORY(frame, frameView.getFrame(), SMART_BMS_FRAME_SIZE);
+}
+
+/**
+ * @brief Count the transitions of a flag.
+ * @param field flag that changed
+ * @param value new value of the flag
+ * @param timestamp time of the frame
+ * @param context array with the number of falling and rising transitions
+ */
+static void countTransition(const SmartBmsField field, const bool value, const uint32_t timestamp, void *context)
+{
+	(void)field;
+	(void)timestamp;
+	static_cast<size_t *>(context)[value ? 1 : 0]++;
+}
+
+void test_noise_causes_no_flag_transitions()
+{
+	// Every generated frame allows charging, so the only transition is the initial rising one
+	std::vector<uint8_t> frames(TEST_FRAME_COUNT * SMART_BMS_FRAME_SIZE);
+	SmartBmsFrameGenerator generator(TEST_SEED);
+	generator.generate(frames.data(), TEST_FRAME_COUNT);
+
+	// Single damaged frames that pass the checksum with the flag cleared
+	for (size_t i = 25; i < TEST_FRAME_COUNT; i += 50)
+	{
+		uint8_t *frame = &frames[i * SMART_BMS_FRAME_SIZE];
+		SmartBmsFrameGenerator::encodeRawValue(frame, SBMS_FIELD_ALLOWED_TO_CHARGE, 0);
+		SmartBmsFrameGenerator::updateChecksum(frame);
+	}
+	const SmartBmsNoiseProfile profile = {"mixed", 200, 200, 200, 20, 32};
+	SmartBmsNoiseInjector injector(TEST_SEED, profile);
+	std::vector<uint8_t> stream;
+	injector.inject(frames.data(), frames.size(), &stream);
+
+	SmartBmsReader smartBmsReader(nullptr);
+	size_t transitionCounts[2] = {0, 0};
+	TEST_ASSERT_TRUE(smartBmsReader.subscribe(SBMS_FIELD_ALLOWED_TO_CHARGE, SmartBmsFlagEdge::SBMS_EDGE_BOTH, countTransition, transitionCounts));
+	SmartBmsFrameView frameView;
+	size_t position = 0;
+	size_t clearedCount = 0;
+	while (position < stream.size())
+	{
+		size_t consumed = 0;
+		if (smartBmsReader.feed(&stream[position], stream.size() - position, &consumed, &frameView) != SmartBmsError::SBMS_OK)
+		{
+			break;
+		}
+		clearedCount += frameView.getRawValue(SBMS_FIELD_ALLOWED_TO_CHARGE) == 0 ? 1 : 0;
+		position += consumed;
+	}
+	TEST_ASSERT_GREATER_THAN(0, clearedCount);
+	TEST_ASSERT_EQUAL(0, transitionCounts[0]);
+	TEST_ASSERT_EQUAL(1, transitionCounts[1]);
+}
+
+void test_flag_transition_needs_two_frames()
+{
+	SmartBmsFrameGenerator generator(TEST_SEED);
+	SmartBmsReader smartBmsReader(nullptr);
+	size_t transitionCounts[2] = {0, 0};
+	TEST_ASSERT_TRUE(smartBmsReader.subscribe(SBMS_FIELD_ALLOWED_TO_CHARGE, SmartBmsFlagEdge::SBMS_EDGE_BOTH, countTransition, transitionCounts));
+	const int32_t values[] = {1, 1, 0, 1, 1, 0, 0, 0, 1};
+	const size_t expectedFalling[] = {0, 0, 0, 0, 0, 0, 1, 1, 1};
+	const size_t expectedRising[] = {0, 1, 1, 1, 1, 1, 1, 1, 1};
+	uint8_t frame[SMART_BMS_FRAME_SIZE];
+	SmartBmsFrameView frameView;
+	for (size_t i = 0; i < sizeof(values) / sizeof(values[0]); i++)
+	{
+		generator.generate(frame);
+		SmartBmsFrameGenerator::encodeRawValue(frame, SBMS_FIELD_ALLOWED_TO_CHARGE, values[i]);
+		SmartBmsFrameGenerator::updateChecksum(frame);
+		size_t consumed = 0;
+		TEST_ASSERT_EQUAL(SmartBmsError::SBMS_OK, smartBmsReader.feed(frame, SMART_BMS_FRAME_SIZE, &consumed, &frameView));
+		TEST_ASSERT_EQUAL(expectedFalling[i], transitionCounts[0]);
+		TEST_ASSERT_EQUAL(expectedRising[i], transitionCounts[1]);
+	}
+}
+
+void test_back_to_back_frames_do_not_set_the_cycle_period()
+{
+	// Two buffered frames arrive one frame duration apart, the BMS itself sends a frame every second
+	SmartBmsFrameGenerator generator(TEST_SEED);
+	SmartBmsReader smartBmsReader(nullptr);
+	smartBmsReader.setClock(getFakeTime);
+	feedFramesAt(&smartBmsReader, &generator, 2, 5000000);
+	for (uint32_t i = 1; i <= 20; i++)
+	{
+		feedFramesAt(&smartBmsReader, &generator, 1, 5000000 + i * 1000000);
+	}
+	TEST_ASSERT_UINT32_WITHIN(1000, 1000000, smartBmsReader.getCyclePeriod());
+	TEST_ASSERT_EQUAL(0, smartBmsReader.getMissedCycleCount());
+}
+
+void test_wrong_cycle_period_is_learned_again()
+{
+	// The first interval contains a missed frame, which makes the first guess twice the period
+	SmartBmsFrameGenerator generator(TEST_SEED);
+	SmartBmsReader smartBmsReader(nullptr);
+	smartBmsReader.setClock(getFakeTime);
+	feedFramesAt(&smartBmsReader, &generator, 1, 1000000);
+	feedFramesAt(&smartBmsReader, &generator, 1, 3000000);
+	for (uint32_t i = 1; i <= 10; i++)
+	{
+		feedFramesAt(&smartBmsReader, &generator, 1, 3000000 + i * 1000000);
+	}
+	TEST_ASSERT_UINT32_WITHIN(1000, 1000000, smartBmsReader.getCyclePeriod());
+	TEST_ASSERT_EQUAL(0, smartBmsReader.getMissedCycleCount());
+
+	// Once the period is right, missed frames are counted
+	feedFramesAt(&smartBmsReader, &generator, 1, 16000000);
+	TEST_ASSERT_EQUAL(2, smartBmsReader.getMissedCycleCount());
+	TEST_ASSERT_UINT32_WITHIN(1000, 1000000, smartBmsReader.getCyclePeriod());
+
+	// A configured period that is far off is learned as well
+	SmartBmsReader configuredReader(nullptr);
+	configuredReader.setClock(getFakeTime);
+	configuredReader.setCyclePeriod(1500000);
+	for (uint32_t i = 0; i <= 10; i++)
+	{
+		feedFramesAt(&configuredReader, &generator, 1, 20000000 + i * 1000000);
+	}
+	TEST_ASSERT_UINT32_WITHIN(1000, 1000000, configuredReader.getCyclePeriod());
+}
+
+int main()
+{
+	UNITY_BEGIN();
+	RUN_TEST(test_clean_stream_delivers_every_frame);
+	RUN_TEST(test_bit_flip_false_accepts);
+	RUN_TEST(test_drop_false_accepts);
+	RUN_TEST(test_duplicate_false_accepts);
+	RUN_TEST(test_burst_false_accepts);
+	RUN_TEST(test_mixed_false_accepts);
+	RUN_TEST(test_implausible_window_is_rejected);
+	RUN_TEST(test_failed_cell_on_aligned_stream_is_delivered);
+	RUN_TEST(test_failed_cell_after_resync_is_rejected);
+	RUN_TEST(test_noise_causes_no_flag_transitions);
+	RUN_TEST(test_flag_transition_needs_two_frames);
+	RUN_TEST(test_back_to_back_frames_do_not_set_the_cycle_period);
+	RUN_TEST(test_wrong_cycle_period_is_learned_again);
+	return UNITY_END();
+}
@@ -0,0 +1,230 @@
+#include <stdint.h>
+#include <unity.h>
+
+#include "bms/SmartBmsScheduler.h"
+
+#define TEST_FRAME_PERIOD_US 1000000
+#define TEST_POLL_INTERVAL_US 1000
+
+// Arrivals of a pack with a cycle of about one second and a few ms of jitter, in µs
+static const uint32_t regularTimeline[] = {
+	2000000, 3001800, 4000900, 5002400, 5999700, 7001100, 8000300, 9002000,
+	10000800, 11001500, 12000100, 13001900, 14000600, 15001200, 16000400, 17002100};
+
+// The same pack with frames that were lost on the wire
+static const uint32_t gapTimeline[] = {
+	2000000, 3001800, 4000900, 5002400, 8000300, 9002000, 10000800, 13001900, 14000600};
+
+// The pack restarts after the fifth frame and sends at a new phase
+static const uint32_t restartTimeline[] = {
+	2000000, 3001800, 4000900, 5002400, 5999700, 6450000, 7451200, 8450600, 9452000, 10450900, 11451400,
+	12451700, 13450400, 14451100, 15450800};
+
+// Simulated time in µs, shared by the timeline and the scheduler
+static uint32_t simulatedTime = 0;
+
+/**
+ * @brief Clock of the simulation.
+ * @return simulated time in µs
+ */
+static const uint32_t getSimulatedTime()
+{
+	return simulatedTime;
+}
+
+/**
+ * @brief Result of a replayed timeline.
+ */
+struct TestReplay
+{
+	size_t receivedCount;
+	size_t lostCount;
+	uint64_t sleepTime;
+};
+
+/**
+ * @brief Replay a timeline with an application that sleeps whenever the scheduler allows it.
+ * A frame that starts while the application sleeps is lost.
+ * @param scheduler scheduler that uses the simulated clock
+ * @param arrivals start times of the frames in µs
+ * @param count number of frames
+ * @return counts of the replay
+ */
+static TestReplay replay(SmartBmsScheduler *scheduler, const uint32_t *arrivals, const size_t count)
+{
+	TestReplay result = {0, 0, 0};
+	simulatedTime = arrivals[0] - TEST_POLL_INTERVAL_US;
+	size_t next = 0;
+	while (next < count)
+	{
+		const uint32_t sleep = scheduler->getSleepTime();
+		if (sleep > 0)
+		{
+			const uint32_t end = simulatedTime + sleep;
+			while (next < count && static_cast<int32_t>(arrivals[next] - end) < 0)
+			{
+				result.lostCount++;
+				next++;
+			}
+			simulatedTime = end;
+			result.sleepTime += sleep;
+		}
+		else
+		{
+			simulatedTime += TEST_POLL_INTERVAL_US;
+		}
+
+		while (next < count && static_cast<int32_t>(simulatedTime - arrivals[next] - SMART_BMS_SCHEDULER_FRAME_DURATION_US) >= 0)
+		{
+			scheduler->onFrame(arrivals[next]);
+			result.receivedCount++;
+			next++;
+		}
+	}
+	return result;
+}
+
+void setUp()
+{
+}
+
+void tearDown()
+{
+}
+
+void test_regular_timeline_locks_and_sleeps()
+{
+	SmartBmsScheduler scheduler(getSimulatedTime);
+	const size_t count = sizeof(regularTimeline) / sizeof(regularTimeline[0]);
+	const TestReplay result = replay(&scheduler, regularTimeline, count);
+	TEST_ASSERT_EQUAL(count, result.receivedCount);
+	TEST_ASSERT_EQUAL(0, result.lostCount);
+	TEST_ASSERT_TRUE(scheduler.isLocked());
+	TEST_ASSERT_UINT32_WITHIN(2000, TEST_FRAME_PERIOD_US, scheduler.getCyclePeriod());
+	TEST_ASSERT_EQUAL(0, scheduler.getMissedCycleCount());
+	TEST_ASSERT_EQUAL(0, scheduler.getRelearnCount());
+
+	// Most of the time after the lock is spent asleep
+	const uint32_t duration = regularTimeline[count - 1] - regularTimeline[0];
+	TEST_ASSERT_GREATER_THAN(duration / 2, result.sleepTime);
+
+	// After the frame the application wakes up one margin before the next one
+	simulatedTime = regularTimeline[count - 1] + SMART_BMS_SCHEDULER_FRAME_DURATION_US + scheduler.getMargin() + 1;
+	const uint32_t sleep = scheduler.getSleepTime();
+	TEST_ASSERT_EQUAL(scheduler.getNextArrival() - scheduler.getMargin(), simulatedTime + sleep);
+	TEST_ASSERT_UINT32_WITHIN(2000, regularTimeline[count - 1] + TEST_FRAME_PERIOD_US, scheduler.getNextArrival());
+}
+
+void test_no_sleep_before_the_lock()
+{
+	SmartBmsScheduler scheduler(getSimulatedTime);
+	simulatedTime = regularTimeline[0];
+	scheduler.onFrame(regularTimeline[0]);
+	TEST_ASSERT_EQUAL(0, scheduler.getSleepTime());
+
+	// Frames back to back are no cycle
+	simulatedTime = regularTimeline[0] + SMART_BMS_SCHEDULER_FRAME_DURATION_US;
+	scheduler.onFrame(simulatedTime);
+	TEST_ASSERT_EQUAL(0, scheduler.getCyclePeriod());
+
+	for (size_t i = 1; i <= SMART_BMS_SCHEDULER_LOCK_INTERVAL_COUNT; i++)
+	{
+		TEST_ASSERT_FALSE(scheduler.isLocked());
+		simulatedTime = regularTimeline[i];
+		scheduler.onFrame(simulatedTime);
+	}
+	TEST_ASSERT_FALSE(scheduler.isLocked());
+	simulatedTime = regularTimeline[SMART_BMS_SCHEDULER_LOCK_INTERVAL_COUNT + 1];
+	scheduler.onFrame(simulatedTime);
+	TEST_ASSERT_TRUE(scheduler.isLocked());
+}
+
+void test_lost_frames_count_as_missed_cycles()
+{
+	SmartBmsScheduler scheduler(getSimulatedTime);
+	const size_t count = sizeof(gapTimeline) / sizeof(gapTimeline[0]);
+	for (size_t i = 0; i < count; i++)
+	{
+		simulatedTime = gapTimeline[i];
+		scheduler.onFrame(gapTimeline[i]);
+	}
+	TEST_ASSERT_TRUE(scheduler.isLocked());
+	TEST_ASSERT_EQUAL(4, scheduler.getMissedCycleCount());
+	TEST_ASSERT_EQUAL(0, scheduler.getRelearnCount());
+	TEST_ASSERT_UINT32_WITHIN(2000, TEST_FRAME_PERIOD_US, scheduler.getCyclePeriod());
+}
+
+void test_restart_is_learned_again()
+{
+	SmartBmsScheduler scheduler(getSimulatedTime);
+	const size_t count = sizeof(restartTimeline) / sizeof(restartTimeline[0]);
+	const TestReplay result = replay(&scheduler, restartTimeline, count);
+
+	// Frames at the new phase start while the application sleeps, until the missing frames drop the lock
+	TEST_ASSERT_EQUAL(count, result.receivedCount + result.lostCount);
+	TEST_ASSERT_GREATER_THAN(0, result.lostCount);
+	TEST_ASSERT_GREATER_THAN(0, scheduler.getRelearnCount());
+	TEST_ASSERT_TRUE(scheduler.isLocked());
+	simulatedTime = restartTimeline[count - 1] + SMART_BMS_SCHEDULER_FRAME_DURATION_US + scheduler.getMargin() + 1;
+	TEST_ASSERT_UINT32_WITHIN(2000, restartTimeline[count - 1] + TEST_FRAME_PERIOD_US, scheduler.getNextArrival());
+}
+
+void test_silence_drops_the_lock()
+{
+	SmartBmsScheduler scheduler(getSimulatedTime);
+	for (size_t i = 0; i < 6; i++)
+	{
+		simulatedTime = regularTimeline[i];
+		scheduler.onFrame(regularTimeline[i]);
+	}
+	TEST_ASSERT_TRUE(scheduler.isLocked());
+
+	// Three missing frames are tolerated, the fourth one drops the lock
+	simulatedTime = regularTimeline[5] + SMART_BMS_SCHEDULER_MAX_MISSED_CYCLES * TEST_FRAME_PERIOD_US + TEST_FRAME_PERIOD_US / 2;
+	TEST_ASSERT_GREATER_THAN(0, scheduler.getSleepTime());
+	simulatedTime += TEST_FRAME_PERIOD_US;
+	TEST_ASSERT_EQUAL(0, scheduler.getSleepTime());
+	TEST_ASSERT_FALSE(scheduler.isLocked());
+	TEST_ASSERT_EQUAL(1, scheduler.getRelearnCount());
+
+	// The next frame starts a new first interval
+	scheduler.onFrame(simulatedTime);
+	TEST_ASSERT_EQUAL(0, scheduler.getCyclePeriod());
+}
+
+void test_buffered_frames_keep_the_lock()
+{
+	SmartBmsScheduler scheduler(getSimulatedTime);
+	for (size_t i = 0; i < 6; i++)
+	{
+		simulatedTime = regularTimeline[i];
+		scheduler.onFrame(regularTimeline[i]);
+	}
+	TEST_ASSERT_TRUE(scheduler.isLocked());
+
+	// The loop stalled for a cycle, so two buffered frames are stamped a few ms apart
+	simulatedTime = regularTimeline[7];
+	scheduler.onFrame(regularTimeline[7] - 3000);
+	scheduler.onFrame(regularTimeline[7]);
+	TEST_ASSERT_TRUE(scheduler.isLocked());
+	TEST_ASSERT_EQUAL(0, scheduler.getRelearnCount());
+	TEST_ASSERT_UINT32_WITHIN(2000, TEST_FRAME_PERIOD_US, scheduler.getCyclePeriod());
+
+	// The next regular frame continues the cycle
+	simulatedTime = regularTimeline[8];
+	scheduler.onFrame(regularTimeline[8]);
+	TEST_ASSERT_TRUE(scheduler.isLocked());
+	TEST_ASSERT_EQUAL(0, scheduler.getRelearnCount());
+}
+
+int main()
+{
+	UNITY_BEGIN();
+	RUN_TEST(test_regular_timeline_locks_and_sleeps);
+	RUN_TEST(test_no_sleep_before_the_lock);
+	RUN_TEST(test_lost_frames_count_as_missed_cycles);
+	RUN_TEST(test_restart_is_learned_again);
+	RUN_TEST(test_silence_drops_the_lock);
+	RUN_TEST(test_buffered_frames_keep_the_lock);
+	return UNITY_END();
+}
@@ -0,0 +1,215 @@
+#include <stdint.h>
+#include <string.h>
+#include <unity.h>
+
+#include "bms/SmartBmsData.h"
+#include "bms/SmartBmsFrameView.h"
+#include "bms/SmartBmsSerializer.h"
+#include "host/SmartBmsFrameGenerator.h"
+
+#define TEST_TIMESTAMP 1700000000000000000ULL
+
+// The columns of a single cell are only decoded with SMART_BMS_CELL_DATA
+#ifdef SMART_BMS_CELL_DATA
+#define TEST_CELL_JSON ",\"cellNumber\":5,\"cellVoltage\":3300,\"cellTemperature\":7960"
+#define TEST_CELL_CSV_HEADER ",cellNumber,cellVoltage[mV],cellTemperature[m°C]"
+#define TEST_CELL_CSV ",5,3300,7960"
+#define TEST_CELL_LINE_PROTOCOL ",cellNumber=5i,cellVoltage=3300i,cellTemperature=7960i"
+#else
+#define TEST_CELL_JSON ""
+#define TEST_CELL_CSV_HEADER ""
+#define TEST_CELL_CSV ""
+#define TEST_CELL_LINE_PROTOCOL ""
+#endif
+
+#define TEST_JSON                                                                                                                          \
+	"{\"cellCount\":16,\"cellVoltageMin\":2800,\"cellVoltageMax\":3650,\"cellVoltageBalance\":3450,\"packSoc\":87,\"packVoltage\":52800," \
+	"\"packCurrent\":-12500,\"packChargeCurrent\":0,\"packDischargeCurrent\":-12500,\"packCapacity\":14300,\"packRemainingEnergy\":12441,"  \
+	"\"lowestCellVoltage\":3250,\"lowestCellVoltageNumber\":3,\"highestCellVoltage\":3350,\"highestCellVoltageNumber\":12,"               \
+	"\"lowestCellTemperature\":-17750,\"lowestCellTemperatureNumber\":2,\"highestCellTemperature\":25100,\"highestCellTemperatureNumber\":7," \
+	"\"communicationError\":false,\"allowedToCharge\":true,\"allowedToDischarge\":false,\"minVoltageAlarm\":true,\"maxVoltageAlarm\":false," \
+	"\"minTemperatureAlarm\":true,\"maxTemperatureAlarm\":false" TEST_CELL_JSON "}"
+
+#define TEST_CSV_HEADER                                                                                                        \
+	"cellCount,cellVoltageMin[mV],cellVoltageMax[mV],cellVoltageBalance[mV],packSoc[%],packVoltage[mV],packCurrent[mA],"       \
+	"packChargeCurrent[mA],packDischargeCurrent[mA],packCapacity[Wh],packRemainingEnergy[Wh],lowestCellVoltage[mV],"           \
+	"lowestCellVoltageNumber,highestCellVoltage[mV],highestCellVoltageNumber,lowestCellTemperature[m°C],"                       \
+	"lowestCellTemperatureNumber,highestCellTemperature[m°C],highestCellTemperatureNumber,communicationError,allowedToCharge," \
+	"allowedToDischarge,minVoltageAlarm,maxVoltageAlarm,minTemperatureAlarm,maxTemperatureAlarm" TEST_CELL_CSV_HEADER
+
+#define TEST_CSV "16,2800,3650,3450,87,52800,-12500,0,-12500,14300,12441,3250,3,3350,12,-17750,2,25100,7,0,1,0,1,0,1,0" TEST_CELL_CSV
+
+#define TEST_LINE_PROTOCOL                                                                                                            \
+	"smartbms cellCount=16i,cellVoltageMin=2800i,cellVoltageMax=3650i,cellVoltageBalance=3450i,packSoc=87i,packVoltage=52800i,"       \
+	"packCurrent=-12500i,packChargeCurrent=0i,packDischargeCurrent=-12500i,packCapacity=14300i,packRemainingEnergy=12441i,"            \
+	"lowestCellVoltage=3250i,lowestCellVoltageNumber=3i,highestCellVoltage=3350i,highestCellVoltageNumber=12i,"                       \
+	"lowestCellTemperature=-17750i,lowestCellTemperatureNumber=2i,highestCellTemperature=25100i,highestCellTemperatureNumber=7i,"     \
+	"communicationError=false,allowedToCharge=true,allowedToDischarge=false,minVoltageAlarm=true,maxVoltageAlarm=false,"              \
+	"minTemperatureAlarm=true,maxTemperatureAlarm=false" TEST_CELL_LINE_PROTOCOL
+
+/**
+ * @brief Build a frame with known values, including a negative current and a negative temperature.
+ * @param frame buffer of 58 bytes that receives the frame
+ */
+static void buildFrame(uint8_t frame[SMART_BMS_FRAME_SIZE])
+{
+	const int32_t rawValues[SBMS_FIELD_COUNT] = {
+		16, 560, 730, 690, 87, 10560, -100, 0, -100, 143, 12441, 650, 3, 670, 12, 250, 2, 300, 7, 0, 1, 0, 1, 0, 1, 0,
+#ifdef SMART_BMS_CELL_DATA
+		5, 660, 280,
+#endif
+	};
+	memset(frame, 0, SMART_BMS_FRAME_SIZE);
+	for (size_t i = 0; i < SBMS_FIELD_COUNT; i++)
+	{
+		SmartBmsFrameGenerator::encodeRawValue(frame, static_cast<SmartBmsField>(i), rawValues[i]);
+	}
+	SmartBmsFrameGenerator::updateChecksum(frame);
+}
+
+/**
+ * @brief Check that every buffer that is too small for the text leaves an empty text.
+ * @param smartBmsData data to write
+ * @param format output format
+ * @param length length of the complete text
+ */
+static void checkOverflow(const SmartBmsData &smartBmsData, const SmartBmsSerializerFormat format, const size_t length)
+{
+	char buffer[SMART_BMS_SERIALIZER_BUFFER_SIZE];
+	for (size_t size = 1; size <= length; size++)
+	{
+		memset(buffer, 'x', sizeof(buffer));
+		TEST_ASSERT_EQUAL(0, SmartBmsSerializer::serialize(smartBmsData, format, buffer, size));
+		TEST_ASSERT_EQUAL_STRING("", buffer);
+	}
+	TEST_ASSERT_EQUAL(length, SmartBmsSerializer::serialize(smartBmsData, format, buffer, length + 1));
+}
+
+void setUp()
+{
+}
+
+void tearDown()
+{
+}
+
+void test_json_of_a_known_frame()
+{
+	uint8_t frame[SMART_BMS_FRAME_SIZE];
+	buildFrame(frame);
+	char buffer[SMART_BMS_SERIALIZER_BUFFER_SIZE];
+	TEST_ASSERT_EQUAL(strlen(TEST_JSON), SmartBmsSerializer::toJson(SmartBmsFrameView(frame), buffer, sizeof(buffer)));
+	TEST_ASSERT_EQUAL_STRING(TEST_JSON, buffer);
+}
+
+void test_csv_of_a_known_frame()
+{
+	uint8_t frame[SMART_BMS_FRAME_SIZE];
+	buildFrame(frame);
+	char buffer[SMART_BMS_SERIALIZER_BUFFER_SIZE];
+	TEST_ASSERT_EQUAL(strlen(TEST_CSV_HEADER), SmartBmsSerializer::toCsvHeader(buffer, sizeof(buffer)));
+	TEST_ASSERT_EQUAL_STRING(TEST_CSV_HEADER, buffer);
+	TEST_ASSERT_EQUAL(strlen(TEST_CSV), SmartBmsSerializer::toCsv(SmartBmsFrameView(frame), buffer, sizeof(buffer)));
+	TEST_ASSERT_EQUAL_STRING(TEST_CSV, buffer);
+}
+
+void test_line_protocol_of_a_known_frame()
+{
+	uint8_t frame[SMART_BMS_FRAME_SIZE];
+	buildFrame(frame);
+	char buffer[SMART_BMS_SERIALIZER_BUFFER_SIZE];
+	TEST_ASSERT_EQUAL(strlen(TEST_LINE_PROTOCOL " 1700000000000000000"), SmartBmsSerializer::toLineProtocol(SmartBmsFrameView(frame), "smartbms", TEST_TIMESTAMP, buffer, sizeof(buffer)));
+	TEST_ASSERT_EQUAL_STRING(TEST_LINE_PROTOCOL " 1700000000000000000", buffer);
+
+	// Without timestamp the server assigns it
+	TEST_ASSERT_EQUAL(strlen(TEST_LINE_PROTOCOL), SmartBmsSerializer::toLineProtocol(SmartBmsFrameView(frame), "smartbms", 0, buffer, sizeof(buffer)));
+	TEST_ASSERT_EQUAL_STRING(TEST_LINE_PROTOCOL, buffer);
+}
+
+void test_serialize_selects_the_format()
+{
+	uint8_t frame[SMART_BMS_FRAME_SIZE];
+	buildFrame(frame);
+	SmartBmsData smartBmsData;
+	SmartBmsFrameView(frame).decode(&smartBmsData);
+	char buffer[SMART_BMS_SERIALIZER_BUFFER_SIZE];
+	SmartBmsSerializer::serialize(smartBmsData, SBMS_FORMAT_JSON, buffer, sizeof(buffer));
+	TEST_ASSERT_EQUAL_STRING(TEST_JSON, buffer);
+	SmartBmsSerializer::serialize(smartBmsData, SBMS_FORMAT_CSV, buffer, sizeof(buffer));
+	TEST_ASSERT_EQUAL_STRING(TEST_CSV, buffer);
+	SmartBmsSerializer::serialize(smartBmsData, SBMS_FORMAT_LINE_PROTOCOL, buffer, sizeof(buffer));
+	TEST_ASSERT_EQUAL_STRING(TEST_LINE_PROTOCOL, buffer);
+}
+
+void test_flags_are_written_as_booleans()
+{
+	uint8_t frame[SMART_BMS_FRAME_SIZE];
+	buildFrame(frame);
+	SmartBmsFrameGenerator::encodeRawValue(frame, SBMS_FIELD_COMMUNICATION_ERROR, 1);
+	SmartBmsFrameGenerator::encodeRawValue(frame, SBMS_FIELD_ALLOWED_TO_CHARGE, 0);
+	const uint32_t mask = SBMS_FIELD_MASK(SBMS_FIELD_COMMUNICATION_ERROR) | SBMS_FIELD_MASK(SBMS_FIELD_ALLOWED_TO_CHARGE);
+	const SmartBmsFrameView frameView(frame);
+	char buffer[SMART_BMS_SERIALIZER_BUFFER_SIZE];
+	SmartBmsSerializer::toJson(frameView, buffer, sizeof(buffer), mask);
+	TEST_ASSERT_EQUAL_STRING("{\"communicationError\":true,\"allowedToCharge\":false}", buffer);
+	SmartBmsSerializer::toCsvHeader(buffer, sizeof(buffer), mask);
+	TEST_ASSERT_EQUAL_STRING("communicationError,allowedToCharge", buffer);
+	SmartBmsSerializer::toCsv(frameView, buffer, sizeof(buffer), mask);
+	TEST_ASSERT_EQUAL_STRING("1,0", buffer);
+	SmartBmsSerializer::toLineProtocol(frameView, "smartbms", 0, buffer, sizeof(buffer), mask);
+	TEST_ASSERT_EQUAL_STRING("smartbms communicationError=true,allowedToCharge=false", buffer);
+}
+
+void test_missing_fields()
+{
+	// Only the pack voltage and current were decoded
+	uint8_t frame[SMART_BMS_FRAME_SIZE];
+	buildFrame(frame);
+	SmartBmsData smartBmsData;
+	SmartBmsFrameView(frame).decode(&smartBmsData, SBMS_FIELD_MASK(SBMS_FIELD_PACK_VOLTAGE) | SBMS_FIELD_MASK(SBMS_FIELD_PACK_CURRENT));
+	const uint32_t mask = SBMS_FIELD_MASK(SBMS_FIELD_PACK_SOC) | SBMS_FIELD_MASK(SBMS_FIELD_PACK_VOLTAGE) | SBMS_FIELD_MASK(SBMS_FIELD_PACK_CURRENT);
+	char buffer[SMART_BMS_SERIALIZER_BUFFER_SIZE];
+
+	// JSON and line protocol skip them, CSV keeps an empty column
+	SmartBmsSerializer::toJson(smartBmsData, buffer, sizeof(buffer), mask);
+	TEST_ASSERT_EQUAL_STRING("{\"packVoltage\":52800,\"packCurrent\":-12500}", buffer);
+	SmartBmsSerializer::toCsv(smartBmsData, buffer, sizeof(buffer), mask);
+	TEST_ASSERT_EQUAL_STRING(",52800,-12500", buffer);
+	SmartBmsSerializer::toLineProtocol(smartBmsData, "smartbms", 0, buffer, sizeof(buffer), mask);
+	TEST_ASSERT_EQUAL_STRING("smartbms packVoltage=52800i,packCurrent=-12500i", buffer);
+
+	// A point without fields is invalid
+	TEST_ASSERT_EQUAL(0, SmartBmsSerializer::toLineProtocol(smartBmsData, "smartbms", 0, buffer, sizeof(buffer), SBMS_FIELD_MASK(SBMS_FIELD_PACK_SOC)));
+	TEST_ASSERT_EQUAL_STRING("", buffer);
+	TEST_ASSERT_EQUAL(2, SmartBmsSerializer::toJson(SmartBmsData(), buffer, sizeof(buffer)));
+	TEST_ASSERT_EQUAL_STRING("{}", buffer);
+}
+
+void test_too_small_buffer_leaves_an_empty_text()
+{
+	uint8_t frame[SMART_BMS_FRAME_SIZE];
+	buildFrame(frame);
+	SmartBmsData smartBmsData;
+	SmartBmsFrameView(frame).decode(&smartBmsData);
+	checkOverflow(smartBmsData, SBMS_FORMAT_JSON, strlen(TEST_JSON));
+	checkOverflow(smartBmsData, SBMS_FORMAT_CSV, strlen(TEST_CSV));
+	checkOverflow(smartBmsData, SBMS_FORMAT_LINE_PROTOCOL, strlen(TEST_LINE_PROTOCOL));
+
+	char buffer[SMART_BMS_SERIALIZER_BUFFER_SIZE];
+	TEST_ASSERT_EQUAL(0, SmartBmsSerializer::toCsvHeader(buffer, strlen(TEST_CSV_HEADER)));
+	TEST_ASSERT_EQUAL_STRING("", buffer);
+	TEST_ASSERT_EQUAL(0, SmartBmsSerializer::toJson(smartBmsData, buffer, 0));
+}
+
+int main()
+{
+	UNITY_BEGIN();
+	RUN_TEST(test_json_of_a_known_frame);
+	RUN_TEST(test_csv_of_a_known_frame);
+	RUN_TEST(test_line_protocol_of_a_known_frame);
+	RUN_TEST(test_serialize_selects_the_format);
+	RUN_TEST(test_flags_are_written_as_booleans);
+	RUN_TEST(test_missing_fields);
+	RUN_TEST(test_too_small_buffer_leaves_an_empty_text);
+	return UNITY_END();
+}
@@ -0,0 +1,247 @@
+#include <string.h>
+#include <vector>
+#include <unity.h>
+
+#include "bms/SmartBmsData.h"
+#include "bms/SmartBmsFrameView.h"
+#include "bms/SmartBmsReader.h"
+#include "bms/SmartBmsStatistics.h"
+#include "host/SmartBmsFrameGenerator.h"
+#include "host/SmartBmsNoiseInjector.h"
+
+#ifdef SMART_BMS_STATISTICS
+#define TEST_FRAME_COUNT 2000
+#define TEST_SEED 0x5EED
+
+// The BMS sends a frame every 1.2 s, so every number of cycles falls clearly into one bucket of the frame interval
+#define TEST_CYCLE_PERIOD_US 1200000
+
+// Every this many frames one is not sent at all
+#define TEST_MISSING_FRAME_INTERVAL 97
+
+#define TEST_PROMETHEUS                                                                                  \
+	"# HELP smartbms_frames_total Frames with a valid checksum.\n"                                       \
+	"# TYPE smartbms_frames_total counter\n"                                                             \
+	"smartbms_frames_total 4\n"                                                                          \
+	"# HELP smartbms_checksum_errors_total Complete windows that did not match their checksum.\n"        \
+	"# TYPE smartbms_checksum_errors_total counter\n"                                                    \
+	"smartbms_checksum_errors_total 2\n"                                                                 \
+	"# HELP smartbms_skipped_bytes_total Bytes skipped to resynchronize to the frame alignment.\n"       \
+	"# TYPE smartbms_skipped_bytes_total counter\n"                                                      \
+	"smartbms_skipped_bytes_total 57\n"                                                                  \
+	"# HELP smartbms_missed_cycles_total Cycles of the BMS without a valid frame.\n"                     \
+	"# TYPE smartbms_missed_cycles_total counter\n"                                                      \
+	"smartbms_missed_cycles_total 3\n"                                                                   \
+	"# HELP smartbms_read_errors_total Failed reads of the input stream.\n"                              \
+	"# TYPE smartbms_read_errors_total counter\n"                                                        \
+	"smartbms_read_errors_total 1\n"                                                                     \
+	"# HELP smartbms_rx_overflows_total Overflows of the UART receive buffer.\n"                         \
+	"# TYPE smartbms_rx_overflows_total counter\n"                                                       \
+	"smartbms_rx_overflows_total 4\n"                                                                    \
+	"# HELP smartbms_dropped_frames_total Frames dropped because the queue was full.\n"                  \
+	"# TYPE smartbms_dropped_frames_total counter\n"                                                     \
+	"smartbms_dropped_frames_total 5\n"                                                                  \
+	"# HELP smartbms_decode_latency_microseconds Time to decode a frame.\n"                              \
+	"# TYPE smartbms_decode_latency_microseconds histogram\n"                                            \
+	"smartbms_decode_latency_microseconds_bucket{le=\"1\"} 2\n"                                          \
+	"smartbms_decode_latency_microseconds_bucket{le=\"2\"} 3\n"                                          \
+	"smartbms_decode_latency_microseconds_bucket{le=\"5\"} 4\n"                                          \
+	"smartbms_decode_latency_microseconds_bucket{le=\"10\"} 4\n"                                         \
+	"smartbms_decode_latency_microseconds_bucket{le=\"20\"} 4\n"                                         \
+	"smartbms_decode_latency_microseconds_bucket{le=\"50\"} 4\n"                                         \
+	"smartbms_decode_latency_microseconds_bucket{le=\"100\"} 4\n"                                        \
+	"smartbms_decode_latency_microseconds_bucket{le=\"200\"} 4\n"                                        \
+	"smartbms_decode_latency_microseconds_bucket{le=\"500\"} 4\n"                                        \
+	"smartbms_decode_latency_microseconds_bucket{le=\"1000\"} 5\n"                                       \
+	"smartbms_decode_latency_microseconds_bucket{le=\"+Inf\"} 6\n"                                       \
+	"smartbms_decode_latency_microseconds_sum 2007\n"                                                    \
+	"smartbms_decode_latency_microseconds_count 6\n"                                                     \
+	"# HELP smartbms_frame_interval_milliseconds Time between two valid frames.\n"                       \
+	"# TYPE smartbms_frame_interval_milliseconds histogram\n"                                            \
+	"smartbms_frame_interval_milliseconds_bucket{le=\"100\"} 0\n"                                        \
+	"smartbms_frame_interval_milliseconds_bucket{le=\"250\"} 0\n"                                        \
+	"smartbms_frame_interval_milliseconds_bucket{le=\"500\"} 0\n"                                        \
+	"smartbms_frame_interval_milliseconds_bucket{le=\"750\"} 0\n"                                        \
+	"smartbms_frame_interval_milliseconds_bucket{le=\"900\"} 0\n"                                        \
+	"smartbms_frame_interval_milliseconds_bucket{le=\"1100\"} 2\n"                                       \
+	"smartbms_frame_interval_milliseconds_bucket{le=\"1250\"} 2\n"                                       \
+	"smartbms_frame_interval_milliseconds_bucket{le=\"1500\"} 2\n"                                       \
+	"smartbms_frame_interval_milliseconds_bucket{le=\"2000\"} 2\n"                                       \
+	"smartbms_frame_interval_milliseconds_bucket{le=\"5000\"} 2\n"                                       \
+	"smartbms_frame_interval_milliseconds_bucket{le=\"+Inf\"} 3\n"                                       \
+	"smartbms_frame_interval_milliseconds_sum 8100\n"                                                    \
+	"smartbms_frame_interval_milliseconds_count 3\n"
+
+// Time of the fake clock in µs
+static uint32_t fakeTime = 0;
+
+/**
+ * @brief Clock that returns the time set by the test.
+ * @return fake time in µs
+ */
+static const uint32_t getFakeTime()
+{
+	return fakeTime;
+}
+
+/**
+ * @brief Fill the statistics with known values.
+ * @param statistics statistics to fill
+ */
+static void fillStatistics(SmartBmsStatistics *statistics)
+{
+	// Intervals of 1000, 1100 and 6000 ms, a value on a bound belongs to the bucket of that bound
+	statistics->countFrame(0);
+	statistics->countFrame(1000000);
+	statistics->countFrame(2100000);
+	statistics->countFrame(8100000);
+	statistics->countChecksumError();
+	statistics->countChecksumError();
+	statistics->countSkippedBytes(57);
+	statistics->countMissedCycles(3);
+	statistics->countReadError();
+	for (size_t i = 0; i < 4; i++)
+	{
+		statistics->countRxOverflow();
+	}
+	for (size_t i = 0; i < 5; i++)
+	{
+		statistics->countDroppedFrame();
+	}
+	const uint32_t latencies[] = {0, 1, 2, 3, 1000, 1001};
+	for (size_t i = 0; i < sizeof(latencies) / sizeof(latencies[0]); i++)
+	{
+		statistics->recordDecodeLatency(latencies[i]);
+	}
+}
+#endif
+
+void setUp()
+{
+}
+
+void tearDown()
+{
+}
+
+#ifdef SMART_BMS_STATISTICS
+void test_values_are_placed_in_their_buckets()
+{
+	SmartBmsStatistics statistics;
+	fillStatistics(&statistics);
+	SmartBmsStatisticsSnapshot snapshot;
+	statistics.getSnapshot(&snapshot);
+
+	const uint32_t latencyBuckets[SMART_BMS_HISTOGRAM_BUCKET_COUNT] = {2, 1, 1, 0, 0, 0, 0, 0, 0, 1, 1};
+	const uint32_t intervalBuckets[SMART_BMS_HISTOGRAM_BUCKET_COUNT] = {0, 0, 0, 0, 0, 2, 0, 0, 0, 0, 1};
+	for (size_t i = 0; i < SMART_BMS_HISTOGRAM_BUCKET_COUNT; i++)
+	{
+		TEST_ASSERT_EQUAL(latencyBuckets[i], snapshot.decodeLatency.bucketCounts[i]);
+		TEST_ASSERT_EQUAL(intervalBuckets[i], snapshot.frameInterval.bucketCounts[i]);
+	}
+	TEST_ASSERT_EQUAL(6, snapshot.decodeLatency.count);
+	TEST_ASSERT_EQUAL(2007, snapshot.decodeLatency.sum);
+	TEST_ASSERT_EQUAL(3, snapshot.frameInterval.count);
+	TEST_ASSERT_EQUAL(8100, snapshot.frameInterval.sum);
+}
+
+void test_prometheus_text()
+{
+	SmartBmsStatistics statistics;
+	fillStatistics(&statistics);
+	char buffer[SMART_BMS_STATISTICS_BUFFER_SIZE];
+	TEST_ASSERT_EQUAL(strlen(TEST_PROMETHEUS), statistics.toPrometheus(buffer, sizeof(buffer)));
+	TEST_ASSERT_EQUAL_STRING(TEST_PROMETHEUS, buffer);
+
+	// A buffer that is too small leaves an empty text
+	TEST_ASSERT_EQUAL(0, statistics.toPrometheus(buffer, strlen(TEST_PROMETHEUS)));
+	TEST_ASSERT_EQUAL_STRING("", buffer);
+
+	// After a reset every counter and bucket is 0 again
+	statistics.reset();
+	SmartBmsStatisticsSnapshot snapshot;
+	statistics.getSnapshot(&snapshot);
+	const SmartBmsStatisticsSnapshot empty = {};
+	TEST_ASSERT_EQUAL_MEMORY(&empty, &snapshot, sizeof(snapshot));
+}
+
+void test_reader_counts_a_noisy_stream()
+{
+	std::vector<uint8_t> frames(TEST_FRAME_COUNT * SMART_BMS_FRAME_SIZE);
+	SmartBmsFrameGenerator generator(TEST_SEED);
+	generator.generate(frames.data(), TEST_FRAME_COUNT);
+
+	SmartBmsStatistics statistics;
+	SmartBmsReader smartBmsReader(nullptr);
+	smartBmsReader.setClock(getFakeTime);
+	smartBmsReader.setStatistics(&statistics);
+
+	// Every frame arrives at once one cycle after the previous one, some are corrupted and some are not sent at all
+	const SmartBmsNoiseProfile profile = {"mixed", 1000, 1000, 1000, 100, 32};
+	SmartBmsNoiseInjector injector(TEST_SEED, profile);
+	std::vector<uint32_t> timestamps;
+	for (size_t i = 0; i < TEST_FRAME_COUNT; i++)
+	{
+		if (i % TEST_MISSING_FRAME_INTERVAL == TEST_MISSING_FRAME_INTERVAL - 1)
+		{
+			continue;
+		}
+		std::vector<uint8_t> chunk;
+		injector.inject(&frames[i * SMART_BMS_FRAME_SIZE], SMART_BMS_FRAME_SIZE, &chunk);
+		fakeTime = 1000000 + i * TEST_CYCLE_PERIOD_US;
+		size_t position = 0;
+		while (position < chunk.size())
+		{
+			size_t consumed = 0;
+			SmartBmsFrameView frameView;
+			if (smartBmsReader.feed(&chunk[position], chunk.size() - position, &consumed, &frameView) == SmartBmsError::SBMS_OK)
+			{
+				// The fake clock stands still while decoding, so every decode takes 0 µs
+				SmartBmsData smartBmsData;
+				smartBmsReader.decode(frameView, &smartBmsData);
+				timestamps.push_back(frameView.getTimestamp());
+			}
+			position += consumed;
+		}
+	}
+
+	// The counters of the statistics agree with the reader
+	SmartBmsStatisticsSnapshot snapshot;
+	statistics.getSnapshot(&snapshot);
+	TEST_ASSERT_EQUAL(timestamps.size(), snapshot.frameCount);
+	TEST_ASSERT_EQUAL(smartBmsReader.getSkippedByteCount(), snapshot.skippedByteCount);
+	TEST_ASSERT_EQUAL(smartBmsReader.getMissedCycleCount(), snapshot.missedCycleCount);
+	TEST_ASSERT_GREATER_THAN(TEST_FRAME_COUNT / TEST_MISSING_FRAME_INTERVAL, snapshot.missedCycleCount);
+
+	// Every resynchronization starts with a checksum error and skips at least one byte
+	TEST_ASSERT_GREATER_THAN(0, snapshot.checksumErrorCount);
+	TEST_ASSERT_LESS_OR_EQUAL(snapshot.skippedByteCount, snapshot.checksumErrorCount);
+	TEST_ASSERT_EQUAL(0, snapshot.readErrorCount);
+	TEST_ASSERT_EQUAL(timestamps.size(), snapshot.decodeLatency.bucketCounts[0]);
+
+	// One cycle falls into the bucket up to 1250 ms, two to four cycles into the bucket up to 5000 ms and more into +Inf
+	uint32_t intervalBuckets[SMART_BMS_HISTOGRAM_BUCKET_COUNT] = {};
+	for (size_t i = 1; i < timestamps.size(); i++)
+	{
+		const uint32_t cycles = (timestamps[i] - timestamps[i - 1] + TEST_CYCLE_PERIOD_US / 2) / TEST_CYCLE_PERIOD_US;
+		intervalBuckets[cycles == 1 ? 6 : (cycles <= 4 ? 9 : 10)]++;
+	}
+	TEST_ASSERT_GREATER_THAN(0, intervalBuckets[9]);
+	for (size_t i = 0; i < SMART_BMS_HISTOGRAM_BUCKET_COUNT; i++)
+	{
+		TEST_ASSERT_EQUAL(intervalBuckets[i], snapshot.frameInterval.bucketCounts[i]);
+	}
+	TEST_ASSERT_EQUAL(timestamps.size() - 1, snapshot.frameInterval.count);
+}
+#endif
+
+int main()
+{
+	UNITY_BEGIN();
+#ifdef SMART_BMS_STATISTICS
+	RUN_TEST(test_values_are_placed_in_their_buckets);
+	RUN_TEST(test_prometheus_text);
+	RUN_TEST(test_reader_counts_a_noisy_stream);
+#endif
+	return UNITY_END();
+}
@@ -0,0 +1,82 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <unity.h>
+
+#include "bms/SmartBmsTextWriter.h"
+
+/**
+ * @brief Check an unsigned value against printf.
+ * @param value value to write
+ */
+static void checkUnsigned(const uint64_t value)
+{
+	char expected[32];
+	snprintf(expected, sizeof(expected), "%llu", static_cast<unsigned long long>(value));
+	char buffer[32];
+	SmartBmsTextWriter writer(buffer, sizeof(buffer));
+	writer.appendUnsigned(value);
+	TEST_ASSERT_GREATER_THAN(0, writer.finish());
+	TEST_ASSERT_EQUAL_STRING(expected, buffer);
+}
+
+/**
+ * @brief Check a signed value against printf.
+ * @param value value to write
+ */
+static void checkInteger(const int64_t value)
+{
+	char expected[32];
+	snprintf(expected, sizeof(expected), "%lld", static_cast<long long>(value));
+	char buffer[32];
+	SmartBmsTextWriter writer(buffer, sizeof(buffer));
+	writer.appendInteger(value);
+	TEST_ASSERT_GREATER_THAN(0, writer.finish());
+	TEST_ASSERT_EQUAL_STRING(expected, buffer);
+}
+
+void setUp()
+{
+}
+
+void tearDown()
+{
+}
+
+void test_unsigned_values_around_the_32_bit_limit()
+{
+	// Values up to 32 bits take the cheap division, larger ones start with the 64 bit division
+	const uint64_t values[] = {0, 9, 10, 52800, 999999999, 1000000000, UINT32_MAX - 1, UINT32_MAX,
+							   static_cast<uint64_t>(UINT32_MAX) + 1, 10000000000ULL, UINT64_MAX};
+	for (size_t i = 0; i < sizeof(values) / sizeof(values[0]); i++)
+	{
+		checkUnsigned(values[i]);
+	}
+}
+
+void test_signed_values()
+{
+	const int64_t values[] = {0, -1, 1, -232000, INT32_MIN, INT32_MAX, INT64_MIN, INT64_MAX};
+	for (size_t i = 0; i < sizeof(values) / sizeof(values[0]); i++)
+	{
+		checkInteger(values[i]);
+	}
+}
+
+void test_too_small_buffer_leaves_an_empty_text()
+{
+	char buffer[4];
+	SmartBmsTextWriter writer(buffer, sizeof(buffer));
+	writer.appendUnsigned(12345);
+	TEST_ASSERT_EQUAL(0, writer.finish());
+	TEST_ASSERT_TRUE(writer.hasOverflow());
+	TEST_ASSERT_EQUAL_STRING("", buffer);
+}
+
+int main()
+{
+	UNITY_BEGIN();
+	RUN_TEST(test_unsigned_values_around_the_32_bit_limit);
+	RUN_TEST(test_signed_values);
+	RUN_TEST(test_too_small_buffer_leaves_an_empty_text);
+	return UNITY_END();
+}
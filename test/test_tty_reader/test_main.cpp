@@ -0,0 +1,179 @@
+#include <stdint.h>
+#include <string.h>
+#include <vector>
+#include <unity.h>
+
+#if defined(__linux__)
+
+#include <pty.h>
+#include <unistd.h>
+#include <thread>
+
+#include "bms/SmartBmsFrameView.h"
+#include "host/SmartBmsFrameGenerator.h"
+#include "host/SmartBmsTtyReader.h"
+
+#define TEST_FRAME_COUNT 20
+#define TEST_SEED 0x5EED
+#define TEST_POLL_TIMEOUT_MS 100
+#define TEST_MAX_POLL_COUNT 50
+
+/**
+ * @brief Pseudo terminal that stands in for the BMS, the reader opens the slave and the test writes into the master.
+ */
+struct TestTerminal
+{
+	int master;
+	int slave;
+	char path[64];
+
+	TestTerminal()
+	{
+		TEST_ASSERT_EQUAL(0, openpty(&this->master, &this->slave, this->path, nullptr, nullptr));
+	}
+
+	~TestTerminal()
+	{
+		this->closeMaster();
+		::close(this->slave);
+	}
+
+	/**
+	 * @brief Write all bytes into the master.
+	 * @param data data to write
+	 * @param length number of bytes
+	 */
+	void write(const uint8_t *data, const size_t length)
+	{
+		TEST_ASSERT_EQUAL(length, ::write(this->master, data, length));
+	}
+
+	/**
+	 * @brief Close the master, which hangs up the slave.
+	 */
+	void closeMaster()
+	{
+		if (this->master >= 0)
+		{
+			::close(this->master);
+			this->master = -1;
+		}
+	}
+};
+
+/**
+ * @brief Collect the received frames.
+ * @param frameView completed frame
+ * @param context vector of frame bytes
+ */
+static void collectFrame(const SmartBmsFrameView *frameView, void *context)
+{
+	std::vector<uint8_t> *frames = static_cast<std::vector<uint8_t> *>(context);
+	frames->insert(frames->end(), frameView->getFrame(), frameView->getFrame() + SMART_BMS_FRAME_SIZE);
+}
+
+void setUp()
+{
+}
+
+void tearDown()
+{
+}
+
+void test_invalid_port_is_not_opened()
+{
+	TestTerminal terminal;
+	SmartBmsTtyReader ttyReader;
+	TEST_ASSERT_FALSE(ttyReader.open("/nonexistent/tty"));
+	TEST_ASSERT_FALSE(ttyReader.isOpen());
+	TEST_ASSERT_FALSE(ttyReader.open(terminal.path, 1234));
+	TEST_ASSERT_FALSE(ttyReader.isOpen());
+	TEST_ASSERT_EQUAL(-1, ttyReader.poll(0));
+
+	// A file is not a tty
+	TEST_ASSERT_FALSE(ttyReader.open("/dev/null"));
+	TEST_ASSERT_TRUE(ttyReader.open(terminal.path));
+	TEST_ASSERT_TRUE(ttyReader.isOpen());
+	TEST_ASSERT_TRUE(ttyReader.getFileDescriptor() >= 0);
+}
+
+void test_frames_arrive_through_the_terminal()
+{
+	std::vector<uint8_t> frames(TEST_FRAME_COUNT * SMART_BMS_FRAME_SIZE);
+	SmartBmsFrameGenerator generator(TEST_SEED);
+	generator.generate(frames.data(), TEST_FRAME_COUNT);
+
+	TestTerminal terminal;
+	SmartBmsTtyReader ttyReader;
+	std::vector<uint8_t> received;
+	ttyReader.setFrameCallback(collectFrame, &received);
+	TEST_ASSERT_TRUE(ttyReader.open(terminal.path));
+	TEST_ASSERT_EQUAL(0, ttyReader.poll(0));
+
+	// Split the frames at odd positions, so frames are completed across reads
+	const size_t chunkSize = SMART_BMS_FRAME_SIZE * 3 + 7;
+	for (size_t offset = 0; offset < frames.size(); offset += chunkSize)
+	{
+		terminal.write(&frames[offset], frames.size() - offset < chunkSize ? frames.size() - offset : chunkSize);
+	}
+	for (size_t i = 0; i < TEST_MAX_POLL_COUNT && ttyReader.getFrameCount() < TEST_FRAME_COUNT; i++)
+	{
+		TEST_ASSERT_TRUE(ttyReader.poll(TEST_POLL_TIMEOUT_MS) >= 0);
+	}
+
+	TEST_ASSERT_EQUAL(TEST_FRAME_COUNT, ttyReader.getFrameCount());
+	TEST_ASSERT_EQUAL(frames.size(), ttyReader.getReceivedByteCount());
+	TEST_ASSERT_EQUAL(frames.size(), received.size());
+	TEST_ASSERT_EQUAL(0, memcmp(frames.data(), received.data(), frames.size()));
+}
+
+void test_hang_up_is_reported()
+{
+	uint8_t frame[SMART_BMS_FRAME_SIZE];
+	SmartBmsFrameGenerator generator(TEST_SEED);
+	generator.generate(frame);
+
+	TestTerminal terminal;
+	SmartBmsTtyReader ttyReader;
+	TEST_ASSERT_TRUE(ttyReader.open(terminal.path));
+
+	// A hang up flushes the input of the slave, so the frame is read first
+	terminal.write(frame, sizeof(frame));
+	for (size_t i = 0; i < TEST_MAX_POLL_COUNT && ttyReader.getFrameCount() < 1; i++)
+	{
+		TEST_ASSERT_TRUE(ttyReader.poll(TEST_POLL_TIMEOUT_MS) >= 0);
+	}
+	terminal.closeMaster();
+	TEST_ASSERT_EQUAL(-1, ttyReader.poll(TEST_POLL_TIMEOUT_MS));
+	TEST_ASSERT_EQUAL(1, ttyReader.getFrameCount());
+	TEST_ASSERT_FALSE(ttyReader.run());
+}
+
+void test_stop_ends_the_loop()
+{
+	TestTerminal terminal;
+	SmartBmsTtyReader ttyReader;
+	TEST_ASSERT_TRUE(ttyReader.open(terminal.path));
+	bool stopped = false;
+	std::thread thread([&ttyReader, &stopped]()
+					   { stopped = ttyReader.run(); });
+	usleep(TEST_POLL_TIMEOUT_MS * 1000);
+	ttyReader.stop();
+	thread.join();
+	TEST_ASSERT_TRUE(stopped);
+	TEST_ASSERT_EQUAL(0, ttyReader.getFrameCount());
+}
+
+#endif
+
+int main()
+{
+	UNITY_BEGIN();
+#if defined(__linux__)
+	RUN_TEST(test_invalid_port_is_not_opened);
+	RUN_TEST(test_frames_arrive_through_the_terminal);
+	RUN_TEST(test_hang_up_is_reported);
+	RUN_TEST(test_stop_ends_the_loop);
+#endif
+	return UNITY_END();
+}
@@ -0,0 +1,329 @@
+#ifndef RECORDED_FRAMES_H
+#define RECORDED_FRAMES_H
+
+#include <stdint.h>
+
+#include "bms/SmartBmsField.h"
+
+// Frames recorded from SmartBmsFrameGenerator with fixed seeds, followed by hand made frames with the extreme values of every encoding
+static const uint8_t RECORDED_FRAMES[][SMART_BMS_FRAME_SIZE] = {
+	// 16 cells at rest
+	{0x00, 0x29, 0x50, 0x2B, 0x00, 0x00, 0x2B, 0x00, 0x00, 0x2B, 0x00, 0x00, 0x02, 0x8F, 0x03, 0x02, 0x9B, 0x0F, 0x01, 0x2B,
+	 0x0A, 0x01, 0x2F, 0x01, 0x01, 0x10, 0x02, 0x94, 0x01, 0x2D, 0x03, 0x00, 0x00, 0x00, 0x00, 0x1B, 0x58, 0x00, 0x00, 0x00,
+	 0x32, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x8F, 0x02, 0x30, 0x02, 0xDA, 0x02, 0xB2, 0x6F},
+	{0x00, 0x29, 0x50, 0x2B, 0x00, 0x00, 0x2B, 0x00, 0x01, 0x2D, 0x00, 0x01, 0x02, 0x94, 0x02, 0x02, 0x96, 0x02, 0x01, 0x2B,
+	 0x0D, 0x01, 0x2F, 0x06, 0x02, 0x10, 0x02, 0x95, 0x01, 0x2E, 0x03, 0x00, 0x00, 0x00, 0x00, 0x1B, 0x58, 0x00, 0x00, 0x00,
+	 0x32, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x8F, 0x02, 0x30, 0x02, 0xDA, 0x02, 0xB2, 0x70},
+	{0x00, 0x29, 0x40, 0x2B, 0x00, 0x03, 0x2B, 0x00, 0x00, 0x2B, 0x00, 0x03, 0x02, 0x94, 0x03, 0x02, 0x94, 0x03, 0x01, 0x2C,
+	 0x0A, 0x01, 0x30, 0x07, 0x03, 0x10, 0x02, 0x95, 0x01, 0x2D, 0x03, 0x00, 0x00, 0x00, 0x00, 0x1B, 0x58, 0x00, 0x00, 0x00,
+	 0x32, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x8F, 0x02, 0x30, 0x02, 0xDA, 0x02, 0xB2, 0x62},
+	{0x00, 0x29, 0x40, 0x2B, 0x00, 0x03, 0x2B, 0x00, 0x00, 0x2B, 0x00, 0x03, 0x02, 0x90, 0x06, 0x02, 0x98, 0x02, 0x01, 0x2C,
+	 0x02, 0x01, 0x30, 0x07, 0x04, 0x10, 0x02, 0x96, 0x01, 0x2E, 0x03, 0x00, 0x00, 0x00, 0x00, 0x1B, 0x58, 0x00, 0x00, 0x00,
+	 0x32, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x8F, 0x02, 0x30, 0x02, 0xDA, 0x02, 0xB2, 0x5F},
+	{0x00, 0x29, 0x50, 0x2B, 0x00, 0x00, 0x2B, 0x00, 0x00, 0x2B, 0x00, 0x00, 0x02, 0x93, 0x0A, 0x02, 0x97, 0x05, 0x01, 0x2B,
+	 0x06, 0x01, 0x2F, 0x0B, 0x05, 0x10, 0x02, 0x93, 0x01, 0x2E, 0x03, 0x00, 0x00, 0x00, 0x00, 0x1B, 0x58, 0x00, 0x00, 0x00,
+	 0x32, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x8F, 0x02, 0x30, 0x02, 0xDA, 0x02, 0xB2, 0x76},
+	{0x00, 0x29, 0x50, 0x2B, 0x00, 0x00, 0x2B, 0x00, 0x00, 0x2B, 0x00, 0x00, 0x02, 0x90, 0x04, 0x02, 0x9A, 0x04, 0x01, 0x2C,
+	 0x0E, 0x01, 0x30, 0x02, 0x06, 0x10, 0x02, 0x94, 0x01, 0x2D, 0x03, 0x00, 0x00, 0x00, 0x00, 0x1B, 0x58, 0x00, 0x00, 0x00,
+	 0x32, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x8F, 0x02, 0x30, 0x02, 0xDA, 0x02, 0xB2, 0x71},
+	{0x00, 0x29, 0x50, 0x2B, 0x00, 0x04, 0x2B, 0x00, 0x00, 0x2B, 0x00, 0x04, 0x02, 0x91, 0x0C, 0x02, 0x99, 0x0F, 0x01, 0x2B,
+	 0x06, 0x01, 0x2F, 0x05, 0x07, 0x10, 0x02, 0x95, 0x01, 0x2D, 0x03, 0x00, 0x00, 0x00, 0x00, 0x1B, 0x58, 0x00, 0x00, 0x00,
+	 0x32, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x8F, 0x02, 0x30, 0x02, 0xDA, 0x02, 0xB2, 0x87},
+	{0x00, 0x29, 0x50, 0x2B, 0x00, 0x07, 0x2B, 0x00, 0x00, 0x2B, 0x00, 0x07, 0x02, 0x92, 0x05, 0x02, 0x98, 0x02, 0x01, 0x2C,
+	 0x03, 0x01, 0x30, 0x0C, 0x08, 0x10, 0x02, 0x96, 0x01, 0x2F, 0x03, 0x00, 0x00, 0x00, 0x00, 0x1B, 0x58, 0x00, 0x00, 0x00,
+	 0x32, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x8F, 0x02, 0x30, 0x02, 0xDA, 0x02, 0xB2, 0x83},
+	{0x00, 0x29, 0x40, 0x2B, 0x00, 0x07, 0x2B, 0x00, 0x00, 0x2B, 0x00, 0x07, 0x02, 0x8D, 0x04, 0x02, 0x9B, 0x02, 0x01, 0x2D,
+	 0x07, 0x01, 0x31, 0x03, 0x09, 0x10, 0x02, 0x96, 0x01, 0x2E, 0x03, 0x00, 0x00, 0x00, 0x00, 0x1B, 0x58, 0x00, 0x00, 0x00,
+	 0x32, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x8F, 0x02, 0x30, 0x02, 0xDA, 0x02, 0xB2, 0x6D},
+	{0x00, 0x29, 0x30, 0x2B, 0x00, 0x0B, 0x2B, 0x00, 0x00, 0x2B, 0x00, 0x0B, 0x02, 0x8E, 0x03, 0x02, 0x98, 0x0F, 0x01, 0x2E,
+	 0x02, 0x01, 0x32, 0x10, 0x0A, 0x10, 0x02, 0x91, 0x01, 0x30, 0x03, 0x00, 0x00, 0x00, 0x00, 0x1B, 0x58, 0x00, 0x00, 0x00,
+	 0x32, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x8F, 0x02, 0x30, 0x02, 0xDA, 0x02, 0xB2, 0x77},
+	{0x00, 0x29, 0x30, 0x2B, 0x00, 0x0E, 0x2B, 0x00, 0x00, 0x2B, 0x00, 0x0E, 0x02, 0x90, 0x0C, 0x02, 0x96, 0x10, 0x01, 0x2D,
+	 0x08, 0x01, 0x31, 0x04, 0x0B, 0x10, 0x02, 0x92, 0x01, 0x30, 0x03, 0x00, 0x00, 0x00, 0x00, 0x1B, 0x58, 0x00, 0x00, 0x00,
+	 0x32, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x8F, 0x02, 0x30, 0x02, 0xDA, 0x02, 0xB2, 0x81},
+	{0x00, 0x29, 0x20, 0x2B, 0x00, 0x10, 0x2B, 0x00, 0x00, 0x2B, 0x00, 0x10, 0x02, 0x8B, 0x02, 0x02, 0x99, 0x09, 0x01, 0x2E,
+	 0x0B, 0x01, 0x32, 0x0B, 0x0C, 0x10, 0x02, 0x92, 0x01, 0x2F, 0x03, 0x00, 0x00, 0x00, 0x00, 0x1B, 0x58, 0x00, 0x00, 0x00,
+	 0x32, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x8F, 0x02, 0x30, 0x02, 0xDA, 0x02, 0xB2, 0x6E},
+	{0x00, 0x29, 0x30, 0x2B, 0x00, 0x11, 0x2B, 0x00, 0x00, 0x2B, 0x00, 0x11, 0x02, 0x8D, 0x08, 0x02, 0x99, 0x0F, 0x01, 0x2F,
+	 0x0D, 0x01, 0x33, 0x0C, 0x0D, 0x10, 0x02, 0x94, 0x01, 0x31, 0x03, 0x00, 0x00, 0x00, 0x00, 0x1B, 0x58, 0x00, 0x00, 0x00,
+	 0x32, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x8F, 0x02, 0x30, 0x02, 0xDA, 0x02, 0xB2, 0x98},
+	{0x00, 0x29, 0x20, 0x2B, 0x00, 0x13, 0x2B, 0x00, 0x00, 0x2B, 0x00, 0x13, 0x02, 0x8B, 0x09, 0x02, 0x99, 0x03, 0x01, 0x2F,
+	 0x03, 0x01, 0x33, 0x05, 0x0E, 0x10, 0x02, 0x94, 0x01, 0x32, 0x03, 0x00, 0x00, 0x00, 0x00, 0x1B, 0x58, 0x00, 0x00, 0x00,
+	 0x32, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x8F, 0x02, 0x30, 0x02, 0xDA, 0x02, 0xB2, 0x70},
+	{0x00, 0x29, 0x30, 0x2B, 0x00, 0x16, 0x2B, 0x00, 0x00, 0x2B, 0x00, 0x16, 0x02, 0x8E, 0x0F, 0x02, 0x98, 0x0C, 0x01, 0x2F,
+	 0x07, 0x01, 0x33, 0x0B, 0x0F, 0x10, 0x02, 0x91, 0x01, 0x30, 0x03, 0x00, 0x00, 0x00, 0x00, 0x1B, 0x58, 0x00, 0x00, 0x00,
+	 0x32, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x8F, 0x02, 0x30, 0x02, 0xDA, 0x02, 0xB2, 0x9D},
+	{0x00, 0x29, 0x30, 0x2B, 0x00, 0x13, 0x2B, 0x00, 0x00, 0x2B, 0x00, 0x13, 0x02, 0x90, 0x0F, 0x02, 0x96, 0x09, 0x01, 0x2E,
+	 0x07, 0x01, 0x32, 0x03, 0x10, 0x10, 0x02, 0x92, 0x01, 0x30, 0x03, 0x00, 0x00, 0x00, 0x00, 0x1B, 0x58, 0x00, 0x00, 0x00,
+	 0x32, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x8F, 0x02, 0x30, 0x02, 0xDA, 0x02, 0xB2, 0x8C},
+	{0x00, 0x29, 0x20, 0x2B, 0x00, 0x11, 0x2B, 0x00, 0x00, 0x2B, 0x00, 0x11, 0x02, 0x92, 0x01, 0x02, 0x92, 0x0F, 0x01, 0x2E,
+	 0x0F, 0x01, 0x32, 0x0B, 0x01, 0x10, 0x02, 0x91, 0x01, 0x30, 0x03, 0x00, 0x00, 0x00, 0x00, 0x1B, 0x58, 0x00, 0x00, 0x00,
+	 0x32, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x8F, 0x02, 0x30, 0x02, 0xDA, 0x02, 0xB2, 0x6E},
+	{0x00, 0x29, 0x10, 0x2B, 0x00, 0x0F, 0x2B, 0x00, 0x00, 0x2B, 0x00, 0x0F, 0x02, 0x8C, 0x10, 0x02, 0x96, 0x0A, 0x01, 0x2D,
+	 0x0C, 0x01, 0x31, 0x08, 0x02, 0x10, 0x02, 0x91, 0x01, 0x30, 0x03, 0x00, 0x00, 0x00, 0x00, 0x1B, 0x58, 0x00, 0x00, 0x00,
+	 0x32, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x8F, 0x02, 0x30, 0x02, 0xDA, 0x02, 0xB2, 0x5B},
+	{0x00, 0x29, 0x00, 0x2B, 0x00, 0x0C, 0x2B, 0x00, 0x00, 0x2B, 0x00, 0x0C, 0x02, 0x90, 0x0B, 0x02, 0x90, 0x05, 0x01, 0x2D,
+	 0x0E, 0x01, 0x31, 0x10, 0x03, 0x10, 0x02, 0x91, 0x01, 0x2E, 0x03, 0x00, 0x00, 0x00, 0x00, 0x1B, 0x58, 0x00, 0x00, 0x00,
+	 0x32, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x8F, 0x02, 0x30, 0x02, 0xDA, 0x02, 0xB2, 0x42},
+	{0x00, 0x29, 0x00, 0x2B, 0x00, 0x0D, 0x2B, 0x00, 0x00, 0x2B, 0x00, 0x0D, 0x02, 0x89, 0x0A, 0x02, 0x97, 0x05, 0x01, 0x2E,
+	 0x02, 0x01, 0x32, 0x0B, 0x04, 0x10, 0x02, 0x92, 0x01, 0x30, 0x03, 0x00, 0x00, 0x00, 0x00, 0x1B, 0x58, 0x00, 0x00, 0x00,
+	 0x32, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x8F, 0x02, 0x30, 0x02, 0xDA, 0x02, 0xB2, 0x38},
+	{0x00, 0x28, 0xF0, 0x2B, 0x00, 0x0C, 0x2B, 0x00, 0x00, 0x2B, 0x00, 0x0C, 0x02, 0x8E, 0x10, 0x02, 0x90, 0x0E, 0x01, 0x2E,
+	 0x06, 0x01, 0x32, 0x08, 0x05, 0x10, 0x02, 0x8D, 0x01, 0x31, 0x03, 0x00, 0x00, 0x00, 0x00, 0x1B, 0x58, 0x00, 0x00, 0x00,
+	 0x32, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x8F, 0x02, 0x30, 0x02, 0xDA, 0x02, 0xB2, 0x30},
+	{0x00, 0x29, 0x00, 0x2B, 0x00, 0x0E, 0x2B, 0x00, 0x00, 0x2B, 0x00, 0x0E, 0x02, 0x8E, 0x01, 0x02, 0x92, 0x0E, 0x01, 0x2F,
+	 0x0D, 0x01, 0x33, 0x0B, 0x06, 0x10, 0x02, 0x8F, 0x01, 0x30, 0x03, 0x00, 0x00, 0x00, 0x00, 0x1B, 0x58, 0x00, 0x00, 0x00,
+	 0x32, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x8F, 0x02, 0x30, 0x02, 0xDA, 0x02, 0xB2, 0x46},
+	{0x00, 0x29, 0x10, 0x2B, 0x00, 0x0C, 0x2B, 0x00, 0x00, 0x2B, 0x00, 0x0C, 0x02, 0x91, 0x0C, 0x02, 0x91, 0x0E, 0x01, 0x2E,
+	 0x03, 0x01, 0x32, 0x04, 0x07, 0x10, 0x02, 0x91, 0x01, 0x30, 0x03, 0x00, 0x00, 0x00, 0x00, 0x1B, 0x58, 0x00, 0x00, 0x00,
+	 0x32, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x8F, 0x02, 0x30, 0x02, 0xDA, 0x02, 0xB2, 0x4F},
+	{0x00, 0x29, 0x20, 0x2B, 0x00, 0x0A, 0x2B, 0x00, 0x00, 0x2B, 0x00, 0x0A, 0x02, 0x8B, 0x08, 0x02, 0x99, 0x0E, 0x01, 0x2E,
+	 0x10, 0x01, 0x32, 0x10, 0x08, 0x10, 0x02, 0x93, 0x01, 0x31, 0x03, 0x00, 0x00, 0x00, 0x00, 0x1B, 0x58, 0x00, 0x00, 0x00,
+	 0x32, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x8F, 0x02, 0x30, 0x02, 0xDA, 0x02, 0xB2, 0x76},
+	{0x00, 0x29, 0x20, 0x2B, 0x00, 0x06, 0x2B, 0x00, 0x00, 0x2B, 0x00, 0x06, 0x02, 0x8D, 0x0D, 0x02, 0x97, 0x03, 0x01, 0x2D,
+	 0x07, 0x01, 0x31, 0x10, 0x09, 0x10, 0x02, 0x94, 0x01, 0x2E, 0x03, 0x00, 0x00, 0x00, 0x00, 0x1B, 0x58, 0x00, 0x00, 0x00,
+	 0x32, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x8F, 0x02, 0x30, 0x02, 0xDA, 0x02, 0xB2, 0x5C},
+	{0x00, 0x29, 0x30, 0x2B, 0x00, 0x08, 0x2B, 0x00, 0x00, 0x2B, 0x00, 0x08, 0x02, 0x93, 0x0D, 0x02, 0x93, 0x02, 0x01, 0x2E,
+	 0x03, 0x01, 0x32, 0x06, 0x0A, 0x10, 0x02, 0x91, 0x01, 0x30, 0x03, 0x00, 0x00, 0x00, 0x00, 0x1B, 0x58, 0x00, 0x00, 0x00,
+	 0x32, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x8F, 0x02, 0x30, 0x02, 0xDA, 0x02, 0xB2, 0x65},
+	{0x00, 0x29, 0x20, 0x2B, 0x00, 0x05, 0x2B, 0x00, 0x00, 0x2B, 0x00, 0x05, 0x02, 0x92, 0x10, 0x02, 0x92, 0x02, 0x01, 0x2E,
+	 0x10, 0x01, 0x32, 0x03, 0x0B, 0x10, 0x02, 0x91, 0x01, 0x31, 0x03, 0x00, 0x00, 0x00, 0x00, 0x1B, 0x58, 0x00, 0x00, 0x00,
+	 0x32, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x8F, 0x02, 0x30, 0x02, 0xDA, 0x02, 0xB2, 0x5C},
+	{0x00, 0x29, 0x20, 0x2B, 0x00, 0x03, 0x2B, 0x00, 0x00, 0x2B, 0x00, 0x03, 0x02, 0x8F, 0x07, 0x02, 0x95, 0x0B, 0x01, 0x2E,
+	 0x0C, 0x01, 0x32, 0x07, 0x0C, 0x10, 0x02, 0x92, 0x01, 0x2F, 0x03, 0x00, 0x00, 0x00, 0x00, 0x1B, 0x58, 0x00, 0x00, 0x00,
+	 0x32, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x8F, 0x02, 0x30, 0x02, 0xDA, 0x02, 0xB2, 0x58},
+	{0x00, 0x29, 0x20, 0x2B, 0x00, 0x04, 0x2B, 0x00, 0x00, 0x2B, 0x00, 0x04, 0x02, 0x8C, 0x0E, 0x02, 0x98, 0x05, 0x01, 0x2F,
+	 0x0F, 0x01, 0x33, 0x04, 0x0D, 0x10, 0x02, 0x93, 0x01, 0x31, 0x03, 0x00, 0x00, 0x00, 0x00, 0x1B, 0x58, 0x00, 0x00, 0x00,
+	 0x32, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x8F, 0x02, 0x30, 0x02, 0xDA, 0x02, 0xB2, 0x61},
+	{0x00, 0x29, 0x20, 0x2B, 0x00, 0x08, 0x2B, 0x00, 0x00, 0x2B, 0x00, 0x08, 0x02, 0x8B, 0x01, 0x02, 0x99, 0x0C, 0x01, 0x30,
+	 0x07, 0x01, 0x34, 0x0E, 0x0E, 0x10, 0x02, 0x94, 0x01, 0x33, 0x03, 0x00, 0x00, 0x00, 0x00, 0x1B, 0x58, 0x00, 0x00, 0x00,
+	 0x32, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x8F, 0x02, 0x30, 0x02, 0xDA, 0x02, 0xB2, 0x6B},
+	{0x00, 0x29, 0x10, 0x2B, 0x00, 0x0C, 0x2B, 0x00, 0x00, 0x2B, 0x00, 0x0C, 0x02, 0x8B, 0x0B, 0x02, 0x97, 0x06, 0x01, 0x2F,
+	 0x01, 0x01, 0x33, 0x03, 0x0F, 0x10, 0x02, 0x8F, 0x01, 0x30, 0x03, 0x00, 0x00, 0x00, 0x00, 0x1B, 0x58, 0x00, 0x00, 0x00,
+	 0x32, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x8F, 0x02, 0x30, 0x02, 0xDA, 0x02, 0xB2, 0x4B},
+	{0x00, 0x29, 0x10, 0x2B, 0x00, 0x0A, 0x2B, 0x00, 0x00, 0x2B, 0x00, 0x0A, 0x02, 0x8F, 0x0A, 0x02, 0x93, 0x07, 0x01, 0x30,
+	 0x06, 0x01, 0x34, 0x10, 0x10, 0x10, 0x02, 0x90, 0x01, 0x32, 0x03, 0x00, 0x00, 0x00, 0x00, 0x1B, 0x58, 0x00, 0x00, 0x00,
+	 0x32, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x8F, 0x02, 0x30, 0x02, 0xDA, 0x02, 0xB2, 0x5F},
+	{0x00, 0x29, 0x00, 0x2B, 0x00, 0x08, 0x2B, 0x00, 0x00, 0x2B, 0x00, 0x08, 0x02, 0x90, 0x09, 0x02, 0x90, 0x05, 0x01, 0x30,
+	 0x04, 0x01, 0x34, 0x0D, 0x01, 0x10, 0x02, 0x8F, 0x01, 0x32, 0x03, 0x00, 0x00, 0x00, 0x00, 0x1B, 0x58, 0x00, 0x00, 0x00,
+	 0x32, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x8F, 0x02, 0x30, 0x02, 0xDA, 0x02, 0xB2, 0x31},
+	{0x00, 0x28, 0xF0, 0x2B, 0x00, 0x07, 0x2B, 0x00, 0x00, 0x2B, 0x00, 0x07, 0x02, 0x89, 0x08, 0x02, 0x95, 0x05, 0x01, 0x30,
+	 0x07, 0x01, 0x34, 0x0F, 0x02, 0x10, 0x02, 0x8F, 0x01, 0x33, 0x03, 0x00, 0x00, 0x00, 0x00, 0x1B, 0x58, 0x00, 0x00, 0x00,
+	 0x32, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x8F, 0x02, 0x30, 0x02, 0xDA, 0x02, 0xB2, 0x22},
+	{0x00, 0x28, 0xF0, 0x2B, 0x00, 0x05, 0x2B, 0x00, 0x00, 0x2B, 0x00, 0x05, 0x02, 0x89, 0x06, 0x02, 0x95, 0x09, 0x01, 0x30,
+	 0x06, 0x01, 0x34, 0x09, 0x03, 0x10, 0x02, 0x90, 0x01, 0x31, 0x03, 0x00, 0x00, 0x00, 0x00, 0x1B, 0x58, 0x00, 0x00, 0x00,
+	 0x32, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x8F, 0x02, 0x30, 0x02, 0xDA, 0x02, 0xB2, 0x19},
+	{0x00, 0x28, 0xE0, 0x2B, 0x00, 0x02, 0x2B, 0x00, 0x00, 0x2B, 0x00, 0x02, 0x02, 0x8B, 0x0B, 0x02, 0x91, 0x0F, 0x01, 0x30,
+	 0x09, 0x01, 0x34, 0x05, 0x04, 0x10, 0x02, 0x90, 0x01, 0x32, 0x03, 0x00, 0x00, 0x00, 0x00, 0x1B, 0x58, 0x00, 0x00, 0x00,
+	 0x32, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x8F, 0x02, 0x30, 0x02, 0xDA, 0x02, 0xB2, 0x0D},
+	{0x00, 0x28, 0xD0, 0x2B, 0x00, 0x03, 0x2B, 0x00, 0x00, 0x2B, 0x00, 0x03, 0x02, 0x8C, 0x06, 0x02, 0x8E, 0x08, 0x01, 0x30,
+	 0x0A, 0x01, 0x34, 0x05, 0x05, 0x10, 0x02, 0x8B, 0x01, 0x33, 0x03, 0x00, 0x00, 0x00, 0x00, 0x1B, 0x58, 0x00, 0x00, 0x00,
+	 0x32, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x8F, 0x02, 0x30, 0x02, 0xDA, 0x02, 0xB2, 0xEF},
+	{0x00, 0x28, 0xC0, 0x2B, 0x00, 0x03, 0x2B, 0x00, 0x00, 0x2B, 0x00, 0x03, 0x02, 0x89, 0x0A, 0x02, 0x8F, 0x0C, 0x01, 0x30,
+	 0x04, 0x01, 0x34, 0x09, 0x06, 0x10, 0x02, 0x8B, 0x01, 0x31, 0x03, 0x00, 0x00, 0x00, 0x00, 0x1B, 0x58, 0x00, 0x00, 0x00,
+	 0x32, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x8F, 0x02, 0x30, 0x02, 0xDA, 0x02, 0xB2, 0xE2},
+	{0x00, 0x28, 0xC0, 0x2B, 0x00, 0x04, 0x2B, 0x00, 0x00, 0x2B, 0x00, 0x04, 0x02, 0x89, 0x04, 0x02, 0x8F, 0x0E, 0x01, 0x30,
+	 0x0A, 0x01, 0x34, 0x02, 0x07, 0x10, 0x02, 0x8C, 0x01, 0x32, 0x03, 0x00, 0x00, 0x00, 0x00, 0x1B, 0x58, 0x00, 0x00, 0x00,
+	 0x32, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x8F, 0x02, 0x30, 0x02, 0xDA, 0x02, 0xB2, 0xE2},
+	{0x00, 0x28, 0xC0, 0x2B, 0x00, 0x04, 0x2B, 0x00, 0x00, 0x2B, 0x00, 0x04, 0x02, 0x86, 0x04, 0x02, 0x92, 0x02, 0x01, 0x31,
+	 0x0F, 0x01, 0x35, 0x02, 0x08, 0x10, 0x02, 0x8D, 0x01, 0x34, 0x03, 0x00, 0x00, 0x00, 0x00, 0x1B, 0x58, 0x00, 0x00, 0x00,
+	 0x32, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x8F, 0x02, 0x30, 0x02, 0xDA, 0x02, 0xB2, 0xE1},
+	{0x00, 0x28, 0xB0, 0x2B, 0x00, 0x03, 0x2B, 0x00, 0x00, 0x2B, 0x00, 0x03, 0x02, 0x89, 0x07, 0x02, 0x8D, 0x07, 0x01, 0x31,
+	 0x09, 0x01, 0x35, 0x0D, 0x09, 0x10, 0x02, 0x8D, 0x01, 0x32, 0x03, 0x00, 0x00, 0x00, 0x00, 0x1B, 0x58, 0x00, 0x00, 0x00,
+	 0x32, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x8F, 0x02, 0x30, 0x02, 0xDA, 0x02, 0xB2, 0xD9},
+	{0x00, 0x28, 0xB0, 0x2B, 0x00, 0x00, 0x2B, 0x00, 0x01, 0x2D, 0x00, 0x01, 0x02, 0x8B, 0x04, 0x02, 0x8B, 0x0D, 0x01, 0x30,
+	 0x10, 0x01, 0x34, 0x0B, 0x0A, 0x10, 0x02, 0x89, 0x01, 0x32, 0x03, 0x00, 0x00, 0x00, 0x00, 0x1B, 0x58, 0x00, 0x00, 0x00,
+	 0x32, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x8F, 0x02, 0x30, 0x02, 0xDA, 0x02, 0xB2, 0xDA},
+	{0x00, 0x28, 0xB0, 0x2B, 0x00, 0x00, 0x2B, 0x00, 0x05, 0x2D, 0x00, 0x05, 0x02, 0x84, 0x0B, 0x02, 0x92, 0x01, 0x01, 0x30,
+	 0x0B, 0x01, 0x34, 0x0D, 0x0B, 0x10, 0x02, 0x8A, 0x01, 0x33, 0x03, 0x00, 0x00, 0x00, 0x00, 0x1B, 0x58, 0x00, 0x00, 0x00,
+	 0x32, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x8F, 0x02, 0x30, 0x02, 0xDA, 0x02, 0xB2, 0xDD},
+	{0x00, 0x28, 0xC0, 0x2B, 0x00, 0x00, 0x2B, 0x00, 0x09, 0x2D, 0x00, 0x09, 0x02, 0x86, 0x05, 0x02, 0x92, 0x05, 0x01, 0x30,
+	 0x08, 0x01, 0x34, 0x03, 0x0C, 0x10, 0x02, 0x8C, 0x01, 0x31, 0x03, 0x00, 0x00, 0x00, 0x00, 0x1B, 0x58, 0x00, 0x00, 0x00,
+	 0x32, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x8F, 0x02, 0x30, 0x02, 0xDA, 0x02, 0xB2, 0xE9},
+	{0x00, 0x28, 0xB0, 0x2B, 0x00, 0x00, 0x2B, 0x00, 0x0B, 0x2D, 0x00, 0x0B, 0x02, 0x89, 0x09, 0x02, 0x8D, 0x05, 0x01, 0x31,
+	 0x10, 0x01, 0x35, 0x09, 0x0D, 0x10, 0x02, 0x8C, 0x01, 0x33, 0x03, 0x00, 0x00, 0x00, 0x00, 0x1B, 0x58, 0x00, 0x00, 0x00,
+	 0x32, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x8F, 0x02, 0x30, 0x02, 0xDA, 0x02, 0xB2, 0xF2},
+	{0x00, 0x28, 0xA0, 0x2B, 0x00, 0x00, 0x2B, 0x00, 0x09, 0x2D, 0x00, 0x09, 0x02, 0x89, 0x09, 0x02, 0x8B, 0x0F, 0x01, 0x30,
+	 0x02, 0x01, 0x34, 0x10, 0x0E, 0x10, 0x02, 0x8C, 0x01, 0x33, 0x03, 0x00, 0x00, 0x00, 0x00, 0x1B, 0x58, 0x00, 0x00, 0x00,
+	 0x32, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x8F, 0x02, 0x30, 0x02, 0xDA, 0x02, 0xB2, 0xDE},
+	{0x00, 0x28, 0x90, 0x2B, 0x00, 0x00, 0x2B, 0x00, 0x08, 0x2D, 0x00, 0x08, 0x02, 0x86, 0x03, 0x02, 0x8C, 0x05, 0x01, 0x31,
+	 0x0A, 0x01, 0x35, 0x0E, 0x0F, 0x10, 0x02, 0x87, 0x01, 0x32, 0x03, 0x00, 0x00, 0x00, 0x00, 0x1B, 0x58, 0x00, 0x00, 0x00,
+	 0x32, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x8F, 0x02, 0x30, 0x02, 0xDA, 0x02, 0xB2, 0xBD},
+	{0x00, 0x28, 0x80, 0x2B, 0x00, 0x00, 0x2B, 0x00, 0x0A, 0x2D, 0x00, 0x0A, 0x02, 0x81, 0x0E, 0x02, 0x8F, 0x09, 0x01, 0x32,
+	 0x0C, 0x01, 0x36, 0x03, 0x10, 0x10, 0x02, 0x87, 0x01, 0x34, 0x03, 0x00, 0x00, 0x00, 0x00, 0x1B, 0x58, 0x00, 0x00, 0x00,
+	 0x32, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x8F, 0x02, 0x30, 0x02, 0xDA, 0x02, 0xB2, 0xBA},
+	// 4 cells
+	{0x00, 0x0A, 0x4C, 0x2B, 0x00, 0x03, 0x2B, 0x00, 0x00, 0x2B, 0x00, 0x03, 0x02, 0x8E, 0x04, 0x02, 0x98, 0x01, 0x01, 0x2A,
+	 0x03, 0x01, 0x2E, 0x04, 0x01, 0x04, 0x02, 0x92, 0x01, 0x2C, 0x03, 0x00, 0x00, 0x00, 0x00, 0x1B, 0x58, 0x00, 0x00, 0x00,
+	 0x32, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x8F, 0x02, 0x30, 0x02, 0xDA, 0x02, 0xB2, 0x2C},
+	{0x00, 0x0A, 0x50, 0x2B, 0x00, 0x01, 0x2B, 0x00, 0x00, 0x2B, 0x00, 0x01, 0x02, 0x90, 0x01, 0x02, 0x98, 0x03, 0x01, 0x2B,
+	 0x02, 0x01, 0x2F, 0x02, 0x02, 0x04, 0x02, 0x94, 0x01, 0x2E, 0x03, 0x00, 0x00, 0x00, 0x00, 0x1B, 0x58, 0x00, 0x00, 0x00,
+	 0x32, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x8F, 0x02, 0x30, 0x02, 0xDA, 0x02, 0xB2, 0x31},
+	{0x00, 0x0A, 0x54, 0x2B, 0x00, 0x04, 0x2B, 0x00, 0x00, 0x2B, 0x00, 0x04, 0x02, 0x92, 0x01, 0x02, 0x98, 0x01, 0x01, 0x2C,
+	 0x04, 0x01, 0x30, 0x01, 0x03, 0x04, 0x02, 0x96, 0x01, 0x2D, 0x03, 0x00, 0x00, 0x00, 0x00, 0x1B, 0x58, 0x00, 0x00, 0x00,
+	 0x32, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x8F, 0x02, 0x30, 0x02, 0xDA, 0x02, 0xB2, 0x40},
+	{0x00, 0x0A, 0x58, 0x2B, 0x00, 0x06, 0x2B, 0x00, 0x00, 0x2B, 0x00, 0x06, 0x02, 0x8F, 0x03, 0x02, 0x9D, 0x02, 0x01, 0x2C,
+	 0x02, 0x01, 0x30, 0x04, 0x04, 0x04, 0x02, 0x98, 0x01, 0x2E, 0x03, 0x00, 0x00, 0x00, 0x00, 0x1B, 0x58, 0x00, 0x00, 0x00,
+	 0x32, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x8F, 0x02, 0x30, 0x02, 0xDA, 0x02, 0xB2, 0x52},
+	{0x00, 0x0A, 0x54, 0x2B, 0x00, 0x04, 0x2B, 0x00, 0x00, 0x2B, 0x00, 0x04, 0x02, 0x8F, 0x02, 0x02, 0x9B, 0x01, 0x01, 0x2D,
+	 0x02, 0x01, 0x31, 0x04, 0x01, 0x04, 0x02, 0x94, 0x01, 0x2F, 0x03, 0x00, 0x00, 0x00, 0x00, 0x1B, 0x58, 0x00, 0x00, 0x00,
+	 0x32, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x8F, 0x02, 0x30, 0x02, 0xDA, 0x02, 0xB2, 0x42},
+	{0x00, 0x0A, 0x50, 0x2B, 0x00, 0x03, 0x2B, 0x00, 0x00, 0x2B, 0x00, 0x03, 0x02, 0x90, 0x04, 0x02, 0x98, 0x02, 0x01, 0x2E,
+	 0x04, 0x01, 0x32, 0x03, 0x02, 0x04, 0x02, 0x94, 0x01, 0x31, 0x03, 0x00, 0x00, 0x00, 0x00, 0x1B, 0x58, 0x00, 0x00, 0x00,
+	 0x32, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x8F, 0x02, 0x30, 0x02, 0xDA, 0x02, 0xB2, 0x43},
+	{0x00, 0x0A, 0x50, 0x2B, 0x00, 0x05, 0x2B, 0x00, 0x00, 0x2B, 0x00, 0x05, 0x02, 0x8D, 0x03, 0x02, 0x9B, 0x04, 0x01, 0x2D,
+	 0x01, 0x01, 0x31, 0x02, 0x03, 0x04, 0x02, 0x95, 0x01, 0x2E, 0x03, 0x00, 0x00, 0x00, 0x00, 0x1B, 0x58, 0x00, 0x00, 0x00,
+	 0x32, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x8F, 0x02, 0x30, 0x02, 0xDA, 0x02, 0xB2, 0x41},
+	{0x00, 0x0A, 0x50, 0x2B, 0x00, 0x09, 0x2B, 0x00, 0x00, 0x2B, 0x00, 0x09, 0x02, 0x8E, 0x04, 0x02, 0x9A, 0x04, 0x01, 0x2C,
+	 0x04, 0x01, 0x30, 0x02, 0x04, 0x04, 0x02, 0x96, 0x01, 0x2E, 0x03, 0x00, 0x00, 0x00, 0x00, 0x1B, 0x58, 0x00, 0x00, 0x00,
+	 0x32, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x8F, 0x02, 0x30, 0x02, 0xDA, 0x02, 0xB2, 0x4D},
+	{0x00, 0x0A, 0x50, 0x2B, 0x00, 0x0D, 0x2B, 0x00, 0x00, 0x2B, 0x00, 0x0D, 0x02, 0x92, 0x04, 0x02, 0x96, 0x04, 0x01, 0x2B,
+	 0x03, 0x01, 0x2F, 0x01, 0x01, 0x04, 0x02, 0x93, 0x01, 0x2D, 0x03, 0x00, 0x00, 0x00, 0x00, 0x1B, 0x58, 0x00, 0x00, 0x00,
+	 0x32, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x8F, 0x02, 0x30, 0x02, 0xDA, 0x02, 0xB2, 0x4A},
+	{0x00, 0x0A, 0x54, 0x2B, 0x00, 0x09, 0x2B, 0x00, 0x00, 0x2B, 0x00, 0x09, 0x02, 0x90, 0x04, 0x02, 0x9A, 0x04, 0x01, 0x2C,
+	 0x02, 0x01, 0x30, 0x01, 0x02, 0x04, 0x02, 0x95, 0x01, 0x2F, 0x03, 0x00, 0x00, 0x00, 0x00, 0x1B, 0x58, 0x00, 0x00, 0x00,
+	 0x32, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x8F, 0x02, 0x30, 0x02, 0xDA, 0x02, 0xB2, 0x4E},
+	{0x00, 0x0A, 0x58, 0x2B, 0x00, 0x0C, 0x2B, 0x00, 0x00, 0x2B, 0x00, 0x0C, 0x02, 0x90, 0x04, 0x02, 0x9C, 0x04, 0x01, 0x2C,
+	 0x02, 0x01, 0x30, 0x03, 0x03, 0x04, 0x02, 0x97, 0x01, 0x2D, 0x03, 0x00, 0x00, 0x00, 0x00, 0x1B, 0x58, 0x00, 0x00, 0x00,
+	 0x32, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x8F, 0x02, 0x30, 0x02, 0xDA, 0x02, 0xB2, 0x5D},
+	{0x00, 0x0A, 0x54, 0x2B, 0x00, 0x0D, 0x2B, 0x00, 0x00, 0x2B, 0x00, 0x0D, 0x02, 0x94, 0x02, 0x02, 0x96, 0x02, 0x01, 0x2B,
+	 0x04, 0x01, 0x2F, 0x03, 0x04, 0x04, 0x02, 0x97, 0x01, 0x2D, 0x03, 0x00, 0x00, 0x00, 0x00, 0x1B, 0x58, 0x00, 0x00, 0x00,
+	 0x32, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x8F, 0x02, 0x30, 0x02, 0xDA, 0x02, 0xB2, 0x56},
+	{0x00, 0x0A, 0x58, 0x2B, 0x00, 0x10, 0x2B, 0x00, 0x00, 0x2B, 0x00, 0x10, 0x02, 0x96, 0x03, 0x02, 0x96, 0x01, 0x01, 0x2A,
+	 0x04, 0x01, 0x2E, 0x03, 0x01, 0x04, 0x02, 0x95, 0x01, 0x2C, 0x03, 0x00, 0x00, 0x00, 0x00, 0x1B, 0x58, 0x00, 0x00, 0x00,
+	 0x32, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x8F, 0x02, 0x30, 0x02, 0xDA, 0x02, 0xB2, 0x5A},
+	{0x00, 0x0A, 0x54, 0x2B, 0x00, 0x11, 0x2B, 0x00, 0x00, 0x2B, 0x00, 0x11, 0x02, 0x95, 0x03, 0x02, 0x95, 0x04, 0x01, 0x29,
+	 0x01, 0x01, 0x2D, 0x01, 0x02, 0x04, 0x02, 0x95, 0x01, 0x2C, 0x03, 0x00, 0x00, 0x00, 0x00, 0x1B, 0x58, 0x00, 0x00, 0x00,
+	 0x32, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x8F, 0x02, 0x30, 0x02, 0xDA, 0x02, 0xB2, 0x53},
+	{0x00, 0x0A, 0x58, 0x2B, 0x00, 0x0D, 0x2B, 0x00, 0x00, 0x2B, 0x00, 0x0D, 0x02, 0x90, 0x01, 0x02, 0x9C, 0x01, 0x01, 0x29,
+	 0x01, 0x01, 0x2D, 0x04, 0x03, 0x04, 0x02, 0x97, 0x01, 0x2A, 0x03, 0x00, 0x00, 0x00, 0x00, 0x1B, 0x58, 0x00, 0x00, 0x00,
+	 0x32, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x8F, 0x02, 0x30, 0x02, 0xDA, 0x02, 0xB2, 0x50},
+	{0x00, 0x0A, 0x5C, 0x2B, 0x00, 0x0A, 0x2B, 0x00, 0x00, 0x2B, 0x00, 0x0A, 0x02, 0x90, 0x03, 0x02, 0x9E, 0x02, 0x01, 0x29,
+	 0x02, 0x01, 0x2D, 0x04, 0x04, 0x04, 0x02, 0x99, 0x01, 0x2B, 0x03, 0x00, 0x00, 0x00, 0x00, 0x1B, 0x58, 0x00, 0x00, 0x00,
+	 0x32, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x8F, 0x02, 0x30, 0x02, 0xDA, 0x02, 0xB2, 0x58},
+	{0x00, 0x0A, 0x60, 0x2B, 0x00, 0x08, 0x2B, 0x00, 0x00, 0x2B, 0x00, 0x08, 0x02, 0x91, 0x01, 0x02, 0x9F, 0x02, 0x01, 0x29,
+	 0x02, 0x01, 0x2D, 0x04, 0x01, 0x04, 0x02, 0x97, 0x01, 0x2B, 0x03, 0x00, 0x00, 0x00, 0x00, 0x1B, 0x58, 0x00, 0x00, 0x00,
+	 0x32, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x8F, 0x02, 0x30, 0x02, 0xDA, 0x02, 0xB2, 0x53},
+	{0x00, 0x0A, 0x60, 0x2B, 0x00, 0x0B, 0x2B, 0x00, 0x00, 0x2B, 0x00, 0x0B, 0x02, 0x97, 0x03, 0x02, 0x99, 0x03, 0x01, 0x29,
+	 0x01, 0x01, 0x2D, 0x04, 0x02, 0x04, 0x02, 0x98, 0x01, 0x2C, 0x03, 0x00, 0x00, 0x00, 0x00, 0x1B, 0x58, 0x00, 0x00, 0x00,
+	 0x32, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x8F, 0x02, 0x30, 0x02, 0xDA, 0x02, 0xB2, 0x5E},
+	{0x00, 0x0A, 0x5C, 0x2B, 0x00, 0x09, 0x2B, 0x00, 0x00, 0x2B, 0x00, 0x09, 0x02, 0x93, 0x01, 0x02, 0x9B, 0x02, 0x01, 0x2A,
+	 0x01, 0x01, 0x2E, 0x04, 0x03, 0x04, 0x02, 0x98, 0x01, 0x2B, 0x03, 0x00, 0x00, 0x00, 0x00, 0x1B, 0x58, 0x00, 0x00, 0x00,
+	 0x32, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x8F, 0x02, 0x30, 0x02, 0xDA, 0x02, 0xB2, 0x53},
+	{0x00, 0x0A, 0x60, 0x2B, 0x00, 0x0B, 0x2B, 0x00, 0x00, 0x2B, 0x00, 0x0B, 0x02, 0x93, 0x03, 0x02, 0x9D, 0x03, 0x01, 0x2B,
+	 0x01, 0x01, 0x2F, 0x04, 0x04, 0x04, 0x02, 0x9A, 0x01, 0x2D, 0x03, 0x00, 0x00, 0x00, 0x00, 0x1B, 0x58, 0x00, 0x00, 0x00,
+	 0x32, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x8F, 0x02, 0x30, 0x02, 0xDA, 0x02, 0xB2, 0x67},
+	{0x00, 0x0A, 0x60, 0x2B, 0x00, 0x0D, 0x2B, 0x00, 0x00, 0x2B, 0x00, 0x0D, 0x02, 0x98, 0x03, 0x02, 0x98, 0x02, 0x01, 0x2C,
+	 0x02, 0x01, 0x30, 0x04, 0x01, 0x04, 0x02, 0x97, 0x01, 0x2E, 0x03, 0x00, 0x00, 0x00, 0x00, 0x1B, 0x58, 0x00, 0x00, 0x00,
+	 0x32, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x8F, 0x02, 0x30, 0x02, 0xDA, 0x02, 0xB2, 0x68},
+	{0x00, 0x0A, 0x60, 0x2B, 0x00, 0x11, 0x2B, 0x00, 0x00, 0x2B, 0x00, 0x11, 0x02, 0x97, 0x01, 0x02, 0x99, 0x02, 0x01, 0x2B,
+	 0x04, 0x01, 0x2F, 0x01, 0x02, 0x04, 0x02, 0x98, 0x01, 0x2E, 0x03, 0x00, 0x00, 0x00, 0x00, 0x1B, 0x58, 0x00, 0x00, 0x00,
+	 0x32, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x8F, 0x02, 0x30, 0x02, 0xDA, 0x02, 0xB2, 0x6D},
+	{0x00, 0x0A, 0x5C, 0x2B, 0x00, 0x10, 0x2B, 0x00, 0x00, 0x2B, 0x00, 0x10, 0x02, 0x94, 0x02, 0x02, 0x9A, 0x03, 0x01, 0x2C,
+	 0x03, 0x01, 0x30, 0x04, 0x03, 0x04, 0x02, 0x98, 0x01, 0x2D, 0x03, 0x00, 0x00, 0x00, 0x00, 0x1B, 0x58, 0x00, 0x00, 0x00,
+	 0x32, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x8F, 0x02, 0x30, 0x02, 0xDA, 0x02, 0xB2, 0x6B},
+	{0x00, 0x0A, 0x5C, 0x2B, 0x00, 0x0F, 0x2B, 0x00, 0x00, 0x2B, 0x00, 0x0F, 0x02, 0x95, 0x02, 0x02, 0x99, 0x01, 0x01, 0x2B,
+	 0x03, 0x01, 0x2F, 0x02, 0x04, 0x04, 0x02, 0x99, 0x01, 0x2D, 0x03, 0x00, 0x00, 0x00, 0x00, 0x1B, 0x58, 0x00, 0x00, 0x00,
+	 0x32, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x8F, 0x02, 0x30, 0x02, 0xDA, 0x02, 0xB2, 0x65},
+	// 120 cells
+	{0x01, 0x35, 0xD8, 0x2B, 0x00, 0x04, 0x2B, 0x00, 0x00, 0x2B, 0x00, 0x04, 0x02, 0x91, 0x20, 0x02, 0x99, 0x5F, 0x01, 0x2B,
+	 0x6C, 0x01, 0x2F, 0x43, 0x01, 0x78, 0x02, 0x94, 0x01, 0x2D, 0x03, 0x00, 0x00, 0x00, 0x00, 0x1B, 0x58, 0x00, 0x00, 0x00,
+	 0x32, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x8F, 0x02, 0x30, 0x02, 0xDA, 0x02, 0xB2, 0x85},
+	{0x01, 0x36, 0x50, 0x2B, 0x00, 0x03, 0x2B, 0x00, 0x00, 0x2B, 0x00, 0x03, 0x02, 0x93, 0x76, 0x02, 0x99, 0x49, 0x01, 0x2B,
+	 0x32, 0x01, 0x2F, 0x06, 0x02, 0x78, 0x02, 0x96, 0x01, 0x2E, 0x03, 0x00, 0x00, 0x00, 0x00, 0x1B, 0x58, 0x00, 0x00, 0x00,
+	 0x32, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x8F, 0x02, 0x30, 0x02, 0xDA, 0x02, 0xB2, 0xCB},
+	{0x01, 0x35, 0xD8, 0x2B, 0x00, 0x06, 0x2B, 0x00, 0x00, 0x2B, 0x00, 0x06, 0x02, 0x93, 0x06, 0x02, 0x97, 0x68, 0x01, 0x2A,
+	 0x6F, 0x01, 0x2E, 0x64, 0x03, 0x78, 0x02, 0x96, 0x01, 0x2B, 0x03, 0x00, 0x00, 0x00, 0x00, 0x1B, 0x58, 0x00, 0x00, 0x00,
+	 0x32, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x8F, 0x02, 0x30, 0x02, 0xDA, 0x02, 0xB2, 0x9C},
+	{0x01, 0x36, 0x50, 0x2B, 0x00, 0x06, 0x2B, 0x00, 0x00, 0x2B, 0x00, 0x06, 0x02, 0x8F, 0x3D, 0x02, 0x9D, 0x4D, 0x01, 0x29,
+	 0x59, 0x01, 0x2D, 0x43, 0x04, 0x78, 0x02, 0x98, 0x01, 0x2B, 0x03, 0x00, 0x00, 0x00, 0x00, 0x1B, 0x58, 0x00, 0x00, 0x00,
+	 0x32, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x8F, 0x02, 0x30, 0x02, 0xDA, 0x02, 0xB2, 0xFD},
+	{0x01, 0x36, 0xC8, 0x2B, 0x00, 0x0A, 0x2B, 0x00, 0x00, 0x2B, 0x00, 0x0A, 0x02, 0x97, 0x4F, 0x02, 0x97, 0x0C, 0x01, 0x29,
+	 0x09, 0x01, 0x2D, 0x23, 0x05, 0x78, 0x02, 0x95, 0x01, 0x2C, 0x03, 0x00, 0x00, 0x00, 0x00, 0x1B, 0x58, 0x00, 0x00, 0x00,
+	 0x32, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x8F, 0x02, 0x30, 0x02, 0xDA, 0x02, 0xB2, 0xDF},
+	{0x01, 0x36, 0xC8, 0x2B, 0x00, 0x0D, 0x2B, 0x00, 0x00, 0x2B, 0x00, 0x0D, 0x02, 0x97, 0x4A, 0x02, 0x97, 0x07, 0x01, 0x2A,
+	 0x37, 0x01, 0x2E, 0x39, 0x06, 0x78, 0x02, 0x96, 0x01, 0x2B, 0x03, 0x00, 0x00, 0x00, 0x00, 0x1B, 0x58, 0x00, 0x00, 0x00,
+	 0x32, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x8F, 0x02, 0x30, 0x02, 0xDA, 0x02, 0xB2, 0x22},
+	{0x01, 0x36, 0xC8, 0x2B, 0x00, 0x0E, 0x2B, 0x00, 0x00, 0x2B, 0x00, 0x0E, 0x02, 0x90, 0x12, 0x02, 0x9E, 0x5E, 0x01, 0x2B,
+	 0x1F, 0x01, 0x2F, 0x3C, 0x07, 0x78, 0x02, 0x97, 0x01, 0x2D, 0x03, 0x00, 0x00, 0x00, 0x00, 0x1B, 0x58, 0x00, 0x00, 0x00,
+	 0x32, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x8F, 0x02, 0x30, 0x02, 0xDA, 0x02, 0xB2, 0x34},
+	{0x01, 0x36, 0x50, 0x2B, 0x00, 0x0D, 0x2B, 0x00, 0x00, 0x2B, 0x00, 0x0D, 0x02, 0x93, 0x2B, 0x02, 0x99, 0x78, 0x01, 0x2B,
+	 0x69, 0x01, 0x2F, 0x4F, 0x08, 0x78, 0x02, 0x97, 0x01, 0x2E, 0x03, 0x00, 0x00, 0x00, 0x00, 0x1B, 0x58, 0x00, 0x00, 0x00,
+	 0x32, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x8F, 0x02, 0x30, 0x02, 0xDA, 0x02, 0xB2, 0x4A},
+	{0x01, 0x36, 0xC8, 0x2B, 0x00, 0x10, 0x2B, 0x00, 0x00, 0x2B, 0x00, 0x10, 0x02, 0x95, 0x33, 0x02, 0x99, 0x06, 0x01, 0x2B,
+	 0x5F, 0x01, 0x2F, 0x51, 0x09, 0x78, 0x02, 0x99, 0x01, 0x2C, 0x03, 0x00, 0x00, 0x00, 0x00, 0x1B, 0x58, 0x00, 0x00, 0x00,
+	 0x32, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x8F, 0x02, 0x30, 0x02, 0xDA, 0x02, 0xB2, 0x59},
+	{0x01, 0x36, 0x50, 0x2B, 0x00, 0x14, 0x2B, 0x00, 0x00, 0x2B, 0x00, 0x14, 0x02, 0x96, 0x31, 0x02, 0x96, 0x6F, 0x01, 0x2B,
+	 0x24, 0x01, 0x2F, 0x3D, 0x0A, 0x78, 0x02, 0x94, 0x01, 0x2D, 0x03, 0x00, 0x00, 0x00, 0x00, 0x1B, 0x58, 0x00, 0x00, 0x00,
+	 0x32, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x8F, 0x02, 0x30, 0x02, 0xDA, 0x02, 0xB2, 0xFC},
+	{0x01, 0x36, 0x50, 0x2B, 0x00, 0x11, 0x2B, 0x00, 0x00, 0x2B, 0x00, 0x11, 0x02, 0x94, 0x2B, 0x02, 0x98, 0x1B, 0x01, 0x2C,
+	 0x08, 0x01, 0x30, 0x2E, 0x0B, 0x78, 0x02, 0x95, 0x01, 0x2F, 0x03, 0x00, 0x00, 0x00, 0x00, 0x1B, 0x58, 0x00, 0x00, 0x00,
+	 0x32, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x8F, 0x02, 0x30, 0x02, 0xDA, 0x02, 0xB2, 0x77},
+	{0x01, 0x36, 0x50, 0x2B, 0x00, 0x0D, 0x2B, 0x00, 0x00, 0x2B, 0x00, 0x0D, 0x02, 0x93, 0x24, 0x02, 0x99, 0x39, 0x01, 0x2D,
+	 0x4F, 0x01, 0x31, 0x11, 0x0C, 0x78, 0x02, 0x96, 0x01, 0x2E, 0x03, 0x00, 0x00, 0x00, 0x00, 0x1B, 0x58, 0x00, 0x00, 0x00,
+	 0x32, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x8F, 0x02, 0x30, 0x02, 0xDA, 0x02, 0xB2, 0xB3},
+	{0x01, 0x36, 0x50, 0x2B, 0x00, 0x11, 0x2B, 0x00, 0x00, 0x2B, 0x00, 0x11, 0x02, 0x96, 0x15, 0x02, 0x96, 0x12, 0x01, 0x2C,
+	 0x12, 0x01, 0x30, 0x13, 0x0D, 0x78, 0x02, 0x97, 0x01, 0x2E, 0x03, 0x00, 0x00, 0x00, 0x00, 0x1B, 0x58, 0x00, 0x00, 0x00,
+	 0x32, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x8F, 0x02, 0x30, 0x02, 0xDA, 0x02, 0xB2, 0x4A},
+	{0x01, 0x35, 0xD8, 0x2B, 0x00, 0x11, 0x2B, 0x00, 0x00, 0x2B, 0x00, 0x11, 0x02, 0x8F, 0x22, 0x02, 0x9B, 0x4C, 0x01, 0x2D,
+	 0x02, 0x01, 0x31, 0x76, 0x0E, 0x78, 0x02, 0x97, 0x01, 0x30, 0x03, 0x00, 0x00, 0x00, 0x00, 0x1B, 0x58, 0x00, 0x00, 0x00,
+	 0x32, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x8F, 0x02, 0x30, 0x02, 0xDA, 0x02, 0xB2, 0x6E},
+	{0x01, 0x35, 0x60, 0x2B, 0x00, 0x0D, 0x2B, 0x00, 0x00, 0x2B, 0x00, 0x0D, 0x02, 0x8E, 0x4F, 0x02, 0x9A, 0x4D, 0x01, 0x2C,
+	 0x2A, 0x01, 0x30, 0x1B, 0x0F, 0x78, 0x02, 0x92, 0x01, 0x2D, 0x03, 0x00, 0x00, 0x00, 0x00, 0x1B, 0x58, 0x00, 0x00, 0x00,
+	 0x32, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x8F, 0x02, 0x30, 0x02, 0xDA, 0x02, 0xB2, 0xDE},
+	{0x01, 0x34, 0xE8, 0x2B, 0x00, 0x0F, 0x2B, 0x00, 0x00, 0x2B, 0x00, 0x0F, 0x02, 0x8D, 0x15, 0x02, 0x99, 0x54, 0x01, 0x2C,
+	 0x71, 0x01, 0x30, 0x35, 0x10, 0x78, 0x02, 0x92, 0x01, 0x2E, 0x03, 0x00, 0x00, 0x00, 0x00, 0x1B, 0x58, 0x00, 0x00, 0x00,
+	 0x32, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x8F, 0x02, 0x30, 0x02, 0xDA, 0x02, 0xB2, 0x97},
+	{0x01, 0x34, 0x70, 0x2B, 0x00, 0x11, 0x2B, 0x00, 0x00, 0x2B, 0x00, 0x11, 0x02, 0x8B, 0x28, 0x02, 0x99, 0x51, 0x01, 0x2C,
+	 0x1F, 0x01, 0x30, 0x1D, 0x11, 0x78, 0x02, 0x92, 0x01, 0x2F, 0x03, 0x00, 0x00, 0x00, 0x00, 0x1B, 0x58, 0x00, 0x00, 0x00,
+	 0x32, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x8F, 0x02, 0x30, 0x02, 0xDA, 0x02, 0xB2, 0xC9},
+	{0x01, 0x33, 0xF8, 0x2B, 0x00, 0x0D, 0x2B, 0x00, 0x00, 0x2B, 0x00, 0x0D, 0x02, 0x90, 0x31, 0x02, 0x92, 0x0B, 0x01, 0x2C,
+	 0x0A, 0x01, 0x30, 0x25, 0x12, 0x78, 0x02, 0x92, 0x01, 0x2D, 0x03, 0x00, 0x00, 0x00, 0x00, 0x1B, 0x58, 0x00, 0x00, 0x00,
+	 0x32, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x8F, 0x02, 0x30, 0x02, 0xDA, 0x02, 0xB2, 0xFB},
+	{0x01, 0x34, 0x70, 0x2B, 0x00, 0x0E, 0x2B, 0x00, 0x00, 0x2B, 0x00, 0x0E, 0x02, 0x91, 0x43, 0x02, 0x93, 0x6C, 0x01, 0x2C,
+	 0x39, 0x01, 0x30, 0x02, 0x13, 0x78, 0x02, 0x94, 0x01, 0x2E, 0x03, 0x00, 0x00, 0x00, 0x00, 0x1B, 0x58, 0x00, 0x00, 0x00,
+	 0x32, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x8F, 0x02, 0x30, 0x02, 0xDA, 0x02, 0xB2, 0xFB},
+	{0x01, 0x34, 0xE8, 0x2B, 0x00, 0x0D, 0x2B, 0x00, 0x00, 0x2B, 0x00, 0x0D, 0x02, 0x93, 0x61, 0x02, 0x93, 0x54, 0x01, 0x2B,
+	 0x52, 0x01, 0x2F, 0x2B, 0x14, 0x78, 0x02, 0x91, 0x01, 0x2E, 0x03, 0x00, 0x00, 0x00, 0x00, 0x1B, 0x58, 0x00, 0x00, 0x00,
+	 0x32, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x8F, 0x02, 0x30, 0x02, 0xDA, 0x02, 0xB2, 0xB7},
+	{0x01, 0x34, 0xE8, 0x2B, 0x00, 0x09, 0x2B, 0x00, 0x00, 0x2B, 0x00, 0x09, 0x02, 0x8E, 0x2A, 0x02, 0x98, 0x5E, 0x01, 0x2C,
+	 0x66, 0x01, 0x30, 0x56, 0x15, 0x78, 0x02, 0x92, 0x01, 0x2D, 0x03, 0x00, 0x00, 0x00, 0x00, 0x1B, 0x58, 0x00, 0x00, 0x00,
+	 0x32, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x8F, 0x02, 0x30, 0x02, 0xDA, 0x02, 0xB2, 0xC4},
+	{0x01, 0x34, 0xE8, 0x2B, 0x00, 0x06, 0x2B, 0x00, 0x00, 0x2B, 0x00, 0x06, 0x02, 0x8C, 0x53, 0x02, 0x9A, 0x11, 0x01, 0x2D,
+	 0x07, 0x01, 0x31, 0x58, 0x16, 0x78, 0x02, 0x93, 0x01, 0x2F, 0x03, 0x00, 0x00, 0x00, 0x00, 0x1B, 0x58, 0x00, 0x00, 0x00,
+	 0x32, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x8F, 0x02, 0x30, 0x02, 0xDA, 0x02, 0xB2, 0x43},
+	{0x01, 0x34, 0xE8, 0x2B, 0x00, 0x0A, 0x2B, 0x00, 0x00, 0x2B, 0x00, 0x0A, 0x02, 0x91, 0x23, 0x02, 0x95, 0x3E, 0x01, 0x2D,
+	 0x18, 0x01, 0x31, 0x28, 0x17, 0x78, 0x02, 0x94, 0x01, 0x30, 0x03, 0x00, 0x00, 0x00, 0x00, 0x1B, 0x58, 0x00, 0x00, 0x00,
+	 0x32, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x8F, 0x02, 0x30, 0x02, 0xDA, 0x02, 0xB2, 0x2C},
+	{0x01, 0x34, 0xE8, 0x2B, 0x00, 0x0E, 0x2B, 0x00, 0x00, 0x2B, 0x00, 0x0E, 0x02, 0x8C, 0x04, 0x02, 0x9A, 0x22, 0x01, 0x2C,
+	 0x75, 0x01, 0x30, 0x69, 0x18, 0x78, 0x02, 0x95, 0x01, 0x2D, 0x03, 0x00, 0x00, 0x00, 0x00, 0x1B, 0x58, 0x00, 0x00, 0x00,
+	 0x32, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x8F, 0x02, 0x30, 0x02, 0xDA, 0x02, 0xB2, 0x94},
+	// All values zero
+	{0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
+	// All values at their maximum
+	{0xFF, 0xFF, 0xFF, 0x2B, 0xFF, 0xFF, 0x2B, 0xFF, 0xFF, 0x2B, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+	 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+	 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x4B},
+	// Largest negative currents
+	{0xFF, 0xFF, 0xFF, 0x2D, 0xFF, 0xFF, 0x2D, 0xFF, 0xFF, 0x2D, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+	 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+	 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x51},
+	// Currents without a value
+	{0x00, 0x28, 0x90, 0x58, 0x00, 0x00, 0x58, 0x00, 0x06, 0x58, 0x00, 0x06, 0x02, 0x84, 0x01, 0x02, 0x8E, 0x10, 0x01, 0x32,
+	 0x0B, 0x01, 0x36, 0x10, 0x01, 0x10, 0x02, 0x88, 0x01, 0x34, 0x03, 0x00, 0x00, 0x00, 0x00, 0x1B, 0x58, 0x00, 0x00, 0x00,
+	 0x32, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x8F, 0x02, 0x30, 0x02, 0xDA, 0x02, 0xB2, 0x41},
+	// Small negative currents and temperatures around 0 degrees
+	{0x00, 0x28, 0x80, 0x2D, 0x03, 0xE6, 0x2D, 0x07, 0xCB, 0x2D, 0x00, 0x01, 0x02, 0x84, 0x07, 0x02, 0x8C, 0x01, 0x01, 0x0E,
+	 0x04, 0x01, 0x0F, 0x09, 0x02, 0x10, 0x02, 0x88, 0x00, 0x01, 0x03, 0x00, 0x00, 0x00, 0x00, 0x1B, 0x58, 0x00, 0x00, 0x00,
+	 0x32, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x8F, 0x02, 0x30, 0x02, 0xDA, 0x02, 0xB2, 0xC9},
+	// All flags set
+	{0x00, 0x28, 0x90, 0x2B, 0x00, 0x00, 0x2B, 0x00, 0x09, 0x2D, 0x00, 0x09, 0x02, 0x85, 0x0A, 0x02, 0x8D, 0x03, 0x01, 0x32,
+	 0x01, 0x01, 0x36, 0x0D, 0x03, 0x10, 0x02, 0x8A, 0x01, 0x33, 0x7F, 0x00, 0x00, 0x00, 0x00, 0x1B, 0x58, 0x00, 0x00, 0x00,
+	 0x32, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x8F, 0x02, 0x30, 0x02, 0xDA, 0x02, 0xB2, 0x30},
+};
+
+#define RECORDED_FRAME_COUNT (sizeof(RECORDED_FRAMES) / sizeof(RECORDED_FRAMES[0]))
+
+#endif
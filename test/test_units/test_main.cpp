@@ -0,0 +1,178 @@
+#include <stdint.h>
+#include <string.h>
+#include <unity.h>
+
+#include "bms/SmartBmsData.h"
+#include "bms/SmartBmsFrameView.h"
+#include "recorded_frames.h"
+
+// Digest of the integer values of the recorded frames without the optional cell data, every build must produce it
+#define RECORDED_FIXED_DIGEST 0x06B0FA46UL
+
+/**
+ * @brief Decode a big endian value of two bytes like the original decoder.
+ * @param buffer two bytes
+ * @return value
+ */
+static const uint16_t referenceTwoByteValue(const uint8_t *buffer)
+{
+	return (static_cast<uint16_t>(buffer[0]) << 8) | buffer[1];
+}
+
+/**
+ * @brief Decode a signed current like the original decoder.
+ * @param buffer sign byte followed by two bytes
+ * @return current in A
+ */
+static const float referenceCurrent(const uint8_t *buffer)
+{
+	float factor = 1.0f;
+	if (buffer[0] == 'X')
+	{
+		factor = 0.0f;
+	}
+	else if (buffer[0] == '-')
+	{
+		factor = -1.0f;
+	}
+	return factor * referenceTwoByteValue(&buffer[1]) * 0.125f;
+}
+
+/**
+ * @brief Add a value to a FNV-1a digest.
+ * @param digest digest so far
+ * @param value value to add
+ * @return new digest
+ */
+static const uint32_t addToDigest(uint32_t digest, const int32_t value)
+{
+	for (uint8_t i = 0; i < 4; i++)
+	{
+		digest = (digest ^ ((static_cast<uint32_t>(value) >> (8 * i)) & 0xFF)) * 16777619UL;
+	}
+	return digest;
+}
+
+void setUp()
+{
+}
+
+void tearDown()
+{
+}
+
+void test_fixed_values_are_exact()
+{
+	for (size_t i = 0; i < RECORDED_FRAME_COUNT; i++)
+	{
+		const uint8_t *frame = RECORDED_FRAMES[i];
+		SmartBmsData smartBmsData;
+		SmartBmsFrameView(frame).decode(&smartBmsData);
+
+		// The integer units are exact multiples of the raw values
+		TEST_ASSERT_EQUAL(frame[25], smartBmsData.getCellCount());
+		TEST_ASSERT_EQUAL(referenceTwoByteValue(&frame[51]) * 5, smartBmsData.getCellVoltageMinMillivolts());
+		TEST_ASSERT_EQUAL(referenceTwoByteValue(&frame[53]) * 5, smartBmsData.getCellVoltageMaxMillivolts());
+		TEST_ASSERT_EQUAL(referenceTwoByteValue(&frame[55]) * 5, smartBmsData.getCellVoltageBalanceMillivolts());
+		TEST_ASSERT_EQUAL(frame[40], smartBmsData.getPackSoc());
+		TEST_ASSERT_EQUAL(((frame[0] << 16) | (frame[1] << 8) | frame[2]) * 5, smartBmsData.getPackVoltageMillivolts());
+		TEST_ASSERT_EQUAL(referenceCurrent(&frame[9]) * 1000, smartBmsData.getPackCurrentMilliamps());
+		TEST_ASSERT_EQUAL(referenceCurrent(&frame[3]) * 1000, smartBmsData.getPackChargeCurrentMilliamps());
+		TEST_ASSERT_EQUAL(referenceCurrent(&frame[6]) * 1000, smartBmsData.getPackDischargeCurrentMilliamps());
+		TEST_ASSERT_EQUAL(referenceTwoByteValue(&frame[49]) * 100, smartBmsData.getPackCapacityWattHours());
+		TEST_ASSERT_EQUAL((frame[34] << 16) | (frame[35] << 8) | frame[36], smartBmsData.getPackRemainingEnergyWattHours());
+		TEST_ASSERT_EQUAL(referenceTwoByteValue(&frame[12]) * 5, smartBmsData.getLowestCellVoltageMillivolts());
+		TEST_ASSERT_EQUAL(referenceTwoByteValue(&frame[15]) * 5, smartBmsData.getHighestCellVoltageMillivolts());
+		TEST_ASSERT_EQUAL(referenceTwoByteValue(&frame[18]) * 857 - 232000, smartBmsData.getLowestCellTemperatureMillicelsius());
+		TEST_ASSERT_EQUAL(referenceTwoByteValue(&frame[21]) * 857 - 232000, smartBmsData.getHighestCellTemperatureMillicelsius());
+		TEST_ASSERT_EQUAL((frame[30] & 0b00000001) != 0, smartBmsData.isAllowedToCharge());
+		TEST_ASSERT_EQUAL((frame[30] & 0b01000000) != 0, smartBmsData.isMaxTemperatureAlarmActive());
+	}
+}
+
+void test_fixed_values_match_the_recorded_digest()
+{
+	uint32_t digest = 2166136261UL;
+	for (size_t i = 0; i < RECORDED_FRAME_COUNT; i++)
+	{
+		SmartBmsData smartBmsData;
+		SmartBmsFrameView(RECORDED_FRAMES[i]).decode(&smartBmsData);
+		for (size_t j = 0; j <= SBMS_FIELD_MAX_TEMPERATURE_ALARM; j++)
+		{
+			digest = addToDigest(digest, smartBmsData.getFixedValue(static_cast<SmartBmsField>(j)));
+		}
+	}
+	TEST_ASSERT_EQUAL_UINT32(RECORDED_FIXED_DIGEST, digest);
+}
+
+#ifndef SMART_BMS_FIXED_POINT
+/**
+ * @brief Check that two floats have the same bits.
+ * @param expected expected value
+ * @param actual actual value
+ * @return true when the bits are identical
+ */
+static const bool isBitIdentical(const float expected, const float actual)
+{
+	return memcmp(&expected, &actual, sizeof(float)) == 0;
+}
+
+void test_float_values_are_bit_identical_to_the_original_decoder()
+{
+	for (size_t i = 0; i < RECORDED_FRAME_COUNT; i++)
+	{
+		const uint8_t *frame = RECORDED_FRAMES[i];
+		SmartBmsData smartBmsData;
+		SmartBmsFrameView(frame).decode(&smartBmsData);
+
+		// The same expressions the decoder used before it stored raw values
+		const uint32_t packVoltage = (static_cast<uint32_t>(frame[0]) << 16) | (static_cast<uint16_t>(frame[1]) << 8) | frame[2];
+		const uint32_t remainingEnergy = (static_cast<uint32_t>(frame[34]) << 16) | (static_cast<uint16_t>(frame[35]) << 8) | frame[36];
+		TEST_ASSERT_TRUE(isBitIdentical(referenceTwoByteValue(&frame[51]) * 0.005f, smartBmsData.getCellVoltageMin()));
+		TEST_ASSERT_TRUE(isBitIdentical(referenceTwoByteValue(&frame[53]) * 0.005f, smartBmsData.getCellVoltageMax()));
+		TEST_ASSERT_TRUE(isBitIdentical(referenceTwoByteValue(&frame[55]) * 0.005f, smartBmsData.getCellVoltageBalance()));
+		TEST_ASSERT_TRUE(isBitIdentical(packVoltage * 0.005f, smartBmsData.getPackVoltage()));
+		TEST_ASSERT_TRUE(isBitIdentical(referenceCurrent(&frame[9]), smartBmsData.getPackCurrent()));
+		TEST_ASSERT_TRUE(isBitIdentical(referenceCurrent(&frame[3]), smartBmsData.getPackChargeCurrent()));
+		TEST_ASSERT_TRUE(isBitIdentical(referenceCurrent(&frame[6]), smartBmsData.getPackDischargeCurrent()));
+		TEST_ASSERT_TRUE(isBitIdentical(referenceTwoByteValue(&frame[49]) * 0.1f, smartBmsData.getPackCapacity()));
+		TEST_ASSERT_TRUE(isBitIdentical(remainingEnergy * 0.001f, smartBmsData.getPackRemainingEnergy()));
+		TEST_ASSERT_TRUE(isBitIdentical(referenceTwoByteValue(&frame[12]) * 0.005f, smartBmsData.getLowestCellVoltage()));
+		TEST_ASSERT_TRUE(isBitIdentical(referenceTwoByteValue(&frame[15]) * 0.005f, smartBmsData.getHighestCellVoltage()));
+		TEST_ASSERT_TRUE(isBitIdentical(referenceTwoByteValue(&frame[18]) * 0.857f - 232.0f, smartBmsData.getLowestCellTemperature()));
+		TEST_ASSERT_TRUE(isBitIdentical(referenceTwoByteValue(&frame[21]) * 0.857f - 232.0f, smartBmsData.getHighestCellTemperature()));
+	}
+}
+
+void test_float_and_fixed_values_agree()
+{
+	// Both units differ by a power of ten, the float value only deviates by its rounding error
+	for (size_t i = 0; i < RECORDED_FRAME_COUNT; i++)
+	{
+		SmartBmsData smartBmsData;
+		SmartBmsFrameView(RECORDED_FRAMES[i]).decode(&smartBmsData);
+		for (size_t j = 0; j < SBMS_FIELD_COUNT; j++)
+		{
+			const SmartBmsField field = static_cast<SmartBmsField>(j);
+			const SmartBmsFieldDescriptor &descriptor = SmartBmsFields::getDescriptor(field);
+			const double ratio = descriptor.fixedScale / descriptor.scale > 10 ? 1000.0 : 1.0;
+			const double fixedValue = smartBmsData.getFixedValue(field);
+			const double difference = smartBmsData.getValue(field) * ratio - fixedValue;
+			const double tolerance = (fixedValue < 0 ? -fixedValue : fixedValue) / (1 << 20) + 0.5;
+			TEST_ASSERT_TRUE(difference <= tolerance && difference >= -tolerance);
+		}
+	}
+}
+#endif
+
+int main()
+{
+	UNITY_BEGIN();
+	RUN_TEST(test_fixed_values_are_exact);
+	RUN_TEST(test_fixed_values_match_the_recorded_digest);
+#ifndef SMART_BMS_FIXED_POINT
+	RUN_TEST(test_float_values_are_bit_identical_to_the_original_decoder);
+	RUN_TEST(test_float_and_fixed_values_agree);
+#endif
+	return UNITY_END();
+}